@@ -0,0 +1,54 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_BENCH_COMMON_MEASUREMENT_HPP
+#define NLSR_BENCH_COMMON_MEASUREMENT_HPP
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+
+namespace nlsr {
+namespace bench {
+
+/*! \brief The heap allocations made by the process since it started.
+
+  The benchmarks replace the global operator new to count them; allocations of every
+  thread are counted.
+ */
+struct AllocationCount
+{
+  uint64_t nAllocations;
+  uint64_t nBytes;
+};
+
+AllocationCount
+getAllocationCount();
+
+/*! \brief Returns the largest resident set size of the process so far, in kilobytes.
+ */
+size_t
+getPeakRssKb();
+
+} // namespace bench
+} // namespace nlsr
+
+#endif // NLSR_BENCH_COMMON_MEASUREMENT_HPP
@@ -0,0 +1,309 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "topology.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace nlsr {
+namespace bench {
+
+static const ndn::time::system_clock::TimePoint NEVER_EXPIRES =
+  ndn::time::system_clock::TimePoint::max();
+
+Topology::Topology(const std::string& kind)
+  : m_kind(kind)
+{
+}
+
+size_t
+Topology::addRouter(const std::string& label)
+{
+  m_names.push_back(ndn::Name("/ndn/bench/%C1.Router").append(label));
+  m_neighbors.emplace_back();
+  return m_names.size() - 1;
+}
+
+void
+Topology::setLinkCost(size_t from, size_t to, double cost, bool isSymmetric)
+{
+  auto setCost = [this] (size_t from, size_t to, double cost, bool isOverwritten) {
+    std::vector<Neighbor>& neighbors = m_neighbors[from];
+    auto it = std::find_if(neighbors.begin(), neighbors.end(),
+                           [to] (const Neighbor& neighbor) { return neighbor.router == to; });
+    if (it == neighbors.end()) {
+      neighbors.push_back({to, cost});
+    }
+    else if (isOverwritten) {
+      it->cost = cost;
+    }
+  };
+
+  setCost(from, to, cost, true);
+  setCost(to, from, cost, isSymmetric);
+}
+
+void
+Topology::assignCoordinates(std::mt19937& rng, size_t nAngles)
+{
+  const double pi = std::acos(-1.0);
+  // Routers are spread uniformly over a hyperbolic disk of radius 2 ln(N), whose area
+  // grows with the hyperbolic cosine of the radius
+  const double diskRadius = 2.0 * std::log(std::max<size_t>(getNRouters(), 2));
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  m_radii.resize(getNRouters());
+  m_angles.resize(getNRouters());
+  for (size_t i = 0; i < getNRouters(); ++i) {
+    m_radii[i] = std::acosh(1.0 + (std::cosh(diskRadius) - 1.0) * uniform(rng));
+    m_angles[i].resize(nAngles);
+    // The last angle goes all around, the others from pole to pole
+    for (size_t k = 0; k + 1 < nAngles; ++k) {
+      m_angles[i][k] = pi * uniform(rng);
+    }
+    m_angles[i][nAngles - 1] = 2.0 * pi * uniform(rng);
+  }
+}
+
+size_t
+Topology::getNLinks() const
+{
+  size_t nLinks = 0;
+  for (const auto& neighbors : m_neighbors) {
+    nLinks += neighbors.size();
+  }
+  return nLinks;
+}
+
+AdjacencyList
+Topology::makeAdjacencyList(size_t router) const
+{
+  AdjacencyList adjacencies;
+  for (const Neighbor& neighbor : m_neighbors[router]) {
+    size_t i = neighbor.router;
+    std::ostringstream faceUri;
+    faceUri << "udp4://10." << (i >> 16 & 0xFF) << "." << (i >> 8 & 0xFF) << "."
+            << (i & 0xFF) << ":6363";
+    Adjacent adjacent(m_names[i], ndn::FaceUri(faceUri.str()), neighbor.cost,
+                      Adjacent::STATUS_ACTIVE, 0, i + 1);
+    adjacencies.insert(adjacent);
+  }
+  return adjacencies;
+}
+
+AdjLsaContainer
+Topology::makeAdjLsas() const
+{
+  AdjLsaContainer adjLsas;
+  for (size_t i = 0; i < getNRouters(); ++i) {
+    AdjacencyList adjacencies = makeAdjacencyList(i);
+    adjLsas.emplace(m_names[i], 1, NEVER_EXPIRES, adjacencies.size(), adjacencies);
+  }
+  return adjLsas;
+}
+
+CoordinateLsaContainer
+Topology::makeCoordinateLsas() const
+{
+  CoordinateLsaContainer coordinateLsas;
+  for (size_t i = 0; i < getNRouters() && i < m_radii.size(); ++i) {
+    coordinateLsas.emplace(m_names[i], 1, NEVER_EXPIRES, m_radii[i], m_angles[i]);
+  }
+  return coordinateLsas;
+}
+
+namespace {
+
+struct Point
+{
+  double x;
+  double y;
+};
+
+std::vector<Point>
+placeRouters(Topology& topology, size_t nRouters, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<Point> points(nRouters);
+  for (size_t i = 0; i < nRouters; ++i) {
+    topology.addRouter("router" + std::to_string(i));
+    points[i].x = uniform(rng);
+    points[i].y = uniform(rng);
+  }
+  return points;
+}
+
+double
+getDistance(const Point& a, const Point& b)
+{
+  return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+} // anonymous namespace
+
+Topology
+makeRandomGeometricTopology(size_t nRouters, double averageDegree, std::mt19937& rng)
+{
+  Topology topology("geometric");
+  std::vector<Point> points = placeRouters(topology, nRouters, rng);
+
+  // A disk of this radius holds averageDegree other routers on average
+  const double pi = std::acos(-1.0);
+  const double radius = std::sqrt(averageDegree / (pi * std::max<size_t>(nRouters - 1, 1)));
+
+  for (size_t i = 0; i < nRouters; ++i) {
+    for (size_t j = i + 1; j < nRouters; ++j) {
+      double distance = getDistance(points[i], points[j]);
+      if (distance < radius) {
+        topology.setLinkCost(i, j, 1 + std::round(99 * distance / radius));
+      }
+    }
+  }
+  return topology;
+}
+
+Topology
+makeWaxmanTopology(size_t nRouters, double averageDegree, std::mt19937& rng, double alpha)
+{
+  Topology topology("waxman");
+  std::vector<Point> points = placeRouters(topology, nRouters, rng);
+
+  // P(i, j) = beta * exp(-d / (alpha * L)), with beta chosen for the average degree
+  const double maxDistance = std::sqrt(2.0);
+  double totalWeight = 0.0;
+  for (size_t i = 0; i < nRouters; ++i) {
+    for (size_t j = i + 1; j < nRouters; ++j) {
+      totalWeight += std::exp(-getDistance(points[i], points[j]) / (alpha * maxDistance));
+    }
+  }
+  const double beta = totalWeight > 0 ?
+                      std::min(1.0, averageDegree * nRouters / (2.0 * totalWeight)) : 0.0;
+
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  for (size_t i = 0; i < nRouters; ++i) {
+    for (size_t j = i + 1; j < nRouters; ++j) {
+      double distance = getDistance(points[i], points[j]);
+      if (uniform(rng) < beta * std::exp(-distance / (alpha * maxDistance))) {
+        topology.setLinkCost(i, j, 1 + std::round(99 * distance / maxDistance));
+      }
+    }
+  }
+  return topology;
+}
+
+Topology
+makeFatTreeTopology(size_t nRouters)
+{
+  size_t k = 2;
+  while (5 * k * k / 4 < nRouters) {
+    k += 2;
+  }
+  const size_t half = k / 2;
+  const double cost = 10;
+
+  Topology topology("fat-tree");
+  // Edge switches first, so that router 0 is one
+  std::vector<size_t> edges;
+  std::vector<size_t> aggregations;
+  std::vector<size_t> cores;
+  for (size_t pod = 0; pod < k; ++pod) {
+    for (size_t i = 0; i < half; ++i) {
+      edges.push_back(topology.addRouter("pod" + std::to_string(pod) + "-edge" + std::to_string(i)));
+    }
+  }
+  for (size_t pod = 0; pod < k; ++pod) {
+    for (size_t i = 0; i < half; ++i) {
+      aggregations.push_back(topology.addRouter("pod" + std::to_string(pod) + "-aggregation" +
+                                                std::to_string(i)));
+    }
+  }
+  for (size_t i = 0; i < half * half; ++i) {
+    cores.push_back(topology.addRouter("core" + std::to_string(i)));
+  }
+
+  for (size_t pod = 0; pod < k; ++pod) {
+    for (size_t a = 0; a < half; ++a) {
+      size_t aggregation = aggregations[pod * half + a];
+      // Every edge switch of a pod is linked to every aggregation switch of the pod
+      for (size_t e = 0; e < half; ++e) {
+        topology.setLinkCost(edges[pod * half + e], aggregation, cost);
+      }
+      // The a-th aggregation switch of every pod is linked to the a-th group of cores
+      for (size_t c = 0; c < half; ++c) {
+        topology.setLinkCost(aggregation, cores[a * half + c], cost);
+      }
+    }
+  }
+  return topology;
+}
+
+Topology
+readEdgeListTopology(std::istream& is)
+{
+  Topology topology("edge-list");
+  std::unordered_map<std::string, size_t> routers;
+  auto getRouter = [&] (const std::string& label) {
+    auto it = routers.find(label);
+    if (it == routers.end()) {
+      it = routers.emplace(label, topology.addRouter(label)).first;
+    }
+    return it->second;
+  };
+
+  std::string line;
+  size_t lineNo = 0;
+  while (std::getline(is, line)) {
+    ++lineNo;
+    std::istringstream fields(line);
+    std::string from;
+    std::string to;
+    std::string costField;
+    if (!(fields >> from) || from[0] == '#') {
+      continue;
+    }
+
+    double cost = 1;
+    size_t costLength = 0;
+    if (fields >> to && fields >> costField) {
+      try {
+        cost = std::stod(costField, &costLength);
+      }
+      catch (const std::logic_error&) {
+        cost = 0;
+      }
+    }
+    if (to.empty() || costLength != costField.size() || !(cost > 0)) {
+      throw std::runtime_error("Cannot parse line " + std::to_string(lineNo) + ": " + line);
+    }
+    if (from != to) {
+      topology.setLinkCost(getRouter(from), getRouter(to), cost, false);
+    }
+  }
+  return topology;
+}
+
+} // namespace bench
+} // namespace nlsr
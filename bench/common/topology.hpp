@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_BENCH_COMMON_TOPOLOGY_HPP
+#define NLSR_BENCH_COMMON_TOPOLOGY_HPP
+
+#include "adjacency-list.hpp"
+#include "lsa.hpp"
+
+#include <iosfwd>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nlsr {
+namespace bench {
+
+/*! \brief A synthetic network of routers, to feed the routing calculators with.
+
+  Router 0 is the router the routing table is calculated for.
+ */
+class Topology
+{
+public:
+  struct Neighbor
+  {
+    size_t router;
+    double cost;
+  };
+
+  explicit
+  Topology(const std::string& kind);
+
+  /*! \brief Adds a router, and returns its index.
+   */
+  size_t
+  addRouter(const std::string& label);
+
+  /*! \brief Adds a link in both directions, or sets the cost of one direction of a link.
+    \param isSymmetric Whether the reverse direction gets the same cost. If not, only the
+                       direction from \p from to \p to is set, and a missing reverse
+                       direction is added with the same cost.
+   */
+  void
+  setLinkCost(size_t from, size_t to, double cost, bool isSymmetric = true);
+
+  /*! \brief Gives every router random hyperbolic coordinates.
+
+    The radii are spread as the radii of routers in a hyperbolic disk, with most routers
+    near its edge.
+   */
+  void
+  assignCoordinates(std::mt19937& rng, size_t nAngles = 1);
+
+  const std::string&
+  getKind() const
+  {
+    return m_kind;
+  }
+
+  size_t
+  getNRouters() const
+  {
+    return m_names.size();
+  }
+
+  /*! \brief Returns the number of links, counting each direction once.
+   */
+  size_t
+  getNLinks() const;
+
+  const ndn::Name&
+  getName(size_t router) const
+  {
+    return m_names[router];
+  }
+
+  const std::vector<Neighbor>&
+  getNeighbors(size_t router) const
+  {
+    return m_neighbors[router];
+  }
+
+  /*! \brief Returns the adjacencies of a router, all of them ACTIVE and with a face.
+   */
+  AdjacencyList
+  makeAdjacencyList(size_t router) const;
+
+  AdjLsaContainer
+  makeAdjLsas() const;
+
+  CoordinateLsaContainer
+  makeCoordinateLsas() const;
+
+private:
+  std::string m_kind;
+  std::vector<ndn::Name> m_names;
+  std::vector<std::vector<Neighbor>> m_neighbors;
+  std::vector<double> m_radii;
+  std::vector<std::vector<double>> m_angles;
+};
+
+/*! \brief Places routers uniformly in the unit square, and links those closer than a radius.
+  \param averageDegree The average number of links per router the radius is chosen for.
+
+  Link costs grow with the distance between the routers.
+ */
+Topology
+makeRandomGeometricTopology(size_t nRouters, double averageDegree, std::mt19937& rng);
+
+/*! \brief Places routers uniformly in the unit square, and links them with a probability
+  that decays exponentially with their distance, as in Waxman's model.
+  \param averageDegree The average number of links per router the probability is scaled to.
+  \param alpha The decay of the probability, relative to the size of the square.
+ */
+Topology
+makeWaxmanTopology(size_t nRouters, double averageDegree, std::mt19937& rng,
+                   double alpha = 0.15);
+
+/*! \brief Makes the smallest k-ary fat tree with at least nRouters switches.
+
+  A k-ary fat tree has (k/2)^2 core switches and k pods of k/2 aggregation and k/2 edge
+  switches, all links having the same cost, so that most destinations have many paths of
+  equal cost. Router 0 is an edge switch.
+ */
+Topology
+makeFatTreeTopology(size_t nRouters);
+
+/*! \brief Reads a topology from a list of links, such as a Rocketfuel weights file.
+
+  Each line holds the labels of two routers and optionally the cost of the link from the
+  first to the second, which defaults to 1. Empty lines and lines starting with '#' are
+  skipped. A link listed in one direction only gets the same cost in both.
+
+  \throw std::runtime_error A line cannot be parsed.
+ */
+Topology
+readEdgeListTopology(std::istream& is);
+
+} // namespace bench
+} // namespace nlsr
+
+#endif // NLSR_BENCH_COMMON_TOPOLOGY_HPP
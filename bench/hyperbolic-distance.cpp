@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*! \file
+ * Measures the hyperbolic distance kernels on random coordinates.
+ *
+ * Usage: bench-hyperbolic-distance [nRouters [nAngles]]
+ *
+ * For every kernel the processor can run, computes the distances from a set of source
+ * routers to all routers, as the hyperbolic calculator does for each neighbor, and prints
+ * the time per distance and the largest difference from the scalar kernel.
+ */
+
+#include "route/hyperbolic-distance.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+int
+main(int argc, char** argv)
+{
+  using namespace nlsr;
+
+  const size_t nRouters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+  const size_t nAngles = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2;
+  if (nRouters < 2 || nAngles < 1) {
+    std::cerr << "Usage: " << argv[0] << " [nRouters [nAngles]]" << std::endl;
+    return 2;
+  }
+  const size_t dimension = nAngles + 1;
+  // Enough sources for the measurement to last, as a router has few neighbors
+  const size_t nSources = std::min<size_t>(nRouters, 256);
+
+  std::mt19937 engine(1);
+  std::normal_distribution<double> normal;
+  std::uniform_real_distribution<double> radius(1.0, 30.0);
+
+  std::vector<double> coordinates(dimension * nRouters);
+  std::vector<double> coshRadii(nRouters);
+  std::vector<double> sinhRadii(nRouters);
+  for (size_t i = 0; i < nRouters; ++i) {
+    double norm = 0.0;
+    for (size_t k = 0; k < dimension; ++k) {
+      coordinates[k * nRouters + i] = normal(engine);
+      norm += coordinates[k * nRouters + i] * coordinates[k * nRouters + i];
+    }
+    for (size_t k = 0; k < dimension; ++k) {
+      coordinates[k * nRouters + i] /= std::sqrt(norm);
+    }
+
+    double r = radius(engine);
+    coshRadii[i] = std::cosh(r);
+    sinhRadii[i] = std::sinh(r);
+  }
+
+  HyperbolicPoints points{nRouters, dimension, coordinates.data(),
+                          coshRadii.data(), sinhRadii.data()};
+  std::vector<double> innerProducts(nRouters);
+  std::vector<double> distances(nRouters);
+  std::vector<double> scalarDistances(nSources * nRouters);
+
+  const auto& kernels = getHyperbolicDistanceKernels();
+  std::cout << "routers: " << nRouters << ", angles: " << nAngles
+            << ", sources: " << nSources << std::endl;
+
+  // The scalar kernel runs first, to give the reference distances
+  for (auto kernel = kernels.rbegin(); kernel != kernels.rend(); ++kernel) {
+    double maxDifference = 0.0;
+    std::chrono::steady_clock::duration elapsed{};
+
+    for (size_t src = 0; src < nSources; ++src) {
+      auto start = std::chrono::steady_clock::now();
+      kernel->kernel(points, src, innerProducts.data(), distances.data());
+      elapsed += std::chrono::steady_clock::now() - start;
+
+      double* reference = scalarDistances.data() + src * nRouters;
+      if (kernel == kernels.rbegin()) {
+        std::copy(distances.begin(), distances.end(), reference);
+      }
+      for (size_t dest = 0; dest < nRouters; ++dest) {
+        if (dest != src) {
+          maxDifference = std::max(maxDifference, std::abs(distances[dest] - reference[dest]));
+        }
+      }
+    }
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << kernel->name << ": "
+              << ns / (nSources * nRouters) << " ns/distance, "
+              << ns / nSources / 1000 << " us/source, "
+              << "max difference " << maxDifference << std::endl;
+  }
+
+  return 0;
+}
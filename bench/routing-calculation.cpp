@@ -0,0 +1,408 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/*! \file
+ * Measures the routing table calculators on synthetic and imported topologies.
+ *
+ * Usage: bench-routing-calculation [options]
+ *
+ *   --topology=KIND        geometric (default), waxman or fat-tree
+ *   --edge-list=FILE       read the topology from a list of links instead, e.g. a
+ *                          Rocketfuel weights file; --sizes is then ignored
+ *   --sizes=N,...          numbers of routers (default 100,300,1000,3000,10000)
+ *   --degree=D             average number of links per router (default 8)
+ *   --calculators=C,...    ls, ls-multipath and hr (default all three)
+ *   --receivers=R,...      count, which only counts the next hops, and table, which fills
+ *                          routing table entries as a calculation of the routing table
+ *                          does (default both)
+ *   --runs=R               calculations measured after the first one (default 5)
+ *   --seed=S               seed of the topology generator (default 1)
+ *   --csv                  print comma-separated values, for comparing runs
+ *
+ * For every topology, calculator and receiver, calculates the routing table of router 0
+ * once, then R times more with the same calculator where the routing table keeps it, and
+ * prints the time of the first calculation, the average time and heap allocations of the
+ * others, and the peak resident set size of the process. The sizes are run in the order
+ * given, so that with increasing sizes the peak belongs to the largest topology so far.
+ */
+
+#include "common/measurement.hpp"
+#include "common/topology.hpp"
+
+#include "route/map.hpp"
+#include "route/nexthop.hpp"
+#include "route/routing-table.hpp"
+#include "route/routing-table-calculator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace nlsr {
+namespace bench {
+
+/*! \brief Counts the next hops instead of keeping them, so that only the calculator is
+  measured.
+ */
+class NextHopCounter : public NextHopReceiver
+{
+public:
+  void
+  addNextHop(const ndn::Name&, NextHop&) override
+  {
+    ++nNextHops;
+  }
+
+  void
+  addNextHopToDryTable(const ndn::Name&, NextHop&) override
+  {
+    ++nNextHops;
+  }
+
+public:
+  size_t nNextHops = 0;
+};
+
+/*! \brief Fills routing table entries the way a calculation of the routing table does, so
+  that filling the table is measured along with the calculator.
+
+  The entries are cleared before each run and filled again, as the routing table hands the
+  entries of its previous table to the next calculation.
+ */
+class TableFiller : public NextHopReceiver
+{
+public:
+  void
+  addNextHop(const ndn::Name& destRouter, NextHop& nh) override
+  {
+    table.addNextHop(destRouter, nh);
+  }
+
+  void
+  addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh) override
+  {
+    dryTable.addNextHop(destRouter, nh);
+  }
+
+  void
+  clear()
+  {
+    table.clear();
+    dryTable.clear();
+  }
+
+  size_t
+  getNNextHops() const
+  {
+    size_t nNextHops = 0;
+    for (const auto& entry : table) {
+      nNextHops += entry.getNexthopList().size();
+    }
+    for (const auto& entry : dryTable) {
+      nNextHops += entry.getNexthopList().size();
+    }
+    return nNextHops;
+  }
+
+public:
+  RoutingTableEntries table;
+  RoutingTableEntries dryTable;
+};
+
+struct Options
+{
+  std::string topology = "geometric";
+  std::string edgeList;
+  std::vector<size_t> sizes = {100, 300, 1000, 3000, 10000};
+  double degree = 8;
+  std::vector<std::string> calculators = {"ls", "ls-multipath", "hr"};
+  std::vector<std::string> receivers = {"count", "table"};
+  size_t nRuns = 5;
+  unsigned seed = 1;
+  bool isCsv = false;
+};
+
+struct Result
+{
+  double firstMs;
+  double averageMs;
+  double allocationsPerRun;
+  double bytesPerRun;
+  size_t nNextHops;
+};
+
+std::vector<std::string>
+split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::istringstream is(list);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    items.push_back(item);
+  }
+  return items;
+}
+
+bool
+parseOptions(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    size_t equals = arg.find('=');
+    std::string name = arg.substr(0, equals);
+    std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+
+    if (name == "--topology" &&
+        (value == "geometric" || value == "waxman" || value == "fat-tree")) {
+      options.topology = value;
+    }
+    else if (name == "--edge-list" && !value.empty()) {
+      options.edgeList = value;
+    }
+    else if (name == "--sizes" && !value.empty()) {
+      options.sizes.clear();
+      for (const auto& size : split(value)) {
+        options.sizes.push_back(std::strtoul(size.data(), nullptr, 10));
+        if (options.sizes.back() < 2) {
+          return false;
+        }
+      }
+    }
+    else if (name == "--degree" && !value.empty()) {
+      options.degree = std::strtod(value.data(), nullptr);
+    }
+    else if (name == "--calculators" && !value.empty()) {
+      options.calculators = split(value);
+      for (const auto& calculator : options.calculators) {
+        if (calculator != "ls" && calculator != "ls-multipath" && calculator != "hr") {
+          return false;
+        }
+      }
+    }
+    else if (name == "--receivers" && !value.empty()) {
+      options.receivers = split(value);
+      for (const auto& receiver : options.receivers) {
+        if (receiver != "count" && receiver != "table") {
+          return false;
+        }
+      }
+    }
+    else if (name == "--runs" && !value.empty()) {
+      options.nRuns = std::strtoul(value.data(), nullptr, 10);
+    }
+    else if (name == "--seed" && !value.empty()) {
+      options.seed = std::strtoul(value.data(), nullptr, 10);
+    }
+    else if (name == "--csv" && value.empty()) {
+      options.isCsv = true;
+    }
+    else {
+      return false;
+    }
+  }
+  return options.degree > 0 && options.nRuns > 0;
+}
+
+/*! \brief Runs one calculation, and returns how long it took in milliseconds.
+ */
+template<typename Calculation>
+double
+measure(const Calculation& calculate)
+{
+  auto start = std::chrono::steady_clock::now();
+  calculate();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+    .count();
+}
+
+Result
+runCalculator(const std::string& calculator, const std::string& receiver,
+              const Topology& topology, size_t nRuns)
+{
+  const ndn::Name& thisRouter = topology.getName(0);
+  AdjacencyList adjacencies = topology.makeAdjacencyList(0);
+  NextHopCounter counter;
+  TableFiller filler;
+  bool isTable = receiver == "table";
+  NextHopReceiver& receiverRef = isTable ? static_cast<NextHopReceiver&>(filler) : counter;
+  std::function<void()> calculate;
+
+  // The LSDB and the map are made once, as the calculators get them ready-made
+  AdjLsaContainer adjLsas;
+  CoordinateLsaContainer coordinateLsas;
+  Map map;
+  std::unique_ptr<LinkStateRoutingTableCalculator> lsCalculator;
+  std::unique_ptr<CalculationParameters> parameters;
+
+  if (calculator == "hr") {
+    coordinateLsas = topology.makeCoordinateLsas();
+    map.createFromCoordinateLsdb(coordinateLsas.begin(), coordinateLsas.end());
+    // The routing table makes a new hyperbolic calculator for every calculation
+    calculate = [&] {
+      filler.clear();
+      HyperbolicRoutingCalculator hrCalculator(map.getMapSize(), false, thisRouter);
+      hrCalculator.calculatePath(map, receiverRef, coordinateLsas, adjacencies);
+    };
+  }
+  else {
+    adjLsas = topology.makeAdjLsas();
+    map.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+    // The routing table keeps its link-state calculator between calculations
+    lsCalculator = std::make_unique<LinkStateRoutingTableCalculator>(map.getMapSize());
+    parameters = std::make_unique<CalculationParameters>(thisRouter,
+                                                         calculator == "ls" ? 1 : 0,
+                                                         adjacencies);
+    calculate = [&] {
+      filler.clear();
+      lsCalculator->calculatePath(map, receiverRef, *parameters, adjLsas);
+    };
+  }
+
+  Result result;
+  result.firstMs = measure(calculate);
+  result.nNextHops = isTable ? filler.getNNextHops() : counter.nNextHops;
+
+  AllocationCount before = getAllocationCount();
+  double totalMs = 0;
+  for (size_t run = 0; run < nRuns; ++run) {
+    totalMs += measure(calculate);
+  }
+  AllocationCount after = getAllocationCount();
+
+  result.averageMs = totalMs / nRuns;
+  result.allocationsPerRun = static_cast<double>(after.nAllocations - before.nAllocations) / nRuns;
+  result.bytesPerRun = static_cast<double>(after.nBytes - before.nBytes) / nRuns;
+  return result;
+}
+
+void
+printHeader(bool isCsv)
+{
+  if (isCsv) {
+    std::cout << "topology,routers,links,calculator,receiver,next_hops,first_ms,average_ms,"
+              << "allocations_per_run,bytes_per_run,peak_rss_kb" << std::endl;
+    return;
+  }
+  std::cout << std::left << std::setw(11) << "topology" << std::right
+            << std::setw(8) << "routers" << std::setw(9) << "links" << "  "
+            << std::left << std::setw(13) << "calculator" << std::setw(9) << "receiver"
+            << std::right << std::setw(10) << "next hops" << std::setw(12) << "first ms"
+            << std::setw(12) << "average ms" << std::setw(14) << "allocs/run"
+            << std::setw(14) << "bytes/run" << std::setw(13) << "peak RSS kB" << std::endl;
+}
+
+void
+printResult(bool isCsv, const Topology& topology, const std::string& calculator,
+            const std::string& receiver, const Result& result)
+{
+  if (isCsv) {
+    std::cout << topology.getKind() << ',' << topology.getNRouters() << ','
+              << topology.getNLinks() << ',' << calculator << ',' << receiver << ','
+              << result.nNextHops << ','
+              << result.firstMs << ',' << result.averageMs << ','
+              << result.allocationsPerRun << ',' << result.bytesPerRun << ','
+              << getPeakRssKb() << std::endl;
+    return;
+  }
+  std::cout << std::left << std::setw(11) << topology.getKind() << std::right
+            << std::setw(8) << topology.getNRouters() << std::setw(9) << topology.getNLinks()
+            << "  " << std::left << std::setw(13) << calculator << std::setw(9) << receiver
+            << std::right << std::setw(10) << result.nNextHops << std::fixed << std::setprecision(3)
+            << std::setw(12) << result.firstMs << std::setw(12) << result.averageMs
+            << std::setprecision(1)
+            << std::setw(14) << result.allocationsPerRun << std::setw(14) << result.bytesPerRun
+            << std::setw(13) << getPeakRssKb() << std::defaultfloat << std::endl;
+}
+
+void
+runTopology(Topology& topology, const Options& options, std::mt19937& rng)
+{
+  topology.assignCoordinates(rng);
+  for (const auto& calculator : options.calculators) {
+    for (const auto& receiver : options.receivers) {
+      Result result = runCalculator(calculator, receiver, topology, options.nRuns);
+      printResult(options.isCsv, topology, calculator, receiver, result);
+    }
+  }
+}
+
+} // namespace bench
+} // namespace nlsr
+
+int
+main(int argc, char** argv)
+{
+  using namespace nlsr::bench;
+
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::cerr << "Usage: " << argv[0] << " [--topology=geometric|waxman|fat-tree]"
+              << " [--edge-list=FILE] [--sizes=N,...] [--degree=D]"
+              << " [--calculators=ls,ls-multipath,hr] [--receivers=count,table]"
+              << " [--runs=R] [--seed=S] [--csv]"
+              << std::endl;
+    return 2;
+  }
+
+  std::mt19937 rng(options.seed);
+  printHeader(options.isCsv);
+
+  if (!options.edgeList.empty()) {
+    std::ifstream file(options.edgeList);
+    if (!file) {
+      std::cerr << "Cannot open " << options.edgeList << std::endl;
+      return 1;
+    }
+    try {
+      Topology topology = readEdgeListTopology(file);
+      runTopology(topology, options, rng);
+    }
+    catch (const std::runtime_error& e) {
+      std::cerr << options.edgeList << ": " << e.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  for (size_t nRouters : options.sizes) {
+    if (options.topology == "waxman") {
+      Topology topology = makeWaxmanTopology(nRouters, options.degree, rng);
+      runTopology(topology, options, rng);
+    }
+    else if (options.topology == "fat-tree") {
+      Topology topology = makeFatTreeTopology(nRouters);
+      runTopology(topology, options, rng);
+    }
+    else {
+      Topology topology = makeRandomGeometricTopology(nRouters, options.degree, rng);
+      runTopology(topology, options, rng);
+    }
+  }
+
+  return 0;
+}
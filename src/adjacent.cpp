@@ -81,7 +81,7 @@ Adjacent::setLinkCost(double lc)
 bool
 Adjacent::operator==(const Adjacent& adjacent) const
 {
-  return (m_name == adjacent.getName()) &&
+  return (m_name == adjacent.m_name) &&
          (m_faceUri == adjacent.getFaceUri()) &&
          (std::abs(m_linkCost - adjacent.getLinkCost()) <
           std::numeric_limits<double>::epsilon());
@@ -92,7 +92,7 @@ Adjacent::operator<(const Adjacent& adjacent) const
 {
   auto linkCost = adjacent.getLinkCost();
   return std::tie(m_name, m_linkCost) <
-         std::tie(adjacent.getName(), linkCost);
+         std::tie(adjacent.m_name, linkCost);
 }
 
 std::ostream&
@@ -25,6 +25,8 @@
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/net/face-uri.hpp>
 
+#include "name-pool.hpp"
+
 #ifndef NLSR_ADJACENT_HPP
 #define NLSR_ADJACENT_HPP
 
@@ -162,7 +164,7 @@ public:
 
 private:
   /*! m_name The NLSR-configured router name of the neighbor */
-  ndn::Name m_name;
+  InternedName m_name;
   /*! m_faceUri The NFD-level specification of the Face*/
   ndn::FaceUri m_faceUri;
   /*! m_linkCost The semi-arbitrary cost to traverse the link. */
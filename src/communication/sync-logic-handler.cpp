@@ -77,6 +77,10 @@ SyncLogicHandler::createSyncLogic(const ndn::Name& syncPrefix, const ndn::time::
                   syncInterestLifetime,
                   std::bind(&SyncLogicHandler::processUpdate, this, _1, _2));
 
+  for (size_t shard = 1; shard < m_nameLsaShardUserPrefixes.size(); ++shard) {
+    m_syncLogic->addUserNode(m_nameLsaShardUserPrefixes[shard]);
+  }
+
   if (m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_OFF) {
     m_syncLogic->addUserNode(m_adjLsaUserPrefix);
   }
@@ -122,11 +126,12 @@ SyncLogicHandler::processUpdateFromSync(const ndn::Name& originRouter,
 
     Lsa::Type lsaType;
     std::istringstream(updateName.get(updateName.size()-1).toUri()) >> lsaType;
+    uint32_t shard = getLsaShard(updateName.get(updateName.size()-1));
 
     NLSR_LOG_DEBUG("Received sync update with higher " << lsaType <<
                    " sequence number than entry in LSDB");
 
-    if (m_isLsaNew(originRouter, lsaType, seqNo)) {
+    if (m_isLsaNew(originRouter, lsaType, seqNo, shard)) {
       if (lsaType == Lsa::Type::ADJACENCY && seqNo != 0 &&
           m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_ON) {
         NLSR_LOG_ERROR("Got an update for adjacency LSA when hyperbolic routing " <<
@@ -146,7 +151,8 @@ SyncLogicHandler::processUpdateFromSync(const ndn::Name& originRouter,
 }
 
 void
-SyncLogicHandler::publishRoutingUpdate(const Lsa::Type& type, const uint64_t& seqNo)
+SyncLogicHandler::publishRoutingUpdate(const Lsa::Type& type, const uint64_t& seqNo,
+                                       uint32_t shard)
 {
   if (m_syncLogic == nullptr) {
     NLSR_LOG_FATAL("Cannot publish routing update; SyncLogic does not exist");
@@ -162,7 +168,7 @@ SyncLogicHandler::publishRoutingUpdate(const Lsa::Type& type, const uint64_t& se
     m_syncLogic->publishUpdate(m_coorLsaUserPrefix, seqNo);
     break;
   case Lsa::Type::NAME:
-    m_syncLogic->publishUpdate(m_nameLsaUserPrefix, seqNo);
+    m_syncLogic->publishUpdate(m_nameLsaShardUserPrefixes.at(shard), seqNo);
     break;
   default:
     break;
@@ -176,8 +182,12 @@ SyncLogicHandler::buildUpdatePrefix()
   updatePrefix.append(m_confParam.getSiteName());
   updatePrefix.append(m_confParam.getRouterName());
 
-  m_nameLsaUserPrefix = updatePrefix;
-  m_nameLsaUserPrefix.append(std::to_string(Lsa::Type::NAME));
+  m_nameLsaShardUserPrefixes.clear();
+  for (uint32_t shard = 0; shard < m_confParam.getNameLsaShards(); ++shard) {
+    m_nameLsaShardUserPrefixes.push_back(
+      ndn::Name(updatePrefix).append(makeLsaTypeComponent(Lsa::Type::NAME, shard)));
+  }
+  m_nameLsaUserPrefix = m_nameLsaShardUserPrefixes.front();
 
   m_adjLsaUserPrefix = updatePrefix;
   m_adjLsaUserPrefix.append(std::to_string(Lsa::Type::ADJACENCY));
@@ -50,7 +50,8 @@ class SyncLogicHandler
 {
 public:
   using IsLsaNew =
-    std::function<bool(const ndn::Name&, const Lsa::Type& lsaType, const uint64_t&)>;
+    std::function<bool(const ndn::Name&, const Lsa::Type& lsaType, const uint64_t&,
+                       uint32_t shard)>;
 
   class Error : public std::runtime_error
   {
@@ -71,10 +72,11 @@ public:
    * this is called. Since each ChronoSync instance maintains its own
    * PIT, doing this satisfies those interests so that other routers
    * know a sync update is available.
+   * \param shard The shard of a name LSA, 0 for the other LSA types.
    * \sa publishSyncUpdate
    */
   void
-  publishRoutingUpdate(const Lsa::Type& type, const uint64_t& seqNo);
+  publishRoutingUpdate(const Lsa::Type& type, const uint64_t& seqNo, uint32_t shard = 0);
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   /*! \brief Create and configure a Logic object to enable Sync for this NLSR.
@@ -129,6 +131,8 @@ private:
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   ndn::Name m_nameLsaUserPrefix;
+  // The sync prefixes of the shards of the name LSA; the first one is m_nameLsaUserPrefix
+  std::vector<ndn::Name> m_nameLsaShardUserPrefixes;
   ndn::Name m_adjLsaUserPrefix;
   ndn::Name m_coorLsaUserPrefix;
 
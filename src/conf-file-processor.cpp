@@ -292,6 +292,18 @@ ConfFileProcessor::processConfSectionGeneral(const ConfigSection& section)
     return false;
   }
 
+  // max-lsa-fetches
+  uint32_t maxLsaFetches = section.get<uint32_t>("max-lsa-fetches", MAX_LSA_FETCHES_DEFAULT);
+  if (maxLsaFetches >= MAX_LSA_FETCHES_MIN && maxLsaFetches <= MAX_LSA_FETCHES_MAX) {
+    m_confParam.setMaxLsaFetches(maxLsaFetches);
+  }
+  else {
+    std::cerr << "Wrong value for max-lsa-fetches. "
+              << "Allowed value:" << MAX_LSA_FETCHES_MIN << "-"
+              << MAX_LSA_FETCHES_MAX << std::endl;
+    return false;
+  }
+
   // sync-protocol
   std::string syncProtocol = section.get<std::string>("sync-protocol", "chronosync");
   if (syncProtocol == "chronosync") {
@@ -306,6 +318,46 @@ ConfFileProcessor::processConfSectionGeneral(const ConfigSection& section)
     return false;
   }
 
+  // lsa-encoding
+  std::string lsaEncoding = section.get<std::string>("lsa-encoding", "text");
+  if (lsaEncoding == "text") {
+    m_confParam.setLsaEncoding(LSA_ENCODING_TEXT);
+  }
+  else if (lsaEncoding == "tlv") {
+    m_confParam.setLsaEncoding(LSA_ENCODING_TLV);
+  }
+  else {
+    std::cerr << "LSA encoding " << lsaEncoding << " is not supported!"
+              << "Use text or tlv" << std::endl;
+    return false;
+  }
+
+  // name-lsa-delta
+  std::string nameLsaDelta = section.get<std::string>("name-lsa-delta", "off");
+  if (boost::iequals(nameLsaDelta, "off")) {
+    m_confParam.setNameLsaDelta(false);
+  }
+  else if (boost::iequals(nameLsaDelta, "on")) {
+    m_confParam.setNameLsaDelta(true);
+  }
+  else {
+    std::cerr << "Wrong format for name-lsa-delta." << std::endl;
+    std::cerr << "Allowed value: off, on" << std::endl;
+    return false;
+  }
+
+  // name-lsa-shards
+  uint32_t nameLsaShards = section.get<uint32_t>("name-lsa-shards", NAME_LSA_SHARDS_DEFAULT);
+  if (nameLsaShards >= NAME_LSA_SHARDS_MIN && nameLsaShards <= NAME_LSA_SHARDS_MAX) {
+    m_confParam.setNameLsaShards(nameLsaShards);
+  }
+  else {
+    std::cerr << "Wrong value for name-lsa-shards. "
+              << "Allowed value:" << NAME_LSA_SHARDS_MIN << "-"
+              << NAME_LSA_SHARDS_MAX << std::endl;
+    return false;
+  }
+
   // sync-interest-lifetime
   uint32_t syncInterestLifetime = section.get<uint32_t>("sync-interest-lifetime",
                                                         SYNC_INTEREST_LIFETIME_DEFAULT);
@@ -321,6 +373,21 @@ ConfFileProcessor::processConfSectionGeneral(const ConfigSection& section)
     return false;
   }
 
+  // lsdb-snapshot-interval
+  uint32_t lsdbSnapshotInterval = section.get<uint32_t>("lsdb-snapshot-interval",
+                                                        LSDB_SNAPSHOT_INTERVAL_DEFAULT);
+  if (lsdbSnapshotInterval >= LSDB_SNAPSHOT_INTERVAL_MIN &&
+      lsdbSnapshotInterval <= LSDB_SNAPSHOT_INTERVAL_MAX) {
+    m_confParam.setLsdbSnapshotInterval(lsdbSnapshotInterval);
+  }
+  else {
+    std::cerr << "Wrong value for lsdb-snapshot-interval. "
+              << "Allowed value:" << LSDB_SNAPSHOT_INTERVAL_MIN << "-"
+              << LSDB_SNAPSHOT_INTERVAL_MAX << std::endl;
+
+    return false;
+  }
+
   try {
     std::string stateDir = section.get<std::string>("state-dir");
     if (boost::filesystem::exists(stateDir)) {
@@ -423,6 +490,31 @@ ConfFileProcessor::processConfSectionNeighbors(const ConfigSection& section)
   if (!adjLsaBuildInterval.parseFromConfigSection(section)) {
     return false;
   }
+
+  // adj-lsa-build-initial-delay
+  ConfigurationVariable<uint32_t> adjLsaBuildInitialDelay("adj-lsa-build-initial-delay",
+                                                          std::bind(&ConfParameter::setAdjLsaBuildInitialDelay,
+                                                                    &m_confParam, _1));
+  adjLsaBuildInitialDelay.setMinAndMaxValue(ADJ_LSA_BUILD_INITIAL_DELAY_MIN,
+                                            ADJ_LSA_BUILD_INITIAL_DELAY_MAX);
+  adjLsaBuildInitialDelay.setOptional(ADJ_LSA_BUILD_INITIAL_DELAY_DEFAULT);
+
+  if (!adjLsaBuildInitialDelay.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // adj-lsa-build-hold-delay
+  ConfigurationVariable<uint32_t> adjLsaBuildHoldDelay("adj-lsa-build-hold-delay",
+                                                       std::bind(&ConfParameter::setAdjLsaBuildHoldDelay,
+                                                                 &m_confParam, _1));
+  adjLsaBuildHoldDelay.setMinAndMaxValue(ADJ_LSA_BUILD_HOLD_DELAY_MIN,
+                                         ADJ_LSA_BUILD_HOLD_DELAY_MAX);
+  adjLsaBuildHoldDelay.setOptional(ADJ_LSA_BUILD_HOLD_DELAY_DEFAULT);
+
+  if (!adjLsaBuildHoldDelay.parseFromConfigSection(section)) {
+    return false;
+  }
+
   // Set the retry count for fetching the FaceStatus dataset
   ConfigurationVariable<uint32_t> faceDatasetFetchTries("face-dataset-fetch-tries",
                                                         std::bind(&ConfParameter::setFaceDatasetFetchTries,
@@ -602,6 +694,78 @@ ConfFileProcessor::processConfSectionFib(const ConfigSection& section)
     return false;
   }
 
+  // routing-calc-initial-delay
+  ConfigurationVariable<uint32_t> routingCalcInitialDelay("routing-calc-initial-delay",
+                                                          std::bind(&ConfParameter::setRoutingCalcInitialDelay,
+                                                                    &m_confParam, _1));
+  routingCalcInitialDelay.setMinAndMaxValue(ROUTING_CALC_INITIAL_DELAY_MIN,
+                                            ROUTING_CALC_INITIAL_DELAY_MAX);
+  routingCalcInitialDelay.setOptional(ROUTING_CALC_INITIAL_DELAY_DEFAULT);
+
+  if (!routingCalcInitialDelay.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // routing-calc-hold-delay
+  ConfigurationVariable<uint32_t> routingCalcHoldDelay("routing-calc-hold-delay",
+                                                       std::bind(&ConfParameter::setRoutingCalcHoldDelay,
+                                                                 &m_confParam, _1));
+  routingCalcHoldDelay.setMinAndMaxValue(ROUTING_CALC_HOLD_DELAY_MIN, ROUTING_CALC_HOLD_DELAY_MAX);
+  routingCalcHoldDelay.setOptional(ROUTING_CALC_HOLD_DELAY_DEFAULT);
+
+  if (!routingCalcHoldDelay.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // routing-calc-threads
+  ConfigurationVariable<uint32_t> routingCalcThreads("routing-calc-threads",
+                                                     std::bind(&ConfParameter::setRoutingCalcThreads,
+                                                               &m_confParam, _1));
+  routingCalcThreads.setMinAndMaxValue(ROUTING_CALC_THREADS_MIN, ROUTING_CALC_THREADS_MAX);
+  routingCalcThreads.setOptional(ROUTING_CALC_THREADS_DEFAULT);
+
+  if (!routingCalcThreads.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // refresh-jitter
+  ConfigurationVariable<uint32_t> refreshJitter("refresh-jitter",
+                                                std::bind(&ConfParameter::setFibRefreshJitter,
+                                                          &m_confParam, _1));
+  refreshJitter.setMinAndMaxValue(FIB_REFRESH_JITTER_MIN, FIB_REFRESH_JITTER_MAX);
+  refreshJitter.setOptional(FIB_REFRESH_JITTER_DEFAULT);
+
+  if (!refreshJitter.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // refresh-batch-size
+  ConfigurationVariable<uint32_t> refreshBatchSize("refresh-batch-size",
+                                                   std::bind(&ConfParameter::setFibRefreshBatchSize,
+                                                             &m_confParam, _1));
+  refreshBatchSize.setMinAndMaxValue(FIB_REFRESH_BATCH_SIZE_MIN, FIB_REFRESH_BATCH_SIZE_MAX);
+  refreshBatchSize.setOptional(FIB_REFRESH_BATCH_SIZE_DEFAULT);
+
+  if (!refreshBatchSize.parseFromConfigSection(section)) {
+    return false;
+  }
+
+  // incremental-spf
+  std::string incrementalSpf = section.get<std::string>("incremental-spf", "off");
+
+  if (boost::iequals(incrementalSpf, "off")) {
+    m_confParam.setIncrementalSpf(false);
+  }
+  else if (boost::iequals(incrementalSpf, "on")) {
+    m_confParam.setIncrementalSpf(true);
+  }
+  else {
+    std::cerr << "Wrong format for incremental-spf." << std::endl;
+    std::cerr << "Allowed value: off, on" << std::endl;
+
+    return false;
+  }
+
   return true;
 }
 
@@ -43,10 +43,16 @@ ConfParameter::ConfParameter(ndn::Face& face, const std::string& confFileName)
   : m_confFileName(confFileName)
   , m_lsaRefreshTime(LSA_REFRESH_TIME_DEFAULT)
   , m_adjLsaBuildInterval(ADJ_LSA_BUILD_INTERVAL_DEFAULT)
+  , m_adjLsaBuildInitialDelay(ADJ_LSA_BUILD_INITIAL_DELAY_DEFAULT)
+  , m_adjLsaBuildHoldDelay(ADJ_LSA_BUILD_HOLD_DELAY_DEFAULT)
   , m_firstHelloInterval(FIRST_HELLO_INTERVAL_DEFAULT)
   , m_routingCalcInterval(ROUTING_CALC_INTERVAL_DEFAULT)
+  , m_routingCalcInitialDelay(ROUTING_CALC_INITIAL_DELAY_DEFAULT)
+  , m_routingCalcHoldDelay(ROUTING_CALC_HOLD_DELAY_DEFAULT)
+  , m_routingCalcThreads(ROUTING_CALC_THREADS_DEFAULT)
   , m_faceDatasetFetchInterval(ndn::time::seconds(static_cast<int>(FACE_DATASET_FETCH_INTERVAL_DEFAULT)))
   , m_lsaInterestLifetime(ndn::time::seconds(static_cast<int>(LSA_INTEREST_LIFETIME_DEFAULT)))
+  , m_maxLsaFetches(MAX_LSA_FETCHES_DEFAULT)
   , m_routerDeadInterval(2 * LSA_REFRESH_TIME_DEFAULT)
   , m_interestRetryNumber(HELLO_RETRIES_DEFAULT)
   , m_interestResendTime(HELLO_TIMEOUT_DEFAULT)
@@ -54,8 +60,15 @@ ConfParameter::ConfParameter(ndn::Face& face, const std::string& confFileName)
   , m_hyperbolicState(HYPERBOLIC_STATE_OFF)
   , m_corR(0)
   , m_maxFacesPerPrefix(MAX_FACES_PER_PREFIX_MIN)
+  , m_fibRefreshJitter(FIB_REFRESH_JITTER_DEFAULT)
+  , m_fibRefreshBatchSize(FIB_REFRESH_BATCH_SIZE_DEFAULT)
+  , m_isIncrementalSpfEnabled(false)
+  , m_lsdbSnapshotInterval(LSDB_SNAPSHOT_INTERVAL_DEFAULT)
   , m_syncInterestLifetime(ndn::time::milliseconds(SYNC_INTEREST_LIFETIME_DEFAULT))
   , m_syncProtocol(SYNC_PROTOCOL_CHRONOSYNC)
+  , m_lsaEncoding(LSA_ENCODING_TEXT)
+  , m_isNameLsaDeltaEnabled(false)
+  , m_nameLsaShards(NAME_LSA_SHARDS_DEFAULT)
   , m_adjl()
   , m_npl()
   , m_validator(makeCertificateFetcher(face))
@@ -78,8 +91,16 @@ ConfParameter::writeLog()
   NLSR_LOG_INFO("LSA refresh time: " << m_lsaRefreshTime);
   NLSR_LOG_INFO("FIB Entry refresh time: " << m_lsaRefreshTime * 2);
   NLSR_LOG_INFO("LSA Interest lifetime: " << getLsaInterestLifetime());
+  NLSR_LOG_INFO("Max LSA fetches: " << m_maxLsaFetches);
+  NLSR_LOG_INFO("LSA encoding: " << (m_lsaEncoding == LSA_ENCODING_TLV ? "tlv" : "text"));
+  NLSR_LOG_INFO("Name LSA delta: " << m_isNameLsaDeltaEnabled);
+  NLSR_LOG_INFO("Name LSA shards: " << m_nameLsaShards);
   NLSR_LOG_INFO("Router dead interval: " << getRouterDeadInterval());
   NLSR_LOG_INFO("Max Faces Per Prefix: " << m_maxFacesPerPrefix);
+  NLSR_LOG_INFO("Routing calculation threads: " << m_routingCalcThreads);
+  NLSR_LOG_INFO("FIB refresh jitter: " << m_fibRefreshJitter << "%");
+  NLSR_LOG_INFO("FIB refresh batch size: " << m_fibRefreshBatchSize);
+  NLSR_LOG_INFO("Incremental SPF: " << m_isIncrementalSpfEnabled);
   NLSR_LOG_INFO("Hyperbolic Routing: " << m_hyperbolicState);
   NLSR_LOG_INFO("Hyp R: " << m_corR);
   int i=0;
@@ -87,11 +108,16 @@ ConfParameter::writeLog()
     NLSR_LOG_INFO("Hyp Angle " << i++ << ": "<< value);
   }
   NLSR_LOG_INFO("State Directory: " << m_stateFileDir);
+  NLSR_LOG_INFO("LSDB snapshot interval: " << m_lsdbSnapshotInterval);
 
   // Event Intervals
   NLSR_LOG_INFO("Adjacency LSA build interval:  " << m_adjLsaBuildInterval);
+  NLSR_LOG_INFO("Adjacency LSA build initial delay: " << m_adjLsaBuildInitialDelay);
+  NLSR_LOG_INFO("Adjacency LSA build hold delay: " << m_adjLsaBuildHoldDelay);
   NLSR_LOG_INFO("First Hello Interest interval: " << m_firstHelloInterval);
   NLSR_LOG_INFO("Routing calculation interval:  " << m_routingCalcInterval);
+  NLSR_LOG_INFO("Routing calculation initial delay: " << m_routingCalcInitialDelay);
+  NLSR_LOG_INFO("Routing calculation hold delay: " << m_routingCalcHoldDelay);
 }
 
 void
@@ -49,18 +49,48 @@ enum {
   SYNC_PROTOCOL_PSYNC = 1
 };
 
+enum {
+  LSA_ENCODING_TEXT = 0,
+  LSA_ENCODING_TLV = 1
+};
+
 enum {
   LSA_INTEREST_LIFETIME_MIN = 1,
   LSA_INTEREST_LIFETIME_DEFAULT = 4,
   LSA_INTEREST_LIFETIME_MAX = 60
 };
 
+enum {
+  MAX_LSA_FETCHES_MIN = 1,
+  MAX_LSA_FETCHES_DEFAULT = 100,
+  MAX_LSA_FETCHES_MAX = 10000
+};
+
+enum {
+  NAME_LSA_SHARDS_MIN = 1,
+  NAME_LSA_SHARDS_DEFAULT = 1,
+  NAME_LSA_SHARDS_MAX = 64
+};
+
 enum {
   ADJ_LSA_BUILD_INTERVAL_MIN = 0,
   ADJ_LSA_BUILD_INTERVAL_DEFAULT = 5,
   ADJ_LSA_BUILD_INTERVAL_MAX = 5
 };
 
+// The throttling delays are in milliseconds, and are capped by the interval
+enum {
+  ADJ_LSA_BUILD_INITIAL_DELAY_MIN = 0,
+  ADJ_LSA_BUILD_INITIAL_DELAY_DEFAULT = 5000,
+  ADJ_LSA_BUILD_INITIAL_DELAY_MAX = 5000
+};
+
+enum {
+  ADJ_LSA_BUILD_HOLD_DELAY_MIN = 0,
+  ADJ_LSA_BUILD_HOLD_DELAY_DEFAULT = 5000,
+  ADJ_LSA_BUILD_HOLD_DELAY_MAX = 5000
+};
+
 enum {
   FIRST_HELLO_INTERVAL_MIN = 0,
   FIRST_HELLO_INTERVAL_DEFAULT = 10,
@@ -73,6 +103,24 @@ enum {
   ROUTING_CALC_INTERVAL_MAX = 15
 };
 
+enum {
+  ROUTING_CALC_INITIAL_DELAY_MIN = 0,
+  ROUTING_CALC_INITIAL_DELAY_DEFAULT = 15000,
+  ROUTING_CALC_INITIAL_DELAY_MAX = 15000
+};
+
+enum {
+  ROUTING_CALC_HOLD_DELAY_MIN = 0,
+  ROUTING_CALC_HOLD_DELAY_DEFAULT = 15000,
+  ROUTING_CALC_HOLD_DELAY_MAX = 15000
+};
+
+enum {
+  ROUTING_CALC_THREADS_MIN = 0,
+  ROUTING_CALC_THREADS_DEFAULT = 0,
+  ROUTING_CALC_THREADS_MAX = 64
+};
+
 
 enum {
   FACE_DATASET_FETCH_TRIES_MIN = 1,
@@ -110,6 +158,18 @@ enum {
   MAX_FACES_PER_PREFIX_MAX = 60
 };
 
+enum {
+  FIB_REFRESH_JITTER_MIN = 1,
+  FIB_REFRESH_JITTER_DEFAULT = 10,
+  FIB_REFRESH_JITTER_MAX = 50
+};
+
+enum {
+  FIB_REFRESH_BATCH_SIZE_MIN = 1,
+  FIB_REFRESH_BATCH_SIZE_DEFAULT = 100,
+  FIB_REFRESH_BATCH_SIZE_MAX = 10000
+};
+
 enum HyperbolicState {
   HYPERBOLIC_STATE_OFF = 0,
   HYPERBOLIC_STATE_ON = 1,
@@ -123,6 +183,13 @@ enum {
   SYNC_INTEREST_LIFETIME_MAX = 120000,
 };
 
+// In seconds; 0 disables the LSDB snapshot
+enum {
+  LSDB_SNAPSHOT_INTERVAL_MIN = 0,
+  LSDB_SNAPSHOT_INTERVAL_DEFAULT = 0,
+  LSDB_SNAPSHOT_INTERVAL_MAX = 3600
+};
+
 /*! \brief A class to house all the configuration parameters for NLSR.
  *
  * This class is conceptually a singleton (but not mechanically) which
@@ -225,6 +292,59 @@ public:
     }
   }
 
+  /*! \brief Returns the encoding this router publishes its LSAs in.
+
+    LSAs are decoded from either encoding, whatever this is set to.
+  */
+  int32_t
+  getLsaEncoding() const
+  {
+    return m_lsaEncoding;
+  }
+
+  void
+  setLsaEncoding(int32_t lsaEncoding)
+  {
+    if (lsaEncoding == LSA_ENCODING_TEXT || lsaEncoding == LSA_ENCODING_TLV) {
+      m_lsaEncoding = lsaEncoding;
+    }
+  }
+
+  /*! \brief Sets whether name LSAs are exchanged as deltas.
+
+    When enabled, this router keeps the recent changes of its own name LSA to serve them as
+    deltas, and fetches the name LSAs of other routers as deltas from the ones it holds.
+    Whatever this is set to, a router that cannot serve a delta serves the whole name LSA.
+   */
+  void
+  setNameLsaDelta(bool isEnabled)
+  {
+    m_isNameLsaDeltaEnabled = isEnabled;
+  }
+
+  bool
+  isNameLsaDeltaEnabled() const
+  {
+    return m_isNameLsaDeltaEnabled;
+  }
+
+  /*! \brief Sets how many shards the names advertised by this router are split across.
+
+    Each shard is a name LSA of its own, with its own sync prefix and sequence number, so that
+    a change to one name only leads other routers to fetch the shard that holds it.
+   */
+  void
+  setNameLsaShards(uint32_t nShards)
+  {
+    m_nameLsaShards = nShards;
+  }
+
+  uint32_t
+  getNameLsaShards() const
+  {
+    return m_nameLsaShards;
+  }
+
   uint32_t
   getLsaRefreshTime() const
   {
@@ -243,6 +363,21 @@ public:
     return m_lsaInterestLifetime;
   }
 
+  /*! \brief Sets how many LSAs may be fetched at once. Further fetches wait for one of them
+    to end.
+   */
+  void
+  setMaxLsaFetches(uint32_t maxLsaFetches)
+  {
+    m_maxLsaFetches = maxLsaFetches;
+  }
+
+  uint32_t
+  getMaxLsaFetches() const
+  {
+    return m_maxLsaFetches;
+  }
+
   void
   setAdjLsaBuildInterval(uint32_t interval)
   {
@@ -255,6 +390,30 @@ public:
     return m_adjLsaBuildInterval;
   }
 
+  void
+  setAdjLsaBuildInitialDelay(uint32_t delay)
+  {
+    m_adjLsaBuildInitialDelay = delay;
+  }
+
+  uint32_t
+  getAdjLsaBuildInitialDelay() const
+  {
+    return m_adjLsaBuildInitialDelay;
+  }
+
+  void
+  setAdjLsaBuildHoldDelay(uint32_t delay)
+  {
+    m_adjLsaBuildHoldDelay = delay;
+  }
+
+  uint32_t
+  getAdjLsaBuildHoldDelay() const
+  {
+    return m_adjLsaBuildHoldDelay;
+  }
+
   void
   setFirstHelloInterval(uint32_t interval)
   {
@@ -279,6 +438,42 @@ public:
     return m_routingCalcInterval;
   }
 
+  void
+  setRoutingCalcInitialDelay(uint32_t delay)
+  {
+    m_routingCalcInitialDelay = delay;
+  }
+
+  uint32_t
+  getRoutingCalcInitialDelay() const
+  {
+    return m_routingCalcInitialDelay;
+  }
+
+  void
+  setRoutingCalcHoldDelay(uint32_t delay)
+  {
+    m_routingCalcHoldDelay = delay;
+  }
+
+  uint32_t
+  getRoutingCalcHoldDelay() const
+  {
+    return m_routingCalcHoldDelay;
+  }
+
+  void
+  setRoutingCalcThreads(uint32_t nThreads)
+  {
+    m_routingCalcThreads = nThreads;
+  }
+
+  uint32_t
+  getRoutingCalcThreads() const
+  {
+    return m_routingCalcThreads;
+  }
+
   void
   setRouterDeadInterval(uint32_t rdt)
   {
@@ -403,6 +598,46 @@ public:
     return m_maxFacesPerPrefix;
   }
 
+  /*! \brief Sets how much earlier than the refresh time, as a percentage of it,
+   *  a FIB entry may be refreshed.
+   */
+  void
+  setFibRefreshJitter(uint32_t jitter)
+  {
+    m_fibRefreshJitter = jitter;
+  }
+
+  uint32_t
+  getFibRefreshJitter() const
+  {
+    return m_fibRefreshJitter;
+  }
+
+  /*! \brief Sets how many FIB entries are refreshed at most in one batch. */
+  void
+  setFibRefreshBatchSize(uint32_t batchSize)
+  {
+    m_fibRefreshBatchSize = batchSize;
+  }
+
+  uint32_t
+  getFibRefreshBatchSize() const
+  {
+    return m_fibRefreshBatchSize;
+  }
+
+  void
+  setIncrementalSpf(bool isEnabled)
+  {
+    m_isIncrementalSpfEnabled = isEnabled;
+  }
+
+  bool
+  isIncrementalSpfEnabled() const
+  {
+    return m_isIncrementalSpfEnabled;
+  }
+
   void
   setStateFileDir(const std::string& ssfd)
   {
@@ -415,6 +650,21 @@ public:
     return m_stateFileDir;
   }
 
+  /*! \brief Sets how often, in seconds, the LSAs of other routers are written to the LSDB
+    snapshot in the state directory. With 0, no snapshot is written or loaded.
+  */
+  void
+  setLsdbSnapshotInterval(uint32_t interval)
+  {
+    m_lsdbSnapshotInterval = interval;
+  }
+
+  uint32_t
+  getLsdbSnapshotInterval() const
+  {
+    return m_lsdbSnapshotInterval;
+  }
+
   void
   setConfFileNameDynamic(const std::string& confFileDynamic)
   {
@@ -489,13 +739,19 @@ private:
   uint32_t  m_lsaRefreshTime;
 
   uint32_t m_adjLsaBuildInterval;
+  uint32_t m_adjLsaBuildInitialDelay;
+  uint32_t m_adjLsaBuildHoldDelay;
   uint32_t m_firstHelloInterval;
   uint32_t m_routingCalcInterval;
+  uint32_t m_routingCalcInitialDelay;
+  uint32_t m_routingCalcHoldDelay;
+  uint32_t m_routingCalcThreads;
 
   uint32_t m_faceDatasetFetchTries;
   ndn::time::seconds m_faceDatasetFetchInterval;
 
   ndn::time::seconds m_lsaInterestLifetime;
+  uint32_t m_maxLsaFetches;
   uint32_t  m_routerDeadInterval;
 
   uint32_t m_interestRetryNumber;
@@ -508,13 +764,21 @@ private:
   std::vector<double> m_corTheta;
 
   uint32_t m_maxFacesPerPrefix;
+  uint32_t m_fibRefreshJitter;
+  uint32_t m_fibRefreshBatchSize;
+  bool m_isIncrementalSpfEnabled;
 
   std::string m_stateFileDir;
+  uint32_t m_lsdbSnapshotInterval;
 
   ndn::time::milliseconds m_syncInterestLifetime;
 
   int32_t m_syncProtocol;
 
+  int32_t m_lsaEncoding;
+  bool m_isNameLsaDeltaEnabled;
+  uint32_t m_nameLsaShards;
+
   std::string m_confFileNameDynamic;
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
@@ -30,6 +30,8 @@ INIT_LOGGER(HelloProtocol);
 
 const std::string HelloProtocol::INFO_COMPONENT = "INFO";
 const std::string HelloProtocol::NLSR_COMPONENT = "nlsr";
+const ndn::time::seconds HelloProtocol::HELLO_DATA_LIFETIME = ndn::time::minutes(30);
+const ndn::time::seconds HelloProtocol::HELLO_DATA_RESIGN_MARGIN = ndn::time::minutes(1);
 
 HelloProtocol::HelloProtocol(ndn::Face& face, ndn::KeyChain& keyChain,
                              ndn::security::SigningInfo& signingInfo,
@@ -113,37 +115,95 @@ HelloProtocol::processInterest(const ndn::Name& name,
   ndn::Name neighbor;
   neighbor.wireDecode(interestName.get(-1).blockFromValue());
   NLSR_LOG_DEBUG("Neighbor: " << neighbor);
-  if (m_confParam.getAdjacencyList().isNeighbor(neighbor)) {
-    std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>();
-    data->setName(ndn::Name(interest.getName()).appendVersion());
-    data->setFreshnessPeriod(ndn::time::seconds(10)); // 10 sec
-    data->setContent(reinterpret_cast<const uint8_t*>(INFO_COMPONENT.c_str()),
-                                                      INFO_COMPONENT.size());
 
-    m_keyChain.sign(*data, m_signingInfo);
+  auto entry = m_helloDataCache.find(neighbor);
+  if (entry == m_helloDataCache.end()) {
+    auto adjacent = m_confParam.getAdjacencyList().findAdjacent(neighbor);
+    if (adjacent == m_confParam.getAdjacencyList().getAdjList().end()) {
+      return;
+    }
+    entry = m_helloDataCache.emplace(neighbor, HelloDataCacheEntry{adjacent, nullptr, {},
+                                                                   false, {}}).first;
+  }
 
-    NLSR_LOG_DEBUG("Sending out data for name: " << interest.getName());
+  const ndn::Data& data = getHelloData(neighbor, entry->second, interestName);
 
-    m_face.put(*data);
-    // increment SENT_HELLO_DATA
-    hpIncrementSignal(Statistics::PacketType::SENT_HELLO_DATA);
+  NLSR_LOG_DEBUG("Sending out data for name: " << interest.getName());
 
-    auto adjacent = m_confParam.getAdjacencyList().findAdjacent(neighbor);
-    // If this neighbor was previously inactive, send our own hello interest, too
-    if (adjacent->getStatus() == Adjacent::STATUS_INACTIVE) {
-      // We can only do that if the neighbor currently has a face.
-      if(adjacent->getFaceId() != 0){
-        // interest name: /<neighbor>/NLSR/INFO/<router>
-        ndn::Name interestName(neighbor);
-        interestName.append(NLSR_COMPONENT);
-        interestName.append(INFO_COMPONENT);
-        interestName.append(m_confParam.getRouterPrefix().wireEncode());
-        expressInterest(interestName, m_confParam.getInterestResendTime());
-      }
+  m_face.put(data);
+  // increment SENT_HELLO_DATA
+  hpIncrementSignal(Statistics::PacketType::SENT_HELLO_DATA);
+
+  auto adjacent = entry->second.adjacent;
+  // If this neighbor was previously inactive, send our own hello interest, too
+  if (adjacent->getStatus() == Adjacent::STATUS_INACTIVE) {
+    // We can only do that if the neighbor currently has a face.
+    if(adjacent->getFaceId() != 0){
+      // interest name: /<neighbor>/NLSR/INFO/<router>
+      ndn::Name interestName(neighbor);
+      interestName.append(NLSR_COMPONENT);
+      interestName.append(INFO_COMPONENT);
+      interestName.append(m_confParam.getRouterPrefix().wireEncode());
+      expressInterest(interestName, m_confParam.getInterestResendTime());
     }
   }
 }
 
+const ndn::Data&
+HelloProtocol::getHelloData(const ndn::Name& neighbor, HelloDataCacheEntry& entry,
+                            const ndn::Name& interestName)
+{
+  if (entry.data == nullptr ||
+      ndn::time::steady_clock::now() >= entry.expiry ||
+      entry.data->getName().getPrefix(-1) != interestName) {
+    signHelloData(neighbor, entry, interestName);
+  }
+  else {
+    NLSR_LOG_TRACE("Using cached Hello Data for neighbor: " << neighbor);
+  }
+
+  entry.isUsed = true;
+  return *entry.data;
+}
+
+void
+HelloProtocol::signHelloData(const ndn::Name& neighbor, HelloDataCacheEntry& entry,
+                             const ndn::Name& interestName)
+{
+  std::shared_ptr<ndn::Data> data = std::make_shared<ndn::Data>();
+  data->setName(ndn::Name(interestName).appendVersion());
+  data->setFreshnessPeriod(ndn::time::seconds(10)); // 10 sec
+  data->setContent(reinterpret_cast<const uint8_t*>(INFO_COMPONENT.c_str()),
+                                                    INFO_COMPONENT.size());
+
+  m_keyChain.sign(*data, m_signingInfo);
+  NLSR_LOG_DEBUG("Signed Hello Data: " << data->getName());
+
+  entry.data = data;
+  entry.expiry = ndn::time::steady_clock::now() + HELLO_DATA_LIFETIME;
+  entry.isUsed = false;
+  entry.resignEvent.cancel();
+  entry.resignEvent = m_scheduler.schedule(HELLO_DATA_LIFETIME - HELLO_DATA_RESIGN_MARGIN,
+                                           [this, neighbor] { resignHelloData(neighbor); });
+}
+
+void
+HelloProtocol::resignHelloData(const ndn::Name& neighbor)
+{
+  auto entry = m_helloDataCache.find(neighbor);
+  if (entry == m_helloDataCache.end()) {
+    return;
+  }
+
+  if (!entry->second.isUsed) {
+    NLSR_LOG_DEBUG("Hello Data for neighbor: " << neighbor << " is not in use, removing it");
+    m_helloDataCache.erase(entry);
+    return;
+  }
+
+  signHelloData(neighbor, entry->second, entry->second.data->getName().getPrefix(-1));
+}
+
 void
 HelloProtocol::processInterestTimedOut(const ndn::Interest& interest)
 {
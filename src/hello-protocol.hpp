@@ -36,6 +36,8 @@
 #include <ndn-cxx/security/v2/validation-error.hpp>
 #include <ndn-cxx/security/validator-config.hpp>
 
+#include <unordered_map>
+
 namespace nlsr {
 
 class HelloProtocol
@@ -97,6 +99,9 @@ public:
    * neighbor that sent the Interest was previously marked as
    * INACTIVE, NLSR will attempt to contact it with its own Hello
    * Interest.
+   *
+   * The reply comes from the Hello Data cache, so a neighbor's reply
+   * is only signed when the cache has none for it yet.
    */
   void
   processInterest(const ndn::Name& name, const ndn::Interest& interest);
@@ -133,6 +138,46 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   onContentValidated(const ndn::Data& data);
 
+  /*! \brief A signed Hello Data kept for one neighbor.
+   *
+   * The entries of the cache are indexed by neighbor name, and also
+   * point to the neighbor in the configured adjacency list, which
+   * keeps its adjacents in place for the lifetime of NLSR.
+   */
+  struct HelloDataCacheEntry
+  {
+    AdjacencyList::iterator adjacent;
+    std::shared_ptr<ndn::Data> data;
+    ndn::time::steady_clock::TimePoint expiry;
+    /*! Whether the data has been sent since it was signed */
+    bool isUsed;
+    ndn::scheduler::EventId resignEvent;
+  };
+
+  /*! \brief Returns the Hello Data to reply to a neighbor with.
+   *
+   * The cached data is signed again if it has expired, or if it does
+   * not answer the Interest.
+   */
+  const ndn::Data&
+  getHelloData(const ndn::Name& neighbor, HelloDataCacheEntry& entry,
+               const ndn::Name& interestName);
+
+  /*! \brief Signs new Hello Data for a neighbor, and schedules it to be
+   *  signed again shortly before it expires.
+   */
+  void
+  signHelloData(const ndn::Name& neighbor, HelloDataCacheEntry& entry,
+                const ndn::Name& interestName);
+
+  /*! \brief Signs a neighbor's Hello Data again ahead of its expiry.
+   *
+   * Data that has not been sent since it was signed is dropped from
+   * the cache instead, so that idle neighbors cost no signatures.
+   */
+  void
+  resignHelloData(const ndn::Name& neighbor);
+
 private:
   /*! \brief Log that incoming data couldn't be validated, but do nothing else.
    */
@@ -176,6 +221,15 @@ private:
   RoutingTable& m_routingTable;
   Lsdb& m_lsdb;
 
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::unordered_map<ndn::Name, HelloDataCacheEntry> m_helloDataCache;
+
+  /*! How long a signed Hello Data is sent to a neighbor */
+  static const ndn::time::seconds HELLO_DATA_LIFETIME;
+  /*! How long before it expires Hello Data that is in use is signed again */
+  static const ndn::time::seconds HELLO_DATA_RESIGN_MARGIN;
+
+private:
   static const std::string INFO_COMPONENT;
   static const std::string NLSR_COMPONENT;
 };
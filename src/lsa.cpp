@@ -24,6 +24,9 @@
 #include "name-prefix-list.hpp"
 #include "adjacent.hpp"
 #include "logger.hpp"
+#include "tlv/tlv-nlsr.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
 
 #include <string>
 #include <iostream>
@@ -31,6 +34,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <unordered_set>
 #include <boost/algorithm/string.hpp>
 
 namespace nlsr {
@@ -49,15 +53,28 @@ Lsa::getData() const
 const ndn::Name
 Lsa::getKey() const
 {
-  return ndn::Name(m_origRouter).append(std::to_string(getType()));
+  return ndn::Name(m_origRouter.get()).append(std::to_string(getType()));
+}
+
+const ndn::Name
+NameLsa::getKey() const
+{
+  return ndn::Name(m_origRouter.get()).append(makeLsaTypeComponent(getType(), m_shard));
+}
+
+uint32_t
+NameLsa::getShardOf(const ndn::Name& name, uint32_t nShards)
+{
+  return std::hash<ndn::Name>()(name) % nShards;
 }
 
 bool
 Lsa::deserializeCommon(boost::tokenizer<boost::char_separator<char>>::iterator& iterator)
 {
-  m_origRouter = ndn::Name(*iterator++);
-  if (m_origRouter.size() <= 0)
+  ndn::Name origRouter(*iterator++);
+  if (origRouter.size() <= 0)
     return false;
+  m_origRouter = origRouter;
   if (*iterator++ != std::to_string(getType()))
     return false;
   m_lsSeqNo = boost::lexical_cast<uint32_t>(*iterator++);
@@ -65,6 +82,83 @@ Lsa::deserializeCommon(boost::tokenizer<boost::char_separator<char>>::iterator&
   return true;
 }
 
+template<ndn::encoding::Tag TAG>
+size_t
+Lsa::wireEncodeLsaInfo(ndn::EncodingImpl<TAG>& block) const
+{
+  size_t totalLength = 0;
+
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(block,
+                   ndn::tlv::nlsr::ExpirationTime,
+                   ndn::time::toUnixTimestamp(m_expirationTimePoint).count());
+
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(block,
+                                                               ndn::tlv::nlsr::SequenceNumber,
+                                                               m_lsSeqNo);
+
+  totalLength += ndn::encoding::prependNestedBlock(block, ndn::tlv::nlsr::OriginRouter,
+                                                   m_origRouter.get());
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(ndn::tlv::nlsr::LsaInfo);
+
+  return totalLength;
+}
+
+void
+Lsa::wireDecodeLsaInfo(const ndn::Block& wire)
+{
+  if (wire.type() != ndn::tlv::nlsr::LsaInfo) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Expected LsaInfo Block, but Block is of type #" +
+                                          std::to_string(wire.type())));
+  }
+
+  wire.parse();
+  ndn::Block::element_const_iterator val = wire.elements_begin();
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::OriginRouter) {
+    val->parse();
+    if (val->elements_size() == 0 || val->elements_begin()->type() != ndn::tlv::Name) {
+      BOOST_THROW_EXCEPTION(ndn::tlv::Error("OriginRouter: Missing required Name field"));
+    }
+    m_origRouter = ndn::Name(*val->elements_begin());
+    ++val;
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required OriginRouter field"));
+  }
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::SequenceNumber) {
+    m_lsSeqNo = static_cast<uint32_t>(ndn::readNonNegativeInteger(*val));
+    ++val;
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required SequenceNumber field"));
+  }
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::ExpirationTime) {
+    m_expirationTimePoint = ndn::time::fromUnixTimestamp(
+      ndn::time::milliseconds(ndn::readNonNegativeInteger(*val)));
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required ExpirationTime field"));
+  }
+}
+
+/*! \brief Encodes an LSA into a block of its own, sized by a first dry run. */
+template<typename LsaType>
+static ndn::Block
+encodeLsa(const LsaType& lsa)
+{
+  ndn::EncodingEstimator estimator;
+  size_t estimatedSize = lsa.wireEncode(estimator);
+
+  ndn::EncodingBuffer buffer(estimatedSize, 0);
+  lsa.wireEncode(buffer);
+
+  return buffer.block();
+}
+
 NameLsa::NameLsa(const ndn::Name& origR, uint32_t lsn,
                  const ndn::time::system_clock::TimePoint& lt,
                  NamePrefixList& npl)
@@ -72,7 +166,7 @@ NameLsa::NameLsa(const ndn::Name& origR, uint32_t lsn,
   m_origRouter = origR;
   m_lsSeqNo = lsn;
   m_expirationTimePoint = lt;
-  for (const auto& name : npl.getNames()) {
+  for (const auto& name : npl) {
     addName(name);
   }
 }
@@ -82,7 +176,7 @@ NameLsa::serialize() const
 {
   std::ostringstream os;
   os << getData() << m_npl.size();
-  for (const auto& name : m_npl.getNames()) {
+  for (const auto& name : m_npl) {
     os << "|" << name;
   }
   os << "|";
@@ -114,6 +208,74 @@ NameLsa::deserialize(const std::string& content) noexcept
   return true;
 }
 
+template<ndn::encoding::Tag TAG>
+size_t
+NameLsa::wireEncode(ndn::EncodingImpl<TAG>& block) const
+{
+  size_t totalLength = 0;
+
+  for (auto name = m_npl.rbegin(); name != m_npl.rend(); ++name) {
+    totalLength += name->wireEncode(block);
+  }
+
+  if (m_shard != 0) {
+    totalLength += ndn::encoding::prependNonNegativeIntegerBlock(block,
+                                                                 ndn::tlv::nlsr::ShardNumber,
+                                                                 m_shard);
+  }
+
+  totalLength += wireEncodeLsaInfo(block);
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(ndn::tlv::nlsr::NameLsa);
+
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(NameLsa);
+
+ndn::Block
+NameLsa::wireEncode() const
+{
+  return encodeLsa(*this);
+}
+
+void
+NameLsa::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != ndn::tlv::nlsr::NameLsa) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Expected NameLsa Block, but Block is of type #" +
+                                          std::to_string(wire.type())));
+  }
+
+  wire.parse();
+  ndn::Block::element_const_iterator val = wire.elements_begin();
+
+  if (val == wire.elements_end()) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required LsaInfo field"));
+  }
+  wireDecodeLsaInfo(*val++);
+
+  m_shard = 0;
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::ShardNumber) {
+    m_shard = static_cast<uint32_t>(ndn::readNonNegativeInteger(*val));
+    ++val;
+  }
+
+  // Looking each name up in the list as it is added would take quadratic time
+  std::vector<ndn::Name> names;
+  std::unordered_set<ndn::Name> uniqueNames;
+  for (; val != wire.elements_end(); ++val) {
+    if (val->type() == ndn::tlv::Name) {
+      ndn::Name name(*val);
+      if (uniqueNames.insert(name).second) {
+        names.push_back(std::move(name));
+      }
+    }
+  }
+  m_npl = NamePrefixList(names);
+}
+
 bool
 NameLsa::isEqualContent(const NameLsa& other) const
 {
@@ -126,6 +288,192 @@ NameLsa::writeLog() const
   NLSR_LOG_DEBUG(*this);
 }
 
+NameLsaDelta::NameLsaDelta(const ndn::Name& origR, uint32_t lsn,
+                           const ndn::time::system_clock::TimePoint& lt, uint32_t baseSeqNo)
+  : m_baseSeqNo(baseSeqNo)
+{
+  m_origRouter = origR;
+  m_lsSeqNo = lsn;
+  m_expirationTimePoint = lt;
+}
+
+const ndn::Name
+NameLsaDelta::getKey() const
+{
+  return ndn::Name(m_origRouter.get()).append(makeLsaTypeComponent(getType(), m_shard));
+}
+
+void
+NameLsaDelta::addName(const ndn::Name& name)
+{
+  if (m_removedNames.erase(name) == 0) {
+    m_addedNames.insert(name);
+  }
+}
+
+void
+NameLsaDelta::removeName(const ndn::Name& name)
+{
+  if (m_addedNames.erase(name) == 0) {
+    m_removedNames.insert(name);
+  }
+}
+
+void
+NameLsaDelta::append(const NameLsaDelta& next)
+{
+  BOOST_ASSERT(next.getBaseSeqNo() == m_lsSeqNo);
+
+  for (const auto& name : next.getAddedNames()) {
+    addName(name);
+  }
+  for (const auto& name : next.getRemovedNames()) {
+    removeName(name);
+  }
+  m_lsSeqNo = next.getLsSeqNo();
+  m_expirationTimePoint = next.getExpirationTimePoint();
+}
+
+std::string
+NameLsaDelta::serialize() const
+{
+  std::ostringstream os;
+  os << getData() << m_baseSeqNo << "|" << m_addedNames.size();
+  for (const auto& name : m_addedNames) {
+    os << "|" << name;
+  }
+  os << "|" << m_removedNames.size();
+  for (const auto& name : m_removedNames) {
+    os << "|" << name;
+  }
+  os << "|";
+  return os.str();
+}
+
+bool
+NameLsaDelta::deserialize(const std::string&) noexcept
+{
+  NLSR_LOG_ERROR("Name LSA deltas have no text encoding");
+  return false;
+}
+
+template<ndn::encoding::Tag TAG>
+static size_t
+prependNames(ndn::EncodingImpl<TAG>& block, uint32_t type, const std::set<ndn::Name>& names)
+{
+  size_t totalLength = 0;
+
+  for (auto name = names.rbegin(); name != names.rend(); ++name) {
+    totalLength += name->wireEncode(block);
+  }
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(type);
+
+  return totalLength;
+}
+
+template<ndn::encoding::Tag TAG>
+size_t
+NameLsaDelta::wireEncode(ndn::EncodingImpl<TAG>& block) const
+{
+  size_t totalLength = 0;
+
+  totalLength += prependNames(block, ndn::tlv::nlsr::RemovedNames, m_removedNames);
+  totalLength += prependNames(block, ndn::tlv::nlsr::AddedNames, m_addedNames);
+
+  totalLength += ndn::encoding::prependNonNegativeIntegerBlock(block,
+                                                               ndn::tlv::nlsr::BaseSeqNumber,
+                                                               m_baseSeqNo);
+
+  if (m_shard != 0) {
+    totalLength += ndn::encoding::prependNonNegativeIntegerBlock(block,
+                                                                 ndn::tlv::nlsr::ShardNumber,
+                                                                 m_shard);
+  }
+
+  totalLength += wireEncodeLsaInfo(block);
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(ndn::tlv::nlsr::NameLsaDelta);
+
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(NameLsaDelta);
+
+ndn::Block
+NameLsaDelta::wireEncode() const
+{
+  return encodeLsa(*this);
+}
+
+static std::set<ndn::Name>
+decodeNames(const ndn::Block& wire)
+{
+  std::set<ndn::Name> names;
+
+  wire.parse();
+  for (const auto& element : wire.elements()) {
+    if (element.type() == ndn::tlv::Name) {
+      names.emplace(element);
+    }
+  }
+  return names;
+}
+
+void
+NameLsaDelta::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != ndn::tlv::nlsr::NameLsaDelta) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Expected NameLsaDelta Block, but Block is of type #" +
+                                          std::to_string(wire.type())));
+  }
+
+  wire.parse();
+  ndn::Block::element_const_iterator val = wire.elements_begin();
+
+  if (val == wire.elements_end()) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required LsaInfo field"));
+  }
+  wireDecodeLsaInfo(*val++);
+
+  m_shard = 0;
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::ShardNumber) {
+    m_shard = static_cast<uint32_t>(ndn::readNonNegativeInteger(*val));
+    ++val;
+  }
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::BaseSeqNumber) {
+    m_baseSeqNo = static_cast<uint32_t>(ndn::readNonNegativeInteger(*val));
+    ++val;
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required BaseSeqNumber field"));
+  }
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::AddedNames) {
+    m_addedNames = decodeNames(*val);
+    ++val;
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required AddedNames field"));
+  }
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::RemovedNames) {
+    m_removedNames = decodeNames(*val);
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required RemovedNames field"));
+  }
+}
+
+void
+NameLsaDelta::writeLog() const
+{
+  NLSR_LOG_DEBUG(*this);
+}
+
 CoordinateLsa::CoordinateLsa(const ndn::Name& origR, uint32_t lsn,
                              const ndn::time::system_clock::TimePoint& lt,
                              double r, std::vector<double> theta)
@@ -190,6 +538,68 @@ CoordinateLsa::deserialize(const std::string& content) noexcept
   return true;
 }
 
+template<ndn::encoding::Tag TAG>
+size_t
+CoordinateLsa::wireEncode(ndn::EncodingImpl<TAG>& block) const
+{
+  size_t totalLength = 0;
+
+  for (auto angle = m_angles.rbegin(); angle != m_angles.rend(); ++angle) {
+    totalLength += ndn::encoding::prependDoubleBlock(block, ndn::tlv::nlsr::HyperbolicAngle,
+                                                     *angle);
+  }
+
+  totalLength += ndn::encoding::prependDoubleBlock(block, ndn::tlv::nlsr::HyperbolicRadius,
+                                                   m_corRad);
+
+  totalLength += wireEncodeLsaInfo(block);
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(ndn::tlv::nlsr::CoordinateLsa);
+
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(CoordinateLsa);
+
+ndn::Block
+CoordinateLsa::wireEncode() const
+{
+  return encodeLsa(*this);
+}
+
+void
+CoordinateLsa::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != ndn::tlv::nlsr::CoordinateLsa) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Expected CoordinateLsa Block, but Block is of type #" +
+                                          std::to_string(wire.type())));
+  }
+
+  wire.parse();
+  ndn::Block::element_const_iterator val = wire.elements_begin();
+
+  if (val == wire.elements_end()) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required LsaInfo field"));
+  }
+  wireDecodeLsaInfo(*val++);
+
+  if (val != wire.elements_end() && val->type() == ndn::tlv::nlsr::HyperbolicRadius) {
+    m_corRad = ndn::encoding::readDouble(*val);
+    ++val;
+  }
+  else {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required HyperbolicRadius field"));
+  }
+
+  m_angles.clear();
+  for (; val != wire.elements_end(); ++val) {
+    if (val->type() == ndn::tlv::nlsr::HyperbolicAngle) {
+      m_angles.push_back(ndn::encoding::readDouble(*val));
+    }
+  }
+}
+
 void
 CoordinateLsa::writeLog() const
 {
@@ -265,6 +675,91 @@ AdjLsa::deserialize(const std::string& content) noexcept
   return true;
 }
 
+template<ndn::encoding::Tag TAG>
+size_t
+AdjLsa::wireEncode(ndn::EncodingImpl<TAG>& block) const
+{
+  size_t totalLength = 0;
+
+  const std::list<Adjacent>& adjacents = m_adl.getAdjList();
+  for (auto adjacent = adjacents.rbegin(); adjacent != adjacents.rend(); ++adjacent) {
+    size_t adjacencyLength = 0;
+    adjacencyLength += ndn::encoding::prependDoubleBlock(block, ndn::tlv::nlsr::CostDouble,
+                                                         adjacent->getLinkCost());
+    std::string uri = adjacent->getFaceUri().toString();
+    adjacencyLength += block.prependByteArrayBlock(ndn::tlv::nlsr::Uri,
+                                                   reinterpret_cast<const uint8_t*>(uri.data()),
+                                                   uri.size());
+    adjacencyLength += adjacent->getName().wireEncode(block);
+    adjacencyLength += block.prependVarNumber(adjacencyLength);
+    adjacencyLength += block.prependVarNumber(ndn::tlv::nlsr::Adjacency);
+    totalLength += adjacencyLength;
+  }
+
+  totalLength += wireEncodeLsaInfo(block);
+
+  totalLength += block.prependVarNumber(totalLength);
+  totalLength += block.prependVarNumber(ndn::tlv::nlsr::AdjacencyLsa);
+
+  return totalLength;
+}
+
+NDN_CXX_DEFINE_WIRE_ENCODE_INSTANTIATIONS(AdjLsa);
+
+ndn::Block
+AdjLsa::wireEncode() const
+{
+  return encodeLsa(*this);
+}
+
+void
+AdjLsa::wireDecode(const ndn::Block& wire)
+{
+  if (wire.type() != ndn::tlv::nlsr::AdjacencyLsa) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Expected AdjacencyLsa Block, but Block is of type #" +
+                                          std::to_string(wire.type())));
+  }
+
+  wire.parse();
+  ndn::Block::element_const_iterator val = wire.elements_begin();
+
+  if (val == wire.elements_end()) {
+    BOOST_THROW_EXCEPTION(ndn::tlv::Error("Missing required LsaInfo field"));
+  }
+  wireDecodeLsaInfo(*val++);
+
+  m_adl.reset();
+  for (; val != wire.elements_end(); ++val) {
+    if (val->type() != ndn::tlv::nlsr::Adjacency) {
+      continue;
+    }
+
+    val->parse();
+    if (val->elements_size() != 3 ||
+        val->elements()[0].type() != ndn::tlv::Name ||
+        val->elements()[1].type() != ndn::tlv::nlsr::Uri ||
+        val->elements()[2].type() != ndn::tlv::nlsr::CostDouble) {
+      BOOST_THROW_EXCEPTION(ndn::tlv::Error("Adjacency: Expected Name, Uri and CostDouble fields"));
+    }
+
+    ndn::FaceUri faceUri;
+    if (!faceUri.parse(ndn::encoding::readString(val->elements()[1]))) {
+      BOOST_THROW_EXCEPTION(ndn::tlv::Error("Adjacency: Malformed Uri field"));
+    }
+
+    double linkCost = ndn::encoding::readDouble(val->elements()[2]);
+    if (linkCost < 0 && linkCost != Adjacent::NON_ADJACENT_COST) {
+      NLSR_LOG_ERROR("Ignoring neighbor with negative link-cost: " <<
+                     ndn::Name(val->elements()[0]));
+      continue;
+    }
+
+    addAdjacent(Adjacent(ndn::Name(val->elements()[0]), faceUri, linkCost,
+                         Adjacent::STATUS_INACTIVE, 0, 0));
+  }
+  m_noLink = m_adl.size();
+}
+
 void
 AdjLsa::writeLog() const
 {
@@ -308,10 +803,12 @@ std::ostream&
 operator<<(std::ostream& os, const NameLsa& lsa)
 {
   os << lsa.toString();
+  if (lsa.m_shard != 0) {
+    os << "--Shard: " << lsa.m_shard << "\n";
+  }
   os << "--Names:\n";
   int i = 0;
-  auto names = lsa.m_npl.getNames();
-  for (const auto& name : names) {
+  for (const auto& name : lsa.m_npl) {
     os << "---Name " << i++ << ": " << name << "\n";
   }
   os << "name_lsa_end";
@@ -319,6 +816,22 @@ operator<<(std::ostream& os, const NameLsa& lsa)
   return os;
 }
 
+std::ostream&
+operator<<(std::ostream& os, const NameLsaDelta& delta)
+{
+  os << delta.toString();
+  os << "--Base Sequence Number: " << delta.getBaseSeqNo() << "\n";
+  for (const auto& name : delta.getAddedNames()) {
+    os << "---Added: " << name << "\n";
+  }
+  for (const auto& name : delta.getRemovedNames()) {
+    os << "---Removed: " << name << "\n";
+  }
+  os << "name_lsa_delta_end";
+
+  return os;
+}
+
 std::ostream&
 operator<<(std::ostream& os, const Lsa::Type& type)
 {
@@ -326,11 +839,36 @@ operator<<(std::ostream& os, const Lsa::Type& type)
   return os;
 }
 
+/*! \brief Reads the shard from the type component of a name LSA shard, as in NAME-3.
+ */
+static bool
+parseNameLsaShard(const std::string& typeString, uint32_t& shard)
+{
+  static const std::string prefix = std::to_string(Lsa::Type::NAME) + "-";
+  if (!boost::starts_with(typeString, prefix) || typeString.size() == prefix.size() ||
+      typeString.find_first_not_of("0123456789", prefix.size()) != std::string::npos) {
+    return false;
+  }
+
+  try {
+    shard = boost::lexical_cast<uint32_t>(typeString.substr(prefix.size()));
+    return true;
+  }
+  catch (const boost::bad_lexical_cast&) {
+    return false;
+  }
+}
+
 std::istream&
 operator>>(std::istream& is, Lsa::Type& type)
 {
   std::string typeString;
   is >> typeString;
+  uint32_t shard = 0;
+  if (parseNameLsaShard(typeString, shard)) {
+    typeString = std::to_string(Lsa::Type::NAME);
+  }
+
   if (typeString == "ADJACENCY") {
     type = Lsa::Type::ADJACENCY;
   }
@@ -346,6 +884,23 @@ operator>>(std::istream& is, Lsa::Type& type)
   return is;
 }
 
+std::string
+makeLsaTypeComponent(Lsa::Type type, uint32_t shard)
+{
+  if (type != Lsa::Type::NAME || shard == 0) {
+    return std::to_string(type);
+  }
+  return std::to_string(type) + "-" + std::to_string(shard);
+}
+
+uint32_t
+getLsaShard(const ndn::Name::Component& typeComponent)
+{
+  uint32_t shard = 0;
+  parseNameLsaShard(typeComponent.toUri(), shard);
+  return shard;
+}
+
 std::string
 Lsa::toString() const
 {
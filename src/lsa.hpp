@@ -22,14 +22,26 @@
 #ifndef NLSR_LSA_HPP
 #define NLSR_LSA_HPP
 
+#include "name-pool.hpp"
 #include "name-prefix-list.hpp"
 #include "adjacent.hpp"
 #include "adjacency-list.hpp"
+#include "timer-wheel.hpp"
 
-#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
 #include <ndn-cxx/util/time.hpp>
 #include <boost/tokenizer.hpp>
 
+#include <set>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/tag.hpp>
+
 namespace nlsr {
 
 class Lsa
@@ -70,6 +82,15 @@ public:
     return m_origRouter;
   }
 
+  /*! \brief Returns the originating router as a handle to the name pool, which the LSDB
+    indexes hash and compare without looking at the name components.
+   */
+  const InternedName&
+  getInternedOrigRouter() const
+  {
+    return m_origRouter;
+  }
+
   void
   setOrigRouter(const ndn::Name& org)
   {
@@ -89,17 +110,32 @@ public:
   }
 
   void
-  setExpiringEventId(ndn::scheduler::EventId eid)
+  setExpiringEventId(TimerWheel::EventId eid)
   {
     m_expiringEventId = std::move(eid);
   }
 
-  ndn::scheduler::EventId
+  TimerWheel::EventId
   getExpiringEventId() const
   {
     return m_expiringEventId;
   }
 
+  /*! \brief Returns whether the LSA was preloaded from the LSDB snapshot, and has been
+    neither received again nor confirmed by sync since.
+   */
+  bool
+  isProvisional() const
+  {
+    return m_isProvisional;
+  }
+
+  void
+  setProvisional(bool isProvisional)
+  {
+    m_isProvisional = isProvisional;
+  }
+
   /*! \brief Return the data that this LSA represents.
    */
   virtual std::string
@@ -108,8 +144,9 @@ public:
   /*! \brief Gets the key for this LSA.
 
     Format is: \<router name\>/\<LSA type>\
+    \sa makeLsaTypeComponent
    */
-  const ndn::Name
+  virtual const ndn::Name
   getKey() const;
 
   /*! \brief Populate this LSA with content from the string "content".
@@ -140,11 +177,29 @@ protected:
   bool
   deserializeCommon(boost::tokenizer<boost::char_separator<char>>::iterator& iterator);
 
+  /*! \brief Encodes the fields common to all LSA types as an LsaInfo block.
+
+    LsaInfo := LSA-INFO-TYPE TLV-LENGTH OriginRouter SequenceNumber ExpirationTime
+
+    ExpirationTime is in milliseconds since the Unix epoch. This method should be called
+    by all LSA classes in their wireEncode() method.
+   */
+  template<ndn::encoding::Tag TAG>
+  size_t
+  wireEncodeLsaInfo(ndn::EncodingImpl<TAG>& block) const;
+
+  /*! \brief Decodes the fields common to all LSA types from an LsaInfo block.
+    \throw ndn::tlv::Error The block is not a valid LsaInfo.
+   */
+  void
+  wireDecodeLsaInfo(const ndn::Block& wire);
+
 protected:
-  ndn::Name m_origRouter;
+  InternedName m_origRouter;
   uint32_t m_lsSeqNo = 0;
   ndn::time::system_clock::TimePoint m_expirationTimePoint;
-  ndn::scheduler::EventId m_expiringEventId;
+  TimerWheel::EventId m_expiringEventId;
+  bool m_isProvisional = false;
 };
 
 class NameLsa : public Lsa
@@ -162,6 +217,30 @@ public:
     return Lsa::Type::NAME;
   }
 
+  const ndn::Name
+  getKey() const override;
+
+  /*! \brief Returns which of the shards of its router's names this LSA holds. A router
+    that does not split its names publishes shard 0 alone.
+   */
+  uint32_t
+  getShard() const
+  {
+    return m_shard;
+  }
+
+  void
+  setShard(uint32_t shard)
+  {
+    m_shard = shard;
+  }
+
+  /*! \brief Returns the shard that holds an advertised name.
+    \param nShards The number of shards the names are split across.
+   */
+  static uint32_t
+  getShardOf(const ndn::Name& name, uint32_t nShards);
+
   NamePrefixList&
   getNpl()
   {
@@ -212,13 +291,153 @@ public:
   std::string
   serialize() const override;
 
+  /*! \brief Encodes this name LSA in TLV.
+
+    NameLsa := NAME-LSA-TYPE TLV-LENGTH LsaInfo ShardNumber? Name*
+
+    ShardNumber is left out for shard 0, so that an LSA that is not sharded is encoded as
+    before.
+   */
+  template<ndn::encoding::Tag TAG>
+  size_t
+  wireEncode(ndn::EncodingImpl<TAG>& block) const;
+
+  ndn::Block
+  wireEncode() const;
+
+  /*! \brief Initializes this name LSA from its TLV encoding.
+
+    The names share the memory of the block instead of being copied out of it.
+    \throw ndn::tlv::Error The block is not a valid name LSA.
+   */
+  void
+  wireDecode(const ndn::Block& wire);
+
 private:
   NamePrefixList m_npl;
+  uint32_t m_shard = 0;
 
   friend std::ostream&
   operator<<(std::ostream& os, const NameLsa& lsa);
 };
 
+/*! \brief The changes that lead from one name LSA of a router to a later one.
+
+  A delta carries the LsaInfo of the name LSA it leads to, so that a router that holds the
+  name LSA of the base sequence number can bring it up to date by adding and removing a few
+  names, instead of fetching every name again.
+
+  Deltas are only exchanged in TLV. Their text form is only meant for logs, and cannot be
+  deserialized.
+ */
+class NameLsaDelta : public Lsa
+{
+public:
+  NameLsaDelta() = default;
+
+  NameLsaDelta(const ndn::Name& origR, uint32_t lsn,
+               const ndn::time::system_clock::TimePoint& lt, uint32_t baseSeqNo);
+
+  Lsa::Type
+  getType() const override
+  {
+    return Lsa::Type::NAME;
+  }
+
+  const ndn::Name
+  getKey() const override;
+
+  /*! \brief Returns the shard of the name LSA that the delta applies to.
+   */
+  uint32_t
+  getShard() const
+  {
+    return m_shard;
+  }
+
+  void
+  setShard(uint32_t shard)
+  {
+    m_shard = shard;
+  }
+
+  uint32_t
+  getBaseSeqNo() const
+  {
+    return m_baseSeqNo;
+  }
+
+  const std::set<ndn::Name>&
+  getAddedNames() const
+  {
+    return m_addedNames;
+  }
+
+  const std::set<ndn::Name>&
+  getRemovedNames() const
+  {
+    return m_removedNames;
+  }
+
+  /*! \brief Records that a name is advertised. Adding a name that the delta removes
+    cancels its removal.
+   */
+  void
+  addName(const ndn::Name& name);
+
+  /*! \brief Records that a name is withdrawn. Removing a name that the delta adds cancels
+    its addition.
+   */
+  void
+  removeName(const ndn::Name& name);
+
+  /*! \brief Extends the delta with the changes of the next one.
+    \param next A delta whose base sequence number is the sequence number of this one.
+
+    The delta then leads from its base to the name LSA that next leads to.
+   */
+  void
+  append(const NameLsaDelta& next);
+
+  bool
+  deserialize(const std::string& content) noexcept override;
+
+  void
+  writeLog() const override;
+
+  std::string
+  serialize() const override;
+
+  /*! \brief Encodes this delta in TLV.
+
+    NameLsaDelta := NAME-LSA-DELTA-TYPE TLV-LENGTH
+                      LsaInfo ShardNumber? BaseSeqNumber AddedNames RemovedNames
+    AddedNames := ADDED-NAMES-TYPE TLV-LENGTH Name*
+    RemovedNames := REMOVED-NAMES-TYPE TLV-LENGTH Name*
+   */
+  template<ndn::encoding::Tag TAG>
+  size_t
+  wireEncode(ndn::EncodingImpl<TAG>& block) const;
+
+  ndn::Block
+  wireEncode() const;
+
+  /*! \brief Initializes this delta from its TLV encoding.
+    \throw ndn::tlv::Error The block is not a valid name LSA delta.
+   */
+  void
+  wireDecode(const ndn::Block& wire);
+
+private:
+  uint32_t m_shard = 0;
+  uint32_t m_baseSeqNo = 0;
+  std::set<ndn::Name> m_addedNames;
+  std::set<ndn::Name> m_removedNames;
+
+  friend std::ostream&
+  operator<<(std::ostream& os, const NameLsaDelta& delta);
+};
+
 class AdjLsa : public Lsa
 {
 public:
@@ -296,6 +515,26 @@ public:
   std::string
   serialize() const override;
 
+  /*! \brief Encodes this adjacency LSA in TLV.
+
+    AdjacencyLsa := ADJACENCY-LSA-TYPE TLV-LENGTH LsaInfo Adjacency*
+    Adjacency := ADJACENCY-TYPE TLV-LENGTH Name Uri CostDouble
+   */
+  template<ndn::encoding::Tag TAG>
+  size_t
+  wireEncode(ndn::EncodingImpl<TAG>& block) const;
+
+  ndn::Block
+  wireEncode() const;
+
+  /*! \brief Initializes this adjacency LSA from its TLV encoding.
+
+    Neighbors advertised with a negative cost are left out.
+    \throw ndn::tlv::Error The block is not a valid adjacency LSA.
+   */
+  void
+  wireDecode(const ndn::Block& wire);
+
 private:
   uint32_t m_noLink;
   AdjacencyList m_adl;
@@ -368,6 +607,23 @@ public:
   std::string
   serialize() const override;
 
+  /*! \brief Encodes this coordinate LSA in TLV.
+
+    CoordinateLsa := COORDINATE-LSA-TYPE TLV-LENGTH LsaInfo HyperbolicRadius HyperbolicAngle*
+   */
+  template<ndn::encoding::Tag TAG>
+  size_t
+  wireEncode(ndn::EncodingImpl<TAG>& block) const;
+
+  ndn::Block
+  wireEncode() const;
+
+  /*! \brief Initializes this coordinate LSA from its TLV encoding.
+    \throw ndn::tlv::Error The block is not a valid coordinate LSA.
+   */
+  void
+  wireDecode(const ndn::Block& wire);
+
 private:
   double m_corRad = 0.0;
   std::vector<double> m_angles;
@@ -385,12 +641,85 @@ operator<<(std::ostream& os, const CoordinateLsa& lsa);
 std::ostream&
 operator<<(std::ostream& os, const NameLsa& lsa);
 
+std::ostream&
+operator<<(std::ostream& os, const NameLsaDelta& delta);
+
 std::ostream&
 operator<<(std::ostream& os, const Lsa::Type& type);
 
+/*! \brief Reads the type of an LSA from the component that stands for it in LSA names.
+
+  The component of a name LSA shard is read as NAME, whatever its shard.
+ */
 std::istream&
 operator>>(std::istream& is, Lsa::Type& type);
 
+/*! \brief Returns the name component that stands for the type of an LSA in the names of its
+  sync updates and Interests, and in its key.
+
+  Shard 0 of a name LSA is NAME, like a name LSA that is not sharded, and the other shards
+  are told apart by a suffix, as in NAME-3. Routers that do not know about shards thus take
+  them for an LSA of an unknown type, and ignore them.
+ */
+std::string
+makeLsaTypeComponent(Lsa::Type type, uint32_t shard = 0);
+
+/*! \brief Returns the shard of a name LSA from the component that stands for its type, or 0
+  if the component names no shard.
+ */
+uint32_t
+getLsaShard(const ndn::Name::Component& typeComponent);
+
+namespace detail {
+
+  using namespace boost::multi_index;
+  // An LSDB holds LSAs of one type, so the originating router identifies an LSA.
+  // LSAs are iterated in the order of their originating routers, and looked up by hash.
+  // The hashed index is keyed on the interned router name, whose hash is computed once;
+  // a plain name can still be looked up in it.
+  struct byOriginRouter {};
+  template<typename LsaType>
+  using LsaContainer = multi_index_container<
+    LsaType,
+    indexed_by<
+      ordered_unique<const_mem_fun<Lsa, const ndn::Name&, &Lsa::getOrigRouter>>,
+      hashed_unique<tag<byOriginRouter>,
+                    const_mem_fun<Lsa, const InternedName&, &Lsa::getInternedOrigRouter>,
+                    InternedNameHash,
+                    std::equal_to<>>
+      >
+    >;
+
+  // A router may split its names across several name LSAs, so a name LSA is identified by
+  // its originating router and its shard. The shards of a router are iterated together.
+  struct byKey {};
+  using NameLsaKey = composite_key<
+    NameLsa,
+    const_mem_fun<Lsa, const ndn::Name&, &Lsa::getOrigRouter>,
+    const_mem_fun<NameLsa, uint32_t, &NameLsa::getShard>
+    >;
+  using InternedNameLsaKey = composite_key<
+    NameLsa,
+    const_mem_fun<Lsa, const InternedName&, &Lsa::getInternedOrigRouter>,
+    const_mem_fun<NameLsa, uint32_t, &NameLsa::getShard>
+    >;
+  using NameLsaContainer = multi_index_container<
+    NameLsa,
+    indexed_by<
+      ordered_unique<NameLsaKey>,
+      hashed_unique<tag<byKey>,
+                    InternedNameLsaKey,
+                    composite_key_hash<InternedNameHash, std::hash<uint32_t>>,
+                    composite_key_equal_to<std::equal_to<>, std::equal_to<uint32_t>>>
+      >
+    >;
+
+} // namespace detail
+
+using NameLsaContainer = detail::NameLsaContainer;
+using AdjLsaContainer = detail::LsaContainer<AdjLsa>;
+using CoordinateLsaContainer = detail::LsaContainer<CoordinateLsa>;
+
 } // namespace nlsr
 
 namespace std {
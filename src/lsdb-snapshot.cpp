@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#include "lsdb-snapshot.hpp"
+#include "logger.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <pwd.h>
+#include <unistd.h>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace nlsr {
+
+INIT_LOGGER(LsdbSnapshot);
+
+const char LsdbSnapshot::MAGIC[8] = {'N', 'L', 'S', 'R', 'L', 'S', 'D', 'B'};
+const uint32_t LsdbSnapshot::VERSION = 1;
+
+namespace {
+
+struct SnapshotHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t nRecords;
+  uint64_t payloadSize;
+  uint32_t checksum;
+  uint32_t reserved;
+  uint64_t writtenAt;
+};
+
+static_assert(sizeof(SnapshotHeader) == 40, "The snapshot header must not be padded");
+
+struct RecordHeader
+{
+  uint32_t lsaType;
+  uint32_t wireSize;
+};
+
+const size_t RECORD_ALIGNMENT = 8;
+
+size_t
+getPaddingSize(size_t size)
+{
+  return (RECORD_ALIGNMENT - size % RECORD_ALIGNMENT) % RECORD_ALIGNMENT;
+}
+
+uint32_t
+computeChecksum(const char* data, size_t size)
+{
+  boost::crc_32_type crc;
+  crc.process_bytes(data, size);
+  return crc.checksum();
+}
+
+template<typename LsaContainer>
+void
+appendRecords(std::string& payload, uint32_t& nRecords,
+              const LsaContainer& lsas, const ndn::Name& thisRouter)
+{
+  for (const auto& lsa : lsas) {
+    if (lsa.getOrigRouter() == thisRouter) {
+      continue;
+    }
+
+    ndn::Block wire = lsa.wireEncode();
+    RecordHeader record{static_cast<uint32_t>(lsa.getType()), static_cast<uint32_t>(wire.size())};
+    payload.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    payload.append(reinterpret_cast<const char*>(wire.wire()), wire.size());
+    payload.append(getPaddingSize(payload.size()), '\0');
+    ++nRecords;
+  }
+}
+
+template<typename LsaType>
+void
+decodeRecord(std::vector<LsaType>& lsas, const ndn::Block& wire)
+{
+  lsas.emplace_back();
+  lsas.back().wireDecode(wire);
+}
+
+} // anonymous namespace
+
+LsdbSnapshot::LsdbSnapshot(const std::string& stateDir)
+  : m_fileName(stateDir)
+{
+  if (m_fileName.empty()) {
+    std::string homeDirPath(getpwuid(getuid())->pw_dir);
+    if (homeDirPath.empty()) {
+      homeDirPath = getenv("HOME");
+    }
+    m_fileName = homeDirPath;
+  }
+  m_fileName = m_fileName + "/nlsrLsdb.snapshot";
+}
+
+size_t
+LsdbSnapshot::write(const NameLsaContainer& nameLsas, const AdjLsaContainer& adjLsas,
+                    const CoordinateLsaContainer& coordinateLsas,
+                    const ndn::Name& thisRouter) const
+{
+  std::string payload;
+  uint32_t nRecords = 0;
+  appendRecords(payload, nRecords, nameLsas, thisRouter);
+  // This router's Adj LSA is kept, as it is only built again once the neighbors answer hellos
+  appendRecords(payload, nRecords, adjLsas, ndn::Name());
+  appendRecords(payload, nRecords, coordinateLsas, thisRouter);
+
+  SnapshotHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+  header.version = VERSION;
+  header.nRecords = nRecords;
+  header.payloadSize = payload.size();
+  header.checksum = computeChecksum(payload.data(), payload.size());
+  header.reserved = 0;
+  header.writtenAt = ndn::time::toUnixTimestamp(ndn::time::system_clock::now()).count();
+
+  std::string tempFileName = m_fileName + ".tmp";
+  std::ofstream file(tempFileName, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(payload.data(), payload.size());
+  file.close();
+
+  boost::system::error_code error;
+  if (!file) {
+    boost::filesystem::remove(tempFileName, error);
+    BOOST_THROW_EXCEPTION(Error("Cannot write " + tempFileName));
+  }
+
+  boost::filesystem::rename(tempFileName, m_fileName, error);
+  if (error) {
+    boost::system::error_code removeError;
+    boost::filesystem::remove(tempFileName, removeError);
+    BOOST_THROW_EXCEPTION(Error("Cannot replace " + m_fileName + ": " + error.message()));
+  }
+
+  NLSR_LOG_DEBUG("Wrote " << nRecords << " LSAs (" << payload.size() << " octets) to "
+                 << m_fileName);
+  return nRecords;
+}
+
+LsdbSnapshot::Contents
+LsdbSnapshot::read() const
+{
+  boost::iostreams::mapped_file_source file;
+  try {
+    file.open(m_fileName);
+  }
+  catch (const std::exception& e) {
+    BOOST_THROW_EXCEPTION(Error("Cannot map " + m_fileName + ": " + e.what()));
+  }
+
+  const char* data = file.data();
+  size_t size = file.size();
+
+  // The header and the records are copied out rather than cast, as nothing guarantees
+  // the alignment of the mapping on every platform
+  SnapshotHeader header;
+  if (size < sizeof(header)) {
+    BOOST_THROW_EXCEPTION(Error(m_fileName + " is too short to be an LSDB snapshot"));
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+    BOOST_THROW_EXCEPTION(Error(m_fileName + " is not an LSDB snapshot"));
+  }
+  if (header.version != VERSION) {
+    BOOST_THROW_EXCEPTION(Error(m_fileName + " is not an LSDB snapshot of version " +
+                                std::to_string(VERSION)));
+  }
+  if (header.payloadSize != size - sizeof(header)) {
+    BOOST_THROW_EXCEPTION(Error(m_fileName + " is truncated"));
+  }
+  if (header.checksum != computeChecksum(data + sizeof(header), header.payloadSize)) {
+    BOOST_THROW_EXCEPTION(Error(m_fileName + " is damaged: wrong checksum"));
+  }
+
+  Contents contents;
+  contents.writtenAt = ndn::time::fromUnixTimestamp(ndn::time::milliseconds(header.writtenAt));
+
+  size_t offset = sizeof(header);
+  for (uint32_t i = 0; i < header.nRecords; ++i) {
+    RecordHeader record;
+    if (offset > size || size - offset < sizeof(record)) {
+      BOOST_THROW_EXCEPTION(Error(m_fileName + " is damaged: record " + std::to_string(i) +
+                                  " is truncated"));
+    }
+    std::memcpy(&record, data + offset, sizeof(record));
+    offset += sizeof(record);
+
+    if (size - offset < record.wireSize) {
+      BOOST_THROW_EXCEPTION(Error(m_fileName + " is damaged: record " + std::to_string(i) +
+                                  " is truncated"));
+    }
+
+    try {
+      ndn::Block wire(reinterpret_cast<const uint8_t*>(data + offset), record.wireSize);
+      switch (static_cast<Lsa::Type>(record.lsaType)) {
+      case Lsa::Type::NAME:
+        decodeRecord(contents.nameLsas, wire);
+        break;
+      case Lsa::Type::ADJACENCY:
+        decodeRecord(contents.adjLsas, wire);
+        break;
+      case Lsa::Type::COORDINATE:
+        decodeRecord(contents.coordinateLsas, wire);
+        break;
+      default:
+        BOOST_THROW_EXCEPTION(Error(m_fileName + " is damaged: record " + std::to_string(i) +
+                                    " has an unknown LSA type"));
+      }
+    }
+    catch (const ndn::tlv::Error& e) {
+      BOOST_THROW_EXCEPTION(Error(m_fileName + " is damaged: record " + std::to_string(i) +
+                                  " cannot be decoded: " + e.what()));
+    }
+
+    offset += record.wireSize + getPaddingSize(record.wireSize);
+  }
+
+  return contents;
+}
+
+} // namespace nlsr
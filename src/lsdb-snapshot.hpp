@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_LSDB_SNAPSHOT_HPP
+#define NLSR_LSDB_SNAPSHOT_HPP
+
+#include "lsa.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace nlsr {
+
+/*! \brief A checksummed copy of the LSDB in the state directory, to restart from.
+
+  The snapshot is a binary file, nlsrLsdb.snapshot, next to the sequence number file. It is
+  laid out so that it can be mapped into memory and walked without parsing:
+
+      Header   := magic(8) version(4) nRecords(4) payloadSize(8) checksum(4) reserved(4)
+                  writtenAt(8)
+      Record   := lsaType(4) wireSize(4) wire(wireSize) padding
+      Snapshot := Header Record*
+
+  The integers are in the byte order of the router that wrote the file; a file of another
+  byte order fails the version check. The checksum is the CRC-32 of all the records, and
+  writtenAt is in milliseconds since the Unix epoch. Each record holds the TLV encoding of an
+  LSA, and is padded to a multiple of 8 octets so that every record is aligned.
+ */
+class LsdbSnapshot
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  struct Contents
+  {
+    std::vector<NameLsa> nameLsas;
+    std::vector<AdjLsa> adjLsas;
+    std::vector<CoordinateLsa> coordinateLsas;
+    ndn::time::system_clock::TimePoint writtenAt;
+  };
+
+  /*! \param stateDir The directory the snapshot is kept in. As for the sequence number
+             file, the home directory is used when it is empty.
+   */
+  explicit
+  LsdbSnapshot(const std::string& stateDir);
+
+  const std::string&
+  getFileName() const
+  {
+    return m_fileName;
+  }
+
+  /*! \brief Writes the LSAs to the snapshot, replacing it.
+    \param thisRouter The name of this router, whose name and coordinate LSAs are left out
+           as they are built again at start. Its Adj LSA is written.
+    \return The number of LSAs written.
+    \throw Error The snapshot could not be written.
+
+    The LSAs are first written to a temporary file, which then takes the place of the
+    snapshot, so that a router stopped while writing leaves the previous snapshot whole.
+   */
+  size_t
+  write(const NameLsaContainer& nameLsas, const AdjLsaContainer& adjLsas,
+        const CoordinateLsaContainer& coordinateLsas, const ndn::Name& thisRouter) const;
+
+  /*! \brief Reads the LSAs of the snapshot.
+    \throw Error There is no snapshot, or it is not one of this version, or it is damaged.
+   */
+  Contents
+  read() const;
+
+public:
+  static const char MAGIC[8];
+  static const uint32_t VERSION;
+
+private:
+  std::string m_fileName;
+};
+
+} // namespace nlsr
+
+#endif // NLSR_LSDB_SNAPSHOT_HPP
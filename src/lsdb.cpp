@@ -23,8 +23,11 @@
 
 #include "logger.hpp"
 #include "nlsr.hpp"
+#include "tlv/tlv-nlsr.hpp"
 #include "utility/name-helper.hpp"
 
+#include <boost/assert.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/security/signing-helpers.hpp>
 
 namespace nlsr {
@@ -32,6 +35,8 @@ namespace nlsr {
 INIT_LOGGER(Lsdb);
 
 const ndn::Name::Component Lsdb::NAME_COMPONENT = ndn::Name::Component("lsdb");
+const ndn::Name::Component Lsdb::DELTA_COMPONENT = ndn::Name::Component("delta");
+const size_t Lsdb::NAME_LSA_DELTA_HISTORY = 64;
 const ndn::time::seconds Lsdb::GRACE_PERIOD = ndn::time::seconds(10);
 const ndn::time::steady_clock::TimePoint Lsdb::DEFAULT_LSA_RETRIEVAL_DEADLINE =
   ndn::time::steady_clock::TimePoint::min();
@@ -41,19 +46,24 @@ Lsdb::Lsdb(ndn::Face& face, ndn::KeyChain& keyChain,
            NamePrefixTable& namePrefixTable, RoutingTable& routingTable)
   : m_face(face)
   , m_scheduler(face.getIoService())
+  , m_timerWheel(m_scheduler)
   , m_signingInfo(signingInfo)
   , m_confParam(confParam)
   , m_namePrefixTable(namePrefixTable)
   , m_routingTable(routingTable)
   , m_sync(m_face,
            [this] (const ndn::Name& routerName, const Lsa::Type& lsaType,
-                   const uint64_t& sequenceNumber) {
-             return isLsaNew(routerName, lsaType, sequenceNumber);
+                   const uint64_t& sequenceNumber, uint32_t shard) {
+             return isLsaNew(routerName, lsaType, sequenceNumber, shard);
            }, m_confParam)
   , m_lsaRefreshTime(ndn::time::seconds(m_confParam.getLsaRefreshTime()))
   , m_thisRouterPrefix(m_confParam.getRouterPrefix().toUri())
   , m_adjLsaBuildInterval(m_confParam.getAdjLsaBuildInterval())
+  , m_adjLsaBuildThrottle(ndn::time::milliseconds(m_confParam.getAdjLsaBuildInitialDelay()),
+                          ndn::time::milliseconds(m_confParam.getAdjLsaBuildHoldDelay()),
+                          m_adjLsaBuildInterval)
   , m_sequencingManager(m_confParam.getStateFileDir(), m_confParam.getHyperbolicState())
+  , m_snapshot(m_confParam.getStateFileDir())
   , m_onNewLsaConnection(m_sync.onNewLsa->connect(
       [this] (const ndn::Name& updateName, uint64_t sequenceNumber,
               const ndn::Name& originRouter) {
@@ -69,8 +79,8 @@ Lsdb::Lsdb(ndn::Face& face, ndn::KeyChain& keyChain,
 
 Lsdb::~Lsdb()
 {
-  for (const auto& sp : m_fetchers) {
-    sp->stop();
+  for (const auto& fetch : m_fetches) {
+    fetch.second.fetcher->stop();
   }
 }
 
@@ -130,47 +140,192 @@ Lsdb::afterFetchLsa(const ndn::ConstBufferPtr& bufferPtr, const ndn::Name& inter
   onContentValidated(data);
 }
 
-  /*! \brief Compares if a name LSA is the same as the one specified by key
+/*! \brief Returns the LSA of an LSDB that has some key, or nullptr if there is none.
 
-    \param nlsa1 A name LSA object
-    \param key A key of an originating router to compare to nlsa1
-   */
+  An LSDB holds LSAs of a single type, so it is indexed by the originating router alone,
+  which is the key without its last (type) component. The LSA is const, as the LSDB is
+  indexed by it; modifyLsa() changes it in place.
+ */
+template<typename LsaContainer>
+static const typename LsaContainer::value_type*
+findLsaByKey(const LsaContainer& lsdb, const ndn::Name& key)
+{
+  if (key.empty()) {
+    return nullptr;
+  }
+  const auto& index = lsdb.template get<detail::byOriginRouter>();
+  auto it = index.find(key.getPrefix(-1));
+  if (it == index.end() || it->getKey() != key) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+/*! \brief Returns the name LSA of an LSDB that has some key, or nullptr if there is none.
+
+  The last component of the key names both the type and the shard of the LSA.
+ */
+static const NameLsa*
+findLsaByKey(const NameLsaContainer& lsdb, const ndn::Name& key)
+{
+  if (key.empty()) {
+    return nullptr;
+  }
+  const auto& index = lsdb.get<detail::byKey>();
+  auto it = index.find(boost::make_tuple(key.getPrefix(-1), getLsaShard(key[-1])));
+  if (it == index.end() || it->getKey() != key) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+/*! \brief Changes an LSA of an LSDB in place.
+
+  The LSA is changed through the LSDB, which keeps its indexes consistent. The modifier must
+  not change the key of the LSA, which could collide with the key of another LSA.
+ */
+template<typename LsaContainer, typename Modifier>
+static void
+modifyLsa(LsaContainer& lsdb, const typename LsaContainer::value_type& lsa, Modifier modifier)
+{
+  BOOST_VERIFY(lsdb.modify(lsdb.iterator_to(lsa), modifier));
+}
+
+/*! \brief Confirms a provisional LSA when sync announces the sequence number it has, as the
+  LSA preloaded from the snapshot is then the current one.
+ */
+template<typename LsaContainer>
+static void
+confirmIfProvisional(LsaContainer& lsdb, const typename LsaContainer::value_type& lsa,
+                     uint64_t seqNo)
+{
+  if (lsa.isProvisional() && lsa.getLsSeqNo() == seqNo) {
+    NLSR_LOG_DEBUG("Provisional LSA " << lsa.getKey() << " confirmed by sync");
+    modifyLsa(lsdb, lsa, [] (Lsa& provisional) { provisional.setProvisional(false); });
+  }
+}
+
+/*! \brief Returns the changes that lead from one name LSA of a router to another. */
+static NameLsaDelta
+makeNameLsaDelta(const NameLsa& base, const NameLsa& next)
+{
+  NameLsaDelta delta(next.getOrigRouter(), next.getLsSeqNo(), next.getExpirationTimePoint(),
+                     base.getLsSeqNo());
+  delta.setShard(next.getShard());
+
+  for (const auto& name : next.getNpl()) {
+    if (base.getNpl().countSources(name) == 0) {
+      delta.addName(name);
+    }
+  }
+  for (const auto& name : base.getNpl()) {
+    if (next.getNpl().countSources(name) == 0) {
+      delta.removeName(name);
+    }
+  }
+
+  return delta;
+}
+
+/*! \brief Returns whether the content of a name LSA Data holds a delta, and not a whole LSA.
+ */
 static bool
-nameLsaCompareByKey(const NameLsa& nlsa1, const ndn::Name& key)
+isNameLsaDeltaContent(const ndn::Block& content)
 {
-  return nlsa1.getKey() == key;
+  if (content.value_size() == 0 || content.value()[0] == '/') {
+    return false;
+  }
+
+  try {
+    return content.blockFromValue().type() == ndn::tlv::nlsr::NameLsaDelta;
+  }
+  catch (const ndn::tlv::Error&) {
+    return false;
+  }
 }
 
 bool
 Lsdb::buildAndInstallOwnNameLsa()
 {
+  uint32_t nShards = m_confParam.getNameLsaShards();
+  if (nShards == 1) {
+    return buildAndInstallOwnNameLsaShard(0, m_confParam.getNamePrefixList());
+  }
+
+  std::vector<std::vector<ndn::Name>> shardNames(nShards);
+  for (const auto& name : m_confParam.getNamePrefixList()) {
+    shardNames[NameLsa::getShardOf(name, nShards)].push_back(name);
+  }
+
+  bool isInstalled = true;
+  for (uint32_t shard = 0; shard < nShards; ++shard) {
+    std::vector<ndn::Name>& names = shardNames[shard];
+    std::sort(names.begin(), names.end());
+
+    // A shard whose names have not changed is left as it is, so that other routers do not
+    // fetch it again
+    ndn::Name key = ndn::Name(m_confParam.getRouterPrefix())
+                      .append(makeLsaTypeComponent(Lsa::Type::NAME, shard));
+    const NameLsa* current = findNameLsa(key);
+    if (current != nullptr && current->getNpl().size() == names.size() &&
+        std::all_of(names.begin(), names.end(), [current] (const ndn::Name& name) {
+          return current->getNpl().countSources(name) > 0;
+        })) {
+      continue;
+    }
+
+    NamePrefixList npl(names);
+    isInstalled = buildAndInstallOwnNameLsaShard(shard, npl) && isInstalled;
+  }
+  return isInstalled;
+}
+
+bool
+Lsdb::buildAndInstallOwnNameLsaShard(uint32_t shard, NamePrefixList& names)
+{
+  // The shards share the sequence numbers of the name LSA, so that each of them has
+  // increasing sequence numbers of its own
   NameLsa nameLsa(m_confParam.getRouterPrefix(),
                   m_sequencingManager.getNameLsaSeq() + 1,
                   getLsaExpirationTimePoint(),
-                  m_confParam.getNamePrefixList());
+                  names);
+  nameLsa.setShard(shard);
   m_sequencingManager.increaseNameLsaSeq();
 
+  if (m_confParam.isNameLsaDeltaEnabled()) {
+    const NameLsa* current = findNameLsa(nameLsa.getKey());
+    if (current != nullptr) {
+      recordOwnNameLsaDelta(makeNameLsaDelta(*current, nameLsa));
+    }
+  }
+
   m_sequencingManager.writeSeqNoToFile();
-  m_sync.publishRoutingUpdate(Lsa::Type::NAME, m_sequencingManager.getNameLsaSeq());
+  m_sync.publishRoutingUpdate(Lsa::Type::NAME, m_sequencingManager.getNameLsaSeq(), shard);
 
   return installNameLsa(nameLsa);
 }
 
-NameLsa*
-Lsdb::findNameLsa(const ndn::Name& key)
+const NameLsa*
+Lsdb::findNameLsa(const ndn::Name& key) const
+{
+  return findLsaByKey(m_nameLsdb, key);
+}
+
+bool
+Lsdb::modifyNameLsa(const ndn::Name& key, const std::function<void(NameLsa&)>& modifier)
 {
-  auto it = std::find_if(m_nameLsdb.begin(), m_nameLsdb.end(),
-                         std::bind(nameLsaCompareByKey, _1, key));
-  if (it != m_nameLsdb.end()) {
-    return &*it;
+  const NameLsa* lsa = findLsaByKey(m_nameLsdb, key);
+  if (lsa == nullptr) {
+    return false;
   }
-  return nullptr;
+  modifyLsa(m_nameLsdb, *lsa, modifier);
+  return true;
 }
 
 bool
 Lsdb::isNameLsaNew(const ndn::Name& key, uint64_t seqNo)
 {
-  NameLsa* nameLsaCheck = findNameLsa(key);
+  const NameLsa* nameLsaCheck = findNameLsa(key);
   // Is the name in the LSDB
   if (nameLsaCheck != nullptr) {
     // And the supplied seq no is the highest so far
@@ -178,18 +333,19 @@ Lsdb::isNameLsaNew(const ndn::Name& key, uint64_t seqNo)
       return true;
     }
     else {
+      confirmIfProvisional(m_nameLsdb, *nameLsaCheck, seqNo);
       return false;
     }
   }
   return true;
 }
 
-ndn::scheduler::EventId
+TimerWheel::EventId
 Lsdb::scheduleNameLsaExpiration(const ndn::Name& key, int seqNo,
                                 const ndn::time::seconds& expTime)
 {
-  return m_scheduler.schedule(expTime + GRACE_PERIOD,
-                              std::bind(&Lsdb::expireOrRefreshNameLsa, this, key, seqNo));
+  return m_timerWheel.schedule(expTime + GRACE_PERIOD,
+                               std::bind(&Lsdb::expireOrRefreshNameLsa, this, key, seqNo));
 }
 
 bool
@@ -197,7 +353,7 @@ Lsdb::installNameLsa(NameLsa& nlsa)
 {
   NLSR_LOG_TRACE("installNameLsa");
   ndn::time::seconds timeToExpire = m_lsaRefreshTime;
-  NameLsa* chkNameLsa = findNameLsa(nlsa.getKey());
+  const NameLsa* chkNameLsa = findNameLsa(nlsa.getKey());
   // Determines if the name LSA is new or not.
   if (chkNameLsa == nullptr) {
     addNameLsa(nlsa);
@@ -213,7 +369,7 @@ Lsdb::installNameLsa(NameLsa& nlsa)
       // prefixes to the NPT.
       m_namePrefixTable.addEntry(nlsa.getOrigRouter(),
                                            nlsa.getOrigRouter());
-      for (const auto& name : nlsa.getNpl().getNames()) {
+      for (const auto& name : nlsa.getNpl()) {
         if (name != m_confParam.getRouterPrefix()) {
           m_namePrefixTable.addEntry(name, nlsa.getOrigRouter());
         }
@@ -234,65 +390,156 @@ Lsdb::installNameLsa(NameLsa& nlsa)
     if (chkNameLsa->getLsSeqNo() < nlsa.getLsSeqNo()) {
       NLSR_LOG_DEBUG("Updated Name LSA. Updating LSDB");
       NLSR_LOG_DEBUG("Deleting Name Lsa");
-      chkNameLsa->writeLog();
-      chkNameLsa->setLsSeqNo(nlsa.getLsSeqNo());
-      chkNameLsa->setExpirationTimePoint(nlsa.getExpirationTimePoint());
-      chkNameLsa->getNpl().sort();
-      nlsa.getNpl().sort();
-      // Obtain the set difference of the current and the incoming
-      // name prefix sets, and add those.
-      std::list<ndn::Name> newNames = nlsa.getNpl().getNames();
-      std::list<ndn::Name> oldNames = chkNameLsa->getNpl().getNames();
-      std::list<ndn::Name> namesToAdd;
-      std::set_difference(newNames.begin(), newNames.end(), oldNames.begin(), oldNames.end(),
-                          std::inserter(namesToAdd, namesToAdd.begin()));
-      for (const auto& name : namesToAdd) {
-        chkNameLsa->addName(name);
-        if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
-          if (name != m_confParam.getRouterPrefix()) {
-            m_namePrefixTable.addEntry(name, nlsa.getOrigRouter());
+      modifyLsa(m_nameLsdb, *chkNameLsa, [&] (NameLsa& lsa) {
+        lsa.writeLog();
+        lsa.setLsSeqNo(nlsa.getLsSeqNo());
+        lsa.setExpirationTimePoint(nlsa.getExpirationTimePoint());
+        lsa.setProvisional(false);
+        // Obtain the set difference of the current and the incoming
+        // name prefix sets, and add those.
+        std::vector<ndn::Name> namesToAdd;
+        for (const auto& name : nlsa.getNpl()) {
+          if (lsa.getNpl().countSources(name) == 0) {
+            namesToAdd.push_back(name);
+          }
+        }
+        std::vector<ndn::Name> namesToRemove;
+        for (const auto& name : lsa.getNpl()) {
+          if (nlsa.getNpl().countSources(name) == 0) {
+            namesToRemove.push_back(name);
           }
         }
-      }
 
-      chkNameLsa->getNpl().sort();
+        for (const auto& name : namesToAdd) {
+          lsa.addName(name);
+          if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+            if (name != m_confParam.getRouterPrefix()) {
+              m_namePrefixTable.addEntry(name, nlsa.getOrigRouter());
+            }
+          }
+        }
 
-      // Also remove any names that are no longer being advertised.
-      std::list<ndn::Name> namesToRemove;
-      std::set_difference(oldNames.begin(), oldNames.end(), newNames.begin(), newNames.end(),
-                          std::inserter(namesToRemove, namesToRemove.begin()));
-      for (const auto& name : namesToRemove) {
-        NLSR_LOG_DEBUG("Removing name LSA no longer advertised: " << name);
-        chkNameLsa->removeName(name);
-        if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
-          if (name != m_confParam.getRouterPrefix()) {
-            m_namePrefixTable.removeEntry(name, nlsa.getOrigRouter());
+        lsa.getNpl().sort();
+
+        // Also remove any names that are no longer being advertised.
+        for (const auto& name : namesToRemove) {
+          NLSR_LOG_DEBUG("Removing name LSA no longer advertised: " << name);
+          lsa.removeName(name);
+          if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+            if (name != m_confParam.getRouterPrefix() && !isNameInOtherShard(lsa, name)) {
+              m_namePrefixTable.removeEntry(name, nlsa.getOrigRouter());
+            }
           }
         }
-      }
 
-      if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
-        auto duration = nlsa.getExpirationTimePoint() - ndn::time::system_clock::now();
-        timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
-      }
-      chkNameLsa->getExpiringEventId().cancel();
-      chkNameLsa->setExpiringEventId(scheduleNameLsaExpiration(nlsa.getKey(),
-                                                               nlsa.getLsSeqNo(),
-                                                               timeToExpire));
-      NLSR_LOG_DEBUG("Adding Name Lsa");
-      chkNameLsa->writeLog();
+        if (nlsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+          auto duration = nlsa.getExpirationTimePoint() - ndn::time::system_clock::now();
+          timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
+        }
+        lsa.getExpiringEventId().cancel();
+        lsa.setExpiringEventId(scheduleNameLsaExpiration(nlsa.getKey(),
+                                                         nlsa.getLsSeqNo(),
+                                                         timeToExpire));
+        NLSR_LOG_DEBUG("Adding Name Lsa");
+        lsa.writeLog();
+      });
     }
   }
   return true;
 }
 
+bool
+Lsdb::installNameLsaDelta(const NameLsaDelta& delta)
+{
+  const NameLsa* nameLsa = findNameLsa(delta.getKey());
+  if (nameLsa == nullptr || nameLsa->getLsSeqNo() != delta.getBaseSeqNo()) {
+    NLSR_LOG_DEBUG("Name LSA " << delta.getKey() << " with seq no " << delta.getBaseSeqNo()
+                   << " is not in the LSDB, so its delta cannot be installed");
+    return false;
+  }
+
+  NLSR_LOG_DEBUG("Installing Name LSA delta");
+  delta.writeLog();
+
+  // Only the changed names are looked at, whatever the number of names advertised
+  bool isOwnLsa = delta.getOrigRouter() == m_confParam.getRouterPrefix();
+  modifyLsa(m_nameLsdb, *nameLsa, [&] (NameLsa& lsa) {
+    for (const auto& name : delta.getAddedNames()) {
+      if (lsa.getNpl().insert(name) && !isOwnLsa && name != m_confParam.getRouterPrefix()) {
+        m_namePrefixTable.addEntry(name, delta.getOrigRouter());
+      }
+    }
+    for (const auto& name : delta.getRemovedNames()) {
+      if (lsa.getNpl().remove(name) && !isOwnLsa && name != m_confParam.getRouterPrefix() &&
+          !isNameInOtherShard(lsa, name)) {
+        m_namePrefixTable.removeEntry(name, delta.getOrigRouter());
+      }
+    }
+
+    lsa.setLsSeqNo(delta.getLsSeqNo());
+    lsa.setExpirationTimePoint(delta.getExpirationTimePoint());
+    lsa.setProvisional(false);
+
+    ndn::time::seconds timeToExpire = m_lsaRefreshTime;
+    if (!isOwnLsa) {
+      auto duration = delta.getExpirationTimePoint() - ndn::time::system_clock::now();
+      timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
+    }
+    lsa.getExpiringEventId().cancel();
+    lsa.setExpiringEventId(scheduleNameLsaExpiration(lsa.getKey(),
+                                                     lsa.getLsSeqNo(),
+                                                     timeToExpire));
+  });
+  return true;
+}
+
+void
+Lsdb::recordOwnNameLsaDelta(NameLsaDelta delta)
+{
+  if (!m_confParam.isNameLsaDeltaEnabled()) {
+    return;
+  }
+
+  // Deltas are only composed from an unbroken chain of changes
+  auto& history = m_ownNameLsaDeltas[delta.getShard()];
+  if (!history.empty() && history.back().getLsSeqNo() != delta.getBaseSeqNo()) {
+    history.clear();
+  }
+
+  history.push_back(std::move(delta));
+  if (history.size() > NAME_LSA_DELTA_HISTORY) {
+    history.pop_front();
+  }
+}
+
+bool
+Lsdb::getOwnNameLsaDelta(uint32_t shard, uint64_t baseSeqNo, uint64_t seqNo,
+                         NameLsaDelta& delta) const
+{
+  auto history = m_ownNameLsaDeltas.find(shard);
+  if (history == m_ownNameLsaDeltas.end()) {
+    return false;
+  }
+
+  auto change = std::find_if(history->second.begin(), history->second.end(),
+                             [baseSeqNo] (const NameLsaDelta& change) {
+                               return change.getBaseSeqNo() == baseSeqNo;
+                             });
+  if (change == history->second.end()) {
+    return false;
+  }
+
+  delta = *change;
+  for (++change; change != history->second.end() && delta.getLsSeqNo() < seqNo; ++change) {
+    delta.append(*change);
+  }
+  return delta.getLsSeqNo() == seqNo;
+}
+
 bool
 Lsdb::addNameLsa(NameLsa& nlsa)
 {
-  auto it = std::find_if(m_nameLsdb.begin(), m_nameLsdb.end(),
-                         std::bind(nameLsaCompareByKey, _1, nlsa.getKey()));
-  if (it == m_nameLsdb.end()) {
-    m_nameLsdb.push_back(nlsa);
+  if (m_nameLsdb.insert(nlsa).second) {
     return true;
   }
   return false;
@@ -301,34 +548,43 @@ Lsdb::addNameLsa(NameLsa& nlsa)
 bool
 Lsdb::removeNameLsa(const ndn::Name& key)
 {
-  auto it = std::find_if(m_nameLsdb.begin(), m_nameLsdb.end(),
-                         std::bind(nameLsaCompareByKey, _1, key));
-  if (it != m_nameLsdb.end()) {
+  const NameLsa* lsa = findLsaByKey(m_nameLsdb, key);
+  if (lsa != nullptr) {
     NLSR_LOG_DEBUG("Deleting Name Lsa");
-    it->writeLog();
+    lsa->writeLog();
     // If the requested name LSA is not ours, we also need to remove
     // its entries from the NPT.
-    if (it->getOrigRouter() != m_confParam.getRouterPrefix()) {
-      m_namePrefixTable.removeEntry(it->getOrigRouter(), it->getOrigRouter());
+    if (lsa->getOrigRouter() != m_confParam.getRouterPrefix()) {
+      // The router prefix stays while another shard of the router is in the LSDB
+      if (m_nameLsdb.count(boost::make_tuple(lsa->getOrigRouter())) == 1) {
+        m_namePrefixTable.removeEntry(lsa->getOrigRouter(), lsa->getOrigRouter());
+      }
 
-      for (const auto& name : it->getNpl().getNames()) {
-        if (name != m_confParam.getRouterPrefix()) {
-          m_namePrefixTable.removeEntry(name, it->getOrigRouter());
+      for (const auto& name : lsa->getNpl()) {
+        if (name != m_confParam.getRouterPrefix() && !isNameInOtherShard(*lsa, name)) {
+          m_namePrefixTable.removeEntry(name, lsa->getOrigRouter());
         }
       }
     }
-    m_nameLsdb.erase(it);
+    m_nameLsdb.erase(m_nameLsdb.iterator_to(*lsa));
     return true;
   }
   return false;
 }
 
+bool
+Lsdb::isNameInOtherShard(const NameLsa& nameLsa, const ndn::Name& name) const
+{
+  auto shards = m_nameLsdb.equal_range(boost::make_tuple(nameLsa.getOrigRouter()));
+  return std::any_of(shards.first, shards.second, [&] (const NameLsa& shard) {
+    return shard.getShard() != nameLsa.getShard() && shard.getNpl().countSources(name) > 0;
+  });
+}
+
 bool
 Lsdb::doesNameLsaExist(const ndn::Name& key)
 {
-  auto it = std::find_if(m_nameLsdb.begin(), m_nameLsdb.end(),
-                         std::bind(nameLsaCompareByKey, _1, key));
-  return it != m_nameLsdb.end();
+  return findLsaByKey(m_nameLsdb, key) != nullptr;
 }
 
 void
@@ -340,7 +596,7 @@ Lsdb::writeNameLsdbLog()
   }
 }
 
-const std::list<NameLsa>&
+const NameLsaContainer&
 Lsdb::getNameLsdb() const
 {
   return m_nameLsdb;
@@ -348,16 +604,6 @@ Lsdb::getNameLsdb() const
 
 // Cor LSA and LSDB related Functions start here
 
-/*! \brief Compares whether an LSA object is the same as a key.
-  \param clsa The cor. LSA to check the identity of.
-  \param key The key of the publishing router to check against.
-*/
-static bool
-corLsaCompareByKey(const CoordinateLsa& clsa, const ndn::Name& key)
-{
-  return clsa.getKey() == key;
-}
-
 bool
 Lsdb::buildAndInstallOwnCoordinateLsa()
 {
@@ -379,21 +625,28 @@ Lsdb::buildAndInstallOwnCoordinateLsa()
   return true;
 }
 
-CoordinateLsa*
-Lsdb::findCoordinateLsa(const ndn::Name& key)
+const CoordinateLsa*
+Lsdb::findCoordinateLsa(const ndn::Name& key) const
+{
+  return findLsaByKey(m_corLsdb, key);
+}
+
+bool
+Lsdb::modifyCoordinateLsa(const ndn::Name& key,
+                          const std::function<void(CoordinateLsa&)>& modifier)
 {
-  auto it = std::find_if(m_corLsdb.begin(), m_corLsdb.end(),
-                         std::bind(corLsaCompareByKey, _1, key));
-  if (it != m_corLsdb.end()) {
-    return &*it;
+  const CoordinateLsa* lsa = findLsaByKey(m_corLsdb, key);
+  if (lsa == nullptr) {
+    return false;
   }
-  return nullptr;
+  modifyLsa(m_corLsdb, *lsa, modifier);
+  return true;
 }
 
 bool
 Lsdb::isCoordinateLsaNew(const ndn::Name& key, uint64_t seqNo)
 {
-  CoordinateLsa* clsa = findCoordinateLsa(key);
+  const CoordinateLsa* clsa = findCoordinateLsa(key);
   // Is the coordinate LSA in the LSDB already
   if (clsa != nullptr) {
     // And the seq no is newer (higher) than the current one
@@ -401,6 +654,7 @@ Lsdb::isCoordinateLsaNew(const ndn::Name& key, uint64_t seqNo)
       return true;
     }
     else {
+      confirmIfProvisional(m_corLsdb, *clsa, seqNo);
       return false;
     }
   }
@@ -411,19 +665,19 @@ Lsdb::isCoordinateLsaNew(const ndn::Name& key, uint64_t seqNo)
   // \param key The name of the router that published the LSA.
   // \param seqNo the seq. no. associated with the LSA to check.
   // \param expTime How long to wait before triggering the event.
-ndn::scheduler::EventId
+TimerWheel::EventId
 Lsdb::scheduleCoordinateLsaExpiration(const ndn::Name& key, int seqNo,
                                       const ndn::time::seconds& expTime)
 {
-  return m_scheduler.schedule(expTime + GRACE_PERIOD,
-                              std::bind(&Lsdb::expireOrRefreshCoordinateLsa, this, key, seqNo));
+  return m_timerWheel.schedule(expTime + GRACE_PERIOD,
+                               std::bind(&Lsdb::expireOrRefreshCoordinateLsa, this, key, seqNo));
 }
 
 bool
 Lsdb::installCoordinateLsa(CoordinateLsa& clsa)
 {
   ndn::time::seconds timeToExpire = m_lsaRefreshTime;
-  CoordinateLsa* chkCorLsa = findCoordinateLsa(clsa.getKey());
+  const CoordinateLsa* chkCorLsa = findCoordinateLsa(clsa.getKey());
   // Checking whether the LSA is new or not.
   if (chkCorLsa == nullptr) {
     NLSR_LOG_DEBUG("New Coordinate LSA. Adding to LSDB");
@@ -453,28 +707,31 @@ Lsdb::installCoordinateLsa(CoordinateLsa& clsa)
     if (chkCorLsa->getLsSeqNo() < clsa.getLsSeqNo()) {
       NLSR_LOG_DEBUG("Updated Coordinate LSA. Updating LSDB");
       NLSR_LOG_DEBUG("Deleting Coordinate Lsa");
-      chkCorLsa->writeLog();
-      chkCorLsa->setLsSeqNo(clsa.getLsSeqNo());
-      chkCorLsa->setExpirationTimePoint(clsa.getExpirationTimePoint());
-      // If the new LSA contains new routing information, update the LSDB with it.
-      if (!chkCorLsa->isEqualContent(clsa)) {
-        chkCorLsa->setCorRadius(clsa.getCorRadius());
-        chkCorLsa->setCorTheta(clsa.getCorTheta());
-        if (m_confParam.getHyperbolicState() >= HYPERBOLIC_STATE_ON) {
-          m_routingTable.scheduleRoutingTableCalculation();
+      modifyLsa(m_corLsdb, *chkCorLsa, [&] (CoordinateLsa& lsa) {
+        lsa.writeLog();
+        lsa.setLsSeqNo(clsa.getLsSeqNo());
+        lsa.setExpirationTimePoint(clsa.getExpirationTimePoint());
+        lsa.setProvisional(false);
+        // If the new LSA contains new routing information, update the LSDB with it.
+        if (!lsa.isEqualContent(clsa)) {
+          lsa.setCorRadius(clsa.getCorRadius());
+          lsa.setCorTheta(clsa.getCorTheta());
+          if (m_confParam.getHyperbolicState() >= HYPERBOLIC_STATE_ON) {
+            m_routingTable.scheduleRoutingTableCalculation();
+          }
         }
-      }
-      // If this is an LSA from another router, refresh its expiration time.
-      if (clsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
-        auto duration = clsa.getExpirationTimePoint() - ndn::time::system_clock::now();
-        timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
-      }
-      chkCorLsa->getExpiringEventId().cancel();
-      chkCorLsa->setExpiringEventId(scheduleCoordinateLsaExpiration(clsa.getKey(),
-                                                                    clsa.getLsSeqNo(),
-                                                                    timeToExpire));
-      NLSR_LOG_DEBUG("Adding Coordinate Lsa");
-      chkCorLsa->writeLog();
+        // If this is an LSA from another router, refresh its expiration time.
+        if (clsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+          auto duration = clsa.getExpirationTimePoint() - ndn::time::system_clock::now();
+          timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
+        }
+        lsa.getExpiringEventId().cancel();
+        lsa.setExpiringEventId(scheduleCoordinateLsaExpiration(clsa.getKey(),
+                                                               clsa.getLsSeqNo(),
+                                                               timeToExpire));
+        NLSR_LOG_DEBUG("Adding Coordinate Lsa");
+        lsa.writeLog();
+      });
     }
   }
   return true;
@@ -483,10 +740,7 @@ Lsdb::installCoordinateLsa(CoordinateLsa& clsa)
 bool
 Lsdb::addCoordinateLsa(CoordinateLsa& clsa)
 {
-  auto it = std::find_if(m_corLsdb.begin(), m_corLsdb.end(),
-                         std::bind(corLsaCompareByKey, _1, clsa.getKey()));
-  if (it == m_corLsdb.end()) {
-    m_corLsdb.push_back(clsa);
+  if (m_corLsdb.insert(clsa).second) {
     return true;
   }
   return false;
@@ -495,18 +749,16 @@ Lsdb::addCoordinateLsa(CoordinateLsa& clsa)
 bool
 Lsdb::removeCoordinateLsa(const ndn::Name& key)
 {
-  auto it = std::find_if(m_corLsdb.begin(), m_corLsdb.end(),
-                         std::bind(corLsaCompareByKey, _1, key));
-
-  if (it != m_corLsdb.end()) {
+  const CoordinateLsa* lsa = findLsaByKey(m_corLsdb, key);
+  if (lsa != nullptr) {
     NLSR_LOG_DEBUG("Deleting Coordinate Lsa");
-    it->writeLog();
+    lsa->writeLog();
 
-    if (it->getOrigRouter() != m_confParam.getRouterPrefix()) {
-      m_namePrefixTable.removeEntry(it->getOrigRouter(), it->getOrigRouter());
+    if (lsa->getOrigRouter() != m_confParam.getRouterPrefix()) {
+      m_namePrefixTable.removeEntry(lsa->getOrigRouter(), lsa->getOrigRouter());
     }
 
-    m_corLsdb.erase(it);
+    m_corLsdb.erase(m_corLsdb.iterator_to(*lsa));
     return true;
   }
   return false;
@@ -515,9 +767,7 @@ Lsdb::removeCoordinateLsa(const ndn::Name& key)
 bool
 Lsdb::doesCoordinateLsaExist(const ndn::Name& key)
 {
-  auto it = std::find_if(m_corLsdb.begin(), m_corLsdb.end(),
-                         std::bind(corLsaCompareByKey, _1, key));
-  return it != m_corLsdb.end();
+  return findLsaByKey(m_corLsdb, key) != nullptr;
 }
 
 void
@@ -529,7 +779,7 @@ Lsdb::writeCorLsdbLog()
   }
 }
 
-const std::list<CoordinateLsa>&
+const CoordinateLsaContainer&
 Lsdb::getCoordinateLsdb() const
 {
   return m_corLsdb;
@@ -537,16 +787,6 @@ Lsdb::getCoordinateLsdb() const
 
 // Adj LSA and LSDB related function starts here
 
-  /*! \brief Returns whether an adj. LSA object is from some router.
-    \param alsa The adj. LSA object.
-    \param key The router name that you want to compare the LSA with.
-   */
-static bool
-adjLsaCompareByKey(AdjLsa& alsa, const ndn::Name& key)
-{
-  return alsa.getKey() == key;
-}
-
 void
 Lsdb::scheduleAdjLsaBuild()
 {
@@ -559,11 +799,16 @@ Lsdb::scheduleAdjLsaBuild()
   }
 
   if (m_isBuildAdjLsaSheduled == false) {
-    NLSR_LOG_DEBUG("Scheduling Adjacency LSA build in " << m_adjLsaBuildInterval);
+    ndn::time::milliseconds delay = m_adjLsaBuildThrottle.scheduleRun();
+    NLSR_LOG_DEBUG("Scheduling Adjacency LSA build in " << delay
+                   << " (hold time " << m_adjLsaBuildThrottle.getCurrentHold() << ")");
 
-    m_scheduler.schedule(m_adjLsaBuildInterval, [this] { buildAdjLsa(); });
+    m_scheduler.schedule(delay, [this] { buildAdjLsa(); });
     m_isBuildAdjLsaSheduled = true;
   }
+  else {
+    m_adjLsaBuildThrottle.recordEvent();
+  }
 }
 
 void
@@ -572,6 +817,7 @@ Lsdb::buildAdjLsa()
   NLSR_LOG_TRACE("Lsdb::buildAdjLsa called");
 
   m_isBuildAdjLsaSheduled = false;
+  m_adjLsaBuildThrottle.recordRun();
 
   if (m_confParam.getAdjacencyList().isAdjLsaBuildable(m_confParam.getInterestRetryNumber())) {
 
@@ -617,10 +863,7 @@ Lsdb::buildAdjLsa()
 bool
 Lsdb::addAdjLsa(AdjLsa& alsa)
 {
-  auto it = std::find_if(m_adjLsdb.begin(), m_adjLsdb.end(),
-                         std::bind(adjLsaCompareByKey, _1, alsa.getKey()));
-  if (it == m_adjLsdb.end()) {
-    m_adjLsdb.push_back(alsa);
+  if (m_adjLsdb.insert(alsa).second) {
     // Add any new name prefixes to the NPT
     // Only add NPT entries if this is an adj LSA from another router.
     if (alsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
@@ -633,21 +876,27 @@ Lsdb::addAdjLsa(AdjLsa& alsa)
   return false;
 }
 
-AdjLsa*
-Lsdb::findAdjLsa(const ndn::Name& key)
+const AdjLsa*
+Lsdb::findAdjLsa(const ndn::Name& key) const
 {
-  auto it = std::find_if(m_adjLsdb.begin(), m_adjLsdb.end(),
-                         std::bind(adjLsaCompareByKey, _1, key));
-  if (it != m_adjLsdb.end()) {
-    return &*it;
+  return findLsaByKey(m_adjLsdb, key);
+}
+
+bool
+Lsdb::modifyAdjLsa(const ndn::Name& key, const std::function<void(AdjLsa&)>& modifier)
+{
+  const AdjLsa* lsa = findLsaByKey(m_adjLsdb, key);
+  if (lsa == nullptr) {
+    return false;
   }
-  return nullptr;
+  modifyLsa(m_adjLsdb, *lsa, modifier);
+  return true;
 }
 
 bool
 Lsdb::isAdjLsaNew(const ndn::Name& key, uint64_t seqNo)
 {
-  AdjLsa* adjLsaCheck = findAdjLsa(key);
+  const AdjLsa* adjLsaCheck = findAdjLsa(key);
   // If it is in the LSDB
   if (adjLsaCheck != nullptr) {
     // And the supplied seq no is newer (higher) than the current one.
@@ -655,25 +904,26 @@ Lsdb::isAdjLsaNew(const ndn::Name& key, uint64_t seqNo)
       return true;
     }
     else {
+      confirmIfProvisional(m_adjLsdb, *adjLsaCheck, seqNo);
       return false;
     }
   }
   return true;
 }
 
-ndn::scheduler::EventId
+TimerWheel::EventId
 Lsdb::scheduleAdjLsaExpiration(const ndn::Name& key, int seqNo,
                                const ndn::time::seconds& expTime)
 {
-  return m_scheduler.schedule(expTime + GRACE_PERIOD,
-                              std::bind(&Lsdb::expireOrRefreshAdjLsa, this, key, seqNo));
+  return m_timerWheel.schedule(expTime + GRACE_PERIOD,
+                               std::bind(&Lsdb::expireOrRefreshAdjLsa, this, key, seqNo));
 }
 
 bool
 Lsdb::installAdjLsa(AdjLsa& alsa)
 {
   ndn::time::seconds timeToExpire = m_lsaRefreshTime;
-  AdjLsa* chkAdjLsa = findAdjLsa(alsa.getKey());
+  const AdjLsa* chkAdjLsa = findAdjLsa(alsa.getKey());
   // If this adj. LSA is not in the LSDB already
   if (chkAdjLsa == nullptr) {
     NLSR_LOG_DEBUG("New Adj LSA. Adding to LSDB");
@@ -682,7 +932,8 @@ Lsdb::installAdjLsa(AdjLsa& alsa)
     addAdjLsa(alsa);
 
     m_routingTable.scheduleRoutingTableCalculation();
-    if (alsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+    // This router's Adj LSA preloaded from the snapshot also keeps its expiration time
+    if (alsa.getOrigRouter() != m_confParam.getRouterPrefix() || alsa.isProvisional()) {
       ndn::time::system_clock::Duration duration = alsa.getExpirationTimePoint() -
                                                    ndn::time::system_clock::now();
       timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
@@ -693,28 +944,31 @@ Lsdb::installAdjLsa(AdjLsa& alsa)
     if (chkAdjLsa->getLsSeqNo() < alsa.getLsSeqNo()) {
       NLSR_LOG_DEBUG("Updated Adj LSA. Updating LSDB");
       NLSR_LOG_DEBUG("Deleting Adj Lsa");
-      chkAdjLsa->writeLog();
-      chkAdjLsa->setLsSeqNo(alsa.getLsSeqNo());
-      chkAdjLsa->setExpirationTimePoint(alsa.getExpirationTimePoint());
-      // If the new adj LSA has new content, update the contents of
-      // the LSDB entry. Additionally, since we've changed the
-      // contents of the LSDB, we have to schedule a routing
-      // calculation.
-      if (!chkAdjLsa->isEqualContent(alsa)) {
-        chkAdjLsa->getAdl().reset();
-        chkAdjLsa->getAdl().addAdjacents(alsa.getAdl());
-        m_routingTable.scheduleRoutingTableCalculation();
-      }
-      if (alsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
-        auto duration = alsa.getExpirationTimePoint() - ndn::time::system_clock::now();
-        timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
-      }
-      chkAdjLsa->getExpiringEventId().cancel();
-      chkAdjLsa->setExpiringEventId(scheduleAdjLsaExpiration(alsa.getKey(),
-                                                             alsa.getLsSeqNo(),
-                                                             timeToExpire));
-      NLSR_LOG_DEBUG("Adding Adj Lsa");
-      chkAdjLsa->writeLog();
+      modifyLsa(m_adjLsdb, *chkAdjLsa, [&] (AdjLsa& lsa) {
+        lsa.writeLog();
+        lsa.setLsSeqNo(alsa.getLsSeqNo());
+        lsa.setExpirationTimePoint(alsa.getExpirationTimePoint());
+        lsa.setProvisional(false);
+        // If the new adj LSA has new content, update the contents of
+        // the LSDB entry. Additionally, since we've changed the
+        // contents of the LSDB, we have to schedule a routing
+        // calculation.
+        if (!lsa.isEqualContent(alsa)) {
+          lsa.getAdl().reset();
+          lsa.getAdl().addAdjacents(alsa.getAdl());
+          m_routingTable.scheduleRoutingTableCalculation();
+        }
+        if (alsa.getOrigRouter() != m_confParam.getRouterPrefix()) {
+          auto duration = alsa.getExpirationTimePoint() - ndn::time::system_clock::now();
+          timeToExpire = ndn::time::duration_cast<ndn::time::seconds>(duration);
+        }
+        lsa.getExpiringEventId().cancel();
+        lsa.setExpiringEventId(scheduleAdjLsaExpiration(alsa.getKey(),
+                                                        alsa.getLsSeqNo(),
+                                                        timeToExpire));
+        NLSR_LOG_DEBUG("Adding Adj Lsa");
+        lsa.writeLog();
+      });
     }
   }
   return true;
@@ -742,15 +996,14 @@ Lsdb::buildAndInstallOwnAdjLsa()
 bool
 Lsdb::removeAdjLsa(const ndn::Name& key)
 {
-  auto it = std::find_if(m_adjLsdb.begin(), m_adjLsdb.end(),
-                         std::bind(adjLsaCompareByKey, _1, key));
-  if (it != m_adjLsdb.end()) {
+  const AdjLsa* lsa = findLsaByKey(m_adjLsdb, key);
+  if (lsa != nullptr) {
     NLSR_LOG_DEBUG("Deleting Adj Lsa");
-    it->writeLog();
-    if (it->getOrigRouter() != m_confParam.getRouterPrefix()) {
-      m_namePrefixTable.removeEntry(it->getOrigRouter(), it->getOrigRouter());
+    lsa->writeLog();
+    if (lsa->getOrigRouter() != m_confParam.getRouterPrefix()) {
+      m_namePrefixTable.removeEntry(lsa->getOrigRouter(), lsa->getOrigRouter());
     }
-    m_adjLsdb.erase(it);
+    m_adjLsdb.erase(m_adjLsdb.iterator_to(*lsa));
     return true;
   }
   return false;
@@ -759,12 +1012,10 @@ Lsdb::removeAdjLsa(const ndn::Name& key)
 bool
 Lsdb::doesAdjLsaExist(const ndn::Name& key)
 {
-  auto it = std::find_if(m_adjLsdb.begin(), m_adjLsdb.end(),
-                         std::bind(adjLsaCompareByKey, _1, key));
-  return it != m_adjLsdb.end();
+  return findLsaByKey(m_adjLsdb, key) != nullptr;
 }
 
-const std::list<AdjLsa>&
+const AdjLsaContainer&
 Lsdb::getAdjLsdb() const
 {
   return m_adjLsdb;
@@ -782,7 +1033,7 @@ Lsdb::expireOrRefreshNameLsa(const ndn::Name& lsaKey, uint64_t seqNo)
 {
   NLSR_LOG_DEBUG("Lsdb::expireOrRefreshNameLsa Called");
   NLSR_LOG_DEBUG("LSA Key : " << lsaKey << " Seq No: " << seqNo);
-  NameLsa* chkNameLsa = findNameLsa(lsaKey);
+  const NameLsa* chkNameLsa = findNameLsa(lsaKey);
   // If this name LSA exists in the LSDB
   if (chkNameLsa != nullptr) {
     NLSR_LOG_DEBUG("LSA Exists with seq no: " << chkNameLsa->getLsSeqNo());
@@ -791,18 +1042,27 @@ Lsdb::expireOrRefreshNameLsa(const ndn::Name& lsaKey, uint64_t seqNo)
       if (chkNameLsa->getOrigRouter() == m_thisRouterPrefix) {
         NLSR_LOG_DEBUG("Own Name LSA, so refreshing it");
         NLSR_LOG_DEBUG("Deleting Name Lsa");
-        chkNameLsa->writeLog();
-        chkNameLsa->setLsSeqNo(chkNameLsa->getLsSeqNo() + 1);
-        m_sequencingManager.setNameLsaSeq(chkNameLsa->getLsSeqNo());
-        chkNameLsa->setExpirationTimePoint(getLsaExpirationTimePoint());
-        NLSR_LOG_DEBUG("Adding Name Lsa");
-        chkNameLsa->writeLog();
-        // schedule refreshing event again
-        chkNameLsa->setExpiringEventId(scheduleNameLsaExpiration(chkNameLsa->getKey(),
-                                                                 chkNameLsa->getLsSeqNo(),
-                                                                 m_lsaRefreshTime));
+        modifyLsa(m_nameLsdb, *chkNameLsa, [&] (NameLsa& lsa) {
+          lsa.writeLog();
+          // The shards of the name LSA share its sequence numbers
+          m_sequencingManager.increaseNameLsaSeq();
+          lsa.setLsSeqNo(m_sequencingManager.getNameLsaSeq());
+          lsa.setExpirationTimePoint(getLsaExpirationTimePoint());
+          // The refreshed LSA advertises the same names
+          NameLsaDelta delta(lsa.getOrigRouter(), lsa.getLsSeqNo(),
+                             lsa.getExpirationTimePoint(), seqNo);
+          delta.setShard(lsa.getShard());
+          recordOwnNameLsaDelta(std::move(delta));
+          NLSR_LOG_DEBUG("Adding Name Lsa");
+          lsa.writeLog();
+          // schedule refreshing event again
+          lsa.setExpiringEventId(scheduleNameLsaExpiration(lsa.getKey(),
+                                                           lsa.getLsSeqNo(),
+                                                           m_lsaRefreshTime));
+        });
         m_sequencingManager.writeSeqNoToFile();
-        m_sync.publishRoutingUpdate(Lsa::Type::NAME, m_sequencingManager.getNameLsaSeq());
+        m_sync.publishRoutingUpdate(Lsa::Type::NAME, m_sequencingManager.getNameLsaSeq(),
+                                    chkNameLsa->getShard());
       }
       // Since we cannot refresh other router's LSAs, our only choice is to expire.
       else {
@@ -825,32 +1085,35 @@ Lsdb::expireOrRefreshAdjLsa(const ndn::Name& lsaKey, uint64_t seqNo)
 {
   NLSR_LOG_DEBUG("Lsdb::expireOrRefreshAdjLsa Called");
   NLSR_LOG_DEBUG("LSA Key: " << lsaKey << " Seq No: " << seqNo);
-  AdjLsa* chkAdjLsa = findAdjLsa(lsaKey);
+  const AdjLsa* chkAdjLsa = findAdjLsa(lsaKey);
   // If this is a valid LSA
   if (chkAdjLsa != nullptr) {
     NLSR_LOG_DEBUG("LSA Exists with seq no: " << chkAdjLsa->getLsSeqNo());
     // And if it hasn't been updated for some other reason
     if (chkAdjLsa->getLsSeqNo() == seqNo) {
-      // If it is our own LSA
-      if (chkAdjLsa->getOrigRouter() == m_thisRouterPrefix) {
+      // If it is our own LSA, and not the one preloaded from the snapshot, which the
+      // neighbors have not confirmed
+      if (chkAdjLsa->getOrigRouter() == m_thisRouterPrefix && !chkAdjLsa->isProvisional()) {
         NLSR_LOG_DEBUG("Own Adj LSA, so refreshing it");
         NLSR_LOG_DEBUG("Deleting Adj Lsa");
-        chkAdjLsa->writeLog();
-        chkAdjLsa->setLsSeqNo(chkAdjLsa->getLsSeqNo() + 1);
-        m_sequencingManager.setAdjLsaSeq(chkAdjLsa->getLsSeqNo());
-        chkAdjLsa->setExpirationTimePoint(getLsaExpirationTimePoint());
-        NLSR_LOG_DEBUG("Adding Adj Lsa");
-        chkAdjLsa->writeLog();
-        // schedule refreshing event again
-        chkAdjLsa->setExpiringEventId(scheduleAdjLsaExpiration(chkAdjLsa->getKey(),
-                                                               chkAdjLsa->getLsSeqNo(),
-                                                               m_lsaRefreshTime));
+        modifyLsa(m_adjLsdb, *chkAdjLsa, [&] (AdjLsa& lsa) {
+          lsa.writeLog();
+          lsa.setLsSeqNo(lsa.getLsSeqNo() + 1);
+          m_sequencingManager.setAdjLsaSeq(lsa.getLsSeqNo());
+          lsa.setExpirationTimePoint(getLsaExpirationTimePoint());
+          NLSR_LOG_DEBUG("Adding Adj Lsa");
+          lsa.writeLog();
+          // schedule refreshing event again
+          lsa.setExpiringEventId(scheduleAdjLsaExpiration(lsa.getKey(),
+                                                          lsa.getLsSeqNo(),
+                                                          m_lsaRefreshTime));
+        });
         m_sequencingManager.writeSeqNoToFile();
         m_sync.publishRoutingUpdate(Lsa::Type::ADJACENCY, m_sequencingManager.getAdjLsaSeq());
       }
-      // An LSA from another router is expiring
+      // An LSA from another router, or a preloaded one, is expiring
       else {
-        NLSR_LOG_DEBUG("Other's Adj LSA, so removing from LSDB");
+        NLSR_LOG_DEBUG("Other's or preloaded Adj LSA, so removing from LSDB");
         removeAdjLsa(lsaKey);
       }
       // We have changed the contents of the LSDB, so we have to
@@ -873,7 +1136,7 @@ Lsdb::expireOrRefreshCoordinateLsa(const ndn::Name& lsaKey,
 {
   NLSR_LOG_DEBUG("Lsdb::expireOrRefreshCorLsa Called ");
   NLSR_LOG_DEBUG("LSA Key : " << lsaKey << " Seq No: " << seqNo);
-  CoordinateLsa* chkCorLsa = findCoordinateLsa(lsaKey);
+  const CoordinateLsa* chkCorLsa = findCoordinateLsa(lsaKey);
   // Whether the LSA is in the LSDB or not.
   if (chkCorLsa != nullptr) {
     NLSR_LOG_DEBUG("LSA Exists with seq no: " << chkCorLsa->getLsSeqNo());
@@ -882,20 +1145,21 @@ Lsdb::expireOrRefreshCoordinateLsa(const ndn::Name& lsaKey,
       if (chkCorLsa->getOrigRouter() == m_thisRouterPrefix) {
         NLSR_LOG_DEBUG("Own Cor LSA, so refreshing it");
         NLSR_LOG_DEBUG("Deleting Coordinate Lsa");
-        chkCorLsa->writeLog();
-        chkCorLsa->setLsSeqNo(chkCorLsa->getLsSeqNo() + 1);
-        if (m_confParam.getHyperbolicState() != HYPERBOLIC_STATE_OFF) {
-          m_sequencingManager.setCorLsaSeq(chkCorLsa->getLsSeqNo());
-        }
+        modifyLsa(m_corLsdb, *chkCorLsa, [&] (CoordinateLsa& lsa) {
+          lsa.writeLog();
+          lsa.setLsSeqNo(lsa.getLsSeqNo() + 1);
+          if (m_confParam.getHyperbolicState() != HYPERBOLIC_STATE_OFF) {
+            m_sequencingManager.setCorLsaSeq(lsa.getLsSeqNo());
+          }
 
-        chkCorLsa->setExpirationTimePoint(getLsaExpirationTimePoint());
-        NLSR_LOG_DEBUG("Adding Coordinate Lsa");
-        chkCorLsa->writeLog();
-        // schedule refreshing event again
-        chkCorLsa->setExpiringEventId(scheduleCoordinateLsaExpiration(
-                                        chkCorLsa->getKey(),
-                                        chkCorLsa->getLsSeqNo(),
-                                        m_lsaRefreshTime));
+          lsa.setExpirationTimePoint(getLsaExpirationTimePoint());
+          NLSR_LOG_DEBUG("Adding Coordinate Lsa");
+          lsa.writeLog();
+          // schedule refreshing event again
+          lsa.setExpiringEventId(scheduleCoordinateLsaExpiration(lsa.getKey(),
+                                                                 lsa.getLsSeqNo(),
+                                                                 m_lsaRefreshTime));
+        });
         // Only sync coordinate LSAs if link-state routing is disabled
         if (m_confParam.getHyperbolicState() != HYPERBOLIC_STATE_OFF) {
           m_sequencingManager.writeSeqNoToFile();
@@ -918,9 +1182,6 @@ void
 Lsdb::expressInterest(const ndn::Name& interestName, uint32_t timeoutCount,
                       ndn::time::steady_clock::TimePoint deadline)
 {
-  // increment SENT_LSA_INTEREST
-  lsaIncrementSignal(Statistics::PacketType::SENT_LSA_INTEREST);
-
   if (deadline == DEFAULT_LSA_RETRIEVAL_DEADLINE) {
     deadline = ndn::time::steady_clock::now() + ndn::time::seconds(static_cast<int>(LSA_REFRESH_TIME_MAX));
   }
@@ -942,43 +1203,132 @@ Lsdb::expressInterest(const ndn::Name& interestName, uint32_t timeoutCount,
     return;
   }
 
+  auto fetch = m_fetches.find(lsaName);
+  if (fetch != m_fetches.end()) {
+    if (fetch->second.seqNo > seqNo || (fetch->second.seqNo == seqNo && timeoutCount == 0)) {
+      NLSR_LOG_TRACE("Already fetching " << lsaName << " Seq number: " << fetch->second.seqNo);
+      return;
+    }
+    NLSR_LOG_DEBUG("Stopping the fetch of " << lsaName << " Seq number: " << fetch->second.seqNo);
+    fetch->second.fetcher->stop();
+    m_fetches.erase(fetch);
+  }
+  else if (m_fetches.size() >= m_confParam.getMaxLsaFetches()) {
+    auto queued = m_queuedFetches.find(lsaName);
+    if (queued == m_queuedFetches.end()) {
+      m_queuedFetches.emplace(lsaName, QueuedLsaFetch{interestName, timeoutCount, deadline});
+      m_fetchQueue.push_back(lsaName);
+    }
+    else {
+      // The LSA keeps its place in the queue
+      queued->second = QueuedLsaFetch{interestName, timeoutCount, deadline};
+    }
+    NLSR_LOG_DEBUG("Queued the fetch of " << interestName << ", " << m_fetchQueue.size()
+                   << " fetches waiting");
+    return;
+  }
+
+  startFetch(interestName, timeoutCount, deadline);
+}
+
+void
+Lsdb::startFetch(const ndn::Name& interestName, uint32_t timeoutCount,
+                 const ndn::time::steady_clock::TimePoint& deadline)
+{
+  // increment SENT_LSA_INTEREST
+  lsaIncrementSignal(Statistics::PacketType::SENT_LSA_INTEREST);
+
+  ndn::Name lsaName = interestName.getSubName(0, interestName.size()-1);
+  uint64_t seqNo = interestName[-1].toNumber();
+
+  Lsa::Type lsaType;
+  std::istringstream(interestName[-2].toUri()) >> lsaType;
+
+  // A name LSA is fetched as a delta from the one in the LSDB, unless a delta from it
+  // could not be fetched or installed before
+  ndn::Name lsaKey;
+  bool isDelta = false;
   ndn::Interest interest(interestName);
+  if (lsaType == Lsa::Type::NAME && m_confParam.isNameLsaDeltaEnabled()) {
+    int32_t lsaPosition = util::getNameComponentPosition(lsaName, "LSA");
+    lsaKey = m_confParam.getNetwork();
+    lsaKey.append(lsaName.getSubName(lsaPosition + 1, lsaName.size() - lsaPosition - 2));
+    lsaKey.append(lsaName[-1]);
+
+    const NameLsa* nameLsa = findNameLsa(lsaKey);
+    if (m_fullNameLsaFetches.erase(lsaKey) == 0 &&
+        nameLsa != nullptr && nameLsa->getLsSeqNo() < seqNo) {
+      isDelta = true;
+      interest.setName(ndn::Name(lsaName).append(DELTA_COMPONENT)
+                                         .appendNumber(nameLsa->getLsSeqNo())
+                                         .appendNumber(seqNo));
+    }
+  }
+
   ndn::util::SegmentFetcher::Options options;
   options.interestLifetime = m_confParam.getLsaInterestLifetime();
 
-  NLSR_LOG_DEBUG("Fetching Data for LSA: " << interestName << " Seq number: " << seqNo);
+  NLSR_LOG_DEBUG("Fetching Data for LSA: " << interest.getName() << " Seq number: " << seqNo);
   auto fetcher = ndn::util::SegmentFetcher::start(m_face, interest,
                                                   m_confParam.getValidator(), options);
 
-  auto it = m_fetchers.insert(fetcher).first;
+  m_fetches[lsaName] = LsaFetch{fetcher, seqNo};
+  const ndn::util::SegmentFetcher* fetcherPtr = fetcher.get();
 
-  fetcher->afterSegmentValidated.connect([this] (const ndn::Data& data) {
+  size_t segmentNameSize = interestName.size() + 2;
+  fetcher->afterSegmentValidated.connect([this, isDelta, segmentNameSize] (const ndn::Data& data) {
     // Nlsr class subscribes to this to fetch certificates
     afterSegmentValidatedSignal(data);
 
+    // Only the segments of whole LSAs, named <LSA name>/<seqNo>/<version>/<segment>, are
+    // served to other routers
+    if (isDelta || data.getName().size() != segmentNameSize) {
+      return;
+    }
+
     // If we don't do this IMS throws: std::bad_weak_ptr: bad_weak_ptr
     auto lsaSegment = std::make_shared<const ndn::Data>(data);
     m_lsaStorage.insert(*lsaSegment);
     const ndn::Name& segmentName = lsaSegment->getName();
     // Schedule deletion of the segment
-    m_scheduler.schedule(ndn::time::seconds(LSA_REFRESH_TIME_DEFAULT),
-                         [this, segmentName] { m_lsaStorage.erase(segmentName); });
+    m_timerWheel.schedule(ndn::time::seconds(LSA_REFRESH_TIME_DEFAULT),
+                          [this, segmentName] { m_lsaStorage.erase(segmentName); });
   });
 
   fetcher->onComplete.connect([=] (const ndn::ConstBufferPtr& bufferPtr) {
+    // A delta can only be installed if it was asked for, against the LSA it is based on
+    if (!isDelta && lsaType == Lsa::Type::NAME && isNameLsaDeltaContent(ndn::Block(bufferPtr))) {
+      onFetchLsaError(ndn::util::SegmentFetcher::ErrorCode::SEGMENT_VALIDATION_FAIL,
+                      "Received a delta instead of the whole name LSA", interestName,
+                      timeoutCount, deadline, lsaName, seqNo);
+      endFetch(lsaName, fetcherPtr);
+      return;
+    }
+
     m_lsaStorage.erase(ndn::Name(lsaName).appendNumber(seqNo - 1));
     afterFetchLsa(bufferPtr, interestName);
-    m_fetchers.erase(it);
+    endFetch(lsaName, fetcherPtr);
+
+    if (isDelta) {
+      const NameLsa* nameLsa = findNameLsa(lsaKey);
+      if (nameLsa == nullptr || nameLsa->getLsSeqNo() < seqNo) {
+        NLSR_LOG_DEBUG("Could not install the delta to " << interestName
+                       << ", fetching the whole name LSA");
+        m_fullNameLsaFetches.insert(lsaKey);
+        expressInterest(interestName, 0, deadline);
+      }
+    }
   });
 
   fetcher->onError.connect([=] (uint32_t errorCode, const std::string& msg) {
+    if (isDelta) {
+      m_fullNameLsaFetches.insert(lsaKey);
+    }
     onFetchLsaError(errorCode, msg, interestName, timeoutCount, deadline, lsaName, seqNo);
-    m_fetchers.erase(it);
+    endFetch(lsaName, fetcherPtr);
   });
 
   // increment a specific SENT_LSA_INTEREST
-  Lsa::Type lsaType;
-  std::istringstream(interestName[-2].toUri()) >> lsaType;
   switch (lsaType) {
   case Lsa::Type::ADJACENCY:
     lsaIncrementSignal(Statistics::PacketType::SENT_ADJ_LSA_INTEREST);
@@ -994,6 +1344,24 @@ Lsdb::expressInterest(const ndn::Name& interestName, uint32_t timeoutCount,
   }
 }
 
+void
+Lsdb::endFetch(const ndn::Name& lsaName, const ndn::util::SegmentFetcher* fetcher)
+{
+  auto fetch = m_fetches.find(lsaName);
+  if (fetch != m_fetches.end() && fetch->second.fetcher.get() == fetcher) {
+    m_fetches.erase(fetch);
+  }
+
+  while (m_fetches.size() < m_confParam.getMaxLsaFetches() && !m_fetchQueue.empty()) {
+    auto queued = m_queuedFetches.find(m_fetchQueue.front());
+    QueuedLsaFetch next = std::move(queued->second);
+    m_queuedFetches.erase(queued);
+    m_fetchQueue.pop_front();
+
+    expressInterest(next.interestName, next.timeoutCount, next.deadline);
+  }
+}
+
 void
 Lsdb::processInterest(const ndn::Name& name, const ndn::Interest& interest)
 {
@@ -1011,6 +1379,17 @@ Lsdb::processInterest(const ndn::Name& name, const ndn::Interest& interest)
     NLSR_LOG_TRACE("Interest w/o segment and version: " << interestName);
   }
 
+  // A delta is asked for as <LSA name>/delta/<base seqNo>/<seqNo>
+  bool isDelta = false;
+  uint64_t baseSeqNo = 0;
+  if (interestName.size() >= 3 && interestName[-3] == DELTA_COMPONENT &&
+      interestName[-2].isNumber() && interestName[-1].isNumber()) {
+    isDelta = true;
+    baseSeqNo = interestName[-2].toNumber();
+    uint64_t seqNo = interestName[-1].toNumber();
+    interestName = interestName.getPrefix(-3).appendNumber(seqNo);
+  }
+
   // increment RCV_LSA_INTEREST
   lsaIncrementSignal(Statistics::PacketType::RCV_LSA_INTEREST);
 
@@ -1031,7 +1410,10 @@ Lsdb::processInterest(const ndn::Name& name, const ndn::Interest& interest)
     Lsa::Type interestedLsType;
     std::istringstream(lsaType) >> interestedLsType;
 
-    if (interestedLsType == Lsa::Type::NAME) {
+    if (interestedLsType == Lsa::Type::NAME && isDelta) {
+      processInterestForNameLsaDelta(interest, originRouter.append(lsaType), seqNo, baseSeqNo);
+    }
+    else if (interestedLsType == Lsa::Type::NAME) {
       processInterestForNameLsa(interest, originRouter.append(lsaType), seqNo);
     }
     else if (interestedLsType == Lsa::Type::ADJACENCY) {
@@ -1057,6 +1439,44 @@ Lsdb::processInterest(const ndn::Name& name, const ndn::Interest& interest)
   }
 }
 
+/*! \brief Encodes an LSA as the content of the Data that carries it.
+  \param lsaEncoding LSA_ENCODING_TEXT or LSA_ENCODING_TLV.
+ */
+template<typename LsaType>
+static ndn::Block
+makeLsaContent(const LsaType& lsa, int32_t lsaEncoding)
+{
+  if (lsaEncoding == LSA_ENCODING_TLV) {
+    return ndn::encoding::makeNestedBlock(ndn::tlv::Content, lsa);
+  }
+  return ndn::encoding::makeStringBlock(ndn::tlv::Content, lsa.serialize());
+}
+
+/*! \brief Decodes an LSA from the content of the Data that carried it, in either encoding.
+
+  The first octet tells the encodings apart: a text LSA starts with the URI of its
+  originating router, hence with '/', while a TLV LSA starts with its TLV type, none of
+  which is '/'. Routers that only know the text encoding thus keep interoperating.
+ */
+template<typename LsaType>
+static bool
+decodeLsaContent(LsaType& lsa, const ndn::Block& content)
+{
+  if (content.value_size() > 0 && content.value()[0] == '/') {
+    return lsa.deserialize(std::string(reinterpret_cast<const char*>(content.value()),
+                                       content.value_size()));
+  }
+
+  try {
+    lsa.wireDecode(content.blockFromValue());
+    return true;
+  }
+  catch (const ndn::tlv::Error& e) {
+    NLSR_LOG_ERROR("Could not decode LSA from content: " << e.what());
+    return false;
+  }
+}
+
   // \brief Finds and sends a requested name LSA.
   // \param interest The interest that seeks the name LSA.
   // \param lsaKey The LSA that the Interest is seeking.
@@ -1070,13 +1490,16 @@ Lsdb::processInterestForNameLsa(const ndn::Interest& interest,
   // increment RCV_NAME_LSA_INTEREST
   lsaIncrementSignal(Statistics::PacketType::RCV_NAME_LSA_INTEREST);
   NLSR_LOG_DEBUG("nameLsa interest " << interest << " received");
-  NameLsa* nameLsa = findNameLsa(lsaKey);
+  const NameLsa* nameLsa = findNameLsa(lsaKey);
   if (nameLsa != nullptr) {
     NLSR_LOG_TRACE("Verifying SeqNo for NameLsa is same as requested.");
     if (nameLsa->getLsSeqNo() == seqNo) {
-      std::string content = nameLsa->serialize();
+      // Routers that fetch the shards of a name LSA read TLV, and the text encoding cannot
+      // tell the shard
+      int32_t lsaEncoding = nameLsa->getShard() == 0 ? m_confParam.getLsaEncoding()
+                                                     : LSA_ENCODING_TLV;
       m_segmentPublisher.publish(interest.getName(), interest.getName(),
-                                 ndn::encoding::makeStringBlock(ndn::tlv::Content, content),
+                                 makeLsaContent(*nameLsa, lsaEncoding),
                                  m_lsaRefreshTime, m_signingInfo);
 
       lsaIncrementSignal(Statistics::PacketType::SENT_NAME_LSA_DATA);
@@ -1090,6 +1513,31 @@ Lsdb::processInterestForNameLsa(const ndn::Interest& interest,
   }
 }
 
+void
+Lsdb::processInterestForNameLsaDelta(const ndn::Interest& interest,
+                                     const ndn::Name& lsaKey,
+                                     uint64_t seqNo,
+                                     uint64_t baseSeqNo)
+{
+  NameLsaDelta delta;
+  if (!getOwnNameLsaDelta(getLsaShard(lsaKey[-1]), baseSeqNo, seqNo, delta)) {
+    NLSR_LOG_DEBUG("No delta of " << lsaKey << " from seq no " << baseSeqNo << " to " << seqNo
+                   << ", sending the whole name LSA");
+    processInterestForNameLsa(interest, lsaKey, seqNo);
+    return;
+  }
+
+  lsaIncrementSignal(Statistics::PacketType::RCV_NAME_LSA_INTEREST);
+  NLSR_LOG_DEBUG("nameLsa delta interest " << interest << " received");
+
+  // Routers that fetch deltas read TLV, whatever encoding this router publishes LSAs in
+  m_segmentPublisher.publish(interest.getName(), interest.getName(),
+                             makeLsaContent(delta, LSA_ENCODING_TLV),
+                             m_lsaRefreshTime, m_signingInfo);
+
+  lsaIncrementSignal(Statistics::PacketType::SENT_NAME_LSA_DATA);
+}
+
   // \brief Finds and sends a requested adj. LSA.
   // \param interest The interest that seeks the adj. LSA.
   // \param lsaKey The LSA that the Interest is seeking.
@@ -1106,13 +1554,12 @@ Lsdb::processInterestForAdjacencyLsa(const ndn::Interest& interest,
 
   lsaIncrementSignal(Statistics::PacketType::RCV_ADJ_LSA_INTEREST);
   NLSR_LOG_DEBUG("AdjLsa interest " << interest << " received");
-  AdjLsa* adjLsa = findAdjLsa(lsaKey);
+  const AdjLsa* adjLsa = findAdjLsa(lsaKey);
   if (adjLsa != nullptr) {
     NLSR_LOG_TRACE("Verifying SeqNo for AdjLsa is same as requested.");
     if (adjLsa->getLsSeqNo() == seqNo) {
-      std::string content = adjLsa->serialize();
       m_segmentPublisher.publish(interest.getName(), interest.getName(),
-                                 ndn::encoding::makeStringBlock(ndn::tlv::Content, content),
+                                 makeLsaContent(*adjLsa, m_confParam.getLsaEncoding()),
                                  m_lsaRefreshTime, m_signingInfo);
 
       lsaIncrementSignal(Statistics::PacketType::SENT_ADJ_LSA_DATA);
@@ -1142,13 +1589,12 @@ Lsdb::processInterestForCoordinateLsa(const ndn::Interest& interest,
 
   lsaIncrementSignal(Statistics::PacketType::RCV_COORD_LSA_INTEREST);
   NLSR_LOG_DEBUG("CoordinateLsa interest " << interest << " received");
-  CoordinateLsa* corLsa = findCoordinateLsa(lsaKey);
+  const CoordinateLsa* corLsa = findCoordinateLsa(lsaKey);
   if (corLsa != nullptr) {
     NLSR_LOG_TRACE("Verifying SeqNo for CoordinateLsa is same as requested.");
     if (corLsa->getLsSeqNo() == seqNo) {
-      std::string content = corLsa->serialize();
       m_segmentPublisher.publish(interest.getName(), interest.getName(),
-                                 ndn::encoding::makeStringBlock(ndn::tlv::Content, content),
+                                 makeLsaContent(*corLsa, m_confParam.getLsaEncoding()),
                                  m_lsaRefreshTime, m_signingInfo);
 
       lsaIncrementSignal(Statistics::PacketType::SENT_COORD_LSA_DATA);
@@ -1178,23 +1624,22 @@ Lsdb::onContentValidated(const std::shared_ptr<const ndn::Data>& data)
     originRouter.append(dataName.getSubName(lsaPosition + 1, dataName.size() - lsaPosition - 3));
 
     uint64_t seqNo = dataName[-1].toNumber();
-    std::string dataContent(reinterpret_cast<const char*>(data->getContent().value()),
-                            data->getContent().value_size());
+    const ndn::Block& content = data->getContent();
 
     Lsa::Type interestedLsType;
     std::istringstream(dataName[-2].toUri()) >> interestedLsType;
 
     if (interestedLsType == Lsa::Type::NAME) {
-      processContentNameLsa(originRouter.append(std::to_string(interestedLsType)), seqNo,
-                            dataContent);
+      // The type component also tells the shard of a name LSA
+      processContentNameLsa(originRouter.append(dataName[-2]), seqNo, content);
     }
     else if (interestedLsType == Lsa::Type::ADJACENCY) {
       processContentAdjacencyLsa(originRouter.append(std::to_string(interestedLsType)), seqNo,
-                                 dataContent);
+                                 content);
     }
     else if (interestedLsType == Lsa::Type::COORDINATE) {
       processContentCoordinateLsa(originRouter.append(std::to_string(interestedLsType)), seqNo,
-                                  dataContent);
+                                  content);
     }
     else {
       NLSR_LOG_WARN("Received unrecognized LSA Type: " << interestedLsType);
@@ -1206,12 +1651,28 @@ Lsdb::onContentValidated(const std::shared_ptr<const ndn::Data>& data)
 
 void
 Lsdb::processContentNameLsa(const ndn::Name& lsaKey,
-                            uint64_t lsSeqNo, std::string& dataContent)
+                            uint64_t lsSeqNo, const ndn::Block& content)
 {
   lsaIncrementSignal(Statistics::PacketType::RCV_NAME_LSA_DATA);
-  if (isNameLsaNew(lsaKey, lsSeqNo)) {
+  if (!isNameLsaNew(lsaKey, lsSeqNo)) {
+    return;
+  }
+
+  // The shard an LSA holds must be the one it was fetched as
+  uint32_t shard = getLsaShard(lsaKey[-1]);
+
+  if (isNameLsaDeltaContent(content)) {
+    NameLsaDelta delta;
+    if (decodeLsaContent(delta, content) && delta.getShard() == shard) {
+      installNameLsaDelta(delta);
+    }
+    else {
+      NLSR_LOG_DEBUG("LSA data decoding error :(");
+    }
+  }
+  else {
     NameLsa nameLsa;
-    if (nameLsa.deserialize(dataContent)) {
+    if (decodeLsaContent(nameLsa, content) && nameLsa.getShard() == shard) {
       installNameLsa(nameLsa);
     }
     else {
@@ -1222,12 +1683,12 @@ Lsdb::processContentNameLsa(const ndn::Name& lsaKey,
 
 void
 Lsdb::processContentAdjacencyLsa(const ndn::Name& lsaKey,
-                                 uint64_t lsSeqNo, std::string& dataContent)
+                                 uint64_t lsSeqNo, const ndn::Block& content)
 {
   lsaIncrementSignal(Statistics::PacketType::RCV_ADJ_LSA_DATA);
   if (isAdjLsaNew(lsaKey, lsSeqNo)) {
     AdjLsa adjLsa;
-    if (adjLsa.deserialize(dataContent)) {
+    if (decodeLsaContent(adjLsa, content)) {
       installAdjLsa(adjLsa);
     }
     else {
@@ -1238,12 +1699,12 @@ Lsdb::processContentAdjacencyLsa(const ndn::Name& lsaKey,
 
 void
 Lsdb::processContentCoordinateLsa(const ndn::Name& lsaKey,
-                                  uint64_t lsSeqNo, std::string& dataContent)
+                                  uint64_t lsSeqNo, const ndn::Block& content)
 {
   lsaIncrementSignal(Statistics::PacketType::RCV_COORD_LSA_DATA);
   if (isCoordinateLsaNew(lsaKey, lsSeqNo)) {
     CoordinateLsa corLsa;
-    if (corLsa.deserialize(dataContent)) {
+    if (decodeLsaContent(corLsa, content)) {
       installCoordinateLsa(corLsa);
     }
     else {
@@ -1265,11 +1726,90 @@ void
 Lsdb::writeAdjLsdbLog()
 {
   NLSR_LOG_DEBUG("---------------Adj LSDB-------------------");
+  NLSR_LOG_DEBUG("Adjacency LSA builds: " << m_adjLsaBuildThrottle.getStatistics());
   for (const auto& adj : m_adjLsdb) {
     adj.writeLog();
   }
 }
 
+size_t
+Lsdb::loadSnapshot()
+{
+  if (m_confParam.getLsdbSnapshotInterval() == 0) {
+    return 0;
+  }
+  scheduleSnapshotWrite();
+
+  LsdbSnapshot::Contents contents;
+  try {
+    contents = m_snapshot.read();
+  }
+  catch (const LsdbSnapshot::Error& e) {
+    NLSR_LOG_WARN("Not preloading the LSDB: " << e.what());
+    return 0;
+  }
+  NLSR_LOG_INFO("Preloading the LSDB from the snapshot written at "
+                << ndn::time::toIsoString(contents.writtenAt));
+
+  // LSAs that have expired since the snapshot was written are left out, and this router
+  // builds its own name and coordinate LSAs again. Its Adj LSA stands in for the one built
+  // from hellos, which the link-state routes cannot be calculated without.
+  auto now = ndn::time::system_clock::now();
+  auto isPreloadable = [&] (const Lsa& lsa) {
+    return lsa.getExpirationTimePoint() > now &&
+           (lsa.getOrigRouter() != m_confParam.getRouterPrefix() ||
+            lsa.getType() == Lsa::Type::ADJACENCY) &&
+           !doesLsaExist(lsa.getKey(), lsa.getType());
+  };
+
+  size_t nPreloaded = 0;
+  for (auto& lsa : contents.nameLsas) {
+    if (isPreloadable(lsa)) {
+      lsa.setProvisional(true);
+      installNameLsa(lsa);
+      ++nPreloaded;
+    }
+  }
+  for (auto& lsa : contents.adjLsas) {
+    if (isPreloadable(lsa)) {
+      lsa.setProvisional(true);
+      installAdjLsa(lsa);
+      ++nPreloaded;
+    }
+  }
+  for (auto& lsa : contents.coordinateLsas) {
+    if (isPreloadable(lsa)) {
+      lsa.setProvisional(true);
+      installCoordinateLsa(lsa);
+      ++nPreloaded;
+    }
+  }
+
+  NLSR_LOG_INFO("Preloaded " << nPreloaded << " provisional LSAs");
+  return nPreloaded;
+}
+
+void
+Lsdb::writeSnapshot()
+{
+  try {
+    m_snapshot.write(m_nameLsdb, m_adjLsdb, m_corLsdb, m_confParam.getRouterPrefix());
+  }
+  catch (const LsdbSnapshot::Error& e) {
+    NLSR_LOG_ERROR("Cannot write the LSDB snapshot: " << e.what());
+  }
+}
+
+void
+Lsdb::scheduleSnapshotWrite()
+{
+  m_snapshotEvent = m_scheduler.schedule(ndn::time::seconds(m_confParam.getLsdbSnapshotInterval()),
+                                         [this] {
+                                           writeSnapshot();
+                                           scheduleSnapshotWrite();
+                                         });
+}
+
 //-----utility function -----
 bool
 Lsdb::doesLsaExist(const ndn::Name& key, const Lsa::Type& lsType)
@@ -1288,9 +1828,9 @@ Lsdb::doesLsaExist(const ndn::Name& key, const Lsa::Type& lsType)
 
 bool
 Lsdb::isLsaNew(const ndn::Name& routerName, const Lsa::Type& lsaType,
-               const uint64_t& sequenceNumber) {
+               const uint64_t& sequenceNumber, uint32_t shard) {
   ndn::Name lsaKey = routerName;
-  lsaKey.append(std::to_string(lsaType));
+  lsaKey.append(makeLsaTypeComponent(lsaType, shard));
 
   switch (lsaType) {
   case Lsa::Type::ADJACENCY:
@@ -24,10 +24,13 @@
 
 #include "conf-parameter.hpp"
 #include "lsa.hpp"
+#include "lsdb-snapshot.hpp"
 #include "sequencing-manager.hpp"
 #include "test-access-control.hpp"
 #include "communication/sync-logic-handler.hpp"
 #include "statistics.hpp"
+#include "throttle.hpp"
+#include "timer-wheel.hpp"
 #include "route/name-prefix-table.hpp"
 
 #include <ndn-cxx/security/key-chain.hpp>
@@ -38,6 +41,10 @@
 
 #include <PSync/segment-publisher.hpp>
 
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
 #include <utility>
 #include <boost/cstdint.hpp>
 
@@ -52,23 +59,41 @@ public:
 
   ~Lsdb();
 
+  /*! \brief Returns whether a sequence number from sync signals a new LSA.
+    \param shard The shard of a name LSA, 0 for the other LSA types.
+   */
   bool
-  isLsaNew(const ndn::Name& routerName, const Lsa::Type& lsaType, const uint64_t& sequenceNumber);
+  isLsaNew(const ndn::Name& routerName, const Lsa::Type& lsaType, const uint64_t& sequenceNumber,
+           uint32_t shard = 0);
 
   bool
   doesLsaExist(const ndn::Name& key, const Lsa::Type& lsType);
 
   /*! \brief Builds a name LSA for this router and then installs it
       into the LSDB.
+
+      When the names are split across several shards, only the shards whose names have
+      changed are built again.
   */
   bool
   buildAndInstallOwnNameLsa();
 
   /*! \brief Returns the name LSA with the given key.
     \param key The name of the router that the desired LSA comes from.
+
+    The LSA can only be changed through modifyNameLsa().
+  */
+  const NameLsa*
+  findNameLsa(const ndn::Name& key) const;
+
+  /*! \brief Changes the name LSA with the given key in place.
+    \param key The name of the router that the LSA comes from.
+    \param modifier Changes the LSA. It must keep the originating router and the shard,
+           by which the LSDB is indexed.
+    \return false if there is no such LSA.
   */
-  NameLsa*
-  findNameLsa(const ndn::Name& key);
+  bool
+  modifyNameLsa(const ndn::Name& key, const std::function<void(NameLsa&)>& modifier);
 
   /*! \brief Installs a name LSA into the LSDB
     \param nlsa The name LSA to install into the LSDB.
@@ -76,6 +101,13 @@ public:
   bool
   installNameLsa(NameLsa& nlsa);
 
+  /*! \brief Brings the name LSA of a router up to date with a delta.
+    \retval false The LSDB does not hold the name LSA the delta is based on, so the whole
+            name LSA has to be fetched instead.
+   */
+  bool
+  installNameLsaDelta(const NameLsaDelta& delta);
+
   /*! \brief Remove a name LSA from the LSDB.
     \param key The name of the router that published the LSA to remove.
 
@@ -96,7 +128,7 @@ public:
   void
   writeNameLsdbLog();
 
-  const std::list<NameLsa>&
+  const NameLsaContainer&
   getNameLsdb() const;
 
   /*! \brief Builds a cor. LSA for this router and installs it into the LSDB. */
@@ -105,9 +137,21 @@ public:
 
   /*! \brief Finds a cor. LSA in the LSDB.
     \param key The name of the originating router that published the LSA.
+
+    The LSA can only be changed through modifyCoordinateLsa().
+  */
+  const CoordinateLsa*
+  findCoordinateLsa(const ndn::Name& key) const;
+
+  /*! \brief Changes a cor. LSA in place.
+    \param key The name of the originating router that published the LSA.
+    \param modifier Changes the LSA. It must keep the originating router, by which the LSDB
+           is indexed.
+    \return false if there is no such LSA.
   */
-  CoordinateLsa*
-  findCoordinateLsa(const ndn::Name& key);
+  bool
+  modifyCoordinateLsa(const ndn::Name& key,
+                      const std::function<void(CoordinateLsa&)>& modifier);
 
   /*! \brief Installs a cor. LSA into the LSDB.
     \param clsa The cor. LSA to install.
@@ -135,7 +179,7 @@ public:
   void
   writeCorLsdbLog();
 
-  const std::list<CoordinateLsa>&
+  const CoordinateLsaContainer&
   getCoordinateLsdb() const;
 
   //function related to Adj LSDB
@@ -172,22 +216,53 @@ public:
 
   /*! \brief Finds an adj. LSA in the LSDB.
     \param key The name of the publishing router whose LSA to find.
+
+    The LSA can only be changed through modifyAdjLsa().
    */
-  AdjLsa*
-  findAdjLsa(const ndn::Name& key);
+  const AdjLsa*
+  findAdjLsa(const ndn::Name& key) const;
+
+  /*! \brief Changes an adj. LSA in place.
+    \param key The name of the publishing router whose LSA to change.
+    \param modifier Changes the LSA. It must keep the originating router, by which the LSDB
+           is indexed.
+    \return false if there is no such LSA.
+   */
+  bool
+  modifyAdjLsa(const ndn::Name& key, const std::function<void(AdjLsa&)>& modifier);
 
-  const std::list<AdjLsa>&
+  const AdjLsaContainer&
   getAdjLsdb() const;
 
+  /*! \brief Sets the longest time an adj. LSA build is held down for, in seconds. */
   void
   setAdjLsaBuildInterval(uint32_t interval)
   {
     m_adjLsaBuildInterval = ndn::time::seconds(interval);
+    m_adjLsaBuildThrottle.setDelays(ndn::time::milliseconds(m_confParam.getAdjLsaBuildInitialDelay()),
+                                    ndn::time::milliseconds(m_confParam.getAdjLsaBuildHoldDelay()),
+                                    m_adjLsaBuildInterval);
+  }
+
+  const Throttle&
+  getAdjLsaBuildThrottle() const
+  {
+    return m_adjLsaBuildThrottle;
   }
 
   void
   writeAdjLsdbLog();
 
+  /*! \brief Fetches an LSA.
+    \param interestName The name of the LSA followed by its sequence number.
+    \param timeoutCount The number of fetches of this LSA that have failed before.
+
+    At most one fetch is in flight for the LSAs of one type from one router. A fetch of a
+    higher sequence number stops the one in flight, and a fetch of the sequence number in
+    flight is dropped unless it retries a failed fetch. Once the configured number of
+    fetches are in flight, fetches wait in a queue, where a later sequence number takes the
+    place of an earlier one.
+   */
   void
   expressInterest(const ndn::Name& interestName, uint32_t timeoutCount,
                   ndn::time::steady_clock::TimePoint deadline = DEFAULT_LSA_RETRIEVAL_DEADLINE);
@@ -212,6 +287,25 @@ public:
     return m_sync;
   }
 
+  /*! \brief Preloads the LSAs of the snapshot, and starts writing it periodically.
+    \return The number of LSAs preloaded.
+
+    Does nothing when the snapshot interval is 0. The LSAs that have not expired are
+    installed as provisional, so that routes are calculated from them right away; sync then
+    only has to fetch the LSAs that have changed since. A preloaded LSA expires at the time
+    its origin router gave it, as if it had been fetched.
+
+    This router's own Adj LSA is preloaded as well, so that routes are calculated before
+    its neighbors answer hellos. It is replaced by the first Adj LSA built from the hellos,
+    and is removed rather than refreshed if it expires first.
+   */
+  size_t
+  loadSnapshot();
+
+  /*! \brief Writes the LSAs of other routers to the snapshot. */
+  void
+  writeSnapshot();
+
 private:
   /* \brief Add a name LSA to the LSDB if it isn't already there.
      \param nlsa The candidade name LSA.
@@ -259,12 +353,12 @@ private:
   bool
   doesAdjLsaExist(const ndn::Name& key);
 
-  /*! \brief Schedules a refresh/expire event in the scheduler.
+  /*! \brief Schedules a refresh/expire event in the timer wheel.
     \param key The name of the router that published the LSA.
     \param seqNo The seq. no. associated with the LSA.
     \param expTime How many seconds to wait before triggering the event.
    */
-  ndn::scheduler::EventId
+  TimerWheel::EventId
   scheduleNameLsaExpiration(const ndn::Name& key, int seqNo,
                             const ndn::time::seconds& expTime);
 
@@ -281,7 +375,7 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
     \param seqNo The sequence number of the LSA to check.
     \param expTime The number of seconds to wait before triggering the event.
   */
-  ndn::scheduler::EventId
+  TimerWheel::EventId
   scheduleAdjLsaExpiration(const ndn::Name& key, int seqNo,
                            const ndn::time::seconds& expTime);
 
@@ -289,7 +383,7 @@ private:
   void
   expireOrRefreshAdjLsa(const ndn::Name& lsaKey, uint64_t seqNo);
 
-  ndn::scheduler::EventId
+  TimerWheel::EventId
   scheduleCoordinateLsaExpiration(const ndn::Name& key, int seqNo,
                                   const ndn::time::seconds& expTime);
 
@@ -297,11 +391,39 @@ private:
   expireOrRefreshCoordinateLsa(const ndn::Name& lsaKey,
                                uint64_t seqNo);
 
+  void
+  scheduleSnapshotWrite();
+
   void
   processInterestForNameLsa(const ndn::Interest& interest,
                             const ndn::Name& lsaKey,
                             uint64_t seqNo);
 
+  /*! \brief Sends the changes of this router's name LSA since a sequence number, or the
+    whole name LSA if they are no longer known.
+   */
+  void
+  processInterestForNameLsaDelta(const ndn::Interest& interest,
+                                 const ndn::Name& lsaKey,
+                                 uint64_t seqNo,
+                                 uint64_t baseSeqNo);
+
+  /*! \brief Keeps a change of this router's name LSA, to serve it as part of deltas. */
+  void
+  recordOwnNameLsaDelta(NameLsaDelta delta);
+
+  /*! \brief Builds and installs one shard of this router's name LSA, with the next sequence
+    number of the name LSA.
+   */
+  bool
+  buildAndInstallOwnNameLsaShard(uint32_t shard, NamePrefixList& names);
+
+  /*! \brief Returns whether another shard of the router that published a name LSA
+    advertises a name too, in which case the name stays in the NPT.
+   */
+  bool
+  isNameInOtherShard(const NameLsa& nameLsa, const ndn::Name& name) const;
+
   void
   processInterestForAdjacencyLsa(const ndn::Interest& interest,
                                  const ndn::Name& lsaKey,
@@ -317,15 +439,15 @@ private:
 
   void
   processContentNameLsa(const ndn::Name& lsaKey,
-                        uint64_t lsSeqNo, std::string& dataContent);
+                        uint64_t lsSeqNo, const ndn::Block& content);
 
   void
   processContentAdjacencyLsa(const ndn::Name& lsaKey,
-                             uint64_t lsSeqNo, std::string& dataContent);
+                             uint64_t lsSeqNo, const ndn::Block& content);
 
   void
   processContentCoordinateLsa(const ndn::Name& lsaKey,
-                              uint64_t lsSeqNo, std::string& dataContent);
+                              uint64_t lsSeqNo, const ndn::Block& content);
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   /*!
@@ -360,12 +482,35 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   afterFetchLsa(const ndn::ConstBufferPtr& data, const ndn::Name& interestName);
 
+private:
+  void
+  startFetch(const ndn::Name& interestName, uint32_t timeoutCount,
+             const ndn::time::steady_clock::TimePoint& deadline);
+
+  /*! \brief Forgets a fetch that has ended, and starts the queued fetches it makes room for.
+    \param fetcher The fetcher that has ended, which is only forgotten if it is still the
+           one in flight for the LSA, and has not been superseded.
+   */
+  void
+  endFetch(const ndn::Name& lsaName, const ndn::util::SegmentFetcher* fetcher);
+
 private:
   ndn::time::system_clock::TimePoint
   getLsaExpirationTimePoint();
 
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /*! \brief Composes the delta that leads from one of this router's name LSAs to a later one.
+    \retval false The changes since baseSeqNo are no longer all known.
+   */
+  bool
+  getOwnNameLsaDelta(uint32_t shard, uint64_t baseSeqNo, uint64_t seqNo,
+                     NameLsaDelta& delta) const;
+
 public:
   static const ndn::Name::Component NAME_COMPONENT;
+  // Interests for a name LSA delta are named /<LSA name>/delta/<base seqNo>/<seqNo>, apart
+  // from the whole LSAs, so that an Interest for a whole LSA never matches a delta
+  static const ndn::Name::Component DELTA_COMPONENT;
 
   ndn::util::signal::Signal<Lsdb, Statistics::PacketType> lsaIncrementSignal;
   ndn::util::signal::Signal<Lsdb, const ndn::Data&> afterSegmentValidatedSignal;
@@ -373,6 +518,8 @@ public:
 private:
   ndn::Face& m_face;
   ndn::Scheduler m_scheduler;
+  // Keeps the lifetimes of the LSAs and of the stored LSA segments
+  TimerWheel m_timerWheel;
   ndn::security::SigningInfo& m_signingInfo;
 
   ConfParameter& m_confParam;
@@ -383,9 +530,9 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   SyncLogicHandler m_sync;
 
 private:
-  std::list<NameLsa> m_nameLsdb;
-  std::list<AdjLsa> m_adjLsdb;
-  std::list<CoordinateLsa> m_corLsdb;
+  NameLsaContainer m_nameLsdb;
+  AdjLsaContainer m_adjLsdb;
+  CoordinateLsaContainer m_corLsdb;
 
   ndn::time::seconds m_lsaRefreshTime;
   std::string m_thisRouterPrefix;
@@ -399,20 +546,53 @@ private:
   static const ndn::time::seconds GRACE_PERIOD;
   static const ndn::time::steady_clock::TimePoint DEFAULT_LSA_RETRIEVAL_DEADLINE;
 
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  // The latest changes of each shard of this router's name LSA, each based on the one before
+  std::map<uint32_t, std::deque<NameLsaDelta>> m_ownNameLsaDeltas;
+  static const size_t NAME_LSA_DELTA_HISTORY;
+
+  // The keys of the name LSAs to fetch in full next time, as a delta could not be fetched
+  // or installed
+  std::set<ndn::Name> m_fullNameLsaFetches;
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   ndn::time::seconds m_adjLsaBuildInterval;
+  Throttle m_adjLsaBuildThrottle;
 
   SequencingManager m_sequencingManager;
+  LsdbSnapshot m_snapshot;
 
 private:
   ndn::util::signal::ScopedConnection m_onNewLsaConnection;
 
-  std::set<std::shared_ptr<ndn::util::SegmentFetcher>> m_fetchers;
+  struct LsaFetch
+  {
+    std::shared_ptr<ndn::util::SegmentFetcher> fetcher;
+    uint64_t seqNo;
+  };
+
+  struct QueuedLsaFetch
+  {
+    ndn::Name interestName;
+    uint32_t timeoutCount;
+    ndn::time::steady_clock::TimePoint deadline;
+  };
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  // The fetches in flight and the queued fetches, by the name of the LSA, which identifies
+  // both the originating router and the type of the LSA
+  std::map<ndn::Name, LsaFetch> m_fetches;
+  std::map<ndn::Name, QueuedLsaFetch> m_queuedFetches;
+  std::deque<ndn::Name> m_fetchQueue;
+
+private:
   psync::SegmentPublisher m_segmentPublisher;
 
   bool m_isBuildAdjLsaSheduled;
   int64_t m_adjBuildCount;
 
+  ndn::scheduler::EventId m_snapshotEvent;
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   ndn::InMemoryStoragePersistent m_lsaStorage;
 };
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#include "name-pool.hpp"
+
+#include <iostream>
+
+namespace nlsr {
+
+NamePool&
+NamePool::getInstance()
+{
+  // Never destroyed, so that handles in static objects can outlive it at exit
+  static NamePool* pool = new NamePool;
+  return *pool;
+}
+
+InternedName
+NamePool::intern(const ndn::Name& name)
+{
+  if (name.empty()) {
+    return InternedName();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(name);
+  if (it == m_entries.end()) {
+    it = m_entries.emplace(name, ++m_lastId).first;
+  }
+  it->nReferences.fetch_add(1, std::memory_order_relaxed);
+  return InternedName(&*it);
+}
+
+size_t
+NamePool::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+void
+NamePool::addReference(const Entry* entry)
+{
+  // The caller holds a reference, so the entry cannot leave the pool meanwhile
+  entry->nReferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+NamePool::removeReference(const Entry* entry)
+{
+  // Dropping a reference that is not the last one does not need the lock
+  size_t nReferences = entry->nReferences.load(std::memory_order_relaxed);
+  while (nReferences > 1) {
+    if (entry->nReferences.compare_exchange_weak(nReferences, nReferences - 1,
+                                                 std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+
+  // The last reference is dropped under the lock, so that intern() cannot revive the entry
+  // while it is being erased
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (entry->nReferences.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    m_entries.erase(m_entries.iterator_to(*entry));
+  }
+}
+
+const ndn::Name&
+InternedName::getEmptyName()
+{
+  static const ndn::Name emptyName;
+  return emptyName;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const InternedName& name)
+{
+  return os << name.get();
+}
+
+} // namespace nlsr
@@ -0,0 +1,298 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#ifndef NLSR_NAME_POOL_HPP
+#define NLSR_NAME_POOL_HPP
+
+#include <atomic>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <ndn-cxx/name.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+
+namespace nlsr {
+
+class InternedName;
+
+/*! \brief A pool of names shared by the LSDB, the routing table, the NPT and the FIB.
+
+  The same router names and name prefixes appear in every LSA that mentions them, and again
+  in the map, the routing table, the name prefix table and the FIB. The pool keeps one copy
+  of each of these names, which the tables refer to through InternedName handles. A name
+  stays in the pool for as long as a handle refers to it.
+
+  The pool can be used from several threads, as the routing table is calculated on worker
+  threads from copies of the LSDB.
+ */
+class NamePool : boost::noncopyable
+{
+public:
+  struct Entry
+  {
+    Entry(const ndn::Name& name, uint64_t id)
+      : name(name)
+      , hash(std::hash<ndn::Name>()(name))
+      , id(id)
+    {
+    }
+
+    ndn::Name name;
+    size_t hash;
+    uint64_t id;
+    mutable std::atomic<size_t> nReferences{0};
+  };
+
+  /*! \brief Returns the pool that InternedName uses. */
+  static NamePool&
+  getInstance();
+
+  /*! \brief Returns a handle to a name, adding the name to the pool if it is not there. */
+  InternedName
+  intern(const ndn::Name& name);
+
+  /*! \brief Returns the number of different names in the pool. */
+  size_t
+  size() const;
+
+private:
+  void
+  addReference(const Entry* entry);
+
+  void
+  removeReference(const Entry* entry);
+
+private:
+  using EntryContainer = boost::multi_index::multi_index_container<
+    Entry,
+    boost::multi_index::indexed_by<
+      boost::multi_index::hashed_unique<
+        boost::multi_index::member<Entry, ndn::Name, &Entry::name>,
+        std::hash<ndn::Name>>
+      >
+    >;
+
+  mutable std::mutex m_mutex;
+  EntryContainer m_entries;
+  uint64_t m_lastId = 0;
+
+  friend class InternedName;
+};
+
+/*! \brief A handle to a name in the NamePool.
+
+  A handle takes the space of a pointer, and copying it does not copy the name. Two handles
+  are equal exactly when they refer to the same pool entry, so that comparing them, and
+  hashing them, does not look at the name components. The empty name is not stored in the
+  pool; it is what a default-constructed handle refers to.
+ */
+class InternedName
+{
+public:
+  InternedName() noexcept = default;
+
+  InternedName(const ndn::Name& name)
+    : InternedName(NamePool::getInstance().intern(name))
+  {
+  }
+
+  InternedName(const char* uri)
+    : InternedName(ndn::Name(uri))
+  {
+  }
+
+  InternedName(const InternedName& other) noexcept
+    : m_entry(other.m_entry)
+  {
+    if (m_entry != nullptr) {
+      NamePool::getInstance().addReference(m_entry);
+    }
+  }
+
+  InternedName(InternedName&& other) noexcept
+    : m_entry(other.m_entry)
+  {
+    other.m_entry = nullptr;
+  }
+
+  ~InternedName()
+  {
+    if (m_entry != nullptr) {
+      NamePool::getInstance().removeReference(m_entry);
+    }
+  }
+
+  InternedName&
+  operator=(InternedName other) noexcept
+  {
+    std::swap(m_entry, other.m_entry);
+    return *this;
+  }
+
+  const ndn::Name&
+  get() const
+  {
+    return m_entry != nullptr ? m_entry->name : getEmptyName();
+  }
+
+  operator const ndn::Name&() const
+  {
+    return get();
+  }
+
+  /*! \brief Returns a number that identifies the name among the names in the pool.
+
+    The empty name is 0. Numbers are never given to another name: a name that leaves the
+    pool and is added again gets a new number.
+   */
+  uint64_t
+  getId() const
+  {
+    return m_entry != nullptr ? m_entry->id : 0;
+  }
+
+  /*! \brief Returns the hash of the name, computed when it entered the pool. */
+  size_t
+  getHash() const
+  {
+    return m_entry != nullptr ? m_entry->hash : 0;
+  }
+
+  friend bool
+  operator==(const InternedName& lhs, const InternedName& rhs)
+  {
+    return lhs.m_entry == rhs.m_entry;
+  }
+
+  friend bool
+  operator<(const InternedName& lhs, const InternedName& rhs)
+  {
+    return lhs.m_entry != rhs.m_entry && lhs.get() < rhs.get();
+  }
+
+private:
+  explicit
+  InternedName(const NamePool::Entry* entry) noexcept
+    : m_entry(entry)
+  {
+  }
+
+  static const ndn::Name&
+  getEmptyName();
+
+private:
+  const NamePool::Entry* m_entry = nullptr;
+
+  friend class NamePool;
+};
+
+inline bool
+operator!=(const InternedName& lhs, const InternedName& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// The mixed comparisons spare looking the name up in the pool, and keep comparisons with an
+// ndn::Name from being ambiguous
+
+inline bool
+operator==(const InternedName& lhs, const ndn::Name& rhs)
+{
+  return lhs.get() == rhs;
+}
+
+inline bool
+operator==(const ndn::Name& lhs, const InternedName& rhs)
+{
+  return lhs == rhs.get();
+}
+
+inline bool
+operator!=(const InternedName& lhs, const ndn::Name& rhs)
+{
+  return lhs.get() != rhs;
+}
+
+inline bool
+operator!=(const ndn::Name& lhs, const InternedName& rhs)
+{
+  return lhs != rhs.get();
+}
+
+inline bool
+operator<(const InternedName& lhs, const ndn::Name& rhs)
+{
+  return lhs.get() < rhs;
+}
+
+inline bool
+operator<(const ndn::Name& lhs, const InternedName& rhs)
+{
+  return lhs < rhs.get();
+}
+
+std::ostream&
+operator<<(std::ostream& os, const InternedName& name);
+
+/*! \brief Hashes a name the same whether or not it is interned.
+
+  An InternedName is hashed with the hash computed when it entered the pool, so that a hashed
+  index keyed on InternedName does not look at the name components. A plain ndn::Name can
+  still be looked up in such an index, with std::equal_to<>, without interning it.
+ */
+struct InternedNameHash
+{
+  size_t
+  operator()(const ndn::Name& name) const
+  {
+    return std::hash<ndn::Name>()(name);
+  }
+
+  size_t
+  operator()(const InternedName& name) const
+  {
+    return name.get().empty() ? (*this)(name.get()) : name.getHash();
+  }
+};
+
+} // namespace nlsr
+
+namespace std {
+
+template<>
+struct hash<nlsr::InternedName>
+{
+  size_t
+  operator()(const nlsr::InternedName& name) const noexcept
+  {
+    return name.getHash();
+  }
+};
+
+} // namespace std
+
+#endif // NLSR_NAME_POOL_HPP
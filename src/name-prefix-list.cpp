@@ -1,6 +1,6 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 /**
- * Copyright (c) 2014-2018,  The University of Memphis,
+ * Copyright (c) 2014-2019,  The University of Memphis,
  *                           Regents of the University of California,
  *                           Arizona Board of Regents.
  *
@@ -24,63 +24,95 @@
 
 #include <iostream>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 
 namespace nlsr {
 
+namespace {
+
+// The sources of all the lists, which LSAs copied to the routing calculation threads use too
+struct SourceTable
+{
+  std::mutex mutex;
+  std::deque<std::string> sources;
+  std::unordered_map<std::string, uint32_t> ids;
+};
+
+SourceTable&
+getSourceTable()
+{
+  // Never destroyed, like the name pool, so that lists in static objects can outlive it
+  static SourceTable* table = new SourceTable;
+  return *table;
+}
+
+} // anonymous namespace
+
 NamePrefixList::NamePrefixList() = default;
 
 NamePrefixList::NamePrefixList(const std::initializer_list<ndn::Name>& names)
 {
-  std::vector<NamePrefixList::NamePair> namePairs;
-  std::transform(names.begin(), names.end(), std::back_inserter(namePairs),
-    [] (const ndn::Name& name) {
-      return NamePrefixList::NamePair{name, {""}};
-    });
-  m_names = std::move(namePairs);
+  for (const auto& name : names) {
+    insert(name);
+  }
 }
 
 NamePrefixList::NamePrefixList(const std::initializer_list<NamePrefixList::NamePair>& namesAndSources)
-  : m_names(namesAndSources)
 {
+  for (const auto& namePair : namesAndSources) {
+    for (const auto& source : std::get<NamePrefixList::NamePairIndex::SOURCES>(namePair)) {
+      insert(std::get<NamePrefixList::NamePairIndex::NAME>(namePair), source);
+    }
+  }
 }
 
 NamePrefixList::~NamePrefixList()
 {
 }
 
-std::vector<NamePrefixList::NamePair>::iterator
-NamePrefixList::get(const ndn::Name& name)
+NamePrefixList::EntryContainer::const_iterator
+NamePrefixList::get(const ndn::Name& name) const
 {
-  return std::find_if(m_names.begin(), m_names.end(),
-                      [&] (const NamePrefixList::NamePair& pair) {
-                        return name == std::get<NamePrefixList::NamePairIndex::NAME>(pair);
-                      });
+  const auto& index = m_names.get<1>();
+  return m_names.project<0>(index.find(name, InternedNameHash(), std::equal_to<>()));
 }
 
-std::vector<std::string>::iterator
-NamePrefixList::getSource(const std::string& source, std::vector<NamePair>::iterator& entry)
+uint32_t
+NamePrefixList::getSourceId(const std::string& source)
+{
+  SourceTable& table = getSourceTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto it = table.ids.find(source);
+  if (it == table.ids.end()) {
+    it = table.ids.emplace(source, table.sources.size()).first;
+    table.sources.push_back(source);
+  }
+  return it->second;
+}
+
+std::string
+NamePrefixList::getSourceName(uint32_t sourceId)
 {
-  return std::find_if(std::get<NamePairIndex::SOURCES>(*entry).begin(),
-                      std::get<NamePairIndex::SOURCES>(*entry).end(),
-                      [&] (const std::string& containerSource) {
-                        return source == containerSource;
-                      });
+  SourceTable& table = getSourceTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  return table.sources.at(sourceId);
 }
 
 bool
 NamePrefixList::insert(const ndn::Name& name, const std::string& source)
 {
-  auto pairItr = get(name);
-  if (pairItr == m_names.end()) {
-    std::vector<std::string> sources{source};
-    m_names.push_back(std::tie(name, sources));
+  uint32_t sourceId = getSourceId(source);
+  auto entry = get(name);
+  if (entry == m_names.end()) {
+    m_names.push_back(Entry{name, {sourceId}});
     return true;
   }
   else {
-    std::vector<std::string>& sources = std::get<NamePrefixList::NamePairIndex::SOURCES>(*pairItr);
-    auto sourceItr = getSource(source, pairItr);
-    if (sourceItr == sources.end()) {
-      sources.push_back(source);
+    std::vector<uint32_t>& sources = entry->sources;
+    if (std::find(sources.begin(), sources.end(), sourceId) == sources.end()) {
+      sources.push_back(sourceId);
       return true;
     }
   }
@@ -90,14 +122,14 @@ NamePrefixList::insert(const ndn::Name& name, const std::string& source)
 bool
 NamePrefixList::remove(const ndn::Name& name, const std::string& source)
 {
-  auto pairItr = get(name);
-  if (pairItr != m_names.end()) {
-    std::vector<std::string>& sources = std::get<NamePrefixList::NamePairIndex::SOURCES>(*pairItr);
-    auto sourceItr = getSource(source, pairItr);
+  auto entry = get(name);
+  if (entry != m_names.end()) {
+    std::vector<uint32_t>& sources = entry->sources;
+    auto sourceItr = std::find(sources.begin(), sources.end(), getSourceId(source));
     if (sourceItr != sources.end()) {
       sources.erase(sourceItr);
       if (sources.size() == 0) {
-        m_names.erase(pairItr);
+        m_names.erase(entry);
       }
       return true;
     }
@@ -108,50 +140,50 @@ NamePrefixList::remove(const ndn::Name& name, const std::string& source)
 bool
 NamePrefixList::operator==(const NamePrefixList& other) const
 {
-  return m_names == other.m_names;
+  return std::equal(m_names.begin(), m_names.end(), other.m_names.begin(), other.m_names.end(),
+                    [] (const Entry& lhs, const Entry& rhs) {
+                      return lhs.name == rhs.name && lhs.sources == rhs.sources;
+                    });
 }
 
 void
 NamePrefixList::sort()
 {
-  std::sort(m_names.begin(), m_names.end());
+  m_names.sort([] (const Entry& lhs, const Entry& rhs) {
+    return lhs.name.get() < rhs.name.get();
+  });
 }
 
 std::list<ndn::Name>
 NamePrefixList::getNames() const
 {
-  std::list<ndn::Name> names;
-  for (const auto& namePair : m_names) {
-    names.push_back(std::get<NamePrefixList::NamePairIndex::NAME>(namePair));
-  }
-  return names;
+  return std::list<ndn::Name>(begin(), end());
 }
 
 uint32_t
 NamePrefixList::countSources(const ndn::Name& name) const
 {
-  return getSources(name).size();
+  auto entry = get(name);
+  return entry != m_names.end() ? entry->sources.size() : 0;
 }
 
 const std::vector<std::string>
 NamePrefixList::getSources(const ndn::Name& name) const
 {
-  auto it = std::find_if(m_names.begin(), m_names.end(),
-                         [&] (const NamePrefixList::NamePair& pair) {
-                           return name == std::get<NamePrefixList::NamePairIndex::NAME>(pair);
-                         });
-  if (it != m_names.end()) {
-    return std::get<NamePrefixList::NamePairIndex::SOURCES>(*it);
-  }
-  else {
-    return std::vector<std::string>{};
+  std::vector<std::string> sources;
+  auto entry = get(name);
+  if (entry != m_names.end()) {
+    for (uint32_t sourceId : entry->sources) {
+      sources.push_back(getSourceName(sourceId));
+    }
   }
+  return sources;
 }
 
 std::ostream&
 operator<<(std::ostream& os, const NamePrefixList& list) {
   os << "Name prefix list: {\n";
-  for (const auto& name : list.getNames()) {
+  for (const ndn::Name& name : list) {
     os << name << "\n"
        << "Sources:\n";
     for (const auto& source : list.getSources(name)) {
@@ -22,22 +22,69 @@
 #ifndef NLSR_NAME_PREFIX_LIST_HPP
 #define NLSR_NAME_PREFIX_LIST_HPP
 
+#include "name-pool.hpp"
+
 #include <list>
 #include <string>
 #include <boost/cstdint.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 #include <ndn-cxx/name.hpp>
 
 
 namespace nlsr {
+
+/*! \brief The names a router advertises, each with the sources that advertise it.
+
+  The names are kept in the order they were inserted, and are also hashed, so that looking
+  a name up, inserting it and removing it do not depend on the number of names. Sources are
+  kept as small numbers that stand for their strings, as only a few different sources exist.
+ */
 class NamePrefixList
 {
 public:
-  using NamePair = std::tuple<ndn::Name, std::vector<std::string>>;
+  // The names are interned, as every Name LSA of a prefix, and the NPT, share them
+  using NamePair = std::tuple<InternedName, std::vector<std::string>>;
   enum NamePairIndex {
     NAME,
     SOURCES
   };
 
+private:
+  struct Entry
+  {
+    InternedName name;
+    // Changing the sources does not move the entry, so they can be changed in place
+    mutable std::vector<uint32_t> sources;
+  };
+
+  struct GetName
+  {
+    const ndn::Name&
+    operator()(const Entry& entry) const
+    {
+      return entry.name.get();
+    }
+  };
+
+  using EntryContainer = boost::multi_index::multi_index_container<
+    Entry,
+    boost::multi_index::indexed_by<
+      boost::multi_index::sequenced<>,
+      boost::multi_index::hashed_unique<
+        boost::multi_index::member<Entry, InternedName, &Entry::name>,
+        InternedNameHash>
+      >
+    >;
+
+public:
+  /*! \brief Iterates over the names of the list, in the order they were inserted. */
+  using const_iterator = boost::transform_iterator<GetName, EntryContainer::const_iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
   NamePrefixList();
 
   NamePrefixList(const std::initializer_list<ndn::Name>& names);
@@ -48,7 +95,7 @@ public:
   NamePrefixList(const ContainerType& names)
   {
     for (const auto& elem : names) {
-      m_names.push_back(NamePair{elem, {""}});
+      insert(elem);
     }
   }
 
@@ -77,6 +124,34 @@ public:
     return m_names.size();
   }
 
+  const_iterator
+  begin() const
+  {
+    return const_iterator(m_names.begin());
+  }
+
+  const_iterator
+  end() const
+  {
+    return const_iterator(m_names.end());
+  }
+
+  const_reverse_iterator
+  rbegin() const
+  {
+    return const_reverse_iterator(end());
+  }
+
+  const_reverse_iterator
+  rend() const
+  {
+    return const_reverse_iterator(begin());
+  }
+
+  /*! \brief Returns a copy of the names.
+
+    Iterating over the list gives the same names without copying them.
+   */
   std::list<ndn::Name>
   getNames() const;
 
@@ -100,19 +175,21 @@ public:
 
 private:
   /*! Obtain an iterator to the entry matching name.
-
-    \note We could do this quite easily inline with a lambda, but this
-    is slightly more efficient.
    */
-  std::vector<NamePair>::iterator
-  get(const ndn::Name& name);
+  EntryContainer::const_iterator
+  get(const ndn::Name& name) const;
+
+  /*! \brief Returns the number that stands for a source, adding the source if it is new.
 
-  /*! Obtain an iterator to a specific source in an entry
+    The numbers are shared by all the lists, and a number is never given to another source.
    */
-  std::vector<std::string>::iterator
-  getSource(const std::string& source, std::vector<NamePair>::iterator& entry);
+  static uint32_t
+  getSourceId(const std::string& source);
+
+  static std::string
+  getSourceName(uint32_t sourceId);
 
-  std::vector<NamePair> m_names;
+  EntryContainer m_names;
 };
 
 std::ostream&
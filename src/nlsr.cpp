@@ -48,7 +48,8 @@ Nlsr::Nlsr(ndn::Face& face, ndn::KeyChain& keyChain, ConfParameter& confParam)
   , m_namePrefixList(confParam.getNamePrefixList())
   , m_validator(m_confParam.getValidator())
   , m_fib(m_face, m_scheduler, m_adjacencyList, m_confParam, m_keyChain)
-  , m_routingTable(m_scheduler, m_fib, m_lsdb, m_namePrefixTable, m_confParam)
+  , m_routingTable(m_face.getIoService(), m_scheduler, m_fib, m_lsdb, m_namePrefixTable,
+                   m_confParam)
   , m_namePrefixTable(m_fib, m_routingTable, m_routingTable.afterRoutingChange)
   , m_lsdb(m_face, m_keyChain, m_signingInfo,
            m_confParam, m_namePrefixTable, m_routingTable)
@@ -265,6 +266,9 @@ Nlsr::initialize()
     m_lsdb.buildAndInstallOwnCoordinateLsa();
   }
 
+  // Routes are calculated from the LSAs of the previous run until sync brings newer ones
+  m_lsdb.loadSnapshot();
+
   registerKeyPrefix();
   registerLocalhostPrefix();
   registerRouterPrefix();
@@ -70,8 +70,8 @@ DatasetInterestHandler::publishAdjStatus(const ndn::Name& topPrefix, const ndn::
 {
   NLSR_LOG_DEBUG("Received interest:  " << interest);
 
-  auto lsaRange = std::make_pair<std::list<AdjLsa>::const_iterator,
-                                 std::list<AdjLsa>::const_iterator>(
+  auto lsaRange = std::make_pair<AdjLsaContainer::const_iterator,
+                                 AdjLsaContainer::const_iterator>(
     m_lsdb.getAdjLsdb().cbegin(), m_lsdb.getAdjLsdb().cend());
   for (auto lsa = lsaRange.first; lsa != lsaRange.second; lsa++) {
     tlv::AdjacencyLsa tlvLsa;
@@ -95,8 +95,8 @@ void
 DatasetInterestHandler::publishCoordinateStatus(const ndn::Name& topPrefix, const ndn::Interest& interest,
                                                 ndn::mgmt::StatusDatasetContext& context)
 {
-  auto lsaRange = std::make_pair<std::list<CoordinateLsa>::const_iterator,
-                                 std::list<CoordinateLsa>::const_iterator>(
+  auto lsaRange = std::make_pair<CoordinateLsaContainer::const_iterator,
+                                 CoordinateLsaContainer::const_iterator>(
     m_lsdb.getCoordinateLsdb().cbegin(), m_lsdb.getCoordinateLsdb().cend());
 
   NLSR_LOG_DEBUG("Received interest:  " << interest);
@@ -118,7 +118,7 @@ void
 DatasetInterestHandler::publishNameStatus(const ndn::Name& topPrefix, const ndn::Interest& interest,
                                           ndn::mgmt::StatusDatasetContext& context)
 {
-  auto lsaRange = std::make_pair<std::list<NameLsa>::const_iterator, std::list<NameLsa>::const_iterator>(
+  auto lsaRange = std::make_pair<NameLsaContainer::const_iterator, NameLsaContainer::const_iterator>(
     m_lsdb.getNameLsdb().cbegin(), m_lsdb.getNameLsdb().cend());
   NLSR_LOG_DEBUG("Received interest:  " << interest);
   for (auto lsa = lsaRange.first; lsa != lsaRange.second; lsa++) {
@@ -127,7 +127,7 @@ DatasetInterestHandler::publishNameStatus(const ndn::Name& topPrefix, const ndn:
     std::shared_ptr<tlv::LsaInfo> tlvLsaInfo = tlv::makeLsaInfo(*lsa);
     tlvLsa.setLsaInfo(*tlvLsaInfo);
 
-    for (const ndn::Name& name : lsa->getNpl().getNames()) {
+    for (const ndn::Name& name : lsa->getNpl()) {
       tlvLsa.addName(name);
     }
 
@@ -21,6 +21,7 @@
 #ifndef NLSR_FIB_ENTRY_HPP
 #define NLSR_FIB_ENTRY_HPP
 
+#include "name-pool.hpp"
 #include "nexthop-list.hpp"
 
 #include <ndn-cxx/util/scheduler.hpp>
@@ -32,7 +33,7 @@ class FibEntry
 public:
   FibEntry() = default;
 
-  FibEntry(const ndn::Name& name)
+  FibEntry(const InternedName& name)
     : m_name(name)
   {
   }
@@ -85,7 +86,7 @@ public:
   end() const;
 
 private:
-  ndn::Name m_name;
+  InternedName m_name;
   ndn::scheduler::EventId m_refreshEventId;
   int32_t m_seqNo = 1;
   NexthopList m_nexthopList;
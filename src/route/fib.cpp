@@ -24,16 +24,24 @@
 #include "logger.hpp"
 #include "nexthop-list.hpp"
 
+#include <ndn-cxx/util/random.hpp>
+
 #include <map>
 #include <cmath>
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <random>
+#include <tuple>
 
 namespace nlsr {
 
 INIT_LOGGER(route.Fib);
 
 const uint64_t Fib::GRACE_PERIOD = 10;
+const size_t Fib::DEFAULT_RIB_COMMAND_WINDOW = 64;
+const ndn::time::milliseconds Fib::REFRESH_BATCH_INTERVAL(100);
+const ndn::time::seconds Fib::REFRESH_DEADLINE_MARGIN(GRACE_PERIOD / 2);
 const std::string Fib::MULTICAST_STRATEGY("ndn:/localhost/nfd/strategy/multicast");
 const std::string Fib::BEST_ROUTE_V2_STRATEGY("ndn:/localhost/nfd/strategy/best-route");
 
@@ -42,8 +50,12 @@ Fib::Fib(ndn::Face& face, ndn::Scheduler& scheduler, AdjacencyList& adjacencyLis
   : m_scheduler(scheduler)
   , m_refreshTime(2 * conf.getLsaRefreshTime())
   , m_controller(face, keyChain)
+  , m_ribCommandWindow(DEFAULT_RIB_COMMAND_WINDOW)
   , m_adjacencyList(adjacencyList)
   , m_confParameter(conf)
+  , m_nextRibCommandOrder(0)
+  , m_nRefreshesInFlight(0)
+  , m_isRefreshBatchScheduled(false)
 {
 }
 
@@ -102,19 +114,21 @@ Fib::update(const ndn::Name& name, const NexthopList& allHops)
     hopsToAdd.addNextHop(*it);
   }
 
-  auto entryIt = m_table.find(name);
+  // The entry and its key share the pooled name
+  InternedName key(name);
+  auto entryIt = m_table.find(key);
 
   // New FIB entry that has nextHops
   if (entryIt == m_table.end() && hopsToAdd.size() != 0) {
     NLSR_LOG_DEBUG("New FIB Entry");
 
-    FibEntry entry(name);
+    FibEntry entry(key);
 
     addNextHopsToFibEntryAndNfd(entry, hopsToAdd);
 
-    m_table.emplace(name, entry);
+    m_table.emplace(key, entry);
 
-    entryIt = m_table.find(name);
+    entryIt = m_table.find(key);
   }
   // Existing FIB entry that may or may not have nextHops
   else {
@@ -148,7 +162,7 @@ Fib::update(const ndn::Name& name, const NexthopList& allHops)
     // Increment sequence number
     entry.setSeqNo(entry.getSeqNo() + 1);
 
-    entryIt = m_table.find(name);
+    entryIt = m_table.find(key);
 
   }
   if (entryIt != m_table.end() &&
@@ -165,6 +179,8 @@ void
 Fib::clean()
 {
   NLSR_LOG_DEBUG("Fib::clean called");
+  // NLSR is terminating, so the unregistrations are not held back
+  m_ribCommandWindow = std::numeric_limits<size_t>::max();
   // can't use const ref here as getNexthopList can't be marked const
   for (auto&& it : m_table) {
     NLSR_LOG_DEBUG("Canceling Scheduled event. Name: " << it.second.getName());
@@ -200,7 +216,7 @@ Fib::isNotNeighbor(const ndn::Name& name)
 void
 Fib::registerPrefix(const ndn::Name& namePrefix, const ndn::FaceUri& faceUri,
                     uint64_t faceCost, const ndn::time::milliseconds& timeout,
-                    uint64_t flags, uint8_t times)
+                    uint64_t flags, uint8_t times, RibCommandPriority priority)
 {
   uint64_t faceId = m_adjacencyList.getFaceId(ndn::FaceUri(faceUri));
 
@@ -215,20 +231,111 @@ Fib::registerPrefix(const ndn::Name& namePrefix, const ndn::FaceUri& faceUri,
      .setOrigin(ndn::nfd::ROUTE_ORIGIN_NLSR);
 
     NLSR_LOG_DEBUG("Registering prefix: " << faceParameters.getName() << " faceUri: " << faceUri);
-    m_controller.start<ndn::nfd::RibRegisterCommand>(faceParameters,
-                                                     std::bind(&Fib::onRegistrationSuccess, this, _1,
-                                                               "Successful in name registration",
-                                                               faceUri),
-                                                     std::bind(&Fib::onRegistrationFailure, this, _1,
-                                                               "Failed in name registration",
-                                                               faceParameters,
-                                                               faceUri, times));
+    queueRibCommand({namePrefix, faceUri.toString(), true, faceParameters, times, priority,
+                     0, ndn::time::steady_clock::now()});
   }
   else {
     NLSR_LOG_WARN("Error: No Face Id for face uri: " << faceUri);
   }
 }
 
+void
+Fib::queueRibCommand(RibCommand command)
+{
+  auto& prefixAndFaceIndex = m_ribCommands.get<detail::byPrefixAndFace>();
+  auto it = prefixAndFaceIndex.find(std::make_tuple(command.name, command.faceUri));
+
+  if (it == prefixAndFaceIndex.end()) {
+    command.order = m_nextRibCommandOrder++;
+    m_ribCommands.insert(command);
+  }
+  else {
+    NLSR_LOG_TRACE("Replacing queued command for " << command.name << " Face Uri: " <<
+                   command.faceUri);
+    command.priority = std::min(command.priority, it->priority);
+    command.order = it->order;
+    command.queuedAt = it->queuedAt;
+    prefixAndFaceIndex.replace(it, command);
+    ++m_ribCounters.nCoalesced;
+  }
+
+  m_ribCounters.maxQueued = std::max(m_ribCounters.maxQueued, m_ribCommands.size());
+  sendRibCommands();
+}
+
+void
+Fib::sendRibCommands()
+{
+  auto& priorityIndex = m_ribCommands.get<detail::byPriority>();
+
+  while (m_ribCounters.nInFlight < m_ribCommandWindow && !priorityIndex.empty()) {
+    auto next = priorityIndex.begin();
+    // Refreshes still get through while routes keep coming, before the registrations expire
+    if (m_nRefreshesInFlight < getRefreshWindow()) {
+      auto refresh = priorityIndex.lower_bound(std::make_tuple(RibCommandPriority::REFRESH));
+      if (refresh != priorityIndex.end()) {
+        next = refresh;
+      }
+    }
+    RibCommand command = *next;
+    priorityIndex.erase(next);
+    ++m_ribCounters.nInFlight;
+    ++m_ribCounters.nSent;
+    if (command.priority == RibCommandPriority::REFRESH) {
+      ++m_nRefreshesInFlight;
+    }
+
+    if (command.isRegister) {
+      m_controller.start<ndn::nfd::RibRegisterCommand>(
+        command.parameters,
+        [this, command] (const ndn::nfd::ControlParameters& commandSuccessResult) {
+          onRegistrationSuccess(commandSuccessResult, "Successful in name registration",
+                                ndn::FaceUri(command.faceUri));
+          onRibCommandAnswered(command);
+        },
+        [this, command] (const ndn::nfd::ControlResponse& response) {
+          onRegistrationFailure(response, "Failed in name registration", command);
+          onRibCommandAnswered(command);
+        });
+    }
+    else {
+      m_controller.start<ndn::nfd::RibUnregisterCommand>(
+        command.parameters,
+        [this, command] (const ndn::nfd::ControlParameters& commandSuccessResult) {
+          onUnregistrationSuccess(commandSuccessResult, "Successful in unregistering name");
+          onRibCommandAnswered(command);
+        },
+        [this, command] (const ndn::nfd::ControlResponse& response) {
+          onUnregistrationFailure(response, "Failed in unregistering name");
+          onRibCommandAnswered(command);
+        });
+    }
+  }
+
+  m_ribCounters.nQueued = m_ribCommands.size();
+}
+
+size_t
+Fib::getRefreshWindow() const
+{
+  return m_ribCommandWindow / 4;
+}
+
+void
+Fib::onRibCommandAnswered(const RibCommand& command)
+{
+  ndn::time::nanoseconds latency = ndn::time::steady_clock::now() - command.queuedAt;
+  --m_ribCounters.nInFlight;
+  if (command.priority == RibCommandPriority::REFRESH) {
+    --m_nRefreshesInFlight;
+  }
+  ++m_ribCounters.nAnswered;
+  m_ribCounters.totalLatency += latency;
+  m_ribCounters.maxLatency = std::max(m_ribCounters.maxLatency, latency);
+
+  sendRibCommands();
+}
+
 void
 Fib::onRegistrationSuccess(const ndn::nfd::ControlParameters& commandSuccessResult,
                            const std::string& message, const ndn::FaceUri& faceUri)
@@ -249,18 +356,21 @@ Fib::onRegistrationSuccess(const ndn::nfd::ControlParameters& commandSuccessResu
 void
 Fib::onRegistrationFailure(const ndn::nfd::ControlResponse& response,
                            const std::string& message,
-                           const ndn::nfd::ControlParameters& parameters,
-                           const ndn::FaceUri& faceUri,
-                           uint8_t times)
+                           const RibCommand& command)
 {
   NLSR_LOG_DEBUG(message << ": " << response.getText() << " (code: " << response.getCode() << ")");
-  NLSR_LOG_DEBUG("Prefix: " << parameters.getName() << " failed for: " << times);
-  if (times < 3) {
+  NLSR_LOG_DEBUG("Prefix: " << command.name << " failed for: " << static_cast<int>(command.times));
+
+  const auto& prefixAndFaceIndex = m_ribCommands.get<detail::byPrefixAndFace>();
+  if (prefixAndFaceIndex.count(std::make_tuple(command.name, command.faceUri)) > 0) {
+    NLSR_LOG_DEBUG("A newer command is queued, registration is not tried again");
+  }
+  else if (command.times < 3) {
     NLSR_LOG_DEBUG("Trying to register again...");
-    registerPrefix(parameters.getName(), faceUri,
-                   parameters.getCost(),
-                   parameters.getExpirationPeriod(),
-                   parameters.getFlags(), times+1);
+    RibCommand retry = command;
+    ++retry.times;
+    retry.queuedAt = ndn::time::steady_clock::now();
+    queueRibCommand(retry);
   }
   else {
     NLSR_LOG_DEBUG("Registration trial given up");
@@ -278,12 +388,8 @@ Fib::unregisterPrefix(const ndn::Name& namePrefix, const std::string& faceUri)
       .setName(namePrefix)
       .setFaceId(faceId)
       .setOrigin(ndn::nfd::ROUTE_ORIGIN_NLSR);
-    m_controller.start<ndn::nfd::RibUnregisterCommand>(controlParameters,
-                                                       std::bind(&Fib::onUnregistrationSuccess, this, _1,
-                                                                 "Successful in unregistering name"),
-                                                       std::bind(&Fib::onUnregistrationFailure,
-                                                                 this, _1,
-                                                                 "Failed in unregistering name"));
+    queueRibCommand({namePrefix, faceUri, false, controlParameters, 0, RibCommandPriority::ROUTE,
+                     0, ndn::time::steady_clock::now()});
   }
 }
 
@@ -338,13 +444,79 @@ Fib::onSetStrategyFailure(const ndn::nfd::ControlResponse& response,
 void
 Fib::scheduleEntryRefresh(FibEntry& entry, const afterRefreshCallback& refreshCallback)
 {
+  ndn::time::milliseconds delay = getRefreshDelay();
   NLSR_LOG_DEBUG("Scheduling refresh for " << entry.getName() <<
                  " Seq Num: " << entry.getSeqNo() <<
-                 " in " << m_refreshTime << " seconds");
+                 " in " << delay);
+
+  ndn::time::steady_clock::TimePoint deadline = ndn::time::steady_clock::now() +
+    ndn::time::seconds(m_refreshTime + GRACE_PERIOD) - REFRESH_DEADLINE_MARGIN;
+
+  auto onDue = [this, name = entry.getName(), refreshCallback, deadline] {
+    m_dueRefreshes.emplace(deadline, std::make_pair(name, refreshCallback));
+    scheduleRefreshBatch();
+  };
+  entry.setRefreshEventId(m_scheduler.schedule(delay, onDue));
+}
+
+ndn::time::milliseconds
+Fib::getRefreshDelay()
+{
+  ndn::time::milliseconds refreshTime = ndn::time::seconds(m_refreshTime);
+  std::uniform_int_distribution<ndn::time::milliseconds::rep>
+    jitter(0, refreshTime.count() * m_confParameter.getFibRefreshJitter() / 100);
+
+  return refreshTime - ndn::time::milliseconds(jitter(ndn::random::getRandomNumberEngine()));
+}
+
+void
+Fib::scheduleRefreshBatch()
+{
+  if (m_isRefreshBatchScheduled) {
+    return;
+  }
 
-  entry.setRefreshEventId(m_scheduler.schedule(ndn::time::seconds(m_refreshTime),
-                                               std::bind(&Fib::refreshEntry, this,
-                                                         entry.getName(), refreshCallback)));
+  ndn::time::nanoseconds delay = ndn::time::nanoseconds::zero();
+  ndn::time::steady_clock::TimePoint now = ndn::time::steady_clock::now();
+  if (m_lastRefreshBatch + REFRESH_BATCH_INTERVAL > now) {
+    delay = m_lastRefreshBatch + REFRESH_BATCH_INTERVAL - now;
+  }
+
+  m_scheduler.schedule(delay, [this] { refreshDueEntries(); });
+  m_isRefreshBatchScheduled = true;
+}
+
+void
+Fib::refreshDueEntries()
+{
+  m_isRefreshBatchScheduled = false;
+  m_lastRefreshBatch = ndn::time::steady_clock::now();
+
+  // Entries whose deadline passes before the next batch cannot wait for it
+  ndn::time::steady_clock::TimePoint nextBatch = m_lastRefreshBatch + REFRESH_BATCH_INTERVAL;
+  uint32_t batchSize = m_confParameter.getFibRefreshBatchSize();
+  size_t nDue = m_dueRefreshes.size();
+  size_t nRefreshed = 0;
+
+  while (!m_dueRefreshes.empty()) {
+    auto it = m_dueRefreshes.begin();
+    bool isNearDeadline = it->first <= nextBatch;
+    if (nRefreshed >= batchSize && !isNearDeadline) {
+      break;
+    }
+
+    auto due = std::move(it->second);
+    m_dueRefreshes.erase(it);
+    refreshEntry(due.first, due.second,
+                 isNearDeadline ? RibCommandPriority::ROUTE : RibCommandPriority::REFRESH);
+    ++nRefreshed;
+  }
+
+  NLSR_LOG_DEBUG("Refreshed " << nRefreshed << " of " << nDue << " due entries");
+
+  if (!m_dueRefreshes.empty()) {
+    scheduleRefreshBatch();
+  }
 }
 
 void
@@ -361,7 +533,8 @@ Fib::cancelEntryRefresh(const FibEntry& entry)
 }
 
 void
-Fib::refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb)
+Fib::refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb,
+                  RibCommandPriority priority)
 {
   auto it = m_table.find(name);
   if (it == m_table.end()) {
@@ -369,6 +542,10 @@ Fib::refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb)
   }
 
   FibEntry& entry = it->second;
+  if (entry.getRefreshEventId()) {
+    NLSR_LOG_DEBUG(entry.getName() << " has been scheduled again, refresh skipped");
+    return;
+  }
   NLSR_LOG_DEBUG("Refreshing " << entry.getName() << " Seq Num: " << entry.getSeqNo());
 
   // Increment sequence number
@@ -379,7 +556,7 @@ Fib::refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb)
                    ndn::FaceUri(hop.getConnectingFaceUri()),
                    hop.getRouteCostAsAdjustedInteger(),
                    ndn::time::seconds(m_refreshTime + GRACE_PERIOD),
-                   ndn::nfd::ROUTE_FLAG_CAPTURE, 0);
+                   ndn::nfd::ROUTE_FLAG_CAPTURE, 0, priority);
   }
 
   refreshCb(entry);
@@ -392,6 +569,14 @@ Fib::writeLog()
   for (const auto& entry : m_table) {
     entry.second.writeLog();
   }
+
+  NLSR_LOG_DEBUG("RIB commands queued: " << m_ribCounters.nQueued <<
+                 " (max " << m_ribCounters.maxQueued << ")" <<
+                 " in flight: " << m_ribCounters.nInFlight <<
+                 " sent: " << m_ribCounters.nSent <<
+                 " answered: " << m_ribCounters.nAnswered <<
+                 " coalesced: " << m_ribCounters.nCoalesced <<
+                 " max latency: " << m_ribCounters.maxLatency);
 }
 
 } // namespace nlsr
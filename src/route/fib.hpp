@@ -29,6 +29,14 @@
 #include <ndn-cxx/mgmt/nfd/controller.hpp>
 #include <ndn-cxx/util/time.hpp>
 
+#include <map>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/tag.hpp>
+
 namespace nlsr {
 
 typedef std::function<void(FibEntry&)> afterRefreshCallback;
@@ -37,6 +45,67 @@ class AdjacencyList;
 class ConfParameter;
 class FibEntry;
 
+/*! \brief The order in which queued RIB commands are sent to NFD. */
+enum class RibCommandPriority {
+  /*! New and changed next hops, and next hops being removed */
+  ROUTE,
+  /*! Next hops that are registered again before they expire */
+  REFRESH
+};
+
+/*! \brief A register or unregister command waiting to be sent to NFD's RIB. */
+struct RibCommand
+{
+  ndn::Name name;
+  std::string faceUri;
+  bool isRegister;
+  ndn::nfd::ControlParameters parameters;
+  /*! How many times this registration has failed */
+  uint8_t times;
+  RibCommandPriority priority;
+  /*! Commands of the same priority are sent in the order they were queued */
+  uint64_t order;
+  ndn::time::steady_clock::TimePoint queuedAt;
+};
+
+/*! \brief Counters of the commands the FIB sends to NFD's RIB. */
+struct RibCommandCounters
+{
+  /*! Commands waiting for room in the in-flight window */
+  size_t nQueued = 0;
+  size_t maxQueued = 0;
+  /*! Commands sent to NFD that have not been answered yet */
+  size_t nInFlight = 0;
+  uint64_t nSent = 0;
+  uint64_t nAnswered = 0;
+  /*! Commands that replaced a queued command for the same prefix and face */
+  uint64_t nCoalesced = 0;
+  /*! Time from queueing a command until NFD answered it, summed over the answered commands */
+  ndn::time::nanoseconds totalLatency = ndn::time::nanoseconds::zero();
+  ndn::time::nanoseconds maxLatency = ndn::time::nanoseconds::zero();
+};
+
+namespace detail {
+
+  using namespace boost::multi_index;
+  struct byPriority {};
+  struct byPrefixAndFace {};
+  using RibCommandQueue = multi_index_container<
+    RibCommand,
+    indexed_by<
+      ordered_unique<tag<byPriority>,
+                     composite_key<RibCommand,
+                                   member<RibCommand, RibCommandPriority, &RibCommand::priority>,
+                                   member<RibCommand, uint64_t, &RibCommand::order>>>,
+      ordered_unique<tag<byPrefixAndFace>,
+                     composite_key<RibCommand,
+                                   member<RibCommand, ndn::Name, &RibCommand::name>,
+                                   member<RibCommand, std::string, &RibCommand::faceUri>>>
+      >
+    >;
+
+} // namespace detail
+
 /*! \brief Maps names to lists of next hops, and exports this information to NFD.
  *
  * The FIB (Forwarding Information Base) is the "authoritative" source
@@ -46,6 +115,19 @@ class FibEntry;
  * methods to inform NFD about these relationships. The FIB has its
  * entries populated by the NamePrefixTable
  *
+ * Commands to NFD's RIB go through a queue: only a window of them is
+ * sent at a time, and the others wait for earlier ones to be answered.
+ * A queued command is replaced by a later command for the same prefix
+ * and face, and new routes are sent before refreshes of existing ones,
+ * except that part of the window is kept for refreshes.
+ *
+ * Registrations are refreshed before they expire. Each entry is
+ * refreshed a random amount earlier than the refresh time, within the
+ * configured jitter, so entries installed together spread out over
+ * time; due refreshes are then done in batches of limited size, earliest
+ * deadline first. Refreshes that would otherwise be done too close to
+ * the expiry of the registration are all done at once, ahead of routes.
+ *
  * \sa nlsr::NamePrefixTable
  * \sa nlsr::NamePrefixTable::addEntry
  * \sa nlsr::NamePrefixTable::updateWithNewRoute
@@ -118,6 +200,7 @@ public:
    * \param timeout How long this registration should last
    * \param flags Route inheritance flags (CAPTURE, CHILD_INHERIT)
    * \param times How many times we have failed to register this prefix since the last success.
+   * \param priority Whether the registration is sent before or after queued refreshes.
    *
    * \sa Fib::registerPrefixInNfd
    */
@@ -127,11 +210,18 @@ public:
                  uint64_t faceCost,
                  const ndn::time::milliseconds& timeout,
                  uint64_t flags,
-                 uint8_t times);
+                 uint8_t times,
+                 RibCommandPriority priority = RibCommandPriority::ROUTE);
 
   void
   setStrategy(const ndn::Name& name, const std::string& strategy, uint32_t count);
 
+  const RibCommandCounters&
+  getRibCommandCounters() const
+  {
+    return m_ribCounters;
+  }
+
   void
   writeLog();
 
@@ -161,6 +251,36 @@ private:
   void
   unregisterPrefix(const ndn::Name& namePrefix, const std::string& faceUri);
 
+  /*! \brief Queues a command for NFD's RIB, and sends what the window allows.
+   *
+   * If a command for the same prefix and face is still queued, it is
+   * replaced, keeping its place in the queue unless the new command
+   * has a higher priority.
+   */
+  void
+  queueRibCommand(RibCommand command);
+
+  /*! \brief Sends queued commands until the in-flight window is full.
+   *
+   * Commands are sent in the order of their priority, but while fewer
+   * than getRefreshWindow() refreshes are in flight, a queued refresh is
+   * sent first.
+   */
+  void
+  sendRibCommands();
+
+  /*! \brief Returns how many slots of the in-flight window are kept for refreshes.
+   *
+   * A quarter of the window is kept, none if the window is smaller than four.
+   */
+  size_t
+  getRefreshWindow() const;
+
+  /*! \brief Updates the counters for an answered command, and sends the next ones.
+   */
+  void
+  onRibCommandAnswered(const RibCommand& command);
+
   /*! \brief Log registration success, and update the Face ID associated with a URI.
    */
   void
@@ -168,13 +288,14 @@ private:
                         const std::string& message, const ndn::FaceUri& faceUri);
 
   /*! \brief Retry a prefix (next-hop) registration up to three (3) times.
+   *
+   * The retry is dropped if a newer command for the same prefix and
+   * face is already queued.
    */
   void
   onRegistrationFailure(const ndn::nfd::ControlResponse& response,
                         const std::string& message,
-                        const ndn::nfd::ControlParameters& parameters,
-                        const ndn::FaceUri& faceUri,
-                        uint8_t times);
+                        const RibCommand& command);
 
   /*! \brief Log a successful unregistration.
    */
@@ -203,8 +324,11 @@ private:
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   /*! \brief Schedule a refresh event for an entry.
    *
-   * Schedules a refresh event for an entry. In order to form a
-   * perpetual loop, refreshCallback needs to call
+   * Schedules a refresh event for an entry, at the refresh time less a
+   * random jitter. When the event fires, the entry joins the queue of
+   * due refreshes rather than being refreshed at once; it must leave the
+   * queue REFRESH_DEADLINE_MARGIN before the registration expires. In
+   * order to form a perpetual loop, refreshCallback needs to call
    * Fib::scheduleEntryRefresh in some way, with refreshCallback being
    * the same each time. In the current implementation, this is
    * accomplished by having a separate function, Fib::scheduleLoop,
@@ -214,6 +338,11 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   scheduleEntryRefresh(FibEntry& entry, const afterRefreshCallback& refreshCb);
 
+  /*! \brief Returns the time until an entry is refreshed, jitter included.
+   */
+  ndn::time::milliseconds
+  getRefreshDelay();
+
 private:
   /*! \brief Continue the entry refresh cycle.
    */
@@ -232,10 +361,29 @@ private:
   void
   cancelEntryRefresh(const FibEntry& entry);
 
+  /*! \brief Schedules the next batch of due refreshes, if none is scheduled.
+   *
+   * Batches are at least REFRESH_BATCH_INTERVAL apart.
+   */
+  void
+  scheduleRefreshBatch();
+
+  /*! \brief Refreshes up to a batch of due entries, and all entries near their deadline.
+   *
+   * An entry is near its deadline if the deadline passes before the next
+   * batch; such entries are refreshed with the priority of routes.
+   */
+  void
+  refreshDueEntries();
+
   /*! \brief Refreshes an entry in NFD.
+   *
+   * Nothing is done if the entry has been removed, or has been
+   * scheduled for another refresh since this one became due.
    */
   void
-  refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb);
+  refreshEntry(const ndn::Name& name, afterRefreshCallback refreshCb,
+               RibCommandPriority priority);
 
 public:
   static const std::string MULTICAST_STRATEGY;
@@ -248,17 +396,44 @@ private:
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   FaceMap m_faceMap;
-  std::map<ndn::Name, FibEntry> m_table;
+  std::map<InternedName, FibEntry> m_table;
+  /*! How many RIB commands may wait for an answer from NFD at once */
+  size_t m_ribCommandWindow;
 
 private:
   AdjacencyList& m_adjacencyList;
   ConfParameter& m_confParameter;
 
+  detail::RibCommandQueue m_ribCommands;
+  uint64_t m_nextRibCommandOrder;
+  RibCommandCounters m_ribCounters;
+  /*! Refreshes sent to NFD that have not been answered yet */
+  size_t m_nRefreshesInFlight;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /*! Entries whose refresh is due, by the time they must be refreshed at the latest */
+  std::multimap<ndn::time::steady_clock::TimePoint,
+                std::pair<ndn::Name, afterRefreshCallback>> m_dueRefreshes;
+
+private:
+  bool m_isRefreshBatchScheduled;
+  ndn::time::steady_clock::TimePoint m_lastRefreshBatch;
+
   /*! GRACE_PERIOD A "window" we append to the timeout time to
    * allow for things like stuttering prefix registrations and
    * processing time when refreshing events.
    */
   static const uint64_t GRACE_PERIOD;
+
+  static const size_t DEFAULT_RIB_COMMAND_WINDOW;
+
+  static const ndn::time::milliseconds REFRESH_BATCH_INTERVAL;
+
+  /*! REFRESH_DEADLINE_MARGIN How long before its registration expires
+   * an entry must be refreshed at the latest, leaving time for the
+   * command to get through the RIB command queue.
+   */
+  static const ndn::time::seconds REFRESH_DEADLINE_MARGIN;
 };
 
 } // namespace nlsr
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "hyperbolic-distance.hpp"
+
+#include <cmath>
+
+// The vector kernels are compiled for their instruction set with function attributes, and
+// only called when the processor supports it, so that NLSR runs on any x86 processor.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NLSR_HAVE_X86_DISTANCE_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace nlsr {
+
+namespace {
+
+// Computes the inner products and the hyperbolic cosines of the distances of points
+// [begin, nPoints), one point at a time. The vector kernels use it for the points left
+// over after the last full vector.
+inline void
+computeRange(const HyperbolicPoints& points, size_t src, size_t begin,
+             double* innerProducts, double* distances)
+{
+  const size_t n = points.nPoints;
+  const double coshSrc = points.coshRadii[src];
+  const double sinhSrc = points.sinhRadii[src];
+
+  for (size_t i = begin; i < n; ++i) {
+    double innerProduct = 0.0;
+    for (size_t k = 0; k < points.dimension; ++k) {
+      const double* row = points.coordinates + k * n;
+      innerProduct += row[src] * row[i];
+    }
+    innerProducts[i] = innerProduct;
+
+    // cosh(d) = cosh(rI)cosh(rJ) - sinh(rI)sinh(rJ)cos(deltaTheta), with zeta = 1
+    distances[i] = coshSrc * points.coshRadii[i] - sinhSrc * points.sinhRadii[i] * innerProduct;
+  }
+}
+
+// There is no vector instruction for the inverse hyperbolic cosine, so it is applied to
+// the whole batch once all the arguments are known
+inline void
+finishDistances(size_t nPoints, double* distances)
+{
+  for (size_t i = 0; i < nPoints; ++i) {
+    distances[i] = std::acosh(distances[i]);
+  }
+}
+
+void
+computeDistancesScalar(const HyperbolicPoints& points, size_t src,
+                       double* innerProducts, double* distances)
+{
+  computeRange(points, src, 0, innerProducts, distances);
+  finishDistances(points.nPoints, distances);
+}
+
+#ifdef NLSR_HAVE_X86_DISTANCE_KERNELS
+
+// The vector kernels compute each lane exactly like computeRange, with separate multiplies
+// and adds in the same order, so that they give the same results as the scalar kernel
+
+__attribute__((target("sse2"))) void
+computeDistancesSse2(const HyperbolicPoints& points, size_t src,
+                     double* innerProducts, double* distances)
+{
+  const size_t n = points.nPoints;
+  const __m128d coshSrc = _mm_set1_pd(points.coshRadii[src]);
+  const __m128d sinhSrc = _mm_set1_pd(points.sinhRadii[src]);
+
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d innerProduct = _mm_setzero_pd();
+    for (size_t k = 0; k < points.dimension; ++k) {
+      const double* row = points.coordinates + k * n;
+      innerProduct = _mm_add_pd(innerProduct,
+                                _mm_mul_pd(_mm_set1_pd(row[src]), _mm_loadu_pd(row + i)));
+    }
+    _mm_storeu_pd(innerProducts + i, innerProduct);
+
+    __m128d coshProduct = _mm_mul_pd(coshSrc, _mm_loadu_pd(points.coshRadii + i));
+    __m128d sinhProduct = _mm_mul_pd(sinhSrc, _mm_loadu_pd(points.sinhRadii + i));
+    _mm_storeu_pd(distances + i,
+                  _mm_sub_pd(coshProduct, _mm_mul_pd(sinhProduct, innerProduct)));
+  }
+
+  computeRange(points, src, i, innerProducts, distances);
+  finishDistances(n, distances);
+}
+
+__attribute__((target("avx"))) void
+computeDistancesAvx(const HyperbolicPoints& points, size_t src,
+                    double* innerProducts, double* distances)
+{
+  const size_t n = points.nPoints;
+  const __m256d coshSrc = _mm256_set1_pd(points.coshRadii[src]);
+  const __m256d sinhSrc = _mm256_set1_pd(points.sinhRadii[src]);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d innerProduct = _mm256_setzero_pd();
+    for (size_t k = 0; k < points.dimension; ++k) {
+      const double* row = points.coordinates + k * n;
+      innerProduct = _mm256_add_pd(innerProduct,
+                                   _mm256_mul_pd(_mm256_set1_pd(row[src]),
+                                                 _mm256_loadu_pd(row + i)));
+    }
+    _mm256_storeu_pd(innerProducts + i, innerProduct);
+
+    __m256d coshProduct = _mm256_mul_pd(coshSrc, _mm256_loadu_pd(points.coshRadii + i));
+    __m256d sinhProduct = _mm256_mul_pd(sinhSrc, _mm256_loadu_pd(points.sinhRadii + i));
+    _mm256_storeu_pd(distances + i,
+                     _mm256_sub_pd(coshProduct, _mm256_mul_pd(sinhProduct, innerProduct)));
+  }
+
+  computeRange(points, src, i, innerProducts, distances);
+  finishDistances(n, distances);
+}
+
+#endif // NLSR_HAVE_X86_DISTANCE_KERNELS
+
+std::vector<HyperbolicDistanceKernelInfo>
+selectKernels()
+{
+  std::vector<HyperbolicDistanceKernelInfo> kernels;
+
+#ifdef NLSR_HAVE_X86_DISTANCE_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx")) {
+    kernels.push_back({"avx", &computeDistancesAvx});
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    kernels.push_back({"sse2", &computeDistancesSse2});
+  }
+#endif // NLSR_HAVE_X86_DISTANCE_KERNELS
+
+  kernels.push_back({"scalar", &computeDistancesScalar});
+  return kernels;
+}
+
+} // anonymous namespace
+
+const std::vector<HyperbolicDistanceKernelInfo>&
+getHyperbolicDistanceKernels()
+{
+  static const std::vector<HyperbolicDistanceKernelInfo> kernels = selectKernels();
+  return kernels;
+}
+
+void
+computeHyperbolicDistances(const HyperbolicPoints& points, size_t src,
+                           double* innerProducts, double* distances)
+{
+  getHyperbolicDistanceKernels().front().kernel(points, src, innerProducts, distances);
+}
+
+} // namespace nlsr
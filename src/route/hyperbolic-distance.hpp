@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_HYPERBOLIC_DISTANCE_HPP
+#define NLSR_HYPERBOLIC_DISTANCE_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace nlsr {
+
+/*! \brief The hyperbolic coordinates of a set of routers, one array per coordinate.
+
+  Each router is a point on the unit sphere, scaled by its radius. Coordinate k of all
+  routers is stored contiguously, so that the distances from one router to all the others
+  can be computed several destinations at a time.
+ */
+struct HyperbolicPoints
+{
+  size_t nPoints;
+  size_t dimension;
+  // coordinates[k * nPoints + i] is coordinate k of point i
+  const double* coordinates;
+  // The hyperbolic cosine and sine of the radius of each point
+  const double* coshRadii;
+  const double* sinhRadii;
+};
+
+/*! \brief Computes the distances from one point to every point of a set.
+  \param points The set of points.
+  \param src The index of the point to compute the distances from.
+  \param[out] innerProducts Receives, for every point, its inner product with point src,
+              i.e. the cosine of their angular distance.
+  \param[out] distances Receives, for every point, its hyperbolic distance to point src.
+
+  Both output arrays must hold points.nPoints values. The distance is only meaningful when
+  both points have coordinates and are not at the same angle (inner product below 1); it is
+  up to the caller to check that.
+ */
+using HyperbolicDistanceKernel = void (*)(const HyperbolicPoints& points, size_t src,
+                                          double* innerProducts, double* distances);
+
+struct HyperbolicDistanceKernelInfo
+{
+  const char* name;
+  HyperbolicDistanceKernel kernel;
+};
+
+/*! \brief Returns the distance kernels that this processor can run, fastest first.
+
+  The vector kernels are selected at run time from the instruction sets the processor
+  supports. The last kernel is always the portable scalar one; all kernels compute the
+  inner products in the same order, and give the same results as the scalar kernel.
+ */
+const std::vector<HyperbolicDistanceKernelInfo>&
+getHyperbolicDistanceKernels();
+
+/*! \brief Computes the distances from one point with the fastest available kernel.
+  \sa HyperbolicDistanceKernel
+ */
+void
+computeHyperbolicDistances(const HyperbolicPoints& points, size_t src,
+                           double* innerProducts, double* distances);
+
+} // namespace nlsr
+
+#endif // NLSR_HYPERBOLIC_DISTANCE_HPP
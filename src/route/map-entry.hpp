@@ -22,6 +22,8 @@
 #ifndef NLSR_MAP_ENTRY_HPP
 #define NLSR_MAP_ENTRY_HPP
 
+#include "name-pool.hpp"
+
 #include <boost/cstdint.hpp>
 #include <ndn-cxx/name.hpp>
 
@@ -52,6 +54,12 @@ public:
     return m_router;
   }
 
+  const InternedName&
+  getInternedRouter() const
+  {
+    return m_router;
+  }
+
   int32_t
   getMappingNumber() const
   {
@@ -62,7 +70,7 @@ public:
   reset();
 
 private:
-  ndn::Name m_router;
+  InternedName m_router;
   int32_t m_mappingNumber;
 };
 
@@ -57,6 +57,17 @@ Map::getRouterNameByMappingNo(int32_t mn) const
   }
 }
 
+const ndn::Name*
+Map::findRouterName(int32_t mn) const
+{
+  auto&& mappingNumberView = m_entries.get<detail::byMappingNumber>();
+  auto iterator = mappingNumberView.find(mn);
+  if (iterator == mappingNumberView.end()) {
+    return nullptr;
+  }
+  return &iterator->getRouter();
+}
+
 ndn::optional<int32_t>
 Map::getMappingNoByRouterName(const ndn::Name& rName)
 {
@@ -39,14 +39,16 @@ namespace detail {
 
   using namespace boost::multi_index;
   // Define tags so that we can search by different indices.
+  // Router names are hashed once, when they are interned.
   struct byRouterName {};
   struct byMappingNumber{};
   using entryContainer = multi_index_container<
     MapEntry,
     indexed_by<
       hashed_unique<tag<byRouterName>,
-                    const_mem_fun<MapEntry, const ndn::Name&, &MapEntry::getRouter>,
-                    std::hash<ndn::Name>>,
+                    const_mem_fun<MapEntry, const InternedName&, &MapEntry::getInternedRouter>,
+                    InternedNameHash,
+                    std::equal_to<>>,
       hashed_unique<tag<byMappingNumber>,
                     const_mem_fun<MapEntry, int32_t, &MapEntry::getMappingNumber>>
       >
@@ -80,8 +82,12 @@ public:
   createFromAdjLsdb(IteratorType begin, IteratorType end)
   {
     BOOST_STATIC_ASSERT_MSG(is_iterator<IteratorType>::value, "IteratorType must be an iterator!");
+    // The routers with an LSA are numbered first, so that their mapping numbers do not
+    // change when links are added or removed, and the previous paths can be repaired
     for (auto lsa = begin; lsa != end; lsa++) {
       addEntry(lsa->getOrigRouter());
+    }
+    for (auto lsa = begin; lsa != end; lsa++) {
       for (const auto& adjacent : lsa->getAdl().getAdjList()) {
         addEntry(adjacent.getName());
       }
@@ -105,6 +111,12 @@ public:
   ndn::optional<ndn::Name>
   getRouterNameByMappingNo(int32_t mn) const;
 
+  /*! \brief Returns the name of a router without copying it.
+    \return The name, or nullptr if no router has that mapping number.
+  */
+  const ndn::Name*
+  findRouterName(int32_t mn) const;
+
   ndn::optional<int32_t>
   getMappingNoByRouterName(const ndn::Name& rName);
 
@@ -22,6 +22,7 @@
 #ifndef NLSR_NAME_PREFIX_TABLE_ENTRY_HPP
 #define NLSR_NAME_PREFIX_TABLE_ENTRY_HPP
 
+#include "name-pool.hpp"
 #include "routing-table-pool-entry.hpp"
 
 #include "test-access-control.hpp"
@@ -50,6 +51,12 @@ public:
     return m_namePrefix;
   }
 
+  const InternedName&
+  getInternedNamePrefix() const
+  {
+    return m_namePrefix;
+  }
+
   const std::list<std::shared_ptr<RoutingTablePoolEntry>>&
   getRteList() const
   {
@@ -107,7 +114,7 @@ public:
   writeLog();
 
 private:
-  ndn::Name m_namePrefix;
+  InternedName m_namePrefix;
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::list<std::shared_ptr<RoutingTablePoolEntry>> m_rteList;
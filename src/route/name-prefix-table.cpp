@@ -25,7 +25,6 @@
 #include "nlsr.hpp"
 #include "routing-table.hpp"
 
-#include <algorithm>
 #include <list>
 #include <utility>
 
@@ -54,12 +53,8 @@ NamePrefixTable::addEntry(const ndn::Name& name, const ndn::Name& destRouter)
 {
 
   // Check if the advertised name prefix is in the table already.
-  NptEntryList::iterator nameItr =
-    std::find_if(m_table.begin(),
-                 m_table.end(),
-                 [&] (const std::shared_ptr<NamePrefixTableEntry>& entry) {
-                   return name == entry->getNamePrefix();
-                 });
+  auto& nameIndex = m_table.get<detail::byNamePrefix>();
+  auto nameItr = nameIndex.find(name);
 
   // Attempt to find a routing table pool entry (RTPE) we can use.
   RoutingTableEntryPool::iterator rtpeItr = m_rtpool.find(destRouter);
@@ -92,7 +87,7 @@ NamePrefixTable::addEntry(const ndn::Name& name, const ndn::Name& destRouter)
 
   std::shared_ptr<NamePrefixTableEntry> npte;
   // Either we have to make a new NPT entry or there already was one.
-  if (nameItr == m_table.end()) {
+  if (nameItr == nameIndex.end()) {
     NLSR_LOG_DEBUG("Adding origin: " << rtpePtr->getDestination()
                << " to a new name prefix: " << name);
     npte = make_shared<NamePrefixTableEntry>(name);
@@ -155,12 +150,9 @@ NamePrefixTable::removeEntry(const ndn::Name& name, const ndn::Name& destRouter)
   std::shared_ptr<RoutingTablePoolEntry> rtpePtr = rtpeItr->second;
 
   // Ensure that the entry exists
-  NptEntryList::iterator nameItr =
-    std::find_if(m_table.begin(), m_table.end(),
-                 [&] (const std::shared_ptr<NamePrefixTableEntry>& entry) {
-                   return entry->getNamePrefix() == name;
-                 });
-  if (nameItr != m_table.end()) {
+  auto& nameIndex = m_table.get<detail::byNamePrefix>();
+  auto nameItr = nameIndex.find(name);
+  if (nameItr != nameIndex.end()) {
     NLSR_LOG_TRACE("Removing origin: " << rtpePtr->getDestination()
                << " from prefix: " << **nameItr);
 
@@ -188,7 +180,7 @@ NamePrefixTable::removeEntry(const ndn::Name& name, const ndn::Name& destRouter)
     if ((*nameItr)->getRteListSize() == 0) {
       NLSR_LOG_TRACE(**nameItr << " has no routing table entries;"
                  << " removing from table and FIB");
-      m_table.erase(nameItr);
+      nameIndex.erase(nameItr);
       m_fib.remove(name);
     }
     else {
@@ -209,29 +201,29 @@ NamePrefixTable::updateWithNewRoute(const std::list<RoutingTableEntry>& entries)
 {
   NLSR_LOG_DEBUG("Updating table with newly calculated routes");
 
-  // Iterate over each pool entry we have
-  for (auto&& poolEntryPair : m_rtpool) {
-    auto&& poolEntry = poolEntryPair.second;
-    auto sourceEntry = std::find_if(entries.begin(), entries.end(),
-                                    [&poolEntry] (const RoutingTableEntry& entry) {
-                                      return poolEntry->getDestination() == entry.getDestination();
-                                    });
-    // If this pool entry has a corresponding entry in the routing table now
-    if (sourceEntry != entries.end()
-        && poolEntry->getNexthopList() != sourceEntry->getNexthopList()) {
-      NLSR_LOG_DEBUG("Routing entry: " << poolEntry->getDestination() << " has changed next-hops.");
-      poolEntry->setNexthopList(sourceEntry->getNexthopList());
-      for (const auto& nameEntry : poolEntry->namePrefixTableEntries) {
-        auto nameEntryFullPtr = nameEntry.second.lock();
-        addEntry(nameEntryFullPtr->getNamePrefix(), poolEntry->getDestination());
-      }
+  // Iterate over each changed entry
+  for (const auto& entry : entries) {
+    auto poolItr = m_rtpool.find(entry.getDestination());
+    // If no name prefix is reached through this destination, there is nothing to update
+    if (poolItr == m_rtpool.end()) {
+      continue;
     }
-    else if (sourceEntry == entries.end()) {
-      NLSR_LOG_DEBUG("Routing entry: " << poolEntry->getDestination() << " now has no next-hops.");
-      poolEntry->getNexthopList().reset();
+
+    auto&& poolEntry = poolItr->second;
+    if (poolEntry->getNexthopList() != entry.getNexthopList()) {
+      if (entry.getNexthopList().size() > 0) {
+        NLSR_LOG_DEBUG("Routing entry: " << poolEntry->getDestination() << " has changed next-hops.");
+      }
+      else {
+        NLSR_LOG_DEBUG("Routing entry: " << poolEntry->getDestination() << " now has no next-hops.");
+      }
+      poolEntry->setNexthopList(entry.getNexthopList());
+      // Only the name prefixes reached through this destination can have changed
       for (const auto& nameEntry : poolEntry->namePrefixTableEntries) {
         auto nameEntryFullPtr = nameEntry.second.lock();
-        addEntry(nameEntryFullPtr->getNamePrefix(), poolEntry->getDestination());
+        if (nameEntryFullPtr != nullptr) {
+          updateFibWithNexthops(*nameEntryFullPtr);
+        }
       }
     }
     else {
@@ -241,6 +233,26 @@ NamePrefixTable::updateWithNewRoute(const std::list<RoutingTableEntry>& entries)
   }
 }
 
+void
+NamePrefixTable::updateFibWithNexthops(NamePrefixTableEntry& npte)
+{
+  NexthopList previousNexthops = npte.getNexthopList();
+  npte.generateNhlfromRteList();
+
+  if (npte.getNexthopList() == previousNexthops) {
+    NLSR_LOG_TRACE("No change in next hops for " << npte.getNamePrefix() <<
+                   ", FIB is not updated");
+  }
+  else if (npte.getNexthopList().size() > 0) {
+    NLSR_LOG_TRACE("Updating FIB with next hops for " << npte.getNamePrefix());
+    m_fib.update(npte.getNamePrefix(), npte.getNexthopList());
+  }
+  else {
+    NLSR_LOG_TRACE(npte.getNamePrefix() << " has no next hops; removing from FIB");
+    m_fib.remove(npte.getNamePrefix());
+  }
+}
+
   // Inserts the routing table pool entry into the NPT's RTE storage
   // pool.  This cannot fail, so the pool is guaranteed to contain the
   // item after this occurs.
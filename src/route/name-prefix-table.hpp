@@ -31,14 +31,40 @@
 #include <list>
 #include <unordered_map>
 
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index/tag.hpp>
+
 namespace nlsr {
 
+namespace detail {
+
+  using namespace boost::multi_index;
+  // Entries are iterated in the order they were added, and looked up by hash. The hash of
+  // an interned name prefix is computed once.
+  struct byNamePrefix {};
+  using NptEntryContainer = multi_index_container<
+    std::shared_ptr<NamePrefixTableEntry>,
+    indexed_by<
+      sequenced<>,
+      hashed_unique<tag<byNamePrefix>,
+                    const_mem_fun<NamePrefixTableEntry, const InternedName&,
+                                  &NamePrefixTableEntry::getInternedNamePrefix>,
+                    InternedNameHash,
+                    std::equal_to<>>
+      >
+    >;
+
+} // namespace detail
+
 class NamePrefixTable
 {
 public:
   using RoutingTableEntryPool =
-    std::unordered_map<ndn::Name, std::shared_ptr<RoutingTablePoolEntry>>;
-  using NptEntryList = std::list<std::shared_ptr<NamePrefixTableEntry>>;
+    std::unordered_map<InternedName, std::shared_ptr<RoutingTablePoolEntry>>;
+  using NptEntryList = detail::NptEntryContainer;
   using const_iterator = NptEntryList::const_iterator;
 
   NamePrefixTable(Fib& fib, RoutingTable& routingTable,
@@ -76,13 +102,17 @@ public:
   void
   removeEntry(const ndn::Name& name, const ndn::Name& destRouter);
 
-  /*! \brief Updates all routing information in the NPT.
+  /*! \brief Updates the routing information in the NPT.
 
-    Takes in a list of entries that are assumed to be exhaustive, and
-    updates each pool entry with the next hop information contained in
-    the corresponding entry in entries. If no entry is found, it is
-    assumed that the destination for that pool entry is inaccessible,
-    and its next hop information is deleted.
+    Takes in a list of routing table entries that have changed, and
+    updates each corresponding pool entry with the next hop information
+    contained in that entry. An entry with no next hops means that its
+    destination has become inaccessible. Pool entries whose destination
+    is not in the list are left as they are.
+
+    Only the name prefixes reached through a changed pool entry are
+    looked at, and the FIB is only updated for those whose next hops
+    have actually changed.
    */
   void
   updateWithNewRoute(const std::list<RoutingTableEntry>& entries);
@@ -124,6 +154,13 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
 
   NptEntryList m_table;
 
+private:
+  /*! \brief Regenerates the next hops of an entry and, if they have
+    changed, installs them in the FIB.
+   */
+  void
+  updateFibWithNexthops(NamePrefixTableEntry& npte);
+
 private:
   Fib& m_fib;
   RoutingTable& m_routingTable;
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "routing-graph.hpp"
+#include "map.hpp"
+#include "adjacent.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <boost/lexical_cast.hpp>
+
+namespace nlsr {
+
+INIT_LOGGER(route.RoutingGraph);
+
+const double RoutingGraph::NO_LINK = std::numeric_limits<double>::infinity();
+
+void
+RoutingGraph::build(const AdjLsaContainer& adjLsaList, Map& map)
+{
+  const int32_t nRouters = static_cast<int32_t>(map.getMapSize());
+
+  // Costs as each router advertised them in its own LSA
+  m_advertised.clear();
+  for (const auto& adjLsa : adjLsaList) {
+    ndn::optional<int32_t> row = map.getMappingNoByRouterName(adjLsa.getOrigRouter());
+    if (!row || *row >= nRouters) {
+      continue;
+    }
+
+    for (const auto& adjacent : adjLsa.getAdl().getAdjList()) {
+      ndn::optional<int32_t> col = map.getMappingNoByRouterName(adjacent.getName());
+      if (col && *col < nRouters) {
+        m_advertised.push_back({*row, *col, adjacent.getLinkCost(), m_advertised.size()});
+      }
+    }
+  }
+
+  // Order the advertisements by router so that reverse costs can be found by binary
+  // search. If a neighbor is listed more than once, the last advertisement wins.
+  std::sort(m_advertised.begin(), m_advertised.end(),
+            [] (const AdvertisedLink& lhs, const AdvertisedLink& rhs) {
+              return std::tie(lhs.from, lhs.to, lhs.order) < std::tie(rhs.from, rhs.to, rhs.order);
+            });
+  auto last = m_advertised.begin();
+  for (auto it = m_advertised.begin(); it != m_advertised.end(); ++it) {
+    if (last != m_advertised.begin() &&
+        std::prev(last)->from == it->from && std::prev(last)->to == it->to) {
+      *std::prev(last) = *it;
+    }
+    else {
+      *last++ = *it;
+    }
+  }
+  m_advertised.erase(last, m_advertised.end());
+
+  m_advertisedOffsets.assign(nRouters + 1, 0);
+  for (const auto& link : m_advertised) {
+    ++m_advertisedOffsets[link.from + 1];
+  }
+  std::partial_sum(m_advertisedOffsets.begin(), m_advertisedOffsets.end(),
+                   m_advertisedOffsets.begin());
+
+  auto findAdvertisedLink = [this] (int32_t from, int32_t to) -> const AdvertisedLink* {
+    auto begin = m_advertised.begin() + m_advertisedOffsets[from];
+    auto end = m_advertised.begin() + m_advertisedOffsets[from + 1];
+    auto it = std::lower_bound(begin, end, to,
+                               [] (const AdvertisedLink& link, int32_t router) {
+                                 return link.to < router;
+                               });
+    if (it != end && it->to == to) {
+      return &*it;
+    }
+    return nullptr;
+  };
+
+  m_corrected.clear();
+  for (const auto& link : m_advertised) {
+    int32_t row = link.from;
+    int32_t col = link.to;
+    if (col == row) {
+      continue;
+    }
+
+    const AdvertisedLink* reverse = findAdvertisedLink(col, row);
+
+    // Each link is considered once: when it is advertised by both ends, from the
+    // lower-numbered end; otherwise from the only end that advertises it.
+    if (col < row && reverse != nullptr) {
+      continue;
+    }
+
+    double toCost = link.cost;
+    double fromCost = reverse != nullptr ? reverse->cost : Adjacent::NON_ADJACENT_COST;
+
+    double correctedCost = toCost;
+
+    if (fromCost != toCost) {
+      correctedCost = Adjacent::NON_ADJACENT_COST;
+
+      if (toCost >= 0 && fromCost >= 0) {
+        // If both sides of the link are up, use the larger cost else break the link
+        correctedCost = std::max(toCost, fromCost);
+      }
+
+      NLSR_LOG_WARN("Cost between [" << row << "][" << col << "] and [" << col << "][" << row <<
+                    "] are not the same (" << toCost << " != " << fromCost << "). " <<
+                    "Correcting to cost: " << correctedCost);
+    }
+
+    if (correctedCost >= 0) {
+      m_corrected.push_back({row, col, correctedCost, 0});
+    }
+  }
+
+  // Lay the links out in rows. Only links advertised by both ends are kept, and they are
+  // taken in the order of their lower-numbered end, so every row comes out ordered by the
+  // router its links lead to.
+  m_offsets.assign(nRouters + 1, 0);
+  for (const auto& link : m_corrected) {
+    ++m_offsets[link.from + 1];
+    ++m_offsets[link.to + 1];
+  }
+  std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+  m_links.resize(m_offsets.back());
+  // The advertised offsets are not needed anymore, and serve as the fill position of each row
+  std::copy(m_offsets.begin(), m_offsets.end(), m_advertisedOffsets.begin());
+  for (const auto& link : m_corrected) {
+    m_links[m_advertisedOffsets[link.from]++] = {link.to, link.cost};
+    m_links[m_advertisedOffsets[link.to]++] = {link.from, link.cost};
+  }
+}
+
+bool
+RoutingGraph::hasZeroCostLink() const
+{
+  return std::any_of(m_links.begin(), m_links.end(),
+                     [] (const Link& link) { return link.cost == 0; });
+}
+
+std::vector<RoutingGraph::LinkChange>
+RoutingGraph::getChangesFrom(const RoutingGraph& previous) const
+{
+  std::vector<LinkChange> changes;
+  getChangesFrom(previous, changes);
+  return changes;
+}
+
+void
+RoutingGraph::getChangesFrom(const RoutingGraph& previous, std::vector<LinkChange>& changes) const
+{
+  changes.clear();
+
+  // Both graphs keep their links ordered by router, so each pair of rows is merged
+  for (int32_t from = 0; from < static_cast<int32_t>(getNRouters()); ++from) {
+    LinkRange oldLinks = previous.getLinks(from);
+    LinkRange newLinks = getLinks(from);
+    auto oldIt = oldLinks.begin();
+    auto newIt = newLinks.begin();
+
+    while (oldIt != oldLinks.end() || newIt != newLinks.end()) {
+      LinkChange change{from, 0, NO_LINK, NO_LINK};
+      if (newIt == newLinks.end() || (oldIt != oldLinks.end() && oldIt->to < newIt->to)) {
+        change.to = oldIt->to;
+        change.oldCost = (oldIt++)->cost;
+      }
+      else if (oldIt == oldLinks.end() || newIt->to < oldIt->to) {
+        change.to = newIt->to;
+        change.newCost = (newIt++)->cost;
+      }
+      else {
+        change.to = newIt->to;
+        change.oldCost = (oldIt++)->cost;
+        change.newCost = (newIt++)->cost;
+      }
+
+      if (from < change.to && change.oldCost != change.newCost) {
+        changes.push_back(change);
+      }
+    }
+  }
+}
+
+void
+RoutingGraph::swap(RoutingGraph& other)
+{
+  m_offsets.swap(other.m_offsets);
+  m_links.swap(other.m_links);
+  m_advertised.swap(other.m_advertised);
+  m_advertisedOffsets.swap(other.m_advertisedOffsets);
+  m_corrected.swap(other.m_corrected);
+}
+
+void
+RoutingGraph::writeLog(const Map& map) const
+{
+  if (!ndn_cxx_getLogger().isLevelEnabled(ndn::util::LogLevel::DEBUG)) {
+    return;
+  }
+
+  NLSR_LOG_DEBUG("-----------Routing Graph (routerName -> links)------");
+  for (size_t i = 0; i < getNRouters(); ++i) {
+    std::string line;
+    for (const auto& link : getLinks(i)) {
+      line += " " + std::to_string(link.to) + ":" + boost::lexical_cast<std::string>(link.cost);
+    }
+    NLSR_LOG_DEBUG("Router:" << *map.getRouterNameByMappingNo(i) << " Index:" << i <<
+                   " Links:" << line);
+  }
+}
+
+} // namespace nlsr
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_ROUTING_GRAPH_HPP
+#define NLSR_ROUTING_GRAPH_HPP
+
+#include "common.hpp"
+#include "lsa.hpp"
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace nlsr {
+
+class Map;
+
+/*! \brief Sparse, undirected view of the network used for path calculation.
+ *
+ * The graph is built straight from the adjacency LSAs in the LSDB, and routers are
+ * identified by their mapping number in a Map. Only links that both ends agree are up are
+ * kept, so the graph holds O(E) links instead of an O(N^2) adjacency matrix.
+ *
+ * Links are stored in compressed sparse rows: the links of all routers share one flat
+ * array, and each router owns a contiguous range of it. The arrays, and the scratch space
+ * used while building, are kept when the graph is built again, so that a graph which is
+ * rebuilt for every calculation stops allocating once it has reached the network's size.
+ */
+class RoutingGraph
+{
+public:
+  struct Link
+  {
+    int32_t to;
+    double cost;
+  };
+
+  /*! \brief A link whose cost is not the same in two graphs.
+
+    A link missing from one of the graphs has a cost of NO_LINK there, so that removing a
+    link compares like raising its cost, and adding one like lowering it.
+  */
+  struct LinkChange
+  {
+    int32_t from;
+    int32_t to;
+    double oldCost;
+    double newCost;
+  };
+
+  /*! \brief The links leaving one router. */
+  class LinkRange
+  {
+  public:
+    LinkRange(const Link* begin, const Link* end)
+      : m_begin(begin)
+      , m_end(end)
+    {
+    }
+
+    const Link*
+    begin() const
+    {
+      return m_begin;
+    }
+
+    const Link*
+    end() const
+    {
+      return m_end;
+    }
+
+    size_t
+    size() const
+    {
+      return m_end - m_begin;
+    }
+
+    const Link&
+    operator[](size_t i) const
+    {
+      return m_begin[i];
+    }
+
+  private:
+    const Link* m_begin;
+    const Link* m_end;
+  };
+
+  /*! \brief Populates the graph from adjacency LSAs.
+    \param adjLsaList The adjacency LSAs to build the graph from.
+    \param map The map translating router names to mapping numbers.
+
+    Links that do not have the same cost for both directions are corrected:
+    if the cost of one side of the link is NON_ADJACENT_COST (i.e. broken) or
+    negative, the link is left out of the graph. Otherwise, both directions of the
+    link use the larger of the two costs.
+  */
+  void
+  build(const AdjLsaContainer& adjLsaList, Map& map);
+
+  size_t
+  getNRouters() const
+  {
+    return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+  }
+
+  /*! \brief Returns the number of links, counting each direction of a link once. */
+  size_t
+  getNLinks() const
+  {
+    return m_links.size();
+  }
+
+  /*! \brief Returns the links leaving a router, ordered by the router they lead to.
+    \param router The mapping number of the router.
+  */
+  LinkRange
+  getLinks(int32_t router) const
+  {
+    return {m_links.data() + m_offsets[router], m_links.data() + m_offsets[router + 1]};
+  }
+
+  /*! \brief Returns whether any link of the graph costs zero. */
+  bool
+  hasZeroCostLink() const;
+
+  /*! \brief Lists the links that differ from another graph of the same routers.
+    \param previous The graph to compare with; its links give the old costs.
+
+    Each changed link is listed once, with from < to.
+  */
+  std::vector<LinkChange>
+  getChangesFrom(const RoutingGraph& previous) const;
+
+  /*! \brief Lists the links that differ from another graph into a vector.
+    \param previous The graph to compare with; its links give the old costs.
+    \param[out] changes Receives the changed links, replacing its contents. Its space is
+                 reused, so that comparing graphs again does not allocate.
+  */
+  void
+  getChangesFrom(const RoutingGraph& previous, std::vector<LinkChange>& changes) const;
+
+  /*! \brief Exchanges the contents, and the allocated space, of two graphs. */
+  void
+  swap(RoutingGraph& other);
+
+  /*! \brief Writes the graph to the DEBUG log. */
+  void
+  writeLog(const Map& map) const;
+
+public:
+  static const double NO_LINK;
+
+private:
+  struct AdvertisedLink
+  {
+    int32_t from;
+    int32_t to;
+    double cost;
+    size_t order;
+  };
+
+  // m_links[m_offsets[i]] up to m_links[m_offsets[i + 1]] are the links of router i
+  std::vector<size_t> m_offsets;
+  std::vector<Link> m_links;
+
+  // Scratch space for build()
+  std::vector<AdvertisedLink> m_advertised;
+  std::vector<size_t> m_advertisedOffsets;
+  std::vector<AdvertisedLink> m_corrected;
+};
+
+} // namespace nlsr
+
+#endif // NLSR_ROUTING_GRAPH_HPP
@@ -20,6 +20,7 @@
  **/
 
 #include "routing-table-calculator.hpp"
+#include "hyperbolic-distance.hpp"
 #include "lsdb.hpp"
 #include "map.hpp"
 #include "nexthop.hpp"
@@ -30,7 +31,9 @@
 #include <iostream>
 #include <boost/math/constants/constants.hpp>
 #include <ndn-cxx/util/logger.hpp>
+#include <algorithm>
 #include <cmath>
+#include <functional>
 
 namespace nlsr {
 
@@ -42,384 +45,501 @@ const int LinkStateRoutingTableCalculator::NO_MAPPING_NUM = -1;
 const int LinkStateRoutingTableCalculator::NO_NEXT_HOP = -12345;
 
 void
-RoutingTableCalculator::allocateAdjMatrix()
+TaskRunner::run(size_t nTasks, const std::function<void(size_t n, size_t slot)>& task)
 {
-  adjMatrix = new double*[m_nRouters];
-
-  for (size_t i = 0; i < m_nRouters; ++i) {
-    adjMatrix[i] = new double[m_nRouters];
+  for (size_t n = 0; n < nTasks; ++n) {
+    task(n, 0);
   }
 }
 
 void
-RoutingTableCalculator::initMatrix()
+LinkStateRoutingTableCalculator::calculatePath(Map& pMap, NextHopReceiver& rt,
+                                               CalculationParameters& parameters,
+                                               const AdjLsaContainer& adjLsaList)
 {
-  for (size_t i = 0; i < m_nRouters; i++) {
-    for (size_t j = 0; j < m_nRouters; j++) {
-      adjMatrix[i][j] = Adjacent::NON_ADJACENT_COST;
-    }
+  NLSR_LOG_DEBUG("LinkStateRoutingTableCalculator::calculatePath Called");
+  m_nRouters = pMap.getMapSize();
+  m_hasPaths = false;
+  RoutingGraph& graph = m_newGraph;
+  graph.build(adjLsaList, pMap);
+  graph.writeLog(pMap);
+  ndn::optional<int32_t> sourceRouter =
+    pMap.getMappingNoByRouterName(parameters.routerPrefix);
+  // We only bother to do the calculation if we have a router by that name.
+  if (!sourceRouter) {
+    return;
   }
+
+  m_sourceRouter = *sourceRouter;
+  m_isSinglePath = parameters.maxFacesPerPrefix == 1;
+  loadRouterNames(pMap);
+  loadFirstHopFaces(graph, parameters.adjacencies);
+  allocateWorkspaces();
+
+  // In the single path case we can simply run Dijkstra's algorithm. In the multipath case,
+  // there is one calculation per neighbor, in which the source may only reach that
+  // neighbor. The calculations are independent, and are handed to the task runner.
+  RoutingGraph::LinkRange firstLinks = graph.getLinks(m_sourceRouter);
+  size_t nCalculations = m_isSinglePath ? 1 : firstLinks.size();
+  // One parent and distance array per calculation, laid out one after the other.
+  allocateParent(nCalculations);
+  allocateDistance(nCalculations);
+  // The next hops are kept, so that updatePath() can tell which ones it changes
+  m_nextHops.resize(m_parents.size());
+  getTaskRunner().run(nCalculations, [&] (size_t n, size_t slot) {
+    Tree tree = getTree(n, slot);
+    doDijkstraPathCalculation(tree, graph, m_sourceRouter,
+                              m_isSinglePath ? NO_MAPPING_NUM : firstLinks[n].to);
+    getAllLsNextHops(tree, m_nextHops.data() + n * m_nRouters);
+  });
+  m_graph.swap(m_newGraph);
+
+  // Update the routing table with the calculations, one neighbor at a time
+  for (size_t n = 0; n < nCalculations; ++n) {
+    addAllLsNextHopsToRoutingTable(rt, getTree(n), m_nextHops.data() + n * m_nRouters);
+  }
+
+  m_hasPaths = true;
 }
 
-void
-RoutingTableCalculator::makeAdjMatrix(const std::list<AdjLsa>& adjLsaList, Map& pMap)
+bool
+LinkStateRoutingTableCalculator::updatePath(Map& pMap, CalculationParameters& parameters,
+                                            const AdjLsaContainer& adjLsaList,
+                                            std::list<RoutingTableEntry>& changedEntries)
 {
-  // For each LSA represented in the map
-  for (const auto& adjLsa : adjLsaList) {
-    ndn::optional<int32_t> row = pMap.getMappingNoByRouterName(adjLsa.getOrigRouter());
-
-    std::list<Adjacent> adl = adjLsa.getAdl().getAdjList();
-    // For each adjacency represented in the LSA
-    for (const auto& adjacent : adl) {
-      ndn::optional<int32_t> col = pMap.getMappingNoByRouterName(adjacent.getName());
-      double cost = adjacent.getLinkCost();
-
-      if (row && col && *row < static_cast<int32_t>(m_nRouters)
-          && *col < static_cast<int32_t>(m_nRouters))
-      {
-        adjMatrix[*row][*col] = cost;
-      }
+  NLSR_LOG_DEBUG("LinkStateRoutingTableCalculator::updatePath Called");
+  if (!m_hasPaths || pMap.getMapSize() != m_routerNames.size() ||
+      m_isSinglePath != (parameters.maxFacesPerPrefix == 1)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < m_routerNames.size(); ++i) {
+    const ndn::Name* routerName = pMap.findRouterName(i);
+    if (routerName == nullptr || *routerName != m_routerNames[i]) {
+      NLSR_LOG_DEBUG("Routers have changed, paths cannot be repaired");
+      return false;
     }
   }
 
-  // Links that do not have the same cost for both directions should
-  // have their costs corrected:
-  //
-  //   If the cost of one side of the link is NON_ADJACENT_COST (i.e. broken) or negative,
-  //   both direction of the link should have their cost corrected to NON_ADJACENT_COST.
-  //
-  //   Otherwise, both sides of the link should use the larger of the two costs.
-  //
-  // Additionally, this means that we can halve the amount of space
-  // that the matrix uses by only maintaining a triangle.
-  // - But that is not yet implemented.
-  for (size_t row = 0; row < m_nRouters; ++row) {
-    for (size_t col = 0; col < m_nRouters; ++col) {
-      double toCost = adjMatrix[row][col];
-      double fromCost = adjMatrix[col][row];
-
-      if (fromCost != toCost) {
-        double correctedCost = Adjacent::NON_ADJACENT_COST;
-
-        if (toCost >= 0 && fromCost >= 0) {
-          // If both sides of the link are up, use the larger cost else break the link
-          correctedCost = std::max(toCost, fromCost);
-        }
+  RoutingGraph& graph = m_newGraph;
+  graph.build(adjLsaList, pMap);
+
+  // Over a link of zero cost, a router may be explored before a router at the same distance
+  // with a lower mapping number, and a full calculation may break ties in a way that the
+  // repaired paths cannot reproduce
+  if (m_graph.hasZeroCostLink() || graph.hasZeroCostLink()) {
+    NLSR_LOG_DEBUG("Links of zero cost, paths cannot be repaired");
+    return false;
+  }
+
+  // The first hops, and with them the layout of the trees, must not have changed
+  RoutingGraph::LinkRange oldFirstLinks = m_graph.getLinks(m_sourceRouter);
+  RoutingGraph::LinkRange firstLinks = graph.getLinks(m_sourceRouter);
+  if (firstLinks.size() != oldFirstLinks.size()) {
+    NLSR_LOG_DEBUG("Links of this router have changed, paths cannot be repaired");
+    return false;
+  }
+  for (size_t hop = 0; hop < firstLinks.size(); ++hop) {
+    const ndn::Name& nextHopRouterName = m_routerNames[firstLinks[hop].to];
+    auto adjacent = parameters.adjacencies.findAdjacent(nextHopRouterName);
+    bool isSameFace = adjacent != parameters.adjacencies.end() ?
+                      adjacent->getFaceUri() == m_firstHopFaceUris[hop] :
+                      m_firstHopFaceUris[hop] == ndn::FaceUri();
+    if (firstLinks[hop].to != oldFirstLinks[hop].to ||
+        firstLinks[hop].cost != oldFirstLinks[hop].cost || !isSameFace) {
+      NLSR_LOG_DEBUG("Links of this router have changed, paths cannot be repaired");
+      return false;
+    }
+  }
 
-        NLSR_LOG_WARN("Cost between [" << row << "][" << col << "] and [" << col << "][" << row <<
-                  "] are not the same (" << toCost << " != " << fromCost << "). " <<
-                  "Correcting to cost: " << correctedCost);
+  allocateWorkspaces();
+  std::vector<RoutingGraph::LinkChange>& changes = m_workspaces[0].changes;
+  graph.getChangesFrom(m_graph, changes);
+  NLSR_LOG_DEBUG("Repairing paths after " << changes.size() << " link changes");
+  if (changes.empty()) {
+    return true;
+  }
+  graph.writeLog(pMap);
+
+  for (auto& workspace : m_workspaces) {
+    workspace.isChanged.assign(m_nRouters, false);
+  }
+  size_t nCalculations = m_isSinglePath ? 1 : firstLinks.size();
+
+  // The trees are repaired independently, and the changes are marked in the workspace of
+  // the slot that found them
+  getTaskRunner().run(nCalculations, [&] (size_t n, size_t slot) {
+    Tree tree = getTree(n, slot);
+    std::vector<double>& oldDistance = tree.workspace.oldDistance;
+    std::vector<int>& nextHop = tree.workspace.nextHop;
+    oldDistance.assign(tree.distance, tree.distance + m_nRouters);
+    nextHop.resize(m_nRouters);
+    doIncrementalPathCalculation(tree, graph,
+                                 m_isSinglePath ? NO_MAPPING_NUM : firstLinks[n].to, changes);
+
+    // A destination changes if its cost or next hop in any of the trees does
+    getAllLsNextHops(tree, nextHop.data());
+    int* oldNextHop = m_nextHops.data() + n * m_nRouters;
+    for (size_t i = 0; i < m_nRouters; ++i) {
+      if (nextHop[i] != oldNextHop[i] || tree.distance[i] != oldDistance[i]) {
+        tree.workspace.isChanged[i] = true;
+        oldNextHop[i] = nextHop[i];
+      }
+    }
+  });
+  m_graph.swap(graph);
+
+  std::vector<bool>& isChanged = m_workspaces[0].isChanged;
+  for (size_t slot = 1; slot < m_workspaces.size(); ++slot) {
+    for (size_t i = 0; i < m_nRouters; ++i) {
+      if (m_workspaces[slot].isChanged[i]) {
+        isChanged[i] = true;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < m_nRouters; ++i) {
+    if (!isChanged[i]) {
+      continue;
+    }
 
-        adjMatrix[row][col] = correctedCost;
-        adjMatrix[col][row] = correctedCost;
+    RoutingTableEntry entry(m_routerNames[i]);
+    for (size_t n = 0; n < nCalculations; ++n) {
+      int nextHopRouter = m_nextHops[n * m_nRouters + i];
+      if (nextHopRouter != NO_NEXT_HOP) {
+        NextHop nh(getFirstHopFace(nextHopRouter), m_distances[n * m_nRouters + i]);
+        entry.getNexthopList().addNextHop(nh);
       }
     }
+    NLSR_LOG_DEBUG("Next hops of " << m_routerNames[i] << " have changed");
+    changedEntries.push_back(std::move(entry));
   }
+
+  return true;
 }
 
 void
-RoutingTableCalculator::writeAdjMatrixLog(const Map& map) const
+LinkStateRoutingTableCalculator::doDijkstraPathCalculation(const Tree& tree,
+                                                           const RoutingGraph& graph,
+                                                           int sourceRouter, int firstHop)
 {
-  if (!ndn_cxx_getLogger().isLevelEnabled(ndn::util::LogLevel::DEBUG)) {
-    return;
-  }
-
-  NLSR_LOG_DEBUG("-----------Legend (routerName -> index)------");
-  std::string routerIndex;
-  std::string indexToNameMapping;
-  std::string lengthOfDash = "--";
+  // Entries of the queue made stale by a later relaxation are skipped
+  tree.workspace.queue.clear();
+  std::vector<bool>& isExplored = tree.workspace.isExplored;
+  isExplored.assign(m_nRouters, false);
 
+  // Initiate the parent
   for (size_t i = 0; i < m_nRouters; i++) {
-      routerIndex += boost::lexical_cast<std::string>(i);
-      routerIndex += " ";
-      lengthOfDash += "--";
-      NLSR_LOG_DEBUG("Router:" + map.getRouterNameByMappingNo(i)->toUri() +
-                     " Index:" + boost::lexical_cast<std::string>(i));
+    tree.parent[i] = EMPTY_PARENT;
+    // Array where the ith element is the distance to the router with mapping no i.
+    tree.distance[i] = INF_DISTANCE;
+  }
+  if (sourceRouter == NO_MAPPING_NUM) {
+    return;
   }
-  NLSR_LOG_DEBUG(" |" + routerIndex);
-  NLSR_LOG_DEBUG(lengthOfDash);
 
-  for (size_t i = 0; i < m_nRouters; i++) {
-    std::string line;
-    for (size_t j = 0; j < m_nRouters; j++) {
-      line += boost::lexical_cast<std::string>(adjMatrix[i][j]);
-      line += " ";
+  // Distance to source from source is always 0.
+  tree.distance[sourceRouter] = 0;
+  pushToQueue(tree.workspace, 0, sourceRouter);
+
+  while (!tree.workspace.queue.empty()) {
+    int u = popFromQueue(tree.workspace).second;
+    if (isExplored[u]) {
+      continue;
+    }
+    isExplored[u] = true;
+
+    // Iterate over the adjacent nodes to u.
+    for (const auto& link : graph.getLinks(u)) {
+      int v = link.to;
+      // In the multipath case, the source may only reach the first hop of this tree
+      if (u == sourceRouter && firstHop != NO_MAPPING_NUM && v != firstHop) {
+        continue;
+      }
+      if (isExplored[v]) {
+        continue;
+      }
+      // If the distance to this node + from this node to v is less than the distance
+      // from our source node to v so far.
+      double distance = tree.distance[u] + link.cost;
+      if (distance < tree.distance[v]) {
+        // Set the new distance
+        tree.distance[v] = distance;
+        // Set how we get there.
+        tree.parent[v] = u;
+        pushToQueue(tree.workspace, tree.distance[v], v);
+      }
+      else if (distance == tree.distance[v] && tree.parent[v] != EMPTY_PARENT &&
+               isPreferredParent(tree, u, tree.parent[v])) {
+        tree.parent[v] = u;
+      }
     }
-    line = boost::lexical_cast<std::string>(i) + "|" + line;
-    NLSR_LOG_DEBUG(line);
   }
 }
 
 void
-RoutingTableCalculator::adjustAdMatrix(int source, int link, double linkCost)
+LinkStateRoutingTableCalculator::doIncrementalPathCalculation(
+  const Tree& tree, const RoutingGraph& graph, int firstHop,
+  const std::vector<RoutingGraph::LinkChange>& changes)
 {
-  for (int i = 0; i < static_cast<int>(m_nRouters); i++) {
-    if (i == link) {
-      adjMatrix[source][i] = linkCost;
+  // A link may only be used from the source if it leads to the first hop of this tree
+  auto isUsable = [this, firstHop] (int from, int to) {
+    return from != m_sourceRouter || firstHop == NO_MAPPING_NUM || to == firstHop;
+  };
+
+  // Children of each router in the tree, as linked lists threaded through two arrays
+  std::vector<int>& firstChild = tree.workspace.firstChild;
+  std::vector<int>& nextSibling = tree.workspace.nextSibling;
+  firstChild.assign(m_nRouters, NO_MAPPING_NUM);
+  nextSibling.assign(m_nRouters, NO_MAPPING_NUM);
+  for (size_t i = 0; i < m_nRouters; ++i) {
+    if (tree.parent[i] != EMPTY_PARENT) {
+      nextSibling[i] = firstChild[tree.parent[i]];
+      firstChild[tree.parent[i]] = i;
+    }
+  }
+
+  // Routers reached over a link that got more expensive or went away have lost their
+  // path, and so has everything below them in the tree.
+  std::vector<bool>& isInvalid = tree.workspace.isInvalid;
+  std::vector<int>& invalid = tree.workspace.invalid;
+  std::vector<int>& stack = tree.workspace.stack;
+  isInvalid.assign(m_nRouters, false);
+  invalid.clear();
+  stack.clear();
+  for (const auto& change : changes) {
+    if (change.newCost <= change.oldCost) {
+      continue;
     }
-    else {
-      // if "i" is not a link to the source, set it's cost to a non adjacent value.
-      adjMatrix[source][i] = Adjacent::NON_ADJACENT_COST;
+    for (int child : {change.from, change.to}) {
+      int parent = child == change.from ? change.to : change.from;
+      if (tree.parent[child] != parent || isInvalid[child]) {
+        continue;
+      }
+      stack.push_back(child);
+      while (!stack.empty()) {
+        int router = stack.back();
+        stack.pop_back();
+        isInvalid[router] = true;
+        invalid.push_back(router);
+        for (int c = firstChild[router]; c != NO_MAPPING_NUM; c = nextSibling[c]) {
+          if (!isInvalid[c]) {
+            stack.push_back(c);
+          }
+        }
+      }
     }
   }
-}
 
-int
-RoutingTableCalculator::getNumOfLinkfromAdjMatrix(int sRouter)
-{
-  int noLink = 0;
+  for (int router : invalid) {
+    tree.parent[router] = EMPTY_PARENT;
+    tree.distance[router] = INF_DISTANCE;
+  }
 
-  for (size_t i = 0; i < m_nRouters; i++) {
-    if (adjMatrix[sRouter][i] >= 0 && i != static_cast<size_t>(sRouter)) { // make sure "i" is not self
-      noLink++;
+  tree.workspace.queue.clear();
+
+  // Ties are broken as in doDijkstraPathCalculation(), so that the repaired paths take the
+  // same next hops as a full calculation would
+  auto relax = [&] (int from, int to, double cost) {
+    if (tree.distance[from] == INF_DISTANCE || !isUsable(from, to)) {
+      return;
+    }
+    double distance = tree.distance[from] + cost;
+    if (distance < tree.distance[to]) {
+      tree.distance[to] = distance;
+      tree.parent[to] = from;
+      pushToQueue(tree.workspace, tree.distance[to], to);
+    }
+    else if (distance == tree.distance[to] && tree.parent[to] != EMPTY_PARENT &&
+             isPreferredParent(tree, from, tree.parent[to])) {
+      // The distance is the same, so the routers below need not be relaxed again
+      tree.parent[to] = from;
+    }
+  };
+
+  // Reattach the invalidated routers through their neighbors that kept their path
+  for (int router : invalid) {
+    for (const auto& link : graph.getLinks(router)) {
+      if (!isInvalid[link.to]) {
+        relax(link.to, router, link.cost);
+      }
     }
   }
-  return noLink;
-}
 
-void
-RoutingTableCalculator::getLinksFromAdjMatrix(int* links,
-                                              double* linkCosts, int source)
-{
-  int j = 0;
+  // Links that got cheaper or came up may shorten the paths of any router
+  for (const auto& change : changes) {
+    if (change.newCost < change.oldCost) {
+      relax(change.from, change.to, change.newCost);
+      relax(change.to, change.from, change.newCost);
+    }
+  }
 
-  for (size_t i = 0; i < m_nRouters; i++) {
-    if (adjMatrix[source][i] >= 0 && i != static_cast<size_t>(source)) {// make sure "i" is not self
-      links[j] = i;
-      linkCosts[j] = adjMatrix[source][i];
-      j++;
+  // Propagate the new distances as in Dijkstra's algorithm
+  while (!tree.workspace.queue.empty()) {
+    std::pair<double, size_t> entry = popFromQueue(tree.workspace);
+    int u = entry.second;
+    if (entry.first > tree.distance[u]) {
+      continue;
+    }
+    for (const auto& link : graph.getLinks(u)) {
+      relax(u, link.to, link.cost);
     }
   }
 }
 
 void
-RoutingTableCalculator::freeAdjMatrix()
+LinkStateRoutingTableCalculator::addAllLsNextHopsToRoutingTable(NextHopReceiver& rt,
+                                                                const Tree& tree,
+                                                                const int* nextHop)
 {
-  for (size_t i = 0; i < m_nRouters; ++i) {
-    delete [] adjMatrix[i];
+  NLSR_LOG_DEBUG("LinkStateRoutingTableCalculator::addAllNextHopsToRoutingTable Called");
+
+  // For each router we have
+  for (size_t i = 0; i < m_nRouters ; i++) {
+    // If this router is accessible at all, through a router other than itself
+    if (static_cast<int>(i) != m_sourceRouter && nextHop[i] != NO_NEXT_HOP) {
+      // Add next hop to routing table, with its distance
+      tree.workspace.nh.setConnectingFaceUri(getFirstHopFace(nextHop[i]));
+      tree.workspace.nh.setRouteCost(tree.distance[i]);
+      rt.addNextHop(m_routerNames[i], tree.workspace.nh);
+    }
   }
-  delete [] adjMatrix;
 }
 
 void
-RoutingTableCalculator::allocateLinks()
+LinkStateRoutingTableCalculator::getAllLsNextHops(const Tree& tree, int* nextHop) const
 {
-  links = new int[vNoLink];
-}
+  // NO_MAPPING_NUM marks the routers whose next hop is not known yet
+  std::fill(nextHop, nextHop + m_nRouters, NO_MAPPING_NUM);
+  nextHop[m_sourceRouter] = NO_NEXT_HOP;
 
-void
-RoutingTableCalculator::allocateLinkCosts()
-{
-  linkCosts = new double[vNoLink];
+  std::vector<int>& path = tree.workspace.path;
+  path.clear();
+  for (size_t i = 0; i < m_nRouters; ++i) {
+    // Walk up until a router whose next hop is known, then fill in the routers passed
+    int router = i;
+    while (nextHop[router] == NO_MAPPING_NUM) {
+      if (tree.parent[router] == EMPTY_PARENT) {
+        nextHop[router] = NO_NEXT_HOP;
+        break;
+      }
+      if (tree.parent[router] == m_sourceRouter) {
+        nextHop[router] = router;
+        break;
+      }
+      path.push_back(router);
+      router = tree.parent[router];
+    }
+    for (int passed : path) {
+      nextHop[passed] = nextHop[router];
+    }
+    path.clear();
+  }
 }
 
-
 void
-RoutingTableCalculator::freeLinks()
+LinkStateRoutingTableCalculator::loadRouterNames(const Map& pMap)
 {
-  delete [] links;
-}
-void
-RoutingTableCalculator::freeLinksCosts()
-{
-  delete [] linkCosts;
+  // Names are only assigned when they differ, as copying one allocates
+  m_routerNames.resize(m_nRouters);
+  for (size_t i = 0; i < m_nRouters; ++i) {
+    const ndn::Name& routerName = *pMap.findRouterName(i);
+    if (m_routerNames[i] != routerName) {
+      m_routerNames[i] = routerName;
+    }
+  }
 }
 
 void
-LinkStateRoutingTableCalculator::calculatePath(Map& pMap, RoutingTable& rt,
-                                               ConfParameter& confParam,
-                                               const std::list<AdjLsa>& adjLsaList)
+LinkStateRoutingTableCalculator::loadFirstHopFaces(const RoutingGraph& graph,
+                                                   AdjacencyList& adjacencies)
 {
-  NLSR_LOG_DEBUG("LinkStateRoutingTableCalculator::calculatePath Called");
-  allocateAdjMatrix();
-  initMatrix();
-  makeAdjMatrix(adjLsaList, pMap);
-  writeAdjMatrixLog(pMap);
-  ndn::optional<int32_t> sourceRouter =
-    pMap.getMappingNoByRouterName(confParam.getRouterPrefix());
-  allocateParent(); // These two matrices are used in Dijkstra's algorithm.
-  allocateDistance(); //
-  // We only bother to do the calculation if we have a router by that name.
-  if (sourceRouter && confParam.getMaxFacesPerPrefix() == 1) {
-    // In the single path case we can simply run Dijkstra's algorithm.
-    doDijkstraPathCalculation(*sourceRouter);
-    // Inform the routing table of the new next hops.
-    addAllLsNextHopsToRoutingTable(confParam.getAdjacencyList(), rt, pMap, *sourceRouter);
-  }
-  else {
-    // Multi Path
-    setNoLink(getNumOfLinkfromAdjMatrix(*sourceRouter));
-    allocateLinks();
-    allocateLinkCosts();
-    // Gets a sparse listing of adjacencies for path calculation
-    getLinksFromAdjMatrix(links, linkCosts, *sourceRouter);
-    for (int i = 0 ; i < vNoLink; i++) {
-      // Simulate that only the current neighbor is accessible
-      adjustAdMatrix(*sourceRouter, links[i], linkCosts[i]);
-      writeAdjMatrixLog(pMap);
-      // Do Dijkstra's algorithm using the current neighbor as your start.
-      doDijkstraPathCalculation(*sourceRouter);
-      // Update the routing table with the calculations.
-      addAllLsNextHopsToRoutingTable(confParam.getAdjacencyList(), rt, pMap, *sourceRouter);
-    }
-    freeLinks();
-    freeLinksCosts();
+  static const ndn::FaceUri NO_FACE_URI;
+
+  RoutingGraph::LinkRange firstLinks = graph.getLinks(m_sourceRouter);
+  m_firstHopFaceUris.resize(firstLinks.size());
+  m_firstHopFaces.resize(firstLinks.size());
+  for (size_t hop = 0; hop < firstLinks.size(); ++hop) {
+    // A neighbor that is not in the adjacency list has no face, as with getAdjacent()
+    auto adjacent = adjacencies.findAdjacent(m_routerNames[firstLinks[hop].to]);
+    const ndn::FaceUri& faceUri = adjacent != adjacencies.end() ? adjacent->getFaceUri() :
+                                                                  NO_FACE_URI;
+    if (m_firstHopFaces[hop].empty() || m_firstHopFaceUris[hop] != faceUri) {
+      m_firstHopFaceUris[hop] = faceUri;
+      m_firstHopFaces[hop] = faceUri.toString();
+    }
   }
-  freeParent();
-  freeDistance();
-  freeAdjMatrix();
 }
 
-void
-LinkStateRoutingTableCalculator::doDijkstraPathCalculation(int sourceRouter)
+const std::string&
+LinkStateRoutingTableCalculator::getFirstHopFace(int nextHopRouter) const
 {
-  int i;
-  int v, u;
-  int* Q = new int[m_nRouters]; // Each cell represents the router with that mapping no.
-  int head = 0;
-  // Initiate the parent
-  for (i = 0 ; i < static_cast<int>(m_nRouters); i++) {
-    m_parent[i] = EMPTY_PARENT;
-    // Array where the ith element is the distance to the router with mapping no i.
-    m_distance[i] = INF_DISTANCE;
-    Q[i] = i;
-  }
-  if (sourceRouter != NO_MAPPING_NUM) {
-    // Distance to source from source is always 0.
-    m_distance[sourceRouter] = 0;
-    sortQueueByDistance(Q, m_distance, head, m_nRouters);
-    // While we haven't visited every node.
-    while (head < static_cast<int>(m_nRouters)) {
-      u = Q[head]; // Set u to be the current node pointed to by head.
-      if (m_distance[u] == INF_DISTANCE) {
-        break; // This can only happen when there are no accessible nodes.
-      }
-      // Iterate over the adjacent nodes to u.
-      for (v = 0 ; v < static_cast<int>(m_nRouters); v++) {
-        // If the current node is accessible.
-        if (adjMatrix[u][v] >= 0) {
-          // And we haven't visited it yet.
-          if (isNotExplored(Q, v, head + 1, m_nRouters)) {
-            // And if the distance to this node + from this node to v
-            // is less than the distance from our source node to v
-            // that we got when we built the adj LSAs
-            if (m_distance[u] + adjMatrix[u][v] <  m_distance[v]) {
-              // Set the new distance
-              m_distance[v] = m_distance[u] + adjMatrix[u][v] ;
-              // Set how we get there.
-              m_parent[v] = u;
-            }
-          }
-        }
-      }
-      // Increment the head position, resort the list by distance from where we are.
-      head++;
-      sortQueueByDistance(Q, m_distance, head, m_nRouters);
-    }
-  }
-  delete [] Q;
+  // The links of this router are ordered by the router they lead to
+  RoutingGraph::LinkRange firstLinks = m_graph.getLinks(m_sourceRouter);
+  auto firstLink = std::lower_bound(firstLinks.begin(), firstLinks.end(), nextHopRouter,
+                                    [] (const RoutingGraph::Link& link, int router) {
+                                      return link.to < router;
+                                    });
+  return m_firstHopFaces[firstLink - firstLinks.begin()];
 }
 
 void
-LinkStateRoutingTableCalculator::addAllLsNextHopsToRoutingTable(AdjacencyList& adjacencies,
-                                                                RoutingTable& rt, Map& pMap,
-                                                                uint32_t sourceRouter)
+LinkStateRoutingTableCalculator::allocateParent(size_t nCalculations)
 {
-  NLSR_LOG_DEBUG("LinkStateRoutingTableCalculator::addAllNextHopsToRoutingTable Called");
-
-  int nextHopRouter = 0;
-
-  // For each router we have
-  for (size_t i = 0; i < m_nRouters ; i++) {
-    if (i != sourceRouter) {
-
-      // Obtain the next hop that was determined by the algorithm
-      nextHopRouter = getLsNextHop(i, sourceRouter);
-      // If this router is accessible at all
-      if (nextHopRouter != NO_NEXT_HOP) {
-
-        // Fetch its distance
-        double routeCost = m_distance[i];
-        // Fetch its actual name
-        ndn::optional<ndn::Name> nextHopRouterName= pMap.getRouterNameByMappingNo(nextHopRouter);
-        if (nextHopRouterName) {
-          std::string nextHopFace =
-            adjacencies.getAdjacent(*nextHopRouterName).getFaceUri().toString();
-          // Add next hop to routing table
-          NextHop nh(nextHopFace, routeCost);
-          rt.addNextHop(*(pMap.getRouterNameByMappingNo(i)), nh);
-
-        }
-      }
-    }
-  }
+  m_parents.resize(m_nRouters * nCalculations);
 }
 
-int
-LinkStateRoutingTableCalculator::getLsNextHop(int dest, int source)
+void
+LinkStateRoutingTableCalculator::allocateDistance(size_t nCalculations)
 {
-  int nextHop = NO_NEXT_HOP;
-  while (m_parent[dest] != EMPTY_PARENT) {
-    nextHop = dest;
-    dest = m_parent[dest];
-  }
-  if (dest != source) {
-    nextHop = NO_NEXT_HOP;
-  }
-  return nextHop;
+  m_distances.resize(m_nRouters * nCalculations);
 }
 
 void
-LinkStateRoutingTableCalculator::sortQueueByDistance(int* Q,
-                                                     double* dist,
-                                                     int start, int element)
+LinkStateRoutingTableCalculator::allocateWorkspaces()
 {
-  for (int i = start ; i < element ; i++) {
-    for (int j = i + 1; j < element; j++) {
-      if (dist[Q[j]] < dist[Q[i]]) {
-        int tempU = Q[j];
-        Q[j] = Q[i];
-        Q[i] = tempU;
-      }
-    }
-  }
+  m_workspaces.resize(std::max<size_t>(getTaskRunner().getConcurrency(), 1));
 }
 
-int
-LinkStateRoutingTableCalculator::isNotExplored(int* Q,
-                                               int u, int start, int element)
+LinkStateRoutingTableCalculator::Tree
+LinkStateRoutingTableCalculator::getTree(size_t n, size_t slot)
 {
-  int ret = 0;
-  for (int i = start; i < element; i++) {
-    if (Q[i] == u) {
-      ret = 1;
-      break;
-    }
-  }
-  return ret;
+  return Tree{m_parents.data() + n * m_nRouters, m_distances.data() + n * m_nRouters,
+              m_workspaces[slot]};
 }
 
-void
-LinkStateRoutingTableCalculator::allocateParent()
+TaskRunner&
+LinkStateRoutingTableCalculator::getTaskRunner()
 {
-  m_parent = new int[m_nRouters];
+  static TaskRunner sequentialRunner;
+  return m_taskRunner != nullptr ? *m_taskRunner : sequentialRunner;
 }
 
-void
-LinkStateRoutingTableCalculator::allocateDistance()
+bool
+LinkStateRoutingTableCalculator::isPreferredParent(const Tree& tree, int router, int parent)
 {
-  m_distance = new double[m_nRouters];
+  return std::make_pair(tree.distance[router], router) <
+         std::make_pair(tree.distance[parent], parent);
 }
 
+// The queue is ordered by (distance, router), so that ties are broken by mapping number
 void
-LinkStateRoutingTableCalculator::freeParent()
+LinkStateRoutingTableCalculator::pushToQueue(Workspace& workspace, double distance,
+                                             size_t router)
 {
-  delete [] m_parent;
+  workspace.queue.emplace_back(distance, router);
+  std::push_heap(workspace.queue.begin(), workspace.queue.end(),
+                 std::greater<std::pair<double, size_t>>());
 }
 
-void LinkStateRoutingTableCalculator::freeDistance()
+std::pair<double, size_t>
+LinkStateRoutingTableCalculator::popFromQueue(Workspace& workspace)
 {
-  delete [] m_distance;
+  std::pop_heap(workspace.queue.begin(), workspace.queue.end(),
+                std::greater<std::pair<double, size_t>>());
+  std::pair<double, size_t> entry = workspace.queue.back();
+  workspace.queue.pop_back();
+  return entry;
 }
 
 const double HyperbolicRoutingCalculator::MATH_PI = boost::math::constants::pi<double>();
@@ -428,50 +548,61 @@ const double HyperbolicRoutingCalculator::UNKNOWN_DISTANCE = -1.0;
 const double HyperbolicRoutingCalculator::UNKNOWN_RADIUS   = -1.0;
 
 void
-HyperbolicRoutingCalculator::calculatePath(Map& map, RoutingTable& rt,
+HyperbolicRoutingCalculator::calculatePath(Map& map, NextHopReceiver& rt,
                                            Lsdb& lsdb, AdjacencyList& adjacencies)
+{
+  calculatePath(map, rt, lsdb.getCoordinateLsdb(), adjacencies);
+}
+
+void
+HyperbolicRoutingCalculator::calculatePath(Map& map, NextHopReceiver& rt,
+                                           const CoordinateLsaContainer& coordinateLsas,
+                                           AdjacencyList& adjacencies)
 {
   NLSR_LOG_TRACE("Calculating hyperbolic paths");
 
+  loadCoordinates(map, coordinateLsas);
+
   ndn::optional<int32_t> thisRouter = map.getMappingNoByRouterName(m_thisRouterName);
 
   // Iterate over directly connected neighbors
-  std::list<Adjacent> neighbors = adjacencies.getAdjList();
-  for (std::list<Adjacent>::iterator adj = neighbors.begin(); adj != neighbors.end(); ++adj) {
+  for (const Adjacent& adj : adjacencies.getAdjList()) {
 
     // Don't calculate nexthops using an inactive router
-    if (adj->getStatus() == Adjacent::STATUS_INACTIVE) {
-      NLSR_LOG_TRACE(adj->getName() << " is inactive; not using it as a nexthop");
+    if (adj.getStatus() == Adjacent::STATUS_INACTIVE) {
+      NLSR_LOG_TRACE(adj.getName() << " is inactive; not using it as a nexthop");
       continue;
     }
 
-    ndn::Name srcRouterName = adj->getName();
+    const ndn::Name& srcRouterName = adj.getName();
 
     // Don't calculate nexthops for this router to other routers
     if (srcRouterName == m_thisRouterName) {
       continue;
     }
 
-    std::string srcFaceUri = adj->getFaceUri().toString();
+    std::string srcFaceUri = adj.getFaceUri().toString();
 
     // Install nexthops for this router to the neighbor; direct neighbors have a 0 cost link
     addNextHop(srcRouterName, srcFaceUri, 0, rt);
 
     ndn::optional<int32_t> src = map.getMappingNoByRouterName(srcRouterName);
 
-    if (!src) {
-      NLSR_LOG_WARN(adj->getName() << " does not exist in the router map!");
+    if (!src || *src >= static_cast<int32_t>(m_nRouters)) {
+      NLSR_LOG_WARN(adj.getName() << " does not exist in the router map!");
       continue;
     }
 
     // Get hyperbolic distance from direct neighbor to every other router
+    calculateDistancesFrom(*src);
+
     for (int dest = 0; dest < static_cast<int>(m_nRouters); ++dest) {
       // Don't calculate nexthops to this router or from a router to itself
       if (thisRouter && dest != *thisRouter && dest != *src) {
 
         ndn::optional<ndn::Name> destRouterName = map.getRouterNameByMappingNo(dest);
         if (destRouterName) {
-          double distance = getHyperbolicDistance(lsdb, srcRouterName, *destRouterName);
+          double distance = m_distances[dest];
 
           // Could not compute distance
           if (distance == UNKNOWN_DISTANCE) {
@@ -486,148 +617,130 @@ HyperbolicRoutingCalculator::calculatePath(Map& map, RoutingTable& rt,
   }
 }
 
-double
-HyperbolicRoutingCalculator::getHyperbolicDistance(Lsdb& lsdb, ndn::Name src, ndn::Name dest)
+void
+HyperbolicRoutingCalculator::loadCoordinates(Map& map,
+                                             const CoordinateLsaContainer& coordinateLsas)
 {
-  NLSR_LOG_TRACE("Calculating hyperbolic distance from " << src << " to " << dest);
-
-  double distance = UNKNOWN_DISTANCE;
-
-  ndn::Name srcLsaKey = src;
-  srcLsaKey.append(std::to_string(Lsa::Type::COORDINATE));
-
-  CoordinateLsa* srcLsa = lsdb.findCoordinateLsa(srcLsaKey);
-
-  ndn::Name destLsaKey = dest;
-  destLsaKey.append(std::to_string(Lsa::Type::COORDINATE));
-
-  CoordinateLsa* destLsa = lsdb.findCoordinateLsa(destLsaKey);
-
-  // Coordinate LSAs do not exist for these routers
-  if (srcLsa == nullptr || destLsa == nullptr) {
-    return UNKNOWN_DISTANCE;
-  }
-
-  std::vector<double> srcTheta = srcLsa->getCorTheta();
-  std::vector<double> destTheta = destLsa->getCorTheta();
-
-  double srcRadius = srcLsa->getCorRadius();
-  double destRadius = destLsa->getCorRadius();
+  // It is not possible for angle vector size to be zero as ensured by conf-file-processor,
+  // but LSAs from other routers are checked all the same
+  std::vector<const CoordinateLsa*> lsas(m_nRouters, nullptr);
+  size_t maxAngles = 0;
+
+  for (const CoordinateLsa& lsa : coordinateLsas) {
+    ndn::optional<int32_t> router = map.getMappingNoByRouterName(lsa.getOrigRouter());
+    if (!router || *router >= static_cast<int32_t>(m_nRouters)) {
+      continue;
+    }
 
-  double diffTheta = calculateAngularDistance(srcTheta, destTheta);
+    const std::vector<double>& angles = lsa.getCorTheta();
+    if (angles.empty()) {
+      NLSR_LOG_ERROR("No angles for " << lsa.getOrigRouter());
+      continue;
+    }
+    if (angles.back() > 2.*M_PI || angles.back() < 0.0) {
+      NLSR_LOG_ERROR("Angle not within [0, 2PI] for " << lsa.getOrigRouter());
+      continue;
+    }
 
-  if (srcRadius == UNKNOWN_RADIUS || destRadius == UNKNOWN_RADIUS ||
-      diffTheta == UNKNOWN_DISTANCE) {
-    return UNKNOWN_DISTANCE;
+    lsas[*router] = &lsa;
+    maxAngles = std::max(maxAngles, angles.size());
   }
 
-  // double r_i, double r_j, double delta_theta, double zeta = 1 (default)
-  distance = calculateHyperbolicDistance(srcRadius, destRadius, diffTheta);
-
-  NLSR_LOG_TRACE("Distance from " << src << " to " << dest << " is " << distance);
+  m_dimension = maxAngles + 1;
+  m_points.assign(m_dimension * m_nRouters, 0.0);
+  m_radii.assign(m_nRouters, UNKNOWN_RADIUS);
+  m_coshRadii.assign(m_nRouters, 0.0);
+  m_sinhRadii.assign(m_nRouters, 0.0);
+  m_nAngles.assign(m_nRouters, 0);
+  m_innerProducts.resize(m_nRouters);
+  m_distances.resize(m_nRouters);
 
-  return distance;
-}
+  // https://en.wikipedia.org/wiki/N-sphere#Spherical_coordinates
+  for (size_t i = 0; i < m_nRouters; ++i) {
+    if (lsas[i] == nullptr) {
+      continue;
+    }
 
-double
-HyperbolicRoutingCalculator::calculateAngularDistance(std::vector<double> angleVectorI,
-                                                      std::vector<double> angleVectorJ)
-{
-  // It is not possible for angle vector size to be zero as ensured by conf-file-processor
+    const std::vector<double>& angles = lsas[i]->getCorTheta();
+    const size_t nAngles = angles.size();
+    auto point = [this, i] (size_t k) -> double& {
+      return m_points[k * m_nRouters + i];
+    };
 
-  // https://en.wikipedia.org/wiki/N-sphere#Spherical_coordinates
+    // Calculate x0 of the vector
+    point(0) = std::cos(angles[0]);
 
-  // Check if two vector lengths are the same
-  if (angleVectorI.size() != angleVectorJ.size()) {
-    NLSR_LOG_ERROR("Angle vector sizes do not match");
-    return UNKNOWN_DISTANCE;
-  }
+    // Calculate xn of the vector, the aggregation of the (n-1) angular coordinates
+    double xn = std::sin(angles[nAngles - 1]);
+    for (size_t k = 0; k < nAngles - 1; k++) {
+      xn *= std::sin(angles[k]);
+    }
+    point(1) = xn;
 
-  // Check if all angles are within the [0, PI] and [0, 2PI] ranges
-  if (angleVectorI.size() > 1) {
-    for (unsigned int k = 0; k < angleVectorI.size() - 1; k++) {
-      if ((angleVectorI[k] > M_PI && angleVectorI[k] < 0.0) ||
-          (angleVectorJ[k] > M_PI && angleVectorJ[k] < 0.0)) {
-        NLSR_LOG_ERROR("Angle outside [0, PI]");
-        return UNKNOWN_DISTANCE;
+    // Calculate the coordinates in between, assuming R_sphere = 1
+    for (size_t m = 1; m < nAngles; m++) {
+      double xm = std::cos(angles[m]);
+      for (size_t l = 0; l < m; l++) {
+        xm *= std::sin(angles[l]);
       }
+      point(m + 1) = xm;
     }
-  }
-  if (angleVectorI[angleVectorI.size()-1] > 2.*M_PI ||
-      angleVectorI[angleVectorI.size()-1] < 0.0) {
-    NLSR_LOG_ERROR("Angle not within [0, 2PI]");
-    return UNKNOWN_DISTANCE;
-  }
 
-  if (angleVectorI[angleVectorI.size()-1] > 2.*M_PI ||
-      angleVectorI[angleVectorI.size()-1] < 0.0) {
-    NLSR_LOG_ERROR("Angle not within [0, 2PI]");
-    return UNKNOWN_DISTANCE;
+    // Usually, we set zeta = 1 in all experiments
+    double radius = lsas[i]->getCorRadius();
+    m_radii[i] = radius;
+    m_coshRadii[i] = std::cosh(radius);
+    m_sinhRadii[i] = std::sinh(radius);
+    m_nAngles[i] = nAngles;
   }
+}
 
-  // deltaTheta = arccos(vectorI . vectorJ) -> do the inner product
-  double innerProduct = 0.0;
-
-  // Calculate x0 of the vectors
-  double x0i = std::cos(angleVectorI[0]);
-  double x0j = std::cos(angleVectorJ[0]);
+void
+HyperbolicRoutingCalculator::calculateDistancesFrom(int32_t src)
+{
+  HyperbolicPoints points{m_nRouters, m_dimension, m_points.data(),
+                          m_coshRadii.data(), m_sinhRadii.data()};
+  computeHyperbolicDistances(points, src, m_innerProducts.data(), m_distances.data());
 
-  // Calculate xn of the vectors
-  double xni = std::sin(angleVectorI[angleVectorI.size() - 1]);
-  double xnj = std::sin(angleVectorJ[angleVectorJ.size() - 1]);
+  for (size_t dest = 0; dest < m_nRouters; ++dest) {
+    if (static_cast<int32_t>(dest) == src) {
+      m_distances[dest] = UNKNOWN_DISTANCE;
+      continue;
+    }
 
-  // Do the aggregation of the (n-1) coordinates (if there is more than one angle)
-  // i.e contraction of all (n-1)-dimensional angular coordinates to one variable
-  for (unsigned int k = 0; k < angleVectorI.size() - 1; k++) {
-    xni *= std::sin(angleVectorI[k]);
-    xnj *= std::sin(angleVectorJ[k]);
-  }
-  innerProduct += (x0i * x0j) + (xni * xnj);
-
-  // If d > 1
-  if (angleVectorI.size() > 1) {
-    for (unsigned int m = 1; m < angleVectorI.size(); m++) {
-      // calculate euclidean coordinates given the angles and assuming R_sphere = 1
-      double xmi = std::cos(angleVectorI[m]);
-      double xmj = std::cos(angleVectorJ[m]);
-      for (unsigned int l = 0; l < m; l++) {
-        xmi *= std::sin(angleVectorI[l]);
-        xmj *= std::sin(angleVectorJ[l]);
-      }
-      innerProduct += xmi * xmj;
+    // Coordinate LSAs do not exist for these routers
+    if (m_nAngles[src] == 0 || m_nAngles[dest] == 0) {
+      m_distances[dest] = UNKNOWN_DISTANCE;
+      continue;
     }
-  }
 
-  // ArcCos of the inner product gives the angular distance
-  // between two points on a d-dimensional sphere
-  return std::acos(innerProduct);
-}
+    // Check if two vector lengths are the same
+    if (m_nAngles[src] != m_nAngles[dest]) {
+      NLSR_LOG_ERROR("Angle vector sizes do not match");
+      m_distances[dest] = UNKNOWN_DISTANCE;
+      continue;
+    }
 
-double
-HyperbolicRoutingCalculator::calculateHyperbolicDistance(double rI, double rJ,
-                                                         double deltaTheta)
-{
-  if (deltaTheta == UNKNOWN_DISTANCE) {
-    return UNKNOWN_DISTANCE;
-  }
+    if (m_radii[src] == UNKNOWN_RADIUS || m_radii[dest] == UNKNOWN_RADIUS) {
+      m_distances[dest] = UNKNOWN_DISTANCE;
+      continue;
+    }
 
-  // Usually, we set zeta = 1 in all experiments
-  double zeta = 1;
+    // An inner product of 1 means that the angular distance, its arc cosine, is 0
+    if (m_innerProducts[dest] >= 1.0 || m_radii[src] <= 0.0 || m_radii[dest] <= 0.0) {
+      NLSR_LOG_ERROR("Delta theta or rI or rJ is <= 0");
+      NLSR_LOG_ERROR("Please make sure that no two nodes have the exact same HR coordinates");
+      m_distances[dest] = UNKNOWN_DISTANCE;
+      continue;
+    }
 
-  if (deltaTheta <= 0.0 || rI <= 0.0 || rJ <= 0.0) {
-    NLSR_LOG_ERROR("Delta theta or rI or rJ is <= 0");
-    NLSR_LOG_ERROR("Please make sure that no two nodes have the exact same HR coordinates");
-    return UNKNOWN_DISTANCE;
+    NLSR_LOG_TRACE("Distance from " << src << " to " << dest << " is " << m_distances[dest]);
   }
-
-  double xij = (1. / zeta) * std::acosh(std::cosh(zeta*rI) * std::cosh(zeta*rJ) -
-               std::sinh(zeta*rI)*std::sinh(zeta*rJ)*std::cos(deltaTheta));
-  return xij;
 }
 
 void
 HyperbolicRoutingCalculator::addNextHop(ndn::Name dest, std::string faceUri,
-                                        double cost, RoutingTable& rt)
+                                        double cost, NextHopReceiver& rt)
 {
   NextHop hop(faceUri, cost);
   hop.setHyperbolic(true);
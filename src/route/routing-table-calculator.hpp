@@ -23,11 +23,19 @@
 #define NLSR_ROUTING_TABLE_CALCULATOR_HPP
 
 #include "common.hpp"
+#include "adjacency-list.hpp"
 #include "lsa.hpp"
 #include "conf-parameter.hpp"
+#include "test-access-control.hpp"
+#include "route/nexthop.hpp"
+#include "route/routing-graph.hpp"
+#include "route/routing-table-entry.hpp"
 
+#include <functional>
 #include <list>
 #include <iostream>
+#include <utility>
+#include <vector>
 #include <boost/cstdint.hpp>
 
 #include <ndn-cxx/name.hpp>
@@ -35,96 +43,91 @@
 namespace nlsr {
 
 class Map;
-class RoutingTable;
 
-class RoutingTableCalculator
+/*! \brief Receives the next hops found by a routing table calculator.
+
+  RoutingTable is one. A calculation on the worker threads collects the next hops in a
+  table of its own instead, which is handed to the routing table once it is done.
+*/
+class NextHopReceiver
 {
 public:
-  RoutingTableCalculator(size_t nRouters)
-  {
-    m_nRouters = nRouters;
-  }
+  virtual
+  ~NextHopReceiver() = default;
 
-protected:
-  /*! \brief Allocate the space needed for the adj. matrix. */
-  void
-  allocateAdjMatrix();
+  virtual void
+  addNextHop(const ndn::Name& destRouter, NextHop& nh) = 0;
 
-  /*! \brief set NON_ADJACENT_COST i.e. -12345 to every cell of the matrix to
-    ensure that the memory is safe. This is also to incorporate zero cost links */
-  void
-  initMatrix();
+  virtual void
+  addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh) = 0;
+};
 
-  /*! \brief Constructs an adj. matrix to calculate with.
-    \param adjLsaList The Adjacency Lsa list.
-    \param pMap The map to populate with the adj. data.
-  */
-  void
-  makeAdjMatrix(const std::list<AdjLsa>& adjLsaList, Map& pMap);
+/*! \brief Runs the independent parts of a calculation.
 
-  /*! \brief Writes a formated adjacent matrix to DEBUG log
-    \param map The map containing adjacent matrix data
-  */
-  void
-  writeAdjMatrixLog(const Map& map) const;
-
-  /*! \brief Returns how many links a router in the matrix has.
-    \param sRouter The router to count the links of.
-  */
-  int
-  getNumOfLinkfromAdjMatrix(int sRouter);
+  The link-state calculator hands it the shortest-path trees of a multipath calculation,
+  one per neighbor of this router. This runner calculates them one after the other on the
+  calling thread; RoutingTable has one that spreads them over its worker threads.
+*/
+class TaskRunner
+{
+public:
+  virtual
+  ~TaskRunner() = default;
 
-  void
-  freeAdjMatrix();
-  /*! \brief Adjust a link cost in the adj. matrix
-    \param source The source router whose adjacency to adjust.
-    \param link The adjacency of the source to adjust.
-    \param linkCost The cost to change to.
-  */
-  void
-  adjustAdMatrix(int source, int link, double linkCost);
+  /*! \brief Returns how many tasks may run at once, and thus the number of slots. */
+  virtual size_t
+  getConcurrency() const
+  {
+    return 1;
+  }
 
-  /*! \brief Populates temp. variables with the link costs for some router.
-    \param source The router whose values are to be adjusted.
-    \param links An integer pointer array for the link mappingNos.
-    \param linkCosts A double pointer array that stores the link costs.
+  /*! \brief Calls task(n, slot) for every n below nTasks, and returns when all are done.
 
-    Obtains a sparse list of adjacencies and link costs for some
-    router. Since this is sparse, that means while generating these
-    arrays, if there is no adjacency at i in the matrix, these
-    temporary variables will not contain a NON_ADJACENT_COST (-12345) at i,
-    but rather will contain the values for the next valid adjacency.
+    The slot is below getConcurrency(), and no two tasks running at once get the same slot,
+    so that a task can use the scratch space of its slot.
   */
-  void
-  getLinksFromAdjMatrix(int* links, double* linkCosts, int source);
+  virtual void
+  run(size_t nTasks, const std::function<void(size_t n, size_t slot)>& task);
+};
 
-  /*! Allocates an array large enough to hold multipath calculation temps. */
-  void
-  allocateLinks();
+/*! \brief The configuration of this router that the calculators depend on.
 
-  void
-  allocateLinkCosts();
+  It is copied out of ConfParameter when a calculation starts, so that the calculation
+  does not see the adjacencies of this router change while it runs on a worker thread.
+*/
+struct CalculationParameters
+{
+  explicit
+  CalculationParameters(ConfParameter& confParam)
+    : routerPrefix(confParam.getRouterPrefix())
+    , maxFacesPerPrefix(confParam.getMaxFacesPerPrefix())
+    , adjacencies(confParam.getAdjacencyList())
+  {
+  }
 
-  void
-  freeLinks();
+  CalculationParameters(const ndn::Name& routerPrefix, uint32_t maxFacesPerPrefix,
+                        const AdjacencyList& adjacencies)
+    : routerPrefix(routerPrefix)
+    , maxFacesPerPrefix(maxFacesPerPrefix)
+    , adjacencies(adjacencies)
+  {
+  }
 
-  void
-  freeLinksCosts();
+  ndn::Name routerPrefix;
+  uint32_t maxFacesPerPrefix;
+  AdjacencyList adjacencies;
+};
 
-  void
-  setNoLink(int nl)
+class RoutingTableCalculator
+{
+public:
+  RoutingTableCalculator(size_t nRouters)
   {
-    vNoLink = nl;
+    m_nRouters = nRouters;
   }
 
 protected:
-  double** adjMatrix;
   size_t m_nRouters;
-
-  int vNoLink;
-  int* links;
-  double* linkCosts;
-
 };
 
 class LinkStateRoutingTableCalculator: public RoutingTableCalculator
@@ -132,70 +135,244 @@ class LinkStateRoutingTableCalculator: public RoutingTableCalculator
 public:
   LinkStateRoutingTableCalculator(size_t nRouters)
     : RoutingTableCalculator(nRouters)
+    , m_hasPaths(false)
+    , m_sourceRouter(NO_MAPPING_NUM)
+    , m_isSinglePath(true)
+    , m_taskRunner(nullptr)
   {
   }
 
   void
-  calculatePath(Map& pMap, RoutingTable& rt, ConfParameter& confParam,
-                const std::list<AdjLsa>& adjLsaList);
+  calculatePath(Map& pMap, NextHopReceiver& rt, CalculationParameters& parameters,
+                const AdjLsaContainer& adjLsaList);
 
-private:
-  /*! \brief Performs a Dijkstra's calculation over the adjacency matrix.
-    \param sourceRouter The origin router to compute paths from.
+  void
+  calculatePath(Map& pMap, NextHopReceiver& rt, ConfParameter& confParam,
+                const AdjLsaContainer& adjLsaList)
+  {
+    CalculationParameters parameters(confParam);
+    calculatePath(pMap, rt, parameters, adjLsaList);
+  }
+
+  /*! \brief Repairs the paths of the previous calculation after adjacencies changed.
+    \param pMap The map of the routers, built from the current LSDB.
+    \param parameters The configuration of this router.
+    \param adjLsaList The current adjacency LSAs.
+    \param[out] changedEntries Receives a routing table entry for every destination whose
+    next hops changed. A destination that is no longer reachable gets an entry without
+    next hops.
+    \return false if the previous paths cannot be repaired, in which case calculatePath()
+    must be called instead.
+
+    The repaired paths are the ones calculatePath() would find, down to the next hops
+    chosen among equal-cost paths. They cannot be repaired if any link costs zero.
+
+    Only the parts of the shortest-path trees below links whose cost went up or which went
+    away are recalculated, from their remaining neighbors and from links whose cost went
+    down. The paths can only be repaired if the set of routers and their mapping numbers
+    have not changed, and if the links and faces of this router are the same as before.
+  */
+  bool
+  updatePath(Map& pMap, CalculationParameters& parameters, const AdjLsaContainer& adjLsaList,
+             std::list<RoutingTableEntry>& changedEntries);
+
+  bool
+  updatePath(Map& pMap, ConfParameter& confParam, const AdjLsaContainer& adjLsaList,
+             std::list<RoutingTableEntry>& changedEntries)
+  {
+    CalculationParameters parameters(confParam);
+    return updatePath(pMap, parameters, adjLsaList, changedEntries);
+  }
+
+  /*! \brief Forgets the paths of the previous calculation.
+
+    The routing table must call this whenever it changes its entries without this
+    calculator, so that a later updatePath() does not repair stale paths.
   */
   void
-  doDijkstraPathCalculation(int sourceRouter);
+  clearPaths()
+  {
+    m_hasPaths = false;
+  }
 
-  /*! \brief Sort the elements of a list.
-    \param Q The array that contains the elements to sort.
-    \param dist The array that contains the distances.
-    \param start The first element in the list to sort.
-    \param element The last element in the list to sort through.
+  /*! \brief Sets the runner of the calculations of the shortest-path trees.
 
-    Sorts the list based on distance. The distances are indexed by
-    their mappingNo in dist. Currently uses an insertion sort.
+    By default, the trees are calculated one after the other on the calling thread. The
+    runner must outlive the calculator.
+  */
+  void
+  setTaskRunner(TaskRunner& taskRunner)
+  {
+    m_taskRunner = &taskRunner;
+  }
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /*! \brief Scratch space of the calculations.
 
-    The cost between two nodes can be zero or greater than zero.
+    The calculator is kept by the routing table between calculations, and so is this
+    space, which only grows with the number of routers and links. Once it has reached the
+    size of the network, calculating the paths again does not allocate.
 
+    There is one workspace per slot of the task runner, so that the trees can be calculated
+    at the same time.
+  */
+  struct Workspace
+  {
+    // Min-heap of (distance, router), kept with std::push_heap and std::pop_heap
+    std::vector<std::pair<double, size_t>> queue;
+    std::vector<bool> isExplored;
+
+    // doIncrementalPathCalculation()
+    std::vector<int> firstChild;
+    std::vector<int> nextSibling;
+    std::vector<bool> isInvalid;
+    std::vector<int> invalid;
+    std::vector<int> stack;
+
+    // updatePath(), which only uses the changes of the first workspace
+    std::vector<RoutingGraph::LinkChange> changes;
+    std::vector<bool> isChanged;
+    std::vector<double> oldDistance;
+    std::vector<int> nextHop;
+
+    // getAllLsNextHops()
+    std::vector<int> path;
+
+    // The next hop handed to the routing table, reused so that its face URI keeps its space
+    NextHop nh;
+  };
+
+  /*! \brief A shortest-path tree, within m_parents and m_distances, and the workspace it
+    is calculated in.
+  */
+  struct Tree
+  {
+    int* parent;
+    double* distance;
+    Workspace& workspace;
+  };
+
+private:
+  /*! \brief Performs a Dijkstra's calculation over the routing graph.
+    \param tree The tree to calculate.
+    \param graph The graph to calculate paths over.
+    \param sourceRouter The origin router to compute paths from.
+    \param firstHop If not NO_MAPPING_NUM, the only router the source may reach directly.
+
+    Uses a binary heap keyed by distance, so that one calculation costs
+    O((N + E) log N) rather than re-sorting every router on each step.
+
+    Routers at the same distance are explored in the order of their mapping numbers. Of
+    the routers that reach a router at its distance, the one explored first becomes its
+    parent, which, as long as every link costs more than zero, is the one preferred by
+    isPreferredParent(). Equal-cost paths thus always resolve to the same next hop.
+  */
+  void
+  doDijkstraPathCalculation(const Tree& tree, const RoutingGraph& graph, int sourceRouter,
+                            int firstHop = NO_MAPPING_NUM);
+
+  /*! \brief Repairs a tree after links changed.
+    \param tree The tree to repair.
+    \param graph The graph with the changed links.
+    \param firstHop If not NO_MAPPING_NUM, the only router the source may reach directly.
+    \param changes The links that changed, each listed once.
   */
   void
-  sortQueueByDistance(int* Q, double* dist, int start, int element);
+  doIncrementalPathCalculation(const Tree& tree, const RoutingGraph& graph, int firstHop,
+                               const std::vector<RoutingGraph::LinkChange>& changes);
 
-  /*! \brief Returns whether an element has been visited yet.
-    \param Q The list of elements to look through.
-    \param u The element to check.
-    \param start The start of list to look through.
-    \param element The end of the list to look through.
+  /*! \brief Hands the next hops of a tree to the routing table.
+    \param rt The routing table to receive the next hops.
+    \param tree The tree the next hops were determined from.
+    \param nextHop The next hop of every router in the tree, from getAllLsNextHops().
   */
-  int
-  isNotExplored(int* Q, int u, int start, int element);
+  void
+  addAllLsNextHopsToRoutingTable(NextHopReceiver& rt, const Tree& tree, const int* nextHop);
 
+  /*! \brief Determines the next hop of every router in a tree.
+    \param tree The tree to follow.
+    \param[out] nextHop Receives one next hop, or NO_NEXT_HOP, per router.
+  */
   void
-  addAllLsNextHopsToRoutingTable(AdjacencyList& adjacencies, RoutingTable& rt,
-                                 Map& pMap, uint32_t sourceRouter);
+  getAllLsNextHops(const Tree& tree, int* nextHop) const;
 
-  /*! \brief Determines a destination's next hop.
-    \param dest The router whose next hop we want to determine.
-    \param source The router to determine a next path to.
+  /*! \brief Copies the names of the routers out of the map, by mapping number.
   */
-  int
-  getLsNextHop(int dest, int source);
+  void
+  loadRouterNames(const Map& pMap);
+
+  /*! \brief Looks up the faces of the links of this router in a graph.
 
+    The face URIs are only converted to strings again when they have changed, so that
+    they can be handed to the routing table without converting one per destination.
+  */
   void
-  allocateParent();
+  loadFirstHopFaces(const RoutingGraph& graph, AdjacencyList& adjacencies);
+
+  /*! \brief Returns the face of the link of this router that leads to a router.
+
+    The link is looked up in m_graph, which must be the graph loadFirstHopFaces() was
+    given.
+  */
+  const std::string&
+  getFirstHopFace(int nextHopRouter) const;
 
   void
-  allocateDistance();
+  allocateParent(size_t nCalculations = 1);
 
   void
-  freeParent();
+  allocateDistance(size_t nCalculations = 1);
 
+  /*! \brief Makes one workspace for each slot of the task runner. */
   void
-  freeDistance();
+  allocateWorkspaces();
+
+  /*! \brief Returns the tree of the nth calculation, with the workspace of a slot. */
+  Tree
+  getTree(size_t n, size_t slot = 0);
+
+  TaskRunner&
+  getTaskRunner();
+
+  /*! \brief Returns whether a router is preferred over the current parent of a router it
+    reaches at the same distance.
+
+    The router closer to the source is preferred, then the one with the lower mapping
+    number. A full and a repaired calculation both follow this rule.
+  */
+  static bool
+  isPreferredParent(const Tree& tree, int router, int parent);
+
+  static void
+  pushToQueue(Workspace& workspace, double distance, size_t router);
+
+  static std::pair<double, size_t>
+  popFromQueue(Workspace& workspace);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  // Kept after a calculation, so that updatePath() can repair it
+  std::vector<int> m_parents;
+  std::vector<double> m_distances;
+
+private:
+  std::vector<int> m_nextHops;
+  bool m_hasPaths;
+  // The graph of the kept paths, and the one the next calculation is built in. Both are
+  // reused, so that rebuilding the graph does not allocate once it has grown to size.
+  RoutingGraph m_graph;
+  RoutingGraph m_newGraph;
+  std::vector<ndn::Name> m_routerNames;
+  // The faces of the links of this router, in the order of its links in the graph
+  std::vector<ndn::FaceUri> m_firstHopFaceUris;
+  std::vector<std::string> m_firstHopFaces;
+  int m_sourceRouter;
+  bool m_isSinglePath;
+  TaskRunner* m_taskRunner;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::vector<Workspace> m_workspaces;
 
 private:
-  int* m_parent;
-  double* m_distance;
 
   static const int EMPTY_PARENT;
   static const double INF_DISTANCE;
@@ -214,31 +391,58 @@ public:
     : m_nRouters(nRouters)
     , m_isDryRun(isDryRun)
     , m_thisRouterName(thisRouterName)
+    , m_dimension(0)
   {
   }
 
   void
-  calculatePath(Map& map, RoutingTable& rt, Lsdb& lsdb, AdjacencyList& adjacencies);
+  calculatePath(Map& map, NextHopReceiver& rt, const CoordinateLsaContainer& coordinateLsas,
+                AdjacencyList& adjacencies);
+
+  void
+  calculatePath(Map& map, NextHopReceiver& rt, Lsdb& lsdb, AdjacencyList& adjacencies);
 
 private:
-  double
-  getHyperbolicDistance(Lsdb& lsdb, ndn::Name src, ndn::Name dest);
+  /*! \brief Loads the coordinates of the routers in the map from their coordinate LSAs.
 
+    The angles of each router are converted once to a point on the unit sphere, so that the
+    angular distance of two routers is the arc cosine of an inner product. The points are
+    stored one coordinate per array, as the batch distance kernel expects them.
+  */
   void
-  addNextHop(ndn::Name destinationRouter, std::string faceUri, double cost, RoutingTable& rt);
+  loadCoordinates(Map& map, const CoordinateLsaContainer& coordinateLsas);
+
+  /*! \brief Computes the hyperbolic distances from one router to every router.
+    \param src The mapping number of the router.
 
-  double
-  calculateHyperbolicDistance(double rI, double rJ, double deltaTheta);
+    Afterwards, m_distances holds the distance to each router by mapping number, or
+    UNKNOWN_DISTANCE where it cannot be computed.
+  */
+  void
+  calculateDistancesFrom(int32_t src);
 
-  double
-  calculateAngularDistance(std::vector<double> angleVectorI,
-                           std::vector<double> angleVectorJ);
+  void
+  addNextHop(ndn::Name destinationRouter, std::string faceUri, double cost, NextHopReceiver& rt);
 
 private:
   const size_t m_nRouters;
   const bool m_isDryRun;
   const ndn::Name m_thisRouterName;
 
+  // m_points[k * m_nRouters + i] is coordinate k of the point of router i, zero when the
+  // router has fewer angles than others
+  size_t m_dimension;
+  std::vector<double> m_points;
+  std::vector<double> m_radii;
+  std::vector<double> m_coshRadii;
+  std::vector<double> m_sinhRadii;
+  // The number of angles of each router, 0 if its coordinates are not known
+  std::vector<size_t> m_nAngles;
+
+  // Output of the distance kernel, by mapping number
+  std::vector<double> m_innerProducts;
+  std::vector<double> m_distances;
+
   static const double MATH_PI;
   static const double UNKNOWN_DISTANCE;
   static const double UNKNOWN_RADIUS;
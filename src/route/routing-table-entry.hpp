@@ -22,6 +22,7 @@
 #ifndef NLSR_ROUTING_TABLE_ENTRY_HPP
 #define NLSR_ROUTING_TABLE_ENTRY_HPP
 
+#include "name-pool.hpp"
 #include "nexthop-list.hpp"
 
 #include <iostream>
@@ -51,6 +52,12 @@ public:
     return m_destination;
   }
 
+  const InternedName&
+  getInternedDestination() const
+  {
+    return m_destination;
+  }
+
   NexthopList&
   getNexthopList()
   {
@@ -72,7 +79,7 @@ public:
   }
 
 protected:
-  ndn::Name m_destination;
+  InternedName m_destination;
   NexthopList m_nexthopList;
 };
 
@@ -104,7 +104,7 @@ public:
   }
 
 public:
-  std::unordered_map<ndn::Name, std::weak_ptr<NamePrefixTableEntry>>
+  std::unordered_map<InternedName, std::weak_ptr<NamePrefixTableEntry>>
     namePrefixTableEntries;
 
 private:
@@ -27,32 +27,306 @@
 #include "name-prefix-table.hpp"
 #include "logger.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace nlsr {
 
 INIT_LOGGER(route.RoutingTable);
 
-RoutingTable::RoutingTable(ndn::Scheduler& scheduler, Fib& fib, Lsdb& lsdb,
-                           NamePrefixTable& namePrefixTable, ConfParameter& confParam)
+void
+RoutingTableEntries::addNextHop(const ndn::Name& destRouter, const NextHop& nh)
+{
+  RoutingTableEntry* entry = find(destRouter);
+  if (entry == nullptr) {
+    entry = &add(destRouter);
+  }
+  entry->getNexthopList().addNextHop(nh);
+}
+
+RoutingTableEntry*
+RoutingTableEntries::find(const ndn::Name& destRouter)
+{
+  auto it = m_index.find(destRouter);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+  return &**it;
+}
+
+void
+RoutingTableEntries::update(const RoutingTableEntry& entry)
+{
+  auto it = m_index.find(entry.getInternedDestination());
+  if (entry.getNexthopList().size() == 0) {
+    if (it != m_index.end()) {
+      EntryIterator removed = *it;
+      m_index.erase(it);
+      *removed = RoutingTableEntry();
+      m_spareEntries.splice(m_spareEntries.end(), m_entries, removed);
+    }
+  }
+  else if (it != m_index.end()) {
+    **it = entry;
+  }
+  else {
+    add(entry.getDestination()) = entry;
+  }
+}
+
+void
+RoutingTableEntries::clear()
+{
+  // The entries let go of their destinations and next hops, but not of their list nodes
+  for (auto& entry : m_entries) {
+    entry = RoutingTableEntry();
+  }
+  m_spareEntries.splice(m_spareEntries.end(), m_entries);
+  m_index.clear();
+}
+
+void
+RoutingTableEntries::swap(std::list<RoutingTableEntry>& entries)
+{
+  m_entries.swap(entries);
+  reindex();
+}
+
+void
+RoutingTableEntries::swap(RoutingTableEntries& other)
+{
+  // The iterators of the indexes move along with the list nodes they refer to
+  m_entries.swap(other.m_entries);
+  m_spareEntries.swap(other.m_spareEntries);
+  m_index.swap(other.m_index);
+}
+
+RoutingTableEntry&
+RoutingTableEntries::add(const ndn::Name& destRouter)
+{
+  if (m_spareEntries.empty()) {
+    m_entries.emplace_back(destRouter);
+  }
+  else {
+    m_entries.splice(m_entries.end(), m_spareEntries, m_spareEntries.begin());
+    m_entries.back() = RoutingTableEntry(destRouter);
+  }
+  m_index.insert(std::prev(m_entries.end()));
+  return m_entries.back();
+}
+
+void
+RoutingTableEntries::reindex()
+{
+  m_index.clear();
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    m_index.insert(it);
+  }
+}
+
+/*! \brief Runs the tasks of a link-state calculation on the worker threads.
+
+  It is only called on a worker thread, which takes part in the tasks as slot 0. The other
+  workers are asked to help as the next slots, but the tasks get done by the calling worker
+  even if the others are busy with another calculation or have been stopped.
+*/
+class WorkerTaskRunner : public TaskRunner
+{
+public:
+  WorkerTaskRunner(boost::asio::io_service& workerIoService, size_t nWorkers)
+    : m_workerIoService(workerIoService)
+    , m_nWorkers(nWorkers)
+  {
+  }
+
+  size_t
+  getConcurrency() const override
+  {
+    return m_nWorkers;
+  }
+
+  void
+  run(size_t nTasks, const std::function<void(size_t n, size_t slot)>& task) override
+  {
+    auto tasks = std::make_shared<Tasks>(nTasks, task);
+    for (size_t slot = 1; slot < std::min(m_nWorkers, nTasks); ++slot) {
+      m_workerIoService.post([tasks, slot] { tasks->runTasks(slot); });
+    }
+    tasks->runTasks(0);
+    tasks->wait();
+  }
+
+private:
+  /*! \brief The tasks of one run, which the workers take one at a time.
+
+    A helper may only get to run after all the tasks are done, and the run has returned.
+    It then finds no task left, and does not touch the task function.
+  */
+  struct Tasks
+  {
+    Tasks(size_t nTasks, const std::function<void(size_t n, size_t slot)>& task)
+      : nTasks(nTasks)
+      , task(task)
+      , nextTask(0)
+      , nDoneTasks(0)
+    {
+    }
+
+    void
+    runTasks(size_t slot)
+    {
+      for (size_t n = nextTask++; n < nTasks; n = nextTask++) {
+        std::exception_ptr taskError;
+        try {
+          task(n, slot);
+        }
+        catch (...) {
+          taskError = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (taskError && !error) {
+          error = taskError;
+        }
+        if (++nDoneTasks == nTasks) {
+          isDone.notify_all();
+        }
+      }
+    }
+
+    /*! \brief Waits for the tasks taken by the helpers, and rethrows what a task threw. */
+    void
+    wait()
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      isDone.wait(lock, [this] { return nDoneTasks == nTasks; });
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    const size_t nTasks;
+    const std::function<void(size_t n, size_t slot)>& task;
+    std::atomic<size_t> nextTask;
+
+    std::mutex mutex;
+    std::condition_variable isDone;
+    size_t nDoneTasks;
+    std::exception_ptr error;
+  };
+
+  boost::asio::io_service& m_workerIoService;
+  const size_t m_nWorkers;
+};
+
+class RoutingTable::Calculation : public NextHopReceiver
+{
+public:
+  Calculation(ConfParameter& confParam, bool isIncremental)
+    : parameters(confParam)
+    , hyperbolicState(confParam.getHyperbolicState())
+    , isIncremental(isIncremental)
+    , adjLsas(nullptr)
+    , coordinateLsas(nullptr)
+    , isUpdated(false)
+    , nRemainingJobs(0)
+  {
+  }
+
+  void
+  addNextHop(const ndn::Name& destRouter, NextHop& nh) override
+  {
+    table.addNextHop(destRouter, nh);
+  }
+
+  void
+  addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh) override
+  {
+    dryTable.addNextHop(destRouter, nh);
+  }
+
+  /*! \brief Makes the calculation work on a copy of the LSDB rather than on the LSDB itself.
+   */
+  void
+  copyLsdb()
+  {
+    adjLsaCopy = *adjLsas;
+    coordinateLsaCopy = *coordinateLsas;
+    adjLsas = &adjLsaCopy;
+    coordinateLsas = &coordinateLsaCopy;
+  }
+
+public:
+  CalculationParameters parameters;
+  const int32_t hyperbolicState;
+  const bool isIncremental;
+
+  // The LSAs the calculation works on, either those of the LSDB or copies of them
+  const AdjLsaContainer* adjLsas;
+  const CoordinateLsaContainer* coordinateLsas;
+  AdjLsaContainer adjLsaCopy;
+  CoordinateLsaContainer coordinateLsaCopy;
+
+  // If the previous paths were repaired, the entries that changed; otherwise, the new table
+  bool isUpdated;
+  std::list<RoutingTableEntry> changedEntries;
+  RoutingTableEntries table;
+  RoutingTableEntries dryTable;
+
+  std::atomic<size_t> nRemainingJobs;
+};
+
+RoutingTable::RoutingTable(boost::asio::io_service& ioService, ndn::Scheduler& scheduler,
+                           Fib& fib, Lsdb& lsdb, NamePrefixTable& namePrefixTable,
+                           ConfParameter& confParam)
   : afterRoutingChange{std::make_unique<AfterRoutingChange>()}
+  , m_ioService(ioService)
   , m_scheduler(scheduler)
   , m_fib(fib)
   , m_lsdb(lsdb)
   , m_namePrefixTable(namePrefixTable)
   , m_NO_NEXT_HOP{-12345}
   , m_routingCalcInterval{confParam.getRoutingCalcInterval()}
+  , m_calculationThrottle(ndn::time::milliseconds(confParam.getRoutingCalcInitialDelay()),
+                          ndn::time::milliseconds(confParam.getRoutingCalcHoldDelay()),
+                          m_routingCalcInterval)
   , m_isRoutingTableCalculating(false)
   , m_isRouteCalculationScheduled(false)
+  , m_isRecalculationNeeded(false)
   , m_confParam(confParam)
+  , m_lsCalculator(0)
+{
+  if (confParam.getRoutingCalcThreads() > 0) {
+    m_workerIoServiceWork = std::make_unique<boost::asio::io_service::work>(m_workerIoService);
+    for (uint32_t i = 0; i < confParam.getRoutingCalcThreads(); ++i) {
+      m_workers.emplace_back([this] { m_workerIoService.run(); });
+    }
+    m_workerTaskRunner = std::make_unique<WorkerTaskRunner>(m_workerIoService, m_workers.size());
+    m_lsCalculator.setTaskRunner(*m_workerTaskRunner);
+  }
+}
+
+RoutingTable::~RoutingTable()
 {
+  m_workerIoServiceWork.reset();
+  m_workerIoService.stop();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
 }
 
 void
 RoutingTable::calculate()
 {
+  m_calculationThrottle.recordRun();
+
   m_lsdb.writeCorLsdbLog();
   m_lsdb.writeNameLsdbLog();
   m_lsdb.writeAdjLsdbLog();
@@ -73,32 +347,10 @@ RoutingTable::calculate()
          .doesLsaExist(ndn::Name{m_confParam.getRouterPrefix()}
                        .append(std::to_string(Lsa::Type::COORDINATE)), Lsa::Type::COORDINATE))) {
       if (m_lsdb.getIsBuildAdjLsaSheduled() != 1) {
-        NLSR_LOG_TRACE("Clearing old routing table");
-        clearRoutingTable();
-        // for dry run options
-        clearDryRoutingTable();
-
-        NLSR_LOG_DEBUG("Calculating routing table");
-
-        // calculate Link State routing
-        if ((m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_OFF)
-            || (m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_DRY_RUN)) {
-          calculateLsRoutingTable();
-        }
-        // calculate hyperbolic routing
-        if (m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_ON) {
-          calculateHypRoutingTable(false);
-        }
-        // calculate dry hyperbolic routing
-        if (m_confParam.getHyperbolicState() == HYPERBOLIC_STATE_DRY_RUN) {
-          calculateHypRoutingTable(true);
-        }
-        // Inform the NPT that updates have been made
-        NLSR_LOG_DEBUG("Calling Update NPT With new Route");
-        (*afterRoutingChange)(m_rTable);
-        writeLog();
-        m_namePrefixTable.writeLog();
-        m_fib.writeLog();
+        // The calculation covers the LSDB as it is now, so later changes schedule another one
+        m_isRouteCalculationScheduled = false;
+        startCalculation(m_confParam.isIncrementalSpfEnabled() && !isHrEnabled);
+        return;
       }
       else {
         NLSR_LOG_DEBUG("Adjacency building is scheduled, so"
@@ -108,11 +360,13 @@ RoutingTable::calculate()
     else {
       NLSR_LOG_DEBUG("No Adj LSA of router itself,"
                  " so Routing table can not be calculated :(");
-      clearRoutingTable();
+      std::list<RoutingTableEntry> previousTable;
+      m_rTable.swap(previousTable);
       clearDryRoutingTable(); // for dry run options
+      m_lsCalculator.clearPaths();
       // need to update NPT here
       NLSR_LOG_DEBUG("Calling Update NPT With new Route");
-      (*afterRoutingChange)(m_rTable);
+      (*afterRoutingChange)(getChangesFrom(previousTable));
       writeLog();
       m_namePrefixTable.writeLog();
       m_fib.writeLog();
@@ -122,55 +376,205 @@ RoutingTable::calculate()
     m_isRoutingTableCalculating = false; // unsetting routing table calculation
   }
   else {
-    scheduleRoutingTableCalculation();
+    // A calculation is running on the worker threads; it does not see the changes that led
+    // here, so calculate again once it is done
+    NLSR_LOG_DEBUG("Routing table is being calculated, calculating again afterwards");
+    m_isRouteCalculationScheduled = false;
+    m_isRecalculationNeeded = true;
+  }
+}
+
+void
+RoutingTable::startCalculation(bool isIncremental)
+{
+  auto calculation = std::make_shared<Calculation>(m_confParam, isIncremental);
+  calculation->adjLsas = &m_lsdb.getAdjLsdb();
+  calculation->coordinateLsas = &m_lsdb.getCoordinateLsdb();
+  // The calculation fills the entries of the previous tables again
+  calculation->table.swap(m_spareTable);
+  calculation->dryTable.swap(m_spareDryTable);
+
+  // The link-state and dry-run hyperbolic tables do not depend on each other, and are
+  // calculated in parallel
+  std::vector<CalculationJob> jobs;
+  if (calculation->hyperbolicState == HYPERBOLIC_STATE_OFF ||
+      calculation->hyperbolicState == HYPERBOLIC_STATE_DRY_RUN) {
+    jobs.push_back([this] (Calculation& c) { calculateLsRoutingTable(c); });
+  }
+  if (calculation->hyperbolicState == HYPERBOLIC_STATE_ON) {
+    jobs.push_back([this] (Calculation& c) { calculateHypRoutingTable(c, false); });
+  }
+  if (calculation->hyperbolicState == HYPERBOLIC_STATE_DRY_RUN) {
+    jobs.push_back([this] (Calculation& c) { calculateHypRoutingTable(c, true); });
+  }
+  calculation->nRemainingJobs = jobs.size();
+
+  if (m_workers.empty()) {
+    NLSR_LOG_DEBUG("Calculating routing table");
+    for (const auto& job : jobs) {
+      job(*calculation);
+    }
+    finishCalculation(*calculation);
+    return;
+  }
+
+  NLSR_LOG_DEBUG("Calculating routing table on " << m_workers.size() << " worker threads");
+  calculation->copyLsdb();
+  m_calculation = calculation;
+  for (const auto& job : jobs) {
+    m_workerIoService.post([this, calculation, job] { runCalculationJob(calculation, job); });
   }
 }
 
 void
-RoutingTable::calculateLsRoutingTable()
+RoutingTable::runCalculationJob(const std::shared_ptr<Calculation>& calculation,
+                                const CalculationJob& job)
+{
+  job(*calculation);
+
+  if (--calculation->nRemainingJobs > 0) {
+    return;
+  }
+
+  // The routing table may be gone by the time the main thread gets to the result; it no
+  // longer holds the calculation then
+  std::weak_ptr<Calculation> weakCalculation = calculation;
+  m_ioService.post([this, weakCalculation] {
+    auto calculation = weakCalculation.lock();
+    if (calculation != nullptr && calculation == m_calculation) {
+      m_calculation.reset();
+      finishCalculation(*calculation);
+    }
+  });
+}
+
+void
+RoutingTable::calculateLsRoutingTable(Calculation& calculation)
 {
   NLSR_LOG_DEBUG("RoutingTable::calculateLsRoutingTable Called");
 
   Map map;
-  map.createFromAdjLsdb(m_lsdb.getAdjLsdb().begin(), m_lsdb.getAdjLsdb().end());
+  map.createFromAdjLsdb(calculation.adjLsas->begin(), calculation.adjLsas->end());
+
+  if (calculation.isIncremental) {
+    if (m_lsCalculator.updatePath(map, calculation.parameters, *calculation.adjLsas,
+                                  calculation.changedEntries)) {
+      calculation.isUpdated = true;
+      return;
+    }
+    NLSR_LOG_DEBUG("Routing table cannot be updated incrementally");
+  }
+
   map.writeLog();
+  m_lsCalculator.calculatePath(map, calculation, calculation.parameters, *calculation.adjLsas);
+}
 
-  size_t nRouters = map.getMapSize();
+void
+RoutingTable::finishCalculation(Calculation& calculation)
+{
+  if (calculation.isUpdated) {
+    for (const auto& entry : calculation.changedEntries) {
+      m_rTable.update(entry);
+    }
 
-  LinkStateRoutingTableCalculator calculator(nRouters);
+    // Inform the NPT of the entries that changed
+    NLSR_LOG_DEBUG("Calling Update NPT With " << calculation.changedEntries.size() <<
+                   " changed routes");
+    if (!calculation.changedEntries.empty()) {
+      (*afterRoutingChange)(calculation.changedEntries);
+    }
+  }
+  else {
+    NLSR_LOG_TRACE("Clearing old routing table");
+    // The previous tables end up in the calculation, and are kept for the next one
+    m_rTable.swap(calculation.table);
+    m_dryTable.swap(calculation.dryTable);
+
+    // Inform the NPT that updates have been made
+    NLSR_LOG_DEBUG("Calling Update NPT With new Route");
+    (*afterRoutingChange)(getChangesFrom(calculation.table));
+  }
+
+  // The entries left in the calculation are filled again by the next one
+  calculation.table.clear();
+  calculation.dryTable.clear();
+  m_spareTable.swap(calculation.table);
+  m_spareDryTable.swap(calculation.dryTable);
 
-  calculator.calculatePath(map, *this, m_confParam, m_lsdb.getAdjLsdb());
+  writeLog();
+  m_namePrefixTable.writeLog();
+  m_fib.writeLog();
+
+  m_isRoutingTableCalculating = false;
+
+  if (m_isRecalculationNeeded) {
+    m_isRecalculationNeeded = false;
+    scheduleRoutingTableCalculation();
+  }
+}
+
+std::list<RoutingTableEntry>
+RoutingTable::getChangesFrom(const std::list<RoutingTableEntry>& previousTable) const
+{
+  std::unordered_map<ndn::Name, const RoutingTableEntry*> previous;
+  for (const auto& rte : previousTable) {
+    previous.emplace(rte.getDestination(), &rte);
+  }
+
+  std::list<RoutingTableEntry> changes;
+  for (const auto& rte : m_rTable) {
+    auto it = previous.find(rte.getDestination());
+    if (it == previous.end()) {
+      changes.push_back(rte);
+      continue;
+    }
+    if (it->second->getNexthopList() != rte.getNexthopList()) {
+      changes.push_back(rte);
+    }
+    previous.erase(it);
+  }
+
+  // Whatever is left has become unreachable
+  for (const auto& rte : previousTable) {
+    if (previous.count(rte.getDestination()) > 0) {
+      changes.emplace_back(rte.getDestination());
+    }
+  }
+
+  NLSR_LOG_DEBUG(changes.size() << " of " << m_rTable.size() + previous.size() <<
+                 " destinations have changed next hops");
+  return changes;
 }
 
 void
-RoutingTable::calculateHypRoutingTable(bool isDryRun)
+RoutingTable::calculateHypRoutingTable(Calculation& calculation, bool isDryRun)
 {
   Map map;
-  map.createFromCoordinateLsdb(m_lsdb.getCoordinateLsdb().begin(),
-                               m_lsdb.getCoordinateLsdb().end());
+  map.createFromCoordinateLsdb(calculation.coordinateLsas->begin(),
+                               calculation.coordinateLsas->end());
   map.writeLog();
 
   size_t nRouters = map.getMapSize();
 
-  HyperbolicRoutingCalculator calculator(nRouters, isDryRun, m_confParam.getRouterPrefix());
+  HyperbolicRoutingCalculator calculator(nRouters, isDryRun, calculation.parameters.routerPrefix);
 
-  calculator.calculatePath(map, *this, m_lsdb, m_confParam.getAdjacencyList());
+  calculator.calculatePath(map, calculation, *calculation.coordinateLsas,
+                           calculation.parameters.adjacencies);
 }
 
 void
 RoutingTable::scheduleRoutingTableCalculation()
 {
   if (!m_isRouteCalculationScheduled) {
-    NLSR_LOG_DEBUG("Scheduling routing table calculation in " << m_routingCalcInterval);
-    m_scheduler.schedule(m_routingCalcInterval, [this] { calculate(); });
+    ndn::time::milliseconds delay = m_calculationThrottle.scheduleRun();
+    NLSR_LOG_DEBUG("Scheduling routing table calculation in " << delay
+                   << " (hold time " << m_calculationThrottle.getCurrentHold() << ")");
+    m_scheduler.schedule(delay, [this] { calculate(); });
     m_isRouteCalculationScheduled = true;
   }
-}
-
-static bool
-routingTableEntryCompare(RoutingTableEntry& rte, ndn::Name& destRouter)
-{
-  return rte.getDestination() == destRouter;
+  else {
+    m_calculationThrottle.recordEvent();
+  }
 }
 
 void
@@ -178,32 +582,20 @@ RoutingTable::addNextHop(const ndn::Name& destRouter, NextHop& nh)
 {
   NLSR_LOG_DEBUG("Adding " << nh << " for destination: " << destRouter);
 
-  RoutingTableEntry* rteChk = findRoutingTableEntry(destRouter);
-  if (rteChk == nullptr) {
-    RoutingTableEntry rte(destRouter);
-    rte.getNexthopList().addNextHop(nh);
-    m_rTable.push_back(rte);
-  }
-  else {
-    rteChk->getNexthopList().addNextHop(nh);
-  }
+  m_rTable.addNextHop(destRouter, nh);
 }
 
 RoutingTableEntry*
 RoutingTable::findRoutingTableEntry(const ndn::Name& destRouter)
 {
-  auto it = std::find_if(m_rTable.begin(), m_rTable.end(),
-                         std::bind(&routingTableEntryCompare, _1, destRouter));
-  if (it != m_rTable.end()) {
-    return &(*it);
-  }
-  return nullptr;
+  return m_rTable.find(destRouter);
 }
 
 void
 RoutingTable::writeLog()
 {
   NLSR_LOG_DEBUG("---------------Routing Table------------------");
+  NLSR_LOG_DEBUG("Calculations: " << m_calculationThrottle.getStatistics());
   for (const auto& rte : m_rTable) {
     NLSR_LOG_DEBUG("Destination: " << rte.getDestination());
     NLSR_LOG_DEBUG("Nexthops: ");
@@ -225,24 +617,7 @@ RoutingTable::addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh)
 {
   NLSR_LOG_DEBUG("Adding " << nh << " to dry table for destination: " << destRouter);
 
-  auto it = std::find_if(m_dryTable.begin(), m_dryTable.end(),
-                         std::bind(&routingTableEntryCompare, _1, destRouter));
-  if (it == m_dryTable.end()) {
-    RoutingTableEntry rte(destRouter);
-    rte.getNexthopList().addNextHop(nh);
-    m_dryTable.push_back(rte);
-  }
-  else {
-    it->getNexthopList().addNextHop(nh);
-  }
-}
-
-void
-RoutingTable::clearRoutingTable()
-{
-  if (m_rTable.size() > 0) {
-    m_rTable.clear();
-  }
+  m_dryTable.addNextHop(destRouter, nh);
 }
 
 void
@@ -26,28 +26,145 @@
 #include "routing-table-entry.hpp"
 #include "signals.hpp"
 #include "lsdb.hpp"
+#include "throttle.hpp"
 #include "route/fib.hpp"
+#include "route/routing-table-calculator.hpp"
 
+#include <functional>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <thread>
 #include <utility>
 #include <string>
+#include <vector>
+#include <boost/asio/io_service.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
 #include <ndn-cxx/util/scheduler.hpp>
 
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+
 namespace nlsr {
 
 class NextHop;
 
-class RoutingTable : boost::noncopyable
+/*! \brief The entries of a routing table, in the order they were added, indexed by
+ *         destination.
+ *
+ *  An entry is found by the hash of its interned destination, so that filling a table and
+ *  looking an entry up do not depend on the number of destinations. Removed entries are
+ *  kept aside and reused for the destinations added next, so that a table that is filled
+ *  again does not allocate its entries anew.
+ */
+class RoutingTableEntries : boost::noncopyable
 {
 public:
-  explicit
-  RoutingTable(ndn::Scheduler& scheduler, Fib& fib, Lsdb& lsdb,
-               NamePrefixTable& namePrefixTable, ConfParameter& confParam);
+  using const_iterator = std::list<RoutingTableEntry>::const_iterator;
+
+  /*! \brief Adds a next hop to the entry of a destination, adding the entry if needed. */
+  void
+  addNextHop(const ndn::Name& destRouter, const NextHop& nh);
+
+  /*! \brief Returns the entry of a destination, or nullptr if there is none. */
+  RoutingTableEntry*
+  find(const ndn::Name& destRouter);
+
+  /*! \brief Replaces the entry of the destination of an entry.
+   *
+   *  An entry without next hops removes the entry of its destination.
+   */
+  void
+  update(const RoutingTableEntry& entry);
+
+  /*! \brief Removes all entries, keeping them for reuse. */
+  void
+  clear();
+
+  /*! \brief Exchanges the entries with those of a list. */
+  void
+  swap(std::list<RoutingTableEntry>& entries);
+
+  void
+  swap(RoutingTableEntries& other);
+
+  const_iterator
+  begin() const
+  {
+    return m_entries.begin();
+  }
+
+  const_iterator
+  end() const
+  {
+    return m_entries.end();
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  bool
+  empty() const
+  {
+    return m_entries.empty();
+  }
+
+  operator const std::list<RoutingTableEntry>&() const
+  {
+    return m_entries;
+  }
+
+private:
+  RoutingTableEntry&
+  add(const ndn::Name& destRouter);
+
+  void
+  reindex();
+
+private:
+  using EntryIterator = std::list<RoutingTableEntry>::iterator;
+  using EntryIndex = boost::multi_index::multi_index_container<
+    EntryIterator,
+    boost::multi_index::indexed_by<
+      boost::multi_index::hashed_unique<
+        boost::multi_index::const_mem_fun<RoutingTableEntry, const InternedName&,
+                                          &RoutingTableEntry::getInternedDestination>,
+        InternedNameHash,
+        std::equal_to<>>
+      >
+    >;
+
+  std::list<RoutingTableEntry> m_entries;
+  std::list<RoutingTableEntry> m_spareEntries;
+  EntryIndex m_index;
+};
+
+class RoutingTable : public NextHopReceiver, boost::noncopyable
+{
+public:
+  /*! \param ioService The io_service of the main thread, to which the results of
+   *         calculations on the worker threads are posted.
+   *
+   *  The routing table starts as many worker threads as ConfParameter::getRoutingCalcThreads.
+   *  A multipath link-state calculation spreads its trees, one per neighbor, over them.
+   */
+  RoutingTable(boost::asio::io_service& ioService, ndn::Scheduler& scheduler, Fib& fib,
+               Lsdb& lsdb, NamePrefixTable& namePrefixTable, ConfParameter& confParam);
+
+  /*! \brief Stops the worker threads, abandoning a calculation that is running. */
+  ~RoutingTable();
 
   /*! \brief Calculates a list of next hops for each router in the network.
    *
-   *  Calculates the list of next hops to every other router in the network.
+   *  Calculates the list of next hops to every other router in the network. With worker
+   *  threads, the calculation runs on them over a copy of the LSDB taken now, and the
+   *  routing table is only updated, and afterRoutingChange emitted, once the main thread
+   *  receives the result.
    */
   void
   calculate();
@@ -57,20 +174,23 @@ public:
    *  \param nh The next hop to add to the RTE.
    */
   void
-  addNextHop(const ndn::Name& destRouter, NextHop& nh);
+  addNextHop(const ndn::Name& destRouter, NextHop& nh) override;
 
   /*! \brief Adds a next hop to a routing table entry in a dry run scenario.
    *  \param destRouter The destination router whose RTE we want to modify.
    *  \param nh The next hop to add to the router.
    */
   void
-  addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh);
+  addNextHopToDryTable(const ndn::Name& destRouter, NextHop& nh) override;
 
   RoutingTableEntry*
   findRoutingTableEntry(const ndn::Name& destRouter);
 
   /*! \brief Schedules a calculation event in the event scheduler only
    *  if one isn't already scheduled.
+   *
+   *  The calculation is throttled: it runs after the initial delay when the network has
+   *  been stable, and is held down for longer and longer while changes keep arriving.
    */
   void
   scheduleRoutingTableCalculation();
@@ -81,10 +201,14 @@ public:
     return m_NO_NEXT_HOP;
   }
 
+  /*! \brief Sets the longest time a calculation is held down for, in seconds. */
   void
   setRoutingCalcInterval(uint32_t interval)
   {
     m_routingCalcInterval = ndn::time::seconds(interval);
+    m_calculationThrottle.setDelays(ndn::time::milliseconds(m_confParam.getRoutingCalcInitialDelay()),
+                                    ndn::time::milliseconds(m_confParam.getRoutingCalcHoldDelay()),
+                                    m_routingCalcInterval);
   }
 
   const ndn::time::seconds&
@@ -111,17 +235,60 @@ public:
     return m_rTable.size();
   }
 
+  bool
+  isCalculating() const
+  {
+    return m_isRoutingTableCalculating;
+  }
+
+  const Throttle&
+  getCalculationThrottle() const
+  {
+    return m_calculationThrottle;
+  }
+
 private:
-  /*! \brief Calculates a link-state routing table. */
+  /*! \brief A routing table calculation, from the LSDB it works on to its result. */
+  class Calculation;
+
+  using CalculationJob = std::function<void(Calculation&)>;
+
+  /*! \brief Calculates the routing table from the current LSDB.
+   *  \param isIncremental Whether to repair the link-state paths of the previous calculation.
+   *
+   *  Without worker threads the calculation is done before returning. Otherwise, the LSDB is
+   *  copied, and the link-state and hyperbolic calculations are queued for the workers.
+   */
   void
-  calculateLsRoutingTable();
+  startCalculation(bool isIncremental);
+
+  /*! \brief Runs one part of a calculation, then hands the calculation over to
+   *         finishCalculation() if it was the last part.
+   *
+   *  On the worker threads, this must not touch anything but the calculation and
+   *  m_lsCalculator, which is left to the calculation while it runs.
+   */
+  void
+  runCalculationJob(const std::shared_ptr<Calculation>& calculation, const CalculationJob& job);
+
+  /*! \brief Calculates a link-state routing table.
+   *
+   *  When the calculation is incremental, the paths of the previous calculation are repaired
+   *  if they can be, and only the entries that changed are kept.
+   */
+  void
+  calculateLsRoutingTable(Calculation& calculation);
 
   /*! \brief Calculates a HR routing table. */
   void
-  calculateHypRoutingTable(bool isDryRun);
+  calculateHypRoutingTable(Calculation& calculation, bool isDryRun);
 
+  /*! \brief Installs the result of a calculation in the routing table, on the main thread.
+   *
+   *  Only the entries that changed are passed on to afterRoutingChange.
+   */
   void
-  clearRoutingTable();
+  finishCalculation(Calculation& calculation);
 
   void
   clearDryRoutingTable();
@@ -130,12 +297,27 @@ private:
   writeLog();
 
 public:
+  /*! \brief Signals the routing table entries that changed in a calculation.
+   *
+   *  An entry without next hops means that its destination is no longer reachable.
+   *  Destinations that are not listed have kept their next hops.
+   */
   std::unique_ptr<AfterRoutingChange> afterRoutingChange;
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
-  std::list<RoutingTableEntry> m_rTable;
+  /*! \brief Lists the entries whose next hops differ from previousTable.
+   *
+   *  Destinations that are new, or whose next hops have changed, are listed with their
+   *  current entry. Every destination that was in previousTable but is no longer
+   *  reachable is listed with an entry without next hops.
+   */
+  std::list<RoutingTableEntry>
+  getChangesFrom(const std::list<RoutingTableEntry>& previousTable) const;
+
+  RoutingTableEntries m_rTable;
 
 private:
+  boost::asio::io_service& m_ioService;
   ndn::Scheduler& m_scheduler;
   Fib& m_fib;
   Lsdb& m_lsdb;
@@ -143,14 +325,33 @@ private:
 
   const int m_NO_NEXT_HOP;
 
-  std::list<RoutingTableEntry> m_dryTable;
+  RoutingTableEntries m_dryTable;
+  // The entries of the previous tables, which the next calculation fills again
+  RoutingTableEntries m_spareTable;
+  RoutingTableEntries m_spareDryTable;
 
   ndn::time::seconds m_routingCalcInterval;
+  Throttle m_calculationThrottle;
 
   bool m_isRoutingTableCalculating;
   bool m_isRouteCalculationScheduled;
+  // The LSDB changed while a calculation was running on the worker threads
+  bool m_isRecalculationNeeded;
 
   ConfParameter& m_confParam;
+
+  // Kept between calculations so that the previous paths can be repaired
+  LinkStateRoutingTableCalculator m_lsCalculator;
+
+  // The calculation running on the worker threads, if any
+  std::shared_ptr<Calculation> m_calculation;
+
+  // The worker threads take the jobs of calculations from their own io_service
+  boost::asio::io_service m_workerIoService;
+  std::unique_ptr<boost::asio::io_service::work> m_workerIoServiceWork;
+  std::vector<std::thread> m_workers;
+  // Hands the trees of the link-state calculation to the worker threads
+  std::unique_ptr<TaskRunner> m_workerTaskRunner;
 };
 
 } // namespace nlsr
@@ -25,97 +25,292 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
 #include <pwd.h>
 #include <cstdlib>
 #include <unistd.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
 
 namespace nlsr {
 
 INIT_LOGGER(SequencingManager);
 
+const uint64_t SequencingManager::SEQ_NO_BLOCK_SIZE = 10;
+
+namespace {
+
+const char SEQ_NO_FILE_MAGIC[8] = {'N', 'L', 'S', 'R', 'S', 'E', 'Q', 'N'};
+const uint32_t SEQ_NO_FILE_VERSION = 1;
+
+struct SeqNoFile
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t checksum;
+  uint64_t seqNos[3];
+};
+
+static_assert(sizeof(SeqNoFile) == 40, "The sequence number file must not be padded");
+
+uint32_t
+computeChecksum(const SeqNoFile& file)
+{
+  boost::crc_32_type crc;
+  crc.process_bytes(file.seqNos, sizeof(file.seqNos));
+  return crc.checksum();
+}
+
+uint64_t
+reserveBlock(uint64_t seqNo)
+{
+  return seqNo == 0 ? 0 : seqNo + SequencingManager::SEQ_NO_BLOCK_SIZE;
+}
+
+} // anonymous namespace
+
+bool
+SequencingManager::SeqNos::reserves(const SeqNos& seqNos, uint64_t margin) const
+{
+  return (seqNos.nameLsaSeq == 0 || nameLsaSeq >= seqNos.nameLsaSeq + margin) &&
+         (seqNos.adjLsaSeq == 0 || adjLsaSeq >= seqNos.adjLsaSeq + margin) &&
+         (seqNos.corLsaSeq == 0 || corLsaSeq >= seqNos.corLsaSeq + margin);
+}
+
 SequencingManager::SequencingManager(std::string filePath, int hypState)
   : m_nameLsaSeq(0)
   , m_adjLsaSeq(0)
   , m_corLsaSeq(0)
+  , m_reserved{0, 0, 0}
+  , m_written{0, 0, 0}
   , m_hyperbolicState(hypState)
 {
   setSeqFileDirectory(filePath);
   initiateSeqNoFromFile();
+
+  m_writerIoServiceWork = std::make_unique<boost::asio::io_service::work>(m_writerIoService);
+  m_writer = std::thread([this] { m_writerIoService.run(); });
+}
+
+SequencingManager::~SequencingManager()
+{
+  // The writer thread finishes the writes that have been posted before it stops
+  m_writerIoServiceWork.reset();
+  m_writer.join();
 }
 
 void
-SequencingManager::writeSeqNoToFile() const
+SequencingManager::writeSeqNoToFile()
 {
   writeLog();
-  std::ofstream outputFile(m_seqFileNameWithPath.c_str());
-  std::ostringstream os;
-  os << "NameLsaSeq " << std::to_string(m_nameLsaSeq) << "\n"
-     << "AdjLsaSeq "  << std::to_string(m_adjLsaSeq)  << "\n"
-     << "CorLsaSeq "  << std::to_string(m_corLsaSeq);
-  outputFile << os.str();
-  outputFile.close();
+  SeqNos inUse{m_nameLsaSeq, m_adjLsaSeq, m_corLsaSeq};
+  SeqNos reservation{reserveBlock(m_nameLsaSeq), reserveBlock(m_adjLsaSeq),
+                     reserveBlock(m_corLsaSeq)};
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_written.reserves(inUse, 0)) {
+    // A sequence number must be reserved on disk before it is published, or a restarted
+    // router could use it again. The writes that have started may reserve it.
+    m_writeFinished.wait(lock, [this] { return m_nPendingWrites == 0; });
+    if (!m_written.reserves(inUse, 0)) {
+      lock.unlock();
+      NLSR_LOG_DEBUG("Sequence numbers are past the reservation on disk, writing it now");
+      m_reserved = reservation;
+      if (writeFile(reservation)) {
+        std::lock_guard<std::mutex> writtenLock(m_mutex);
+        m_written = reservation;
+      }
+      return;
+    }
+  }
+
+  // The next blocks are reserved once half of the current ones are used, so that they are
+  // on disk by the time they are needed
+  if (m_reserved.reserves(inUse, SEQ_NO_BLOCK_SIZE / 2)) {
+    return;
+  }
+  m_reserved = reservation;
+  ++m_nPendingWrites;
+  lock.unlock();
+
+  m_writerIoService.post([this, reservation] {
+    bool isWritten = writeFile(reservation);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (isWritten) {
+      m_written = reservation;
+    }
+    --m_nPendingWrites;
+    m_writeFinished.notify_all();
+  });
 }
 
 void
-SequencingManager::initiateSeqNoFromFile()
+SequencingManager::waitForWrites()
 {
-  NLSR_LOG_DEBUG("Seq File Name: " << m_seqFileNameWithPath);
-  std::ifstream inputFile(m_seqFileNameWithPath.c_str());
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_writeFinished.wait(lock, [this] { return m_nPendingWrites == 0; });
+}
+
+bool
+SequencingManager::writeFile(const SeqNos& seqNos) const
+{
+  SeqNoFile file;
+  std::memcpy(file.magic, SEQ_NO_FILE_MAGIC, sizeof(file.magic));
+  file.version = SEQ_NO_FILE_VERSION;
+  file.seqNos[0] = seqNos.nameLsaSeq;
+  file.seqNos[1] = seqNos.adjLsaSeq;
+  file.seqNos[2] = seqNos.corLsaSeq;
+  file.checksum = computeChecksum(file);
+
+  // The file is replaced only once the new one is on disk, so that a router stopped while
+  // writing finds the previous one whole
+  std::string tempFileName = m_seqFileNameWithPath + ".tmp";
+  int fd = ::open(tempFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    NLSR_LOG_ERROR("Cannot open " << tempFileName << ": " << std::strerror(errno));
+    return false;
+  }
+  bool isWritten = ::write(fd, &file, sizeof(file)) == sizeof(file) && ::fsync(fd) == 0;
+  isWritten = ::close(fd) == 0 && isWritten;
+  if (!isWritten || std::rename(tempFileName.c_str(), m_seqFileNameWithPath.c_str()) != 0) {
+    NLSR_LOG_ERROR("Cannot write " << m_seqFileNameWithPath << ": " << std::strerror(errno));
+    ::unlink(tempFileName.c_str());
+    return false;
+  }
+
+  // The new name of the file is on disk once its directory is
+  std::string directory = boost::filesystem::path(m_seqFileNameWithPath).parent_path().string();
+  int directoryFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (directoryFd >= 0) {
+    ::fsync(directoryFd);
+    ::close(directoryFd);
+  }
+
+  boost::system::error_code error;
+  boost::filesystem::remove(m_legacySeqFileNameWithPath, error);
+
+  NLSR_LOG_DEBUG("Reserved sequence numbers up to name: " << seqNos.nameLsaSeq
+                 << " adj: " << seqNos.adjLsaSeq << " cor: " << seqNos.corLsaSeq);
+  return true;
+}
+
+bool
+SequencingManager::readSeqNoFile()
+{
+  std::ifstream inputFile(m_seqFileNameWithPath, std::ios::binary);
+  SeqNoFile file;
+  inputFile.read(reinterpret_cast<char*>(&file), sizeof(file));
+  if (inputFile.gcount() != sizeof(file) || inputFile.peek() != std::ifstream::traits_type::eof()) {
+    NLSR_LOG_ERROR(m_seqFileNameWithPath << " does not have the size of a sequence number file");
+    return false;
+  }
+  if (std::memcmp(file.magic, SEQ_NO_FILE_MAGIC, sizeof(file.magic)) != 0 ||
+      file.version != SEQ_NO_FILE_VERSION) {
+    NLSR_LOG_ERROR(m_seqFileNameWithPath << " is not a sequence number file of version "
+                   << SEQ_NO_FILE_VERSION);
+    return false;
+  }
+  if (file.checksum != computeChecksum(file)) {
+    NLSR_LOG_ERROR(m_seqFileNameWithPath << " is damaged: wrong checksum");
+    return false;
+  }
+
+  m_nameLsaSeq = file.seqNos[0];
+  m_adjLsaSeq = file.seqNos[1];
+  m_corLsaSeq = file.seqNos[2];
+  return true;
+}
+
+bool
+SequencingManager::readLegacySeqNoFile()
+{
+  std::ifstream inputFile(m_legacySeqFileNameWithPath.c_str());
 
   // Good checks that file is not (bad or eof or fail)
-  if (inputFile.good()) {
-    std::string lsaOrCombinedSeqNo;
-    uint64_t seqNo = 0;
-
-    // If file has a combined seq number, lsaOrCombinedSeqNo would hold it
-    // and seqNo will be zero everytime
-    inputFile >> lsaOrCombinedSeqNo >> seqNo;
-    m_nameLsaSeq = seqNo;
-
-    inputFile >> lsaOrCombinedSeqNo >> seqNo;
-    m_adjLsaSeq = seqNo;
-
-    inputFile >> lsaOrCombinedSeqNo >> seqNo;
-    m_corLsaSeq = seqNo;
-
-    // File was in old format and had a combined sequence number
-    // if all of the seqNo should are still zero and
-    // lsaOrCombinedSeqNo != CorLsaSeq
-    if (m_nameLsaSeq == 0 && m_adjLsaSeq == 0 && m_corLsaSeq == 0 &&
-        lsaOrCombinedSeqNo != "CorLsaSeq") {
-      NLSR_LOG_DEBUG("Old file had combined sequence number: " << lsaOrCombinedSeqNo);
-      std::istringstream iss(lsaOrCombinedSeqNo);
-      iss >> seqNo;
-      m_adjLsaSeq = (seqNo & 0xFFFFF);
-      m_corLsaSeq = ((seqNo >> 20) & 0xFFFFF);
-      m_nameLsaSeq = ((seqNo >> 40) & 0xFFFFFF);
-    }
+  if (!inputFile.good()) {
+    return false;
+  }
 
-    inputFile.close();
+  std::string lsaOrCombinedSeqNo;
+  uint64_t seqNo = 0;
 
-    m_nameLsaSeq += 10;
+  // If file has a combined seq number, lsaOrCombinedSeqNo would hold it
+  // and seqNo will be zero everytime
+  inputFile >> lsaOrCombinedSeqNo >> seqNo;
+  m_nameLsaSeq = seqNo;
 
-    // Increment the adjacency LSA seq. no. if link-state or dry HR is enabled
-    if (m_hyperbolicState != HYPERBOLIC_STATE_ON) {
-      if (m_corLsaSeq != 0) {
-        NLSR_LOG_WARN("This router was previously configured for hyperbolic"
-                   << " routing without clearing the seq. no. file.");
-        m_corLsaSeq = 0;
-      }
-      m_adjLsaSeq += 10;
+  inputFile >> lsaOrCombinedSeqNo >> seqNo;
+  m_adjLsaSeq = seqNo;
+
+  inputFile >> lsaOrCombinedSeqNo >> seqNo;
+  m_corLsaSeq = seqNo;
+
+  // File was in old format and had a combined sequence number
+  // if all of the seqNo should are still zero and
+  // lsaOrCombinedSeqNo != CorLsaSeq
+  if (m_nameLsaSeq == 0 && m_adjLsaSeq == 0 && m_corLsaSeq == 0 &&
+      lsaOrCombinedSeqNo != "CorLsaSeq") {
+    NLSR_LOG_DEBUG("Old file had combined sequence number: " << lsaOrCombinedSeqNo);
+    std::istringstream iss(lsaOrCombinedSeqNo);
+    iss >> seqNo;
+    m_adjLsaSeq = (seqNo & 0xFFFFF);
+    m_corLsaSeq = ((seqNo >> 20) & 0xFFFFF);
+    m_nameLsaSeq = ((seqNo >> 40) & 0xFFFFFF);
+  }
+
+  inputFile.close();
+  return true;
+}
+
+void
+SequencingManager::initiateSeqNoFromFile()
+{
+  NLSR_LOG_DEBUG("Seq File Name: " << m_seqFileNameWithPath);
+
+  // The binary file holds the ends of the blocks reserved, which no sequence number used
+  // went past. The text file holds the last sequence numbers used, so a block is skipped.
+  uint64_t margin = 0;
+  if (boost::filesystem::exists(m_seqFileNameWithPath) && readSeqNoFile()) {
+    m_reserved = SeqNos{m_nameLsaSeq, m_adjLsaSeq, m_corLsaSeq};
+  }
+  else if (readLegacySeqNoFile()) {
+    NLSR_LOG_DEBUG("Read sequence numbers from " << m_legacySeqFileNameWithPath);
+    margin = SEQ_NO_BLOCK_SIZE;
+    m_reserved = SeqNos{0, 0, 0};
+  }
+  else {
+    writeLog();
+    return;
+  }
+
+  m_nameLsaSeq += margin;
+
+  // Increment the adjacency LSA seq. no. if link-state or dry HR is enabled
+  if (m_hyperbolicState != HYPERBOLIC_STATE_ON) {
+    if (m_corLsaSeq != 0) {
+      NLSR_LOG_WARN("This router was previously configured for hyperbolic"
+                 << " routing without clearing the seq. no. file.");
+      m_corLsaSeq = 0;
     }
+    m_adjLsaSeq += margin;
+  }
 
-    // Similarly, increment the coordinate LSA seq. no only if link-state is disabled.
-    if (m_hyperbolicState != HYPERBOLIC_STATE_OFF) {
-      if (m_adjLsaSeq != 0) {
-        NLSR_LOG_WARN("This router was previously configured for link-state"
-                  << " routing without clearing the seq. no. file.");
-        m_adjLsaSeq = 0;
-      }
-      m_corLsaSeq += 10;
+  // Similarly, increment the coordinate LSA seq. no only if link-state is disabled.
+  if (m_hyperbolicState != HYPERBOLIC_STATE_OFF) {
+    if (m_adjLsaSeq != 0) {
+      NLSR_LOG_WARN("This router was previously configured for link-state"
+                << " routing without clearing the seq. no. file.");
+      m_adjLsaSeq = 0;
     }
+    m_corLsaSeq += margin;
   }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_written = m_reserved;
   writeLog();
 }
 
@@ -131,7 +326,8 @@ SequencingManager::setSeqFileDirectory(const std::string& filePath)
     }
     m_seqFileNameWithPath = homeDirPath;
   }
-  m_seqFileNameWithPath = m_seqFileNameWithPath + "/nlsrSeqNo.txt";
+  m_legacySeqFileNameWithPath = m_seqFileNameWithPath + "/nlsrSeqNo.txt";
+  m_seqFileNameWithPath = m_seqFileNameWithPath + "/nlsrSeqNo.bin";
 }
 
 void
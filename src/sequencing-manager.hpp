@@ -27,17 +27,41 @@
 
 #include <ndn-cxx/face.hpp>
 
+#include <condition_variable>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <boost/asio/io_service.hpp>
 #include <boost/cstdint.hpp>
 
 namespace nlsr {
 
+/*! \brief Hands out the sequence numbers of this router's LSAs, and keeps them across restarts.
+
+  The sequence numbers are not written each time one is used. Instead, the file in the state
+  directory reserves a block of SEQ_NO_BLOCK_SIZE numbers ahead of each sequence number, and
+  is written again, on a thread of its own, when half of the block is used. A router that is
+  restarted goes on from the end of the blocks, so that it never reuses a sequence number.
+
+  The file, nlsrSeqNo.bin, is binary:
+
+      SeqNoFile := magic(8) version(4) checksum(4) nameLsaSeq(8) adjLsaSeq(8) corLsaSeq(8)
+
+  The integers are in the byte order of the router that wrote the file, and the checksum is
+  the CRC-32 of the sequence numbers. It is written to a temporary file that is synced to
+  disk and then takes the place of the file. The text file of earlier versions, nlsrSeqNo.txt,
+  is read when there is no binary file, and removed once the binary file is written.
+ */
 class SequencingManager
 {
 public:
   SequencingManager(std::string filePath, int hypState);
 
+  /*! \brief Waits for the file to be written, and stops the thread that writes it. */
+  ~SequencingManager();
+
   uint64_t
   getNameLsaSeq() const
   {
@@ -92,14 +116,51 @@ public:
     m_corLsaSeq++;
   }
 
+  /*! \brief Makes sure that the sequence numbers in use are reserved in the file.
+
+    This must be called after changing a sequence number and before publishing it. The file
+    is only written on this thread when a sequence number has gone past the reservation on
+    disk, which happens at start and when the numbers are used faster than the file can be
+    written. Otherwise, the next blocks are reserved by a write on the writer thread.
+   */
   void
-  writeSeqNoToFile() const;
+  writeSeqNoToFile();
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   initiateSeqNoFromFile();
 
+  /*! \brief Waits until the writes that have been started are done. */
+  void
+  waitForWrites();
+
+  const std::string&
+  getSeqFileName() const
+  {
+    return m_seqFileNameWithPath;
+  }
+
+  const std::string&
+  getLegacySeqFileName() const
+  {
+    return m_legacySeqFileNameWithPath;
+  }
+
 private:
+  struct SeqNos
+  {
+    /*! \brief Returns whether these reserve \p seqNos, and \p margin numbers past them.
+
+      A sequence number of 0 has not been used, and needs no reservation.
+     */
+    bool
+    reserves(const SeqNos& seqNos, uint64_t margin) const;
+
+    uint64_t nameLsaSeq;
+    uint64_t adjLsaSeq;
+    uint64_t corLsaSeq;
+  };
+
   /*! \brief Set the sequence file directory
 
     If the string is empty, home directory is set as sequence file directory
@@ -109,14 +170,54 @@ private:
   void
   setSeqFileDirectory(const std::string& filePath);
 
+  /*! \brief Reads the binary file into the sequence numbers.
+    \retval false The file is damaged, or is not a sequence number file of this version.
+   */
+  bool
+  readSeqNoFile();
+
+  /*! \brief Reads the text file of earlier versions into the sequence numbers.
+    \retval false There is no such file.
+   */
+  bool
+  readLegacySeqNoFile();
+
+  /*! \brief Writes sequence numbers to the file, replacing it.
+    \retval false The file could not be written; the previous file, if any, is left whole.
+   */
+  bool
+  writeFile(const SeqNos& seqNos) const;
+
   void
   writeLog() const;
 
+public:
+  /*! \brief The number of sequence numbers that are reserved ahead of each one in use.
+
+    A router restarted from the text file of earlier versions also skips this many.
+   */
+  static const uint64_t SEQ_NO_BLOCK_SIZE;
+
 private:
   uint64_t m_nameLsaSeq;
   uint64_t m_adjLsaSeq;
   uint64_t m_corLsaSeq;
   std::string m_seqFileNameWithPath;
+  std::string m_legacySeqFileNameWithPath;
+
+  // The sequence numbers the file reserves once the writes started have finished
+  SeqNos m_reserved;
+
+  // The sequence numbers the file on disk reserves, and the writes that have not finished.
+  // Both are shared with the writer thread.
+  std::mutex m_mutex;
+  std::condition_variable m_writeFinished;
+  SeqNos m_written;
+  size_t m_nPendingWrites = 0;
+
+  boost::asio::io_service m_writerIoService;
+  std::unique_ptr<boost::asio::io_service::work> m_writerIoServiceWork;
+  std::thread m_writer;
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   int m_hyperbolicState;
@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "throttle.hpp"
+
+#include <algorithm>
+
+namespace nlsr {
+
+Throttle::Throttle(const ndn::time::milliseconds& initialDelay,
+                   const ndn::time::milliseconds& holdDelay,
+                   const ndn::time::milliseconds& maxDelay)
+  : m_hasRun(false)
+{
+  setDelays(initialDelay, holdDelay, maxDelay);
+}
+
+void
+Throttle::setDelays(const ndn::time::milliseconds& initialDelay,
+                    const ndn::time::milliseconds& holdDelay,
+                    const ndn::time::milliseconds& maxDelay)
+{
+  m_maxDelay = maxDelay;
+  m_initialDelay = std::min(initialDelay, m_maxDelay);
+  m_holdDelay = std::min(holdDelay, m_maxDelay);
+  m_hold = m_holdDelay;
+}
+
+ndn::time::milliseconds
+Throttle::scheduleRun()
+{
+  ++m_stats.nEvents;
+
+  ndn::time::steady_clock::TimePoint now = ndn::time::steady_clock::now();
+  ndn::time::milliseconds delay = m_initialDelay;
+
+  if (!m_hasRun || now - m_lastRun >= 2 * m_hold) {
+    // Quiet for long enough: take the fast path, and start holding down from the hold delay
+    m_hold = m_holdDelay;
+    ++m_stats.nFastRuns;
+  }
+  else {
+    ndn::time::steady_clock::TimePoint holdEnd = m_lastRun + m_hold;
+    if (holdEnd > now) {
+      // Round up, so that the run is never before the end of the hold time
+      auto remaining = ndn::time::duration_cast<ndn::time::milliseconds>(holdEnd - now);
+      if (now + remaining < holdEnd) {
+        remaining += ndn::time::milliseconds(1);
+      }
+      delay = std::max(delay, remaining);
+    }
+    m_hold = std::min(2 * m_hold, m_maxDelay);
+    ++m_stats.nHeldRuns;
+  }
+
+  m_stats.longestDelay = std::max(m_stats.longestDelay, delay);
+  return delay;
+}
+
+void
+Throttle::recordRun()
+{
+  ++m_stats.nRuns;
+  m_hasRun = true;
+  m_lastRun = ndn::time::steady_clock::now();
+}
+
+std::ostream&
+operator<<(std::ostream& os, const Throttle::Statistics& stats)
+{
+  os << "events: " << stats.nEvents
+     << ", runs: " << stats.nRuns
+     << " (" << stats.nFastRuns << " fast, " << stats.nHeldRuns << " held down)"
+     << ", longest delay: " << stats.longestDelay;
+  return os;
+}
+
+} // namespace nlsr
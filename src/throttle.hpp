@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_THROTTLE_HPP
+#define NLSR_THROTTLE_HPP
+
+#include "common.hpp"
+
+#include <boost/cstdint.hpp>
+
+namespace nlsr {
+
+/*! \brief Decides how long to wait before running an action that is triggered by bursts of
+  events, such as building the Adjacency LSA or calculating the routing table.
+
+  The first event after a quiet period runs the action after the initial delay, so that a
+  single change is acted upon quickly. While events keep arriving, each run is held down
+  until the hold time has passed since the previous run; the hold time starts at the hold
+  delay and doubles with every held-down run, up to the maximum delay. Once no event has
+  arrived for twice the current hold time after a run, the throttle is back to the initial
+  delay.
+
+  No delay is ever longer than the maximum delay, so that setting the three delays to the
+  same value gives a fixed delay.
+ */
+class Throttle
+{
+public:
+  struct Statistics
+  {
+    // Events that asked for the action to run, including those that were coalesced into
+    // an already scheduled run
+    uint64_t nEvents = 0;
+    // Times the action was run
+    uint64_t nRuns = 0;
+    // Runs that were scheduled after the initial delay, because the throttle was quiet
+    uint64_t nFastRuns = 0;
+    // Runs that were held down because the previous run was too recent
+    uint64_t nHeldRuns = 0;
+    // The longest delay that was waited before a run
+    ndn::time::milliseconds longestDelay = ndn::time::milliseconds::zero();
+  };
+
+  Throttle(const ndn::time::milliseconds& initialDelay,
+           const ndn::time::milliseconds& holdDelay,
+           const ndn::time::milliseconds& maxDelay);
+
+  void
+  setDelays(const ndn::time::milliseconds& initialDelay,
+            const ndn::time::milliseconds& holdDelay,
+            const ndn::time::milliseconds& maxDelay);
+
+  /*! \brief Records an event that is coalesced into a run that is already scheduled.
+   */
+  void
+  recordEvent()
+  {
+    ++m_stats.nEvents;
+  }
+
+  /*! \brief Records an event and returns how long to wait before running the action.
+
+    Call this when no run is scheduled yet, and schedule the run after the returned delay.
+   */
+  ndn::time::milliseconds
+  scheduleRun();
+
+  /*! \brief Records that the action is being run.
+   */
+  void
+  recordRun();
+
+  const ndn::time::milliseconds&
+  getInitialDelay() const
+  {
+    return m_initialDelay;
+  }
+
+  const ndn::time::milliseconds&
+  getHoldDelay() const
+  {
+    return m_holdDelay;
+  }
+
+  const ndn::time::milliseconds&
+  getMaxDelay() const
+  {
+    return m_maxDelay;
+  }
+
+  /*! \brief Returns the hold time that applies to a run following the last one.
+   */
+  const ndn::time::milliseconds&
+  getCurrentHold() const
+  {
+    return m_hold;
+  }
+
+  const Statistics&
+  getStatistics() const
+  {
+    return m_stats;
+  }
+
+private:
+  ndn::time::milliseconds m_initialDelay;
+  ndn::time::milliseconds m_holdDelay;
+  ndn::time::milliseconds m_maxDelay;
+
+  ndn::time::milliseconds m_hold;
+  bool m_hasRun;
+  ndn::time::steady_clock::TimePoint m_lastRun;
+
+  Statistics m_stats;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const Throttle::Statistics& stats);
+
+} // namespace nlsr
+
+#endif // NLSR_THROTTLE_HPP
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#include "timer-wheel.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+#include <boost/assert.hpp>
+
+namespace nlsr {
+
+INIT_LOGGER(TimerWheel);
+
+constexpr int TimerWheel::SLOT_BITS;
+constexpr size_t TimerWheel::N_SLOTS;
+constexpr int TimerWheel::N_LEVELS;
+constexpr int TimerWheel::DUE;
+constexpr int TimerWheel::DONE;
+
+void
+TimerWheel::EventId::cancel()
+{
+  auto timer = m_timer.lock();
+  if (timer != nullptr && timer->level != DONE) {
+    timer->wheel->cancel(*timer);
+  }
+}
+
+TimerWheel::EventId::operator bool() const
+{
+  auto timer = m_timer.lock();
+  return timer != nullptr && timer->level != DONE;
+}
+
+TimerWheel::TimerWheel(ndn::Scheduler& scheduler)
+  : m_scheduler(scheduler)
+  , m_origin(ndn::time::steady_clock::now())
+{
+  m_occupiedSlots.fill(0);
+}
+
+TimerWheel::~TimerWheel()
+{
+  m_tickEvent.cancel();
+
+  // The timers may outlive the wheel through their callbacks, but can no longer run
+  for (auto& level : m_slots) {
+    for (auto& slot : level) {
+      for (auto& timer : slot) {
+        timer->level = DONE;
+      }
+    }
+  }
+  for (auto& timer : m_dueTimers) {
+    timer->level = DONE;
+  }
+}
+
+TimerWheel::EventId
+TimerWheel::schedule(ndn::time::nanoseconds after, const std::function<void()>& callback)
+{
+  auto timer = std::make_shared<Timer>();
+  timer->callback = callback;
+  timer->wheel = this;
+
+  ndn::time::nanoseconds now = ndn::time::steady_clock::now() - m_origin;
+  if (m_nTimers == 0 && !m_isAdvancing) {
+    // Catch up with the time spent idle, so that the timer is not filed too high
+    m_now = std::max<uint64_t>(m_now, now.count() / 1000000);
+  }
+
+  // Rounded up, so that a timer never runs early
+  ndn::time::nanoseconds due = now + std::max(after, ndn::time::nanoseconds::zero());
+  timer->dueTick = std::max<uint64_t>((due.count() + 999999) / 1000000, m_now + 1);
+
+  TimerList scheduled{timer};
+  file(scheduled, scheduled.begin());
+  ++m_nTimers;
+  scheduleTick();
+  return EventId(timer);
+}
+
+void
+TimerWheel::cancel(Timer& timer)
+{
+  if (timer.level == DUE) {
+    m_dueTimers.erase(timer.position);
+  }
+  else {
+    size_t slot = (timer.dueTick >> (timer.level * SLOT_BITS)) & (N_SLOTS - 1);
+    TimerList& list = m_slots[timer.level][slot];
+    list.erase(timer.position);
+    if (list.empty()) {
+      m_occupiedSlots[timer.level] &= ~(uint64_t(1) << slot);
+    }
+  }
+  timer.level = DONE;
+  --m_nTimers;
+  // The tick event is left as it is; if it was set for this timer, it finds nothing to do
+}
+
+void
+TimerWheel::file(TimerList& list, TimerList::iterator timer)
+{
+  Timer& t = **timer;
+  if (t.dueTick <= m_now) {
+    t.level = DUE;
+    m_dueTimers.splice(m_dueTimers.end(), list, timer);
+    t.position = timer;
+    return;
+  }
+
+  int highestBit = 63 - __builtin_clzll(t.dueTick ^ m_now);
+  t.level = highestBit / SLOT_BITS;
+  size_t slot = (t.dueTick >> (t.level * SLOT_BITS)) & (N_SLOTS - 1);
+  m_slots[t.level][slot].splice(m_slots[t.level][slot].end(), list, timer);
+  m_occupiedSlots[t.level] |= uint64_t(1) << slot;
+  t.position = timer;
+}
+
+bool
+TimerWheel::findNextTick(uint64_t& tick) const
+{
+  // A slot at a lower level is entered before any slot at a higher level, as all the slots
+  // of a level are within the current slot of the level above
+  for (int level = 0; level < N_LEVELS; ++level) {
+    if (m_occupiedSlots[level] == 0) {
+      continue;
+    }
+    int shift = level * SLOT_BITS;
+    int slot = __builtin_ctzll(m_occupiedSlots[level]);
+    BOOST_ASSERT(static_cast<uint64_t>(slot) > ((m_now >> shift) & (N_SLOTS - 1)));
+
+    int blockShift = shift + SLOT_BITS;
+    uint64_t block = blockShift < 64 ? (m_now >> blockShift) << blockShift : 0;
+    tick = block + (static_cast<uint64_t>(slot) << shift);
+    return true;
+  }
+  return false;
+}
+
+void
+TimerWheel::scheduleTick()
+{
+  if (m_isAdvancing) {
+    return;
+  }
+
+  uint64_t tick = 0;
+  if (!findNextTick(tick)) {
+    m_tickEvent.cancel();
+    m_hasTickEvent = false;
+    return;
+  }
+  if (m_hasTickEvent && m_tickEventTick <= tick) {
+    return;
+  }
+
+  m_tickEvent.cancel();
+  m_hasTickEvent = true;
+  m_tickEventTick = tick;
+  ndn::time::nanoseconds delay = getTime(tick) - ndn::time::steady_clock::now();
+  m_tickEvent = m_scheduler.schedule(std::max(delay, ndn::time::nanoseconds::zero()), [this] {
+    m_hasTickEvent = false;
+    advance();
+  });
+}
+
+void
+TimerWheel::advance()
+{
+  uint64_t target = ndn::time::duration_cast<ndn::time::milliseconds>(
+                      ndn::time::steady_clock::now() - m_origin).count();
+  m_isAdvancing = true;
+
+  uint64_t tick = 0;
+  size_t nRun = 0;
+  while (findNextTick(tick) && tick <= target) {
+    m_now = tick;
+
+    // Enter the slots that start now, from the highest level down, so that the timers
+    // filed again land in the levels that are still to be entered
+    for (int level = N_LEVELS - 1; level >= 0; --level) {
+      int shift = level * SLOT_BITS;
+      if ((m_now & ((uint64_t(1) << shift) - 1)) != 0) {
+        continue;
+      }
+      size_t slot = (m_now >> shift) & (N_SLOTS - 1);
+      TimerList& list = m_slots[level][slot];
+      if (list.empty()) {
+        continue;
+      }
+      TimerList entered;
+      entered.splice(entered.end(), list);
+      m_occupiedSlots[level] &= ~(uint64_t(1) << slot);
+      while (!entered.empty()) {
+        file(entered, entered.begin());
+      }
+    }
+
+    // A callback may cancel a timer that is due, and schedule new ones
+    while (!m_dueTimers.empty()) {
+      std::shared_ptr<Timer> timer = m_dueTimers.front();
+      m_dueTimers.pop_front();
+      timer->level = DONE;
+      --m_nTimers;
+      ++nRun;
+      timer->callback();
+    }
+  }
+  m_now = std::max(m_now, target);
+
+  m_isAdvancing = false;
+  NLSR_LOG_TRACE("Ran " << nRun << " timers, " << m_nTimers << " left");
+  scheduleTick();
+}
+
+} // namespace nlsr
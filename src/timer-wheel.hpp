@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#ifndef NLSR_TIMER_WHEEL_HPP
+#define NLSR_TIMER_WHEEL_HPP
+
+#include "common.hpp"
+
+#include <array>
+#include <list>
+#include <memory>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+namespace nlsr {
+
+/*! \brief Runs callbacks after a delay, for timers that are many and long-lived, such as
+  the lifetimes of LSAs.
+
+  ndn::Scheduler keeps its events in an ordered set, so scheduling and cancelling an event
+  take O(log n). The timer wheel files each timer in a slot of a hierarchy of wheels
+  instead, so that both take O(1). Time is counted in milliseconds since the wheel was
+  made, written in base-64 digits: level i of the wheel has a slot for each value of digit
+  i. A timer is filed at the level of the highest digit in which its due time differs from
+  the current time, in the slot of its own digit there. When the current time enters that
+  slot, the timer is filed again a level lower, until it is due.
+
+  The wheel is driven by a single scheduler event, set for the next time a slot is entered.
+  All the timers due at that time run from that one event, in the order they are filed.
+ */
+class TimerWheel : boost::noncopyable
+{
+private:
+  struct Timer;
+  using TimerList = std::list<std::shared_ptr<Timer>>;
+
+public:
+  /*! \brief Identifies a timer, so that it can be cancelled. */
+  class EventId
+  {
+  public:
+    EventId() = default;
+
+    /*! \brief Cancels the timer, if it has not run yet. */
+    void
+    cancel();
+
+    /*! \brief Returns whether the timer is still to run. */
+    explicit
+    operator bool() const;
+
+  private:
+    explicit
+    EventId(const std::shared_ptr<Timer>& timer)
+      : m_timer(timer)
+    {
+    }
+
+  private:
+    std::weak_ptr<Timer> m_timer;
+
+    friend class TimerWheel;
+  };
+
+  explicit
+  TimerWheel(ndn::Scheduler& scheduler);
+
+  ~TimerWheel();
+
+  /*! \brief Runs a callback after a delay.
+    \param after The delay, which is rounded up to the millisecond.
+    \param callback The callback, which may schedule and cancel timers.
+   */
+  EventId
+  schedule(ndn::time::nanoseconds after, const std::function<void()>& callback);
+
+  /*! \brief Returns the number of timers that are still to run. */
+  size_t
+  size() const
+  {
+    return m_nTimers;
+  }
+
+private:
+  void
+  cancel(Timer& timer);
+
+  /*! \brief Moves a timer from a list to the slot it is due in, or to the due timers. */
+  void
+  file(TimerList& list, TimerList::iterator timer);
+
+  /*! \brief Finds the next time at which a slot is entered.
+    \retval false No timer is filed.
+   */
+  bool
+  findNextTick(uint64_t& tick) const;
+
+  /*! \brief Makes sure that the scheduler event is set for the next tick. */
+  void
+  scheduleTick();
+
+  /*! \brief Enters the slots up to the current time, and runs the timers that are due. */
+  void
+  advance();
+
+  ndn::time::steady_clock::TimePoint
+  getTime(uint64_t tick) const
+  {
+    return m_origin + ndn::time::milliseconds(tick);
+  }
+
+private:
+  static constexpr int SLOT_BITS = 6;
+  static constexpr size_t N_SLOTS = size_t(1) << SLOT_BITS;
+  // Enough levels for every digit of a 64-bit time
+  static constexpr int N_LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+  // The level of a timer that is due, or has run or been cancelled
+  static constexpr int DUE = -1;
+  static constexpr int DONE = -2;
+
+  struct Timer
+  {
+    std::function<void()> callback;
+    TimerWheel* wheel;
+    // The tick the timer is due at
+    uint64_t dueTick;
+    int level;
+    TimerList::iterator position;
+  };
+
+  ndn::Scheduler& m_scheduler;
+  const ndn::time::steady_clock::TimePoint m_origin;
+  // The tick the wheel has advanced to; every filed timer is due after it
+  uint64_t m_now = 0;
+
+  std::array<std::array<TimerList, N_SLOTS>, N_LEVELS> m_slots;
+  // A bit for each slot of a level that holds timers
+  std::array<uint64_t, N_LEVELS> m_occupiedSlots;
+  TimerList m_dueTimers;
+  size_t m_nTimers = 0;
+
+  ndn::scheduler::EventId m_tickEvent;
+  bool m_hasTickEvent = false;
+  uint64_t m_tickEventTick = 0;
+  bool m_isAdvancing = false;
+};
+
+} // namespace nlsr
+
+#endif // NLSR_TIMER_WHEEL_HPP
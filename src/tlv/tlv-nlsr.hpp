@@ -31,7 +31,8 @@ namespace nlsr {
 /*! The TLV block types that NLSR uses to encode/decode LSA types. The
  *  way NLSR encodes LSAs to TLV is by encoding each element of the
  *  LSA as a separate TLV block. So, block types are needed. These are
- *  used in the LSDB Status Dataset.
+ *  used in the LSDB Status Dataset, and in the content of LSA Data when
+ *  LSAs are published in TLV.
  */
 enum {
   LsaInfo          = 128,
@@ -52,6 +53,12 @@ enum {
   NextHop          = 143,
   RoutingTable     = 144,
   RouteTableEntry  = 145,
+  ExpirationTime   = 146,
+  NameLsaDelta     = 147,
+  BaseSeqNumber    = 148,
+  AddedNames       = 149,
+  RemovedNames     = 150,
+  ShardNumber      = 151,
 };
 
 } // namespace nlsr
@@ -41,7 +41,7 @@ public:
     , conf(face)
     , confProcessor(conf, Protocol)
     , testIsLsaNew([] (const ndn::Name& name, const Lsa::Type& lsaType,
-                       const uint64_t sequenceNumber) {
+                       const uint64_t sequenceNumber, uint32_t shard) {
                      return true;
                    })
     , sync(face, testIsLsaNew, conf)
@@ -219,7 +219,7 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(MalformedUpdate, T, Protocols, SyncLogicFixture
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(LsaNotNew, T, Protocols, SyncLogicFixture<T::value>)
 {
   auto testLsaAlwaysFalse = [] (const ndn::Name& routerName, const Lsa::Type& lsaType,
-                                const uint64_t& sequenceNumber) {
+                                const uint64_t& sequenceNumber, uint32_t shard) {
     return false;
   };
 
@@ -236,6 +236,38 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(LsaNotNew, T, Protocols, SyncLogicFixture<T::va
   this->receiveUpdate(updateName, sequenceNumber);
 }
 
+/* Tests that an update for a shard of a name LSA is emitted, and that the
+   shard is checked for a new LSA.
+ */
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(UpdateForNameLsaShard, T, Protocols, SyncLogicFixture<T::value>)
+{
+  uint32_t checkedShard = 0;
+  auto isLsaNew = [&] (const ndn::Name& routerName, const Lsa::Type& lsaType,
+                       const uint64_t& sequenceNumber, uint32_t shard) {
+    BOOST_CHECK_EQUAL(lsaType, Lsa::Type::NAME);
+    checkedShard = shard;
+    return true;
+  };
+  SyncLogicHandler sync{this->face, isLsaNew, this->conf};
+
+  const uint64_t syncSeqNo = 1;
+  std::string updateName = this->updateNamePrefix + makeLsaTypeComponent(Lsa::Type::NAME, 3);
+
+  bool isEmitted = false;
+  ndn::util::signal::ScopedConnection connection = sync.onNewLsa->connect(
+    [&] (const ndn::Name& routerName, const uint64_t& sequenceNumber,
+         const ndn::Name& originRouter) {
+      BOOST_CHECK_EQUAL(ndn::Name{updateName}, routerName);
+      BOOST_CHECK_EQUAL(sequenceNumber, syncSeqNo);
+      BOOST_CHECK_EQUAL(originRouter, ndn::Name("/ndn/site/%C1.Router/other-router"));
+      isEmitted = true;
+    });
+
+  sync.processUpdate(updateName, syncSeqNo);
+  BOOST_CHECK(isEmitted);
+  BOOST_CHECK_EQUAL(checkedShard, 3);
+}
+
 /* Tests that SyncLogicHandler successfully concatenates configured
    variables together to form the necessary prefixes to advertise
    through ChronoSync.
@@ -254,6 +286,17 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(UpdatePrefix, T, Protocols, SyncLogicFixture<T:
                     ndn::Name(expectedPrefix).append(std::to_string(Lsa::Type::ADJACENCY)));
   BOOST_CHECK_EQUAL(this->sync.m_coorLsaUserPrefix,
                     ndn::Name(expectedPrefix).append(std::to_string(Lsa::Type::COORDINATE)));
+
+  // Each shard of the name LSA has a prefix of its own
+  this->conf.setNameLsaShards(3);
+  this->sync.buildUpdatePrefix();
+
+  BOOST_REQUIRE_EQUAL(this->sync.m_nameLsaShardUserPrefixes.size(), 3);
+  BOOST_CHECK_EQUAL(this->sync.m_nameLsaShardUserPrefixes[0], this->sync.m_nameLsaUserPrefix);
+  BOOST_CHECK_EQUAL(this->sync.m_nameLsaUserPrefix,
+                    ndn::Name(expectedPrefix).append(std::to_string(Lsa::Type::NAME)));
+  BOOST_CHECK_EQUAL(this->sync.m_nameLsaShardUserPrefixes[2],
+                    ndn::Name(expectedPrefix).append("NAME-2"));
 }
 
 /* Tests that SyncLogicHandler's socket will be created when
@@ -270,7 +313,7 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(createSyncLogicOnInitialization, T, Protocols,
 
   // Make sure an adjacency LSA has not been built yet
   ndn::Name key = ndn::Name(this->conf.getRouterPrefix()).append(std::to_string(Lsa::Type::ADJACENCY));
-  AdjLsa* lsa = nlsr.m_lsdb.findAdjLsa(key);
+  const AdjLsa* lsa = nlsr.m_lsdb.findAdjLsa(key);
   BOOST_REQUIRE(lsa == nullptr);
 
   // Publish a routing update before an Adjacency LSA is built
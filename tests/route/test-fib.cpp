@@ -27,6 +27,8 @@
 
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <algorithm>
+
 namespace nlsr {
 namespace test {
 
@@ -332,6 +334,171 @@ BOOST_AUTO_TEST_CASE(ShouldNotRefreshNeighborRoute) // #4799
   BOOST_CHECK_EQUAL(face->sentInterests.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(RibCommandsCoalescedWhileQueued)
+{
+  fib->m_ribCommandWindow = 1;
+
+  NexthopList hops;
+  hops.addNextHop(NextHop(router1FaceUri, 10));
+  hops.addNextHop(NextHop(router2FaceUri, 20));
+
+  fib->update("/ndn/name", hops);
+  face->processEvents(ndn::time::milliseconds(-1));
+
+  // Only the registration of face 1 fits in the window
+  BOOST_REQUIRE_EQUAL(interests.size(), 1);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nInFlight, 1);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nQueued, 1);
+
+  // The unregistration of face 2 replaces its queued registration
+  fib->remove("/ndn/name");
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nQueued, 2);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nCoalesced, 1);
+
+  // The registration times out; it is not tried again, as face 1 is being unregistered
+  this->advanceClocks(ndn::time::seconds(1), 11);
+
+  BOOST_REQUIRE_EQUAL(interests.size(), 2);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nAnswered, 1);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().nQueued, 1);
+
+  ndn::nfd::ControlParameters extractedParameters;
+  ndn::Name::Component verb;
+  extractRibCommandParameters(interests.back(), verb, extractedParameters);
+
+  BOOST_CHECK(extractedParameters.getName() == "/ndn/name" &&
+              extractedParameters.getFaceId() == router2FaceId &&
+              verb == ndn::Name::Component("unregister"));
+}
+
+BOOST_AUTO_TEST_CASE(RibCommandsRoutesBeforeRefreshes)
+{
+  fib->m_ribCommandWindow = 1;
+
+  const auto timeout = ndn::time::seconds(60);
+  fib->registerPrefix("/ndn/a", ndn::FaceUri(router1FaceUri), 10, timeout,
+                      ndn::nfd::ROUTE_FLAG_CAPTURE, 0, RibCommandPriority::REFRESH);
+  fib->registerPrefix("/ndn/b", ndn::FaceUri(router1FaceUri), 10, timeout,
+                      ndn::nfd::ROUTE_FLAG_CAPTURE, 0, RibCommandPriority::REFRESH);
+  fib->registerPrefix("/ndn/c", ndn::FaceUri(router1FaceUri), 10, timeout,
+                      ndn::nfd::ROUTE_FLAG_CAPTURE, 0, RibCommandPriority::ROUTE);
+  face->processEvents(ndn::time::milliseconds(-1));
+
+  BOOST_REQUIRE_EQUAL(interests.size(), 1);
+  BOOST_CHECK_EQUAL(fib->getRibCommandCounters().maxQueued, 2);
+
+  this->advanceClocks(ndn::time::seconds(1), 11);
+
+  BOOST_REQUIRE_EQUAL(interests.size(), 2);
+
+  ndn::nfd::ControlParameters extractedParameters;
+  ndn::Name::Component verb;
+  extractRibCommandParameters(interests.back(), verb, extractedParameters);
+
+  BOOST_CHECK_EQUAL(extractedParameters.getName(), "/ndn/c");
+  BOOST_CHECK(verb == ndn::Name::Component("register"));
+}
+
+BOOST_AUTO_TEST_CASE(RibCommandsWindowKeptForRefreshes)
+{
+  fib->m_ribCommandWindow = 4;
+
+  const auto timeout = ndn::time::seconds(60);
+  for (int i = 0; i < 8; ++i) {
+    fib->registerPrefix(ndn::Name("/ndn/route").appendNumber(i), ndn::FaceUri(router1FaceUri),
+                        10, timeout, ndn::nfd::ROUTE_FLAG_CAPTURE, 0, RibCommandPriority::ROUTE);
+  }
+  fib->registerPrefix("/ndn/refresh", ndn::FaceUri(router1FaceUri), 10, timeout,
+                      ndn::nfd::ROUTE_FLAG_CAPTURE, 0, RibCommandPriority::REFRESH);
+  face->processEvents(ndn::time::milliseconds(-1));
+
+  BOOST_REQUIRE_EQUAL(interests.size(), 4);
+
+  // Once the first routes time out, the refresh is sent before the routes still queued
+  this->advanceClocks(ndn::time::seconds(1), 11);
+
+  BOOST_REQUIRE_EQUAL(interests.size(), 8);
+
+  ndn::nfd::ControlParameters extractedParameters;
+  ndn::Name::Component verb;
+  extractRibCommandParameters(interests[4], verb, extractedParameters);
+
+  BOOST_CHECK_EQUAL(extractedParameters.getName(), "/ndn/refresh");
+}
+
+BOOST_AUTO_TEST_CASE(RefreshDelayWithinJitter)
+{
+  fib->setEntryRefreshTime(100);
+  conf.setFibRefreshJitter(20);
+
+  for (int i = 0; i < 100; ++i) {
+    ndn::time::milliseconds delay = fib->getRefreshDelay();
+    BOOST_CHECK_GE(delay, ndn::time::seconds(80));
+    BOOST_CHECK_LE(delay, ndn::time::seconds(100));
+  }
+
+  conf.setFibRefreshJitter(0);
+  BOOST_CHECK_EQUAL(fib->getRefreshDelay(), ndn::time::seconds(100));
+}
+
+BOOST_AUTO_TEST_CASE(RefreshInBatches)
+{
+  conf.setFibRefreshJitter(0);
+  conf.setFibRefreshBatchSize(2);
+
+  NexthopList hops;
+  hops.addNextHop(NextHop(router1FaceUri, 10));
+  for (int i = 0; i < 5; ++i) {
+    fib->update(ndn::Name("/ndn/name").appendNumber(i), hops);
+  }
+  face->processEvents(ndn::time::milliseconds(-1));
+  BOOST_REQUIRE_EQUAL(interests.size(), 5);
+  interests.clear();
+
+  // All five entries are due after one second, but only two are refreshed at a time
+  this->advanceClocks(ndn::time::milliseconds(10), 101);
+  BOOST_CHECK_EQUAL(interests.size(), 2);
+  BOOST_CHECK_EQUAL(fib->m_dueRefreshes.size(), 3);
+
+  this->advanceClocks(ndn::time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(interests.size(), 4);
+
+  this->advanceClocks(ndn::time::milliseconds(10), 10);
+  BOOST_CHECK_EQUAL(interests.size(), 5);
+  BOOST_CHECK(fib->m_dueRefreshes.empty());
+}
+
+BOOST_AUTO_TEST_CASE(RefreshBeforeDeadline)
+{
+  conf.setFibRefreshJitter(0);
+  conf.setFibRefreshBatchSize(1);
+
+  NexthopList hops;
+  hops.addNextHop(NextHop(router1FaceUri, 10));
+  std::vector<ndn::Name> names;
+  for (int i = 0; i < 100; ++i) {
+    names.push_back(ndn::Name("/ndn/name").appendNumber(i));
+    fib->update(names.back(), hops);
+  }
+  face->processEvents(ndn::time::milliseconds(-1));
+
+  auto countRefreshed = [&] {
+    return std::count_if(names.begin(), names.end(), [&] (const ndn::Name& name) {
+      return fib->m_table.at(name).getSeqNo() > 1;
+    });
+  };
+
+  // All entries are due after one second, far more than the ten batches a second can refresh
+  // before the deadline, five seconds before the registrations expire
+  this->advanceClocks(ndn::time::milliseconds(10), 550);
+  BOOST_CHECK_GT(countRefreshed(), 0);
+  BOOST_CHECK_LT(countRefreshed(), 100);
+
+  // At the deadline, all the remaining entries are refreshed at once
+  this->advanceClocks(ndn::time::milliseconds(10), 60);
+  BOOST_CHECK_EQUAL(countRefreshed(), 100);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "route/hyperbolic-distance.hpp"
+#include "../test-common.hpp"
+
+#include <cmath>
+#include <random>
+
+namespace nlsr {
+namespace test {
+
+class HyperbolicDistanceFixture : public BaseFixture
+{
+public:
+  // Random points on the unit sphere, with radii like those of the coordinate LSAs.
+  // The number of points is not a multiple of any vector width, so that every kernel
+  // also goes through its scalar tail.
+  HyperbolicDistanceFixture()
+    : nPoints(1003)
+    , dimension(3)
+    , coordinates(nPoints * dimension)
+    , coshRadii(nPoints)
+    , sinhRadii(nPoints)
+  {
+    std::mt19937 engine(42);
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> radius(1.0, 20.0);
+
+    for (size_t i = 0; i < nPoints; ++i) {
+      double norm = 0.0;
+      for (size_t k = 0; k < dimension; ++k) {
+        coordinates[k * nPoints + i] = normal(engine);
+        norm += coordinates[k * nPoints + i] * coordinates[k * nPoints + i];
+      }
+      for (size_t k = 0; k < dimension; ++k) {
+        coordinates[k * nPoints + i] /= std::sqrt(norm);
+      }
+
+      double r = radius(engine);
+      coshRadii[i] = std::cosh(r);
+      sinhRadii[i] = std::sinh(r);
+    }
+  }
+
+  HyperbolicPoints
+  getPoints() const
+  {
+    return {nPoints, dimension, coordinates.data(), coshRadii.data(), sinhRadii.data()};
+  }
+
+public:
+  const size_t nPoints;
+  const size_t dimension;
+  std::vector<double> coordinates;
+  std::vector<double> coshRadii;
+  std::vector<double> sinhRadii;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestHyperbolicDistance, HyperbolicDistanceFixture)
+
+BOOST_AUTO_TEST_CASE(ScalarKernelIsLast)
+{
+  const auto& kernels = getHyperbolicDistanceKernels();
+  BOOST_REQUIRE(!kernels.empty());
+  BOOST_CHECK_EQUAL(kernels.back().name, std::string("scalar"));
+}
+
+BOOST_AUTO_TEST_CASE(MatchesPairwiseFormula)
+{
+  std::vector<double> innerProducts(nPoints);
+  std::vector<double> distances(nPoints);
+  computeHyperbolicDistances(getPoints(), 7, innerProducts.data(), distances.data());
+
+  double r7 = std::acosh(coshRadii[7]);
+  for (size_t i = 0; i < nPoints; i += 97) {
+    double innerProduct = 0.0;
+    for (size_t k = 0; k < dimension; ++k) {
+      innerProduct += coordinates[k * nPoints + 7] * coordinates[k * nPoints + i];
+    }
+    BOOST_CHECK_CLOSE(innerProducts[i], innerProduct, 1e-10);
+
+    if (i != 7) {
+      double r = std::acosh(coshRadii[i]);
+      double expected = std::acosh(std::cosh(r7) * std::cosh(r) -
+                                   std::sinh(r7) * std::sinh(r) * std::cos(std::acos(innerProduct)));
+      BOOST_CHECK_CLOSE(distances[i], expected, 1e-6);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(KernelsMatchScalar)
+{
+  const auto& kernels = getHyperbolicDistanceKernels();
+  HyperbolicPoints points = getPoints();
+
+  std::vector<double> expectedInnerProducts(nPoints);
+  std::vector<double> expectedDistances(nPoints);
+  std::vector<double> innerProducts(nPoints);
+  std::vector<double> distances(nPoints);
+
+  for (size_t src : {size_t(0), size_t(1), nPoints - 1}) {
+    kernels.back().kernel(points, src, expectedInnerProducts.data(), expectedDistances.data());
+
+    for (const auto& kernel : kernels) {
+      BOOST_TEST_MESSAGE("Kernel " << kernel.name << " from point " << src);
+      kernel.kernel(points, src, innerProducts.data(), distances.data());
+
+      for (size_t i = 0; i < nPoints; ++i) {
+        BOOST_CHECK_SMALL(innerProducts[i] - expectedInnerProducts[i], 1e-12);
+        if (i != src) {
+          BOOST_CHECK_SMALL(distances[i] - expectedDistances[i], 1e-12);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
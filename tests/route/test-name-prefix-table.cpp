@@ -306,6 +306,67 @@ BOOST_FIXTURE_TEST_CASE(RoutingTableUpdate, NamePrefixTableFixture)
   BOOST_CHECK_EQUAL(nextHops.size(), 3);
 }
 
+BOOST_FIXTURE_TEST_CASE(FibUpdatedOnlyWhenNexthopsChange, NamePrefixTableFixture)
+{
+  const ndn::Name prefix("/ndn/prefix");
+  const ndn::Name destination1("/ndn/destination1");
+  const ndn::Name destination2("/ndn/destination2");
+  npt.addEntry(prefix, destination1);
+  npt.addEntry(prefix, destination2);
+
+  RoutingTableEntry rte1(destination1);
+  rte1.getNexthopList().addNextHop(NextHop("udp4://10.0.0.1", 10));
+  RoutingTableEntry rte2(destination2);
+  rte2.getNexthopList().addNextHop(NextHop("udp4://10.0.0.1", 20));
+  npt.updateWithNewRoute({rte1, rte2});
+
+  auto fibIt = nlsr.m_fib.m_table.find(prefix);
+  BOOST_REQUIRE(fibIt != nlsr.m_fib.m_table.end());
+  const int32_t seqNo = fibIt->second.getSeqNo();
+
+  // The cheaper hop through destination1 is kept, so the prefix's next hops do not change
+  rte2.getNexthopList().reset();
+  rte2.getNexthopList().addNextHop(NextHop("udp4://10.0.0.1", 30));
+  npt.updateWithNewRoute({rte2});
+  BOOST_CHECK_EQUAL(fibIt->second.getSeqNo(), seqNo);
+
+  rte1.getNexthopList().reset();
+  rte1.getNexthopList().addNextHop(NextHop("udp4://10.0.0.2", 10));
+  npt.updateWithNewRoute({rte1});
+  BOOST_CHECK_EQUAL(fibIt->second.getSeqNo(), seqNo + 1);
+  BOOST_CHECK_EQUAL(fibIt->second.getNexthopList().size(), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(InsertionOrder, NamePrefixTableFixture)
+{
+  const ndn::Name destination("/ndn/destination1");
+  const std::vector<ndn::Name> prefixes{"/ndn/c", "/ndn/a", "/ndn/b"};
+  for (const auto& prefix : prefixes) {
+    npt.addEntry(prefix, destination);
+  }
+  // Adding an origin to an existing prefix does not move it
+  npt.addEntry("/ndn/c", "/ndn/destination2");
+
+  auto getPrefixes = [this] {
+    std::vector<ndn::Name> names;
+    for (const auto& entry : npt) {
+      names.push_back(entry->getNamePrefix());
+    }
+    return names;
+  };
+
+  std::vector<ndn::Name> actual = getPrefixes();
+  BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), prefixes.begin(), prefixes.end());
+
+  // A prefix that is removed and added again goes to the end
+  npt.removeEntry("/ndn/a", destination);
+  npt.addEntry("/ndn/a", destination);
+
+  const std::vector<ndn::Name> expected{"/ndn/c", "/ndn/b", "/ndn/a"};
+  actual = getPrefixes();
+  BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
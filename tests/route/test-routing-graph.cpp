@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "route/routing-graph.hpp"
+#include "route/map.hpp"
+#include "adjacency-list.hpp"
+#include "adjacent.hpp"
+#include "lsa.hpp"
+#include "../test-common.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace nlsr {
+namespace test {
+
+class RoutingGraphFixture : public BaseFixture
+{
+public:
+  RoutingGraphFixture()
+    : names{"/ndn/site/%C1.Router/a", "/ndn/site/%C1.Router/b",
+            "/ndn/site/%C1.Router/c", "/ndn/site/%C1.Router/d"}
+    , adjacencies(names.size())
+  {
+  }
+
+  void
+  advertise(size_t from, size_t to, double cost)
+  {
+    Adjacent adjacent(names[to], ndn::FaceUri("udp4://10.0.0." + std::to_string(to)), cost,
+                      Adjacent::STATUS_ACTIVE, 0, 0);
+    adjacencies[from].insert(adjacent);
+  }
+
+  void
+  buildGraph(RoutingGraph& graph)
+  {
+    adjLsas.clear();
+    for (size_t i = 0; i < names.size(); ++i) {
+      adjLsas.emplace(names[i], 1, ndn::time::system_clock::TimePoint::max(),
+                           adjacencies[i].size(), adjacencies[i]);
+    }
+    map.reset();
+    map.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+    graph.build(adjLsas, map);
+  }
+
+  /*! \brief Returns the links of a router as (router index, cost) pairs.
+   */
+  std::vector<std::pair<size_t, double>>
+  getLinks(const RoutingGraph& graph, size_t router)
+  {
+    std::vector<std::pair<size_t, double>> links;
+    for (const auto& link : graph.getLinks(*map.getMappingNoByRouterName(names[router]))) {
+      const ndn::Name& to = *map.getRouterNameByMappingNo(link.to);
+      links.emplace_back(std::find(names.begin(), names.end(), to) - names.begin(), link.cost);
+    }
+    std::sort(links.begin(), links.end());
+    return links;
+  }
+
+public:
+  std::vector<ndn::Name> names;
+  std::vector<AdjacencyList> adjacencies;
+  AdjLsaContainer adjLsas;
+  Map map;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestRoutingGraph, RoutingGraphFixture)
+
+BOOST_AUTO_TEST_CASE(CostCorrection)
+{
+  // a-b is symmetric, a-c asymmetric, b-c broken on one side and c-d one-sided
+  advertise(0, 1, 5);
+  advertise(1, 0, 5);
+  advertise(0, 2, 10);
+  advertise(2, 0, 12);
+  advertise(1, 2, 7);
+  advertise(2, 1, Adjacent::NON_ADJACENT_COST);
+  advertise(2, 3, 3);
+
+  RoutingGraph graph;
+  buildGraph(graph);
+
+  BOOST_CHECK_EQUAL(graph.getNRouters(), 4);
+  BOOST_CHECK_EQUAL(graph.getNLinks(), 4);
+
+  using Links = std::vector<std::pair<size_t, double>>;
+  BOOST_CHECK(getLinks(graph, 0) == (Links{{1, 5}, {2, 12}}));
+  BOOST_CHECK(getLinks(graph, 1) == (Links{{0, 5}}));
+  BOOST_CHECK(getLinks(graph, 2) == (Links{{0, 12}}));
+  BOOST_CHECK(getLinks(graph, 3).empty());
+
+  // Rows are ordered by the router the links lead to
+  for (size_t router = 0; router < graph.getNRouters(); ++router) {
+    auto links = graph.getLinks(router);
+    BOOST_CHECK(std::is_sorted(links.begin(), links.end(),
+                               [] (const RoutingGraph::Link& lhs, const RoutingGraph::Link& rhs) {
+                                 return lhs.to < rhs.to;
+                               }));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RebuildAndCompare)
+{
+  advertise(0, 1, 5);
+  advertise(1, 0, 5);
+  advertise(1, 2, 7);
+  advertise(2, 1, 7);
+
+  RoutingGraph previous;
+  buildGraph(previous);
+
+  // b-c goes down, c-d comes up and a-b gets more expensive
+  adjacencies[2].findAdjacent(names[1])->setLinkCost(Adjacent::NON_ADJACENT_COST);
+  adjacencies[0].findAdjacent(names[1])->setLinkCost(8);
+  advertise(2, 3, 3);
+  advertise(3, 2, 3);
+
+  RoutingGraph graph;
+  buildGraph(graph);
+  BOOST_CHECK_EQUAL(graph.getNLinks(), 4);
+
+  std::vector<RoutingGraph::LinkChange> changes = graph.getChangesFrom(previous);
+  BOOST_REQUIRE_EQUAL(changes.size(), 3);
+
+  std::map<std::pair<size_t, size_t>, std::pair<double, double>> changedCosts;
+  for (const auto& change : changes) {
+    BOOST_CHECK_LT(change.from, change.to);
+    size_t from = std::find(names.begin(), names.end(),
+                            *map.getRouterNameByMappingNo(change.from)) - names.begin();
+    size_t to = std::find(names.begin(), names.end(),
+                          *map.getRouterNameByMappingNo(change.to)) - names.begin();
+    changedCosts[std::minmax(from, to)] = {change.oldCost, change.newCost};
+  }
+  BOOST_CHECK(changedCosts[{0, 1}] == std::make_pair(5.0, 8.0));
+  BOOST_CHECK(changedCosts[{1, 2}] == std::make_pair(7.0, RoutingGraph::NO_LINK));
+  BOOST_CHECK(changedCosts[{2, 3}] == std::make_pair(RoutingGraph::NO_LINK, 3.0));
+
+  // Building into a graph that held another network replaces it entirely
+  graph.swap(previous);
+  buildGraph(graph);
+  BOOST_CHECK(graph.getChangesFrom(previous).empty());
+  BOOST_CHECK(getLinks(graph, 3) == getLinks(previous, 3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
@@ -28,6 +28,10 @@
 #include "route/nexthop.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <map>
+#include <thread>
+
 namespace nlsr {
 namespace test {
 
@@ -40,7 +44,7 @@ BOOST_AUTO_TEST_CASE(RoutingTableAddNextHop)
   ndn::KeyChain keyChain;
   Nlsr nlsr(face, keyChain, conf);
 
-  RoutingTable rt1(m_scheduler, nlsr.m_fib, nlsr.m_lsdb,
+  RoutingTable rt1(m_ioService, m_scheduler, nlsr.m_fib, nlsr.m_lsdb,
                    nlsr.m_namePrefixTable, conf);
 
   NextHop nh1;
@@ -50,6 +54,160 @@ BOOST_AUTO_TEST_CASE(RoutingTableAddNextHop)
   BOOST_CHECK_EQUAL(rt1.findRoutingTableEntry(DEST_ROUTER)->getDestination(), DEST_ROUTER);
 }
 
+BOOST_AUTO_TEST_CASE(ChangesFromPreviousTable)
+{
+  ndn::util::DummyClientFace face;
+  ConfParameter conf(face);
+  ndn::KeyChain keyChain;
+  Nlsr nlsr(face, keyChain, conf);
+
+  RoutingTable rt1(m_ioService, m_scheduler, nlsr.m_fib, nlsr.m_lsdb,
+                   nlsr.m_namePrefixTable, conf);
+
+  NextHop nh1("udp4://10.0.0.1", 10);
+  NextHop nh2("udp4://10.0.0.2", 20);
+
+  rt1.addNextHop("/ndn/unchanged", nh1);
+  rt1.addNextHop("/ndn/changed", nh1);
+  rt1.addNextHop("/ndn/removed", nh2);
+
+  std::list<RoutingTableEntry> previousTable;
+  rt1.m_rTable.swap(previousTable);
+
+  rt1.addNextHop("/ndn/unchanged", nh1);
+  rt1.addNextHop("/ndn/changed", nh1);
+  rt1.addNextHop("/ndn/changed", nh2);
+  rt1.addNextHop("/ndn/added", nh2);
+
+  std::list<RoutingTableEntry> changes = rt1.getChangesFrom(previousTable);
+  BOOST_REQUIRE_EQUAL(changes.size(), 3);
+
+  auto it = changes.begin();
+  BOOST_CHECK_EQUAL(it->getDestination(), "/ndn/changed");
+  BOOST_CHECK_EQUAL(it->getNexthopList().size(), 2);
+  ++it;
+  BOOST_CHECK_EQUAL(it->getDestination(), "/ndn/added");
+  BOOST_CHECK_EQUAL(it->getNexthopList().size(), 1);
+  ++it;
+  BOOST_CHECK_EQUAL(it->getDestination(), "/ndn/removed");
+  BOOST_CHECK_EQUAL(it->getNexthopList().size(), 0);
+
+  previousTable = rt1.m_rTable;
+  BOOST_CHECK(rt1.getChangesFrom(previousTable).empty());
+}
+
+BOOST_AUTO_TEST_CASE(EntriesByDestination)
+{
+  RoutingTableEntries entries;
+  NextHop nh1("udp4://10.0.0.1", 10);
+  NextHop nh2("udp4://10.0.0.2", 20);
+
+  entries.addNextHop("/ndn/a", nh1);
+  entries.addNextHop("/ndn/b", nh1);
+  entries.addNextHop("/ndn/a", nh2);
+  BOOST_CHECK_EQUAL(entries.size(), 2);
+  BOOST_CHECK_EQUAL(entries.begin()->getDestination(), "/ndn/a");
+  BOOST_REQUIRE(entries.find("/ndn/a") != nullptr);
+  BOOST_CHECK_EQUAL(entries.find("/ndn/a")->getNexthopList().size(), 2);
+  BOOST_CHECK(entries.find("/ndn/c") == nullptr);
+
+  // An entry without next hops removes its destination
+  entries.update(RoutingTableEntry("/ndn/a"));
+  BOOST_CHECK_EQUAL(entries.size(), 1);
+  BOOST_CHECK(entries.find("/ndn/a") == nullptr);
+
+  RoutingTableEntry c("/ndn/c");
+  c.getNexthopList().addNextHop(nh2);
+  entries.update(c);
+  BOOST_REQUIRE(entries.find("/ndn/c") != nullptr);
+  BOOST_CHECK_EQUAL(entries.find("/ndn/c")->getNexthopList().size(), 1);
+
+  // Entries that were removed are filled again rather than allocated
+  const RoutingTableEntry* b = entries.find("/ndn/b");
+  entries.clear();
+  BOOST_CHECK(entries.empty());
+  BOOST_CHECK(entries.find("/ndn/b") == nullptr);
+  entries.addNextHop("/ndn/d", nh1);
+  entries.addNextHop("/ndn/e", nh1);
+  entries.addNextHop("/ndn/f", nh1);
+  BOOST_CHECK(entries.find("/ndn/e") == b);
+  BOOST_CHECK_EQUAL(entries.find("/ndn/e")->getNexthopList().size(), 1);
+
+  std::list<RoutingTableEntry> list;
+  entries.swap(list);
+  BOOST_CHECK(entries.empty());
+  BOOST_CHECK_EQUAL(list.size(), 3);
+  entries.swap(list);
+  BOOST_CHECK(entries.find("/ndn/f") != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(CalculateOnWorkerThreads)
+{
+  ndn::util::DummyClientFace face(m_ioService, m_keyChain);
+  ConfParameter conf(face);
+  DummyConfFileProcessor confProcessor(conf);
+  conf.setRoutingCalcThreads(2);
+  Nlsr nlsr(face, m_keyChain, conf);
+  RoutingTable& routingTable = nlsr.m_routingTable;
+
+  // Triangle topology, this router being A
+  const ndn::Name a = conf.getRouterPrefix();
+  const ndn::Name b = "/ndn/site/%C1.Router/b";
+  const ndn::Name c = "/ndn/site/%C1.Router/c";
+  std::map<ndn::Name, std::string> faces{{a, "udp4://10.0.0.1"},
+                                         {b, "udp4://10.0.0.2"},
+                                         {c, "udp4://10.0.0.3"}};
+  auto installAdjLsa = [&] (const ndn::Name& origin, const ndn::Name& first, double firstCost,
+                            const ndn::Name& second, double secondCost) {
+    AdjacencyList adjacencies;
+    adjacencies.insert(Adjacent(first, ndn::FaceUri(faces[first]), firstCost,
+                                Adjacent::STATUS_ACTIVE, 0, 0));
+    adjacencies.insert(Adjacent(second, ndn::FaceUri(faces[second]), secondCost,
+                                Adjacent::STATUS_ACTIVE, 0, 0));
+    if (origin == a) {
+      conf.getAdjacencyList() = adjacencies;
+    }
+    AdjLsa lsa(origin, 1, ndn::time::system_clock::TimePoint::max(), 2, adjacencies);
+    nlsr.m_lsdb.installAdjLsa(lsa);
+  };
+  installAdjLsa(a, b, 5, c, 10);
+  installAdjLsa(b, a, 5, c, 17);
+  installAdjLsa(c, a, 10, b, 17);
+
+  std::list<RoutingTableEntry> changes;
+  size_t nRoutingChanges = 0;
+  ndn::util::signal::ScopedConnection connection = routingTable.afterRoutingChange->connect(
+    [&] (const std::list<RoutingTableEntry>& entries) {
+      changes = entries;
+      ++nRoutingChanges;
+    });
+
+  routingTable.calculate();
+
+  // The routing table is only changed on the main thread, once the workers are done
+  BOOST_CHECK(routingTable.isCalculating());
+  BOOST_CHECK(routingTable.getRoutingTableEntry().empty());
+  BOOST_CHECK_EQUAL(nRoutingChanges, 0);
+
+  for (int i = 0; i < 500 && routingTable.isCalculating(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    m_ioService.reset();
+    m_ioService.poll();
+  }
+  BOOST_REQUIRE(!routingTable.isCalculating());
+
+  BOOST_CHECK_EQUAL(nRoutingChanges, 1);
+  BOOST_CHECK_EQUAL(changes.size(), 2);
+
+  RoutingTableEntry* entryB = routingTable.findRoutingTableEntry(b);
+  BOOST_REQUIRE(entryB != nullptr);
+  BOOST_CHECK_EQUAL(entryB->getNexthopList().size(), 2);
+
+  RoutingTableEntry* entryC = routingTable.findRoutingTableEntry(c);
+  BOOST_REQUIRE(entryC != nullptr);
+  BOOST_CHECK_EQUAL(entryC->getNexthopList().size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
@@ -42,9 +42,14 @@ const std::string SECTION_GENERAL =
   "  router /cs/pollux/\n"
   "  lsa-refresh-time 1800\n"
   "  lsa-interest-lifetime 3\n"
+  "  max-lsa-fetches 50\n"
   "  router-dead-interval 86400\n"
   "  sync-protocol psync\n"
+  "  lsa-encoding tlv\n"
+  "  name-lsa-delta on\n"
+  "  name-lsa-shards 8\n"
   "  sync-interest-lifetime 10000\n"
+  "  lsdb-snapshot-interval 300\n"
   "  state-dir /tmp\n"
   "}\n\n";
 
@@ -55,6 +60,8 @@ const std::string SECTION_NEIGHBORS =
   "  hello-timeout 1\n"
   "  hello-interval  60\n\n"
   "  adj-lsa-build-interval 3\n"
+  "  adj-lsa-build-initial-delay 50\n"
+  "  adj-lsa-build-hold-delay 500\n"
   "  first-hello-interval  6\n"
   "  neighbor\n"
   "  {\n"
@@ -99,6 +106,12 @@ const std::string SECTION_FIB =
   "{\n"
   "   max-faces-per-prefix 3\n"
   "   routing-calc-interval 9\n"
+  "   routing-calc-initial-delay 100\n"
+  "   routing-calc-hold-delay 1000\n"
+  "   routing-calc-threads 4\n"
+  "   refresh-jitter 25\n"
+  "   refresh-batch-size 500\n"
+  "   incremental-spf on\n"
   "}\n\n";
 
 const std::string SECTION_ADVERTISING =
@@ -173,9 +186,14 @@ BOOST_AUTO_TEST_CASE(LinkState)
   BOOST_CHECK_EQUAL(conf.getLsaPrefix(), "/localhop/ndn/nlsr/LSA");
   BOOST_CHECK_EQUAL(conf.getLsaRefreshTime(), 1800);
   BOOST_CHECK_EQUAL(conf.getSyncProtocol(), SYNC_PROTOCOL_PSYNC);
+  BOOST_CHECK_EQUAL(conf.getLsaEncoding(), LSA_ENCODING_TLV);
+  BOOST_CHECK(conf.isNameLsaDeltaEnabled());
+  BOOST_CHECK_EQUAL(conf.getNameLsaShards(), 8);
   BOOST_CHECK_EQUAL(conf.getLsaInterestLifetime(), ndn::time::seconds(3));
+  BOOST_CHECK_EQUAL(conf.getMaxLsaFetches(), 50);
   BOOST_CHECK_EQUAL(conf.getRouterDeadInterval(), 86400);
   BOOST_CHECK_EQUAL(conf.getSyncInterestLifetime(), ndn::time::milliseconds(10000));
+  BOOST_CHECK_EQUAL(conf.getLsdbSnapshotInterval(), 300);
   BOOST_CHECK_EQUAL(conf.getStateFileDir(), "/tmp");
 
   // Neighbors
@@ -184,6 +202,8 @@ BOOST_AUTO_TEST_CASE(LinkState)
   BOOST_CHECK_EQUAL(conf.getInfoInterestInterval(), 60);
 
   BOOST_CHECK_EQUAL(conf.getAdjLsaBuildInterval(), 3);
+  BOOST_CHECK_EQUAL(conf.getAdjLsaBuildInitialDelay(), 50);
+  BOOST_CHECK_EQUAL(conf.getAdjLsaBuildHoldDelay(), 500);
   BOOST_CHECK_EQUAL(conf.getFirstHelloInterval(), 6);
 
   BOOST_CHECK(conf.getAdjacencyList().isNeighbor("/ndn/memphis.edu/cs/mira"));
@@ -206,6 +226,12 @@ BOOST_AUTO_TEST_CASE(LinkState)
   // FIB
   BOOST_CHECK_EQUAL(conf.getMaxFacesPerPrefix(), 3);
   BOOST_CHECK_EQUAL(conf.getRoutingCalcInterval(), 9);
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcInitialDelay(), 100);
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcHoldDelay(), 1000);
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcThreads(), 4);
+  BOOST_CHECK_EQUAL(conf.getFibRefreshJitter(), 25);
+  BOOST_CHECK_EQUAL(conf.getFibRefreshBatchSize(), 500);
+  BOOST_CHECK_EQUAL(conf.isIncrementalSpfEnabled(), true);
 
   // Advertising
   BOOST_CHECK_EQUAL(conf.getNamePrefixList().size(), 2);
@@ -262,6 +288,11 @@ BOOST_AUTO_TEST_CASE(DefaultValuesGeneral)
   commentOut("lsa-refresh-time", config);
   commentOut("lsa-interest-lifetime", config);
   commentOut("router-dead-interval", config);
+  commentOut("lsa-encoding", config);
+  commentOut("name-lsa-delta", config);
+  commentOut("name-lsa-shards", config);
+  commentOut("lsdb-snapshot-interval", config);
+  commentOut("max-lsa-fetches", config);
 
   BOOST_CHECK_EQUAL(processConfigurationString(config), true);
 
@@ -269,6 +300,12 @@ BOOST_AUTO_TEST_CASE(DefaultValuesGeneral)
   BOOST_CHECK_EQUAL(conf.getLsaInterestLifetime(),
                     static_cast<ndn::time::seconds>(LSA_INTEREST_LIFETIME_DEFAULT));
   BOOST_CHECK_EQUAL(conf.getRouterDeadInterval(), (2*conf.getLsaRefreshTime()));
+  BOOST_CHECK_EQUAL(conf.getLsaEncoding(), LSA_ENCODING_TEXT);
+  BOOST_CHECK(!conf.isNameLsaDeltaEnabled());
+  BOOST_CHECK_EQUAL(conf.getNameLsaShards(), static_cast<uint32_t>(NAME_LSA_SHARDS_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getLsdbSnapshotInterval(),
+                    static_cast<uint32_t>(LSDB_SNAPSHOT_INTERVAL_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getMaxLsaFetches(), static_cast<uint32_t>(MAX_LSA_FETCHES_DEFAULT));
 }
 
 BOOST_AUTO_TEST_CASE(DefaultValuesNeighbors)
@@ -280,6 +317,8 @@ BOOST_AUTO_TEST_CASE(DefaultValuesNeighbors)
   commentOut("hello-interval", config);
   commentOut("first-hello-interval", config);
   commentOut("adj-lsa-build-interval", config);
+  commentOut("adj-lsa-build-initial-delay", config);
+  commentOut("adj-lsa-build-hold-delay", config);
 
   BOOST_CHECK_EQUAL(processConfigurationString(config), true);
 
@@ -290,6 +329,10 @@ BOOST_AUTO_TEST_CASE(DefaultValuesNeighbors)
                     static_cast<uint32_t>(FIRST_HELLO_INTERVAL_DEFAULT));
   BOOST_CHECK_EQUAL(conf.getAdjLsaBuildInterval(),
                     static_cast<uint32_t>(ADJ_LSA_BUILD_INTERVAL_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getAdjLsaBuildInitialDelay(),
+                    static_cast<uint32_t>(ADJ_LSA_BUILD_INITIAL_DELAY_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getAdjLsaBuildHoldDelay(),
+                    static_cast<uint32_t>(ADJ_LSA_BUILD_HOLD_DELAY_DEFAULT));
 }
 
 BOOST_AUTO_TEST_CASE(CanonizeNeighbors)
@@ -324,6 +367,12 @@ BOOST_AUTO_TEST_CASE(DefaultValuesFib)
 
   commentOut("max-faces-per-prefix", config);
   commentOut("routing-calc-interval", config);
+  commentOut("routing-calc-initial-delay", config);
+  commentOut("routing-calc-hold-delay", config);
+  commentOut("routing-calc-threads", config);
+  commentOut("refresh-jitter", config);
+  commentOut("refresh-batch-size", config);
+  commentOut("incremental-spf", config);
 
   BOOST_CHECK_EQUAL(processConfigurationString(config), true);
 
@@ -331,6 +380,17 @@ BOOST_AUTO_TEST_CASE(DefaultValuesFib)
                     static_cast<uint32_t>(MAX_FACES_PER_PREFIX_DEFAULT));
   BOOST_CHECK_EQUAL(conf.getRoutingCalcInterval(),
                     static_cast<uint32_t>(ROUTING_CALC_INTERVAL_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcInitialDelay(),
+                    static_cast<uint32_t>(ROUTING_CALC_INITIAL_DELAY_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcHoldDelay(),
+                    static_cast<uint32_t>(ROUTING_CALC_HOLD_DELAY_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getRoutingCalcThreads(),
+                    static_cast<uint32_t>(ROUTING_CALC_THREADS_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getFibRefreshJitter(),
+                    static_cast<uint32_t>(FIB_REFRESH_JITTER_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.getFibRefreshBatchSize(),
+                    static_cast<uint32_t>(FIB_REFRESH_BATCH_SIZE_DEFAULT));
+  BOOST_CHECK_EQUAL(conf.isIncrementalSpfEnabled(), false);
 }
 
 BOOST_AUTO_TEST_CASE(DefaultValuesHyperbolic)
@@ -355,6 +415,14 @@ BOOST_AUTO_TEST_CASE(OutOfRangeValue)
 
   // Processing should fail due to out of range value
   BOOST_CHECK_EQUAL(processConfigurationString(SECTION_FIB_OUT_OF_RANGE), false);
+
+  const std::string SECTION_FIB_NO_JITTER =
+  "fib\n"
+  "{\n"
+  "   refresh-jitter 0\n" // Smaller than min value
+  "}\n\n";
+
+  BOOST_CHECK_EQUAL(processConfigurationString(SECTION_FIB_NO_JITTER), false);
 }
 
 BOOST_AUTO_TEST_CASE(NegativeValue)
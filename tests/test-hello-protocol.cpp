@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "hello-protocol.hpp"
+#include "test-common.hpp"
+#include "nlsr.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace nlsr {
+namespace test {
+
+class HelloProtocolFixture : public UnitTestTimeFixture
+{
+public:
+  HelloProtocolFixture()
+    : face(m_ioService, m_keyChain)
+    , conf(face)
+    , nlsr(face, m_keyChain, conf)
+    , hello(nlsr.m_helloProtocol)
+  {
+    conf.setNetwork("/ndn");
+    conf.setSiteName("/site");
+    conf.setRouterName("/%C1.Router/this-router");
+    conf.buildRouterPrefix();
+    conf.setSyncInterestLifetime(1000);
+
+    Adjacent other(OTHER_ROUTER, ndn::FaceUri("udp4://10.0.0.2"), 25,
+                   Adjacent::STATUS_ACTIVE, 0, 0);
+    conf.getAdjacencyList().insert(other);
+
+    addIdentity(conf.getRouterPrefix());
+
+    nlsr.initialize();
+
+    this->advanceClocks(ndn::time::milliseconds(1), 10);
+    face.sentData.clear();
+  }
+
+  void
+  receiveHelloInterest(const ndn::Name& neighbor)
+  {
+    // interest name: /<router>/NLSR/INFO/<neighbor>
+    ndn::Name interestName(conf.getRouterPrefix());
+    interestName.append("NLSR");
+    interestName.append("INFO");
+    interestName.append(neighbor.wireEncode());
+
+    hello.processInterest(ndn::Name(), ndn::Interest(interestName));
+    this->advanceClocks(ndn::time::milliseconds(1), 10);
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  ConfParameter conf;
+  Nlsr nlsr;
+  HelloProtocol& hello;
+
+  static const ndn::Name OTHER_ROUTER;
+};
+
+const ndn::Name HelloProtocolFixture::OTHER_ROUTER("/ndn/site/%C1.Router/other-router");
+
+BOOST_FIXTURE_TEST_SUITE(TestHelloProtocol, HelloProtocolFixture)
+
+BOOST_AUTO_TEST_CASE(ReplyFromCache)
+{
+  receiveHelloInterest(OTHER_ROUTER);
+  receiveHelloInterest(OTHER_ROUTER);
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  // The second reply is the data signed for the first one
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), face.sentData[1].getName());
+  BOOST_CHECK(face.sentData[0].wireEncode() == face.sentData[1].wireEncode());
+  BOOST_CHECK_EQUAL(hello.m_helloDataCache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownNeighbor)
+{
+  receiveHelloInterest("/ndn/site/%C1.Router/unknown-router");
+
+  BOOST_CHECK_EQUAL(face.sentData.size(), 0);
+  BOOST_CHECK(hello.m_helloDataCache.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ResignBeforeExpiry)
+{
+  receiveHelloInterest(OTHER_ROUTER);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  ndn::Name firstName = face.sentData[0].getName();
+
+  // The data has been used, so it is signed again before it expires
+  this->advanceClocks(ndn::time::seconds(1),
+                      ndn::time::duration_cast<ndn::time::seconds>(
+                        HelloProtocol::HELLO_DATA_LIFETIME -
+                        HelloProtocol::HELLO_DATA_RESIGN_MARGIN).count() + 1);
+
+  auto entry = hello.m_helloDataCache.find(OTHER_ROUTER);
+  BOOST_REQUIRE(entry != hello.m_helloDataCache.end());
+  BOOST_CHECK_NE(entry->second.data->getName(), firstName);
+  BOOST_CHECK_EQUAL(entry->second.isUsed, false);
+
+  // Data that has not been used since is dropped instead
+  this->advanceClocks(ndn::time::seconds(1),
+                      ndn::time::duration_cast<ndn::time::seconds>(
+                        HelloProtocol::HELLO_DATA_LIFETIME).count());
+  BOOST_CHECK(hello.m_helloDataCache.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
@@ -196,6 +196,30 @@ BOOST_AUTO_TEST_CASE(BasicMultipleAngles)
   runTest(30.655296361);
 }
 
+BOOST_AUTO_TEST_CASE(MismatchedAngles)
+{
+  std::vector<double> anglesA = {2.97},
+                      anglesB = {3.0, 0.09},
+                      anglesC = {2.99};
+  setUpTopology(anglesA, anglesB, anglesC);
+
+  HyperbolicRoutingCalculator calculator(map.getMapSize(), false, ROUTER_A_NAME);
+  calculator.calculatePath(map, routingTable, lsdb, adjacencies);
+
+  // There is no distance between B and C, so each is only reached directly
+  RoutingTableEntry* entryB = routingTable.findRoutingTableEntry(ROUTER_B_NAME);
+  BOOST_REQUIRE(entryB != nullptr);
+  BOOST_REQUIRE_EQUAL(entryB->getNexthopList().size(), 1);
+  BOOST_CHECK_EQUAL(entryB->getNexthopList().getNextHops().begin()->getConnectingFaceUri(),
+                    ROUTER_B_FACE);
+
+  RoutingTableEntry* entryC = routingTable.findRoutingTableEntry(ROUTER_C_NAME);
+  BOOST_REQUIRE(entryC != nullptr);
+  BOOST_REQUIRE_EQUAL(entryC->getNexthopList().size(), 1);
+  BOOST_CHECK_EQUAL(entryC->getNexthopList().getNextHops().begin()->getConnectingFaceUri(),
+                    ROUTER_C_FACE);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
@@ -32,6 +32,12 @@
 
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+
 namespace nlsr {
 namespace test {
 
@@ -130,6 +136,275 @@ const double LinkStateCalculatorFixture::LINK_AB_COST = 5;
 const double LinkStateCalculatorFixture::LINK_AC_COST = 10;
 const double LinkStateCalculatorFixture::LINK_BC_COST = 17;
 
+/*! \brief Reference shortest-path calculation over a dense adjacency matrix.
+
+  This is the original O(N^2)-per-pass calculation, kept here to check that the
+  calculator produces identical routes on random topologies.
+*/
+class ReferenceCalculator
+{
+public:
+  ReferenceCalculator(const AdjLsaContainer& adjLsas, Map& map)
+    : m_nRouters(map.getMapSize())
+    , m_matrix(m_nRouters, std::vector<double>(m_nRouters, Adjacent::NON_ADJACENT_COST))
+  {
+    for (const auto& adjLsa : adjLsas) {
+      int32_t row = *map.getMappingNoByRouterName(adjLsa.getOrigRouter());
+      for (const auto& adjacent : adjLsa.getAdl().getAdjList()) {
+        int32_t col = *map.getMappingNoByRouterName(adjacent.getName());
+        m_matrix[row][col] = adjacent.getLinkCost();
+      }
+    }
+
+    for (size_t row = 0; row < m_nRouters; ++row) {
+      for (size_t col = 0; col < m_nRouters; ++col) {
+        double toCost = m_matrix[row][col];
+        double fromCost = m_matrix[col][row];
+        if (fromCost != toCost) {
+          double correctedCost = Adjacent::NON_ADJACENT_COST;
+          if (toCost >= 0 && fromCost >= 0) {
+            correctedCost = std::max(toCost, fromCost);
+          }
+          m_matrix[row][col] = correctedCost;
+          m_matrix[col][row] = correctedCost;
+        }
+      }
+    }
+  }
+
+  std::vector<int32_t>
+  getNeighbors(int32_t source) const
+  {
+    std::vector<int32_t> neighbors;
+    for (size_t i = 0; i < m_nRouters; ++i) {
+      if (m_matrix[source][i] >= 0 && static_cast<int32_t>(i) != source) {
+        neighbors.push_back(i);
+      }
+    }
+    return neighbors;
+  }
+
+  /*! \brief Returns distances from source, optionally only leaving source through neighbor.
+   */
+  std::vector<double>
+  getDistances(int32_t source, int32_t neighbor = -1) const
+  {
+    std::vector<int32_t> parent;
+    return getDistances(source, neighbor, parent);
+  }
+
+  /*! \brief Returns the next hop to each router, or -1 where there is none.
+
+    Routers at the same distance are explored in the order of their mapping numbers, and
+    a router keeps the parent that first reached it at its distance. The original queue
+    sort left the order of equally distant routers to its swaps, so the calculator and this
+    reference both break ties by mapping number instead.
+   */
+  std::vector<int32_t>
+  getNextHops(int32_t source, int32_t neighbor = -1) const
+  {
+    std::vector<int32_t> parent;
+    getDistances(source, neighbor, parent);
+
+    std::vector<int32_t> nextHop(m_nRouters, -1);
+    for (size_t i = 0; i < m_nRouters; ++i) {
+      int32_t router = i;
+      while (router >= 0 && parent[router] != source) {
+        router = parent[router];
+      }
+      if (router >= 0 && static_cast<int32_t>(i) != source) {
+        nextHop[i] = router;
+      }
+    }
+    return nextHop;
+  }
+
+private:
+  std::vector<double>
+  getDistances(int32_t source, int32_t neighbor, std::vector<int32_t>& parent) const
+  {
+    std::vector<double> distance(m_nRouters, INF);
+    std::vector<bool> isExplored(m_nRouters, false);
+    parent.assign(m_nRouters, -1);
+    distance[source] = 0;
+
+    for (size_t round = 0; round < m_nRouters; ++round) {
+      int32_t u = -1;
+      for (size_t i = 0; i < m_nRouters; ++i) {
+        if (!isExplored[i] && (u < 0 || distance[i] < distance[u])) {
+          u = i;
+        }
+      }
+      if (distance[u] == INF) {
+        break;
+      }
+      isExplored[u] = true;
+
+      for (size_t v = 0; v < m_nRouters; ++v) {
+        double cost = m_matrix[u][v];
+        if (u == source && neighbor >= 0 && static_cast<int32_t>(v) != neighbor) {
+          continue;
+        }
+        if (cost >= 0 && !isExplored[v] && distance[u] + cost < distance[v]) {
+          distance[v] = distance[u] + cost;
+          parent[v] = u;
+        }
+      }
+    }
+    return distance;
+  }
+
+public:
+  static const double INF;
+
+private:
+  size_t m_nRouters;
+  std::vector<std::vector<double>> m_matrix;
+};
+
+const double ReferenceCalculator::INF = 2147483647;
+
+/*! \brief Sparse random topology, with some asymmetric, broken and one-sided links.
+
+  The first router is named sourceName, so that it can be the router calculating paths.
+*/
+class RandomTopology
+{
+public:
+  RandomTopology(std::mt19937& rng, size_t nRouters, const ndn::Name& sourceName,
+                 int maxCost = 100)
+    : m_rng(rng)
+    , m_costDist(1, maxCost)
+    , adjacencies(nRouters)
+  {
+    names.push_back(sourceName);
+    faces.push_back(ndn::FaceUri("udp4://10.1.0.0").toString());
+    for (size_t i = 1; i < nRouters; ++i) {
+      names.push_back(ndn::Name("/ndn/site/%C1.Router").append("router" + std::to_string(i)));
+      faces.push_back(ndn::FaceUri("udp4://10.1.0." + std::to_string(i)).toString());
+    }
+
+    for (size_t i = 1; i < nRouters; ++i) {
+      addLink(std::uniform_int_distribution<size_t>(0, i - 1)(m_rng), i);
+    }
+    for (size_t i = 0; i < nRouters; ++i) {
+      for (size_t j = i + 1; j < nRouters; ++j) {
+        if (m_uniform(m_rng) < 0.05) {
+          addLink(i, j);
+        }
+      }
+    }
+  }
+
+  /*! \brief Adds a link between i and j, or changes its costs if there is one already.
+   */
+  void
+  addLink(size_t i, size_t j)
+  {
+    double cost = m_costDist(m_rng);
+    double reverseCost = cost;
+    double kind = m_uniform(m_rng);
+    if (kind < 0.1) {
+      reverseCost = m_costDist(m_rng);
+    }
+    else if (kind < 0.15) {
+      reverseCost = Adjacent::NON_ADJACENT_COST;
+    }
+
+    setLinkCost(i, j, cost);
+    if (kind >= 0.15 && kind < 0.18) {
+      return;
+    }
+    setLinkCost(j, i, reverseCost);
+  }
+
+  AdjLsaContainer
+  getAdjLsas()
+  {
+    AdjLsaContainer adjLsas;
+    for (size_t i = 0; i < names.size(); ++i) {
+      adjLsas.emplace(names[i], 1, MAX_TIME, adjacencies[i].size(), adjacencies[i]);
+    }
+    return adjLsas;
+  }
+
+private:
+  void
+  setLinkCost(size_t from, size_t to, double cost)
+  {
+    auto it = adjacencies[from].findAdjacent(names[to]);
+    if (it != adjacencies[from].end()) {
+      it->setLinkCost(cost);
+      return;
+    }
+    Adjacent adjacent(names[to], ndn::FaceUri(faces[to]), cost, Adjacent::STATUS_ACTIVE, 0, 0);
+    adjacencies[from].insert(adjacent);
+  }
+
+private:
+  std::mt19937& m_rng;
+  std::uniform_int_distribution<int> m_costDist;
+  std::uniform_real_distribution<double> m_uniform{0, 1};
+
+public:
+  std::vector<ndn::Name> names;
+  std::vector<std::string> faces;
+  std::vector<AdjacencyList> adjacencies;
+};
+
+/*! \brief Runs the tasks on threads of its own, several at a time.
+
+  Each slot takes its share of the tasks from the last, so that the trees are not calculated
+  in the order of the sequential runner.
+*/
+class ThreadTaskRunner : public TaskRunner
+{
+public:
+  size_t
+  getConcurrency() const override
+  {
+    return N_THREADS;
+  }
+
+  void
+  run(size_t nTasks, const std::function<void(size_t n, size_t slot)>& task) override
+  {
+    ++nRuns;
+    std::vector<std::thread> threads;
+    for (size_t slot = 0; slot < N_THREADS; ++slot) {
+      threads.emplace_back([nTasks, slot, &task] {
+        for (size_t n = nTasks; n-- > 0;) {
+          if (n % N_THREADS == slot) {
+            task(n, slot);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+public:
+  static const size_t N_THREADS = 3;
+  size_t nRuns = 0;
+};
+
+/*! \brief Returns the next hops of each destination, optionally without their faces.
+ */
+static std::map<ndn::Name, std::set<std::pair<std::string, double>>>
+getRoutes(const std::list<RoutingTableEntry>& entries, bool isCostOnly)
+{
+  std::map<ndn::Name, std::set<std::pair<std::string, double>>> routes;
+  for (const auto& entry : entries) {
+    for (const NextHop& hop : entry.getNexthopList().getNextHops()) {
+      routes[entry.getDestination()].emplace(isCostOnly ? "" : hop.getConnectingFaceUri(),
+                                             hop.getRouteCost());
+    }
+  }
+  return routes;
+}
+
 BOOST_FIXTURE_TEST_SUITE(TestLinkStateRoutingCalculator, LinkStateCalculatorFixture)
 
 BOOST_AUTO_TEST_CASE(Basic)
@@ -173,14 +448,13 @@ BOOST_AUTO_TEST_CASE(Asymmetric)
 {
   // Asymmetric link cost between B and C
   ndn::Name key = ndn::Name(ROUTER_B_NAME).append(std::to_string(Lsa::Type::ADJACENCY));
-  AdjLsa* lsa = nlsr.m_lsdb.findAdjLsa(key);
-  BOOST_REQUIRE(lsa != nullptr);
-
-  auto c = lsa->getAdl().findAdjacent(ROUTER_C_NAME);
-  BOOST_REQUIRE(c != conf.getAdjacencyList().end());
-
   double higherLinkCost = LINK_BC_COST + 1;
-  c->setLinkCost(higherLinkCost);
+  bool isModified = nlsr.m_lsdb.modifyAdjLsa(key, [&] (AdjLsa& lsa) {
+    auto c = lsa.getAdl().findAdjacent(ROUTER_C_NAME);
+    BOOST_REQUIRE(c != lsa.getAdl().end());
+    c->setLinkCost(higherLinkCost);
+  });
+  BOOST_REQUIRE(isModified);
 
   // Calculation should consider the link between B and C as having cost = higherLinkCost
   LinkStateRoutingTableCalculator calculator(map.getMapSize());
@@ -222,14 +496,14 @@ BOOST_AUTO_TEST_CASE(NonAdjacentCost)
 {
   // Asymmetric link cost between B and C
   ndn::Name key = ndn::Name(ROUTER_B_NAME).append(std::to_string(Lsa::Type::ADJACENCY));
-  auto lsa = nlsr.m_lsdb.findAdjLsa(key);
-  BOOST_REQUIRE(lsa != nullptr);
-
-  auto c = lsa->getAdl().findAdjacent(ROUTER_C_NAME);
-  BOOST_REQUIRE(c != conf.getAdjacencyList().end());
+  bool isModified = nlsr.m_lsdb.modifyAdjLsa(key, [] (AdjLsa& lsa) {
+    auto c = lsa.getAdl().findAdjacent(ROUTER_C_NAME);
+    BOOST_REQUIRE(c != lsa.getAdl().end());
 
-  // Break the link between B - C by setting it to a NON_ADJACENT_COST.
-  c->setLinkCost(Adjacent::NON_ADJACENT_COST);
+    // Break the link between B - C by setting it to a NON_ADJACENT_COST.
+    c->setLinkCost(Adjacent::NON_ADJACENT_COST);
+  });
+  BOOST_REQUIRE(isModified);
 
   // Calculation should consider the link between B and C as down
   LinkStateRoutingTableCalculator calculator(map.getMapSize());
@@ -264,28 +538,27 @@ BOOST_AUTO_TEST_CASE(AsymmetricZeroCostLink)
 {
   // Asymmetric and zero link cost between B - C, and B - A.
   ndn::Name keyB = ndn::Name(ROUTER_B_NAME).append(std::to_string(Lsa::Type::ADJACENCY));
-  auto lsaB = nlsr.m_lsdb.findAdjLsa(keyB);
-  BOOST_REQUIRE(lsaB != nullptr);
-
-  auto c = lsaB->getAdl().findAdjacent(ROUTER_C_NAME);
-  BOOST_REQUIRE(c != conf.getAdjacencyList().end());
-  // Re-adjust link cost to 0 from B-C. However, this should not set B-C cost 0 because C-B
-  // cost is greater that 0 i.e. 17
-  c->setLinkCost(0);
-
-  auto a = lsaB->getAdl().findAdjacent(ROUTER_A_NAME);
-  BOOST_REQUIRE(a != conf.getAdjacencyList().end());
-
-  ndn::Name keyA = ndn::Name(ROUTER_A_NAME).append(std::to_string(Lsa::Type::ADJACENCY));
-  auto lsaA = nlsr.m_lsdb.findAdjLsa(keyA);
-  BOOST_REQUIRE(lsaA != nullptr);
-
-  auto b = lsaA->getAdl().findAdjacent(ROUTER_B_NAME);
-  BOOST_REQUIRE(b != conf.getAdjacencyList().end());
+  bool isModified = nlsr.m_lsdb.modifyAdjLsa(keyB, [] (AdjLsa& lsaB) {
+    auto c = lsaB.getAdl().findAdjacent(ROUTER_C_NAME);
+    BOOST_REQUIRE(c != lsaB.getAdl().end());
+    // Re-adjust link cost to 0 from B-C. However, this should not set B-C cost 0 because C-B
+    // cost is greater that 0 i.e. 17
+    c->setLinkCost(0);
+
+    auto a = lsaB.getAdl().findAdjacent(ROUTER_A_NAME);
+    BOOST_REQUIRE(a != lsaB.getAdl().end());
+    a->setLinkCost(0);
+  });
+  BOOST_REQUIRE(isModified);
 
   // Re-adjust link cost to 0 from both the direction i.e B-A and A-B
-  a->setLinkCost(0);
-  b->setLinkCost(0);
+  ndn::Name keyA = ndn::Name(ROUTER_A_NAME).append(std::to_string(Lsa::Type::ADJACENCY));
+  isModified = nlsr.m_lsdb.modifyAdjLsa(keyA, [] (AdjLsa& lsaA) {
+    auto b = lsaA.getAdl().findAdjacent(ROUTER_B_NAME);
+    BOOST_REQUIRE(b != lsaA.getAdl().end());
+    b->setLinkCost(0);
+  });
+  BOOST_REQUIRE(isModified);
 
   // Calculation should consider 0 link-cost between B and C
   LinkStateRoutingTableCalculator calculator(map.getMapSize());
@@ -318,6 +591,359 @@ BOOST_AUTO_TEST_CASE(AsymmetricZeroCostLink)
 
 }
 
+BOOST_AUTO_TEST_CASE(RandomTopologyEquivalence)
+{
+  const size_t N_ROUTERS = 40;
+  std::mt19937 rng(7358);
+
+  for (int iteration = 0; iteration < 10; ++iteration) {
+    RandomTopology topology(rng, N_ROUTERS, ROUTER_A_NAME);
+    AdjLsaContainer adjLsas = topology.getAdjLsas();
+
+    conf.getAdjacencyList().reset();
+    conf.getAdjacencyList().addAdjacents(topology.adjacencies[0]);
+
+    Map randomMap;
+    randomMap.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+    int32_t source = *randomMap.getMappingNoByRouterName(ROUTER_A_NAME);
+    ReferenceCalculator reference(adjLsas, randomMap);
+
+    auto getFace = [&] (int32_t router) {
+      return conf.getAdjacencyList().getAdjacent(*randomMap.getRouterNameByMappingNo(router))
+               .getFaceUri().toString();
+    };
+
+    // Single path: one next hop per reachable destination, at the shortest distance and
+    // through the same neighbor as the reference
+    conf.setMaxFacesPerPrefix(1);
+    routingTable.m_rTable.clear();
+    LinkStateRoutingTableCalculator singlePath(randomMap.getMapSize());
+    singlePath.calculatePath(randomMap, routingTable, conf, adjLsas);
+
+    std::vector<double> distance = reference.getDistances(source);
+    std::vector<int32_t> nextHop = reference.getNextHops(source);
+    for (size_t i = 0; i < randomMap.getMapSize(); ++i) {
+      if (static_cast<int32_t>(i) == source) {
+        continue;
+      }
+      RoutingTableEntry* entry =
+        routingTable.findRoutingTableEntry(*randomMap.getRouterNameByMappingNo(i));
+      if (distance[i] == ReferenceCalculator::INF) {
+        BOOST_CHECK(entry == nullptr);
+        continue;
+      }
+      BOOST_REQUIRE(entry != nullptr);
+      BOOST_REQUIRE_EQUAL(entry->getNexthopList().size(), 1);
+      BOOST_CHECK_EQUAL(entry->getNexthopList().begin()->getRouteCost(), distance[i]);
+      BOOST_CHECK_EQUAL(entry->getNexthopList().begin()->getConnectingFaceUri(),
+                        getFace(nextHop[i]));
+    }
+
+    // Multipath: one next hop per neighbor from which the destination is reachable
+    conf.setMaxFacesPerPrefix(N_ROUTERS);
+    routingTable.m_rTable.clear();
+    LinkStateRoutingTableCalculator multiPath(randomMap.getMapSize());
+    multiPath.calculatePath(randomMap, routingTable, conf, adjLsas);
+
+    std::map<int32_t, std::set<std::pair<std::string, double>>> expected;
+    for (int32_t neighbor : reference.getNeighbors(source)) {
+      std::string face = getFace(neighbor);
+      std::vector<double> viaNeighbor = reference.getDistances(source, neighbor);
+      for (size_t i = 0; i < randomMap.getMapSize(); ++i) {
+        if (static_cast<int32_t>(i) != source && viaNeighbor[i] != ReferenceCalculator::INF) {
+          expected[i].emplace(face, viaNeighbor[i]);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < randomMap.getMapSize(); ++i) {
+      if (static_cast<int32_t>(i) == source) {
+        continue;
+      }
+      RoutingTableEntry* entry =
+        routingTable.findRoutingTableEntry(*randomMap.getRouterNameByMappingNo(i));
+      if (expected.count(i) == 0) {
+        BOOST_CHECK(entry == nullptr);
+        continue;
+      }
+      BOOST_REQUIRE(entry != nullptr);
+      std::set<std::pair<std::string, double>> actual;
+      for (const NextHop& hop : entry->getNexthopList()) {
+        actual.emplace(hop.getConnectingFaceUri(), hop.getRouteCost());
+      }
+      BOOST_CHECK(actual == expected[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MultipathEquivalence)
+{
+  std::mt19937 rng(5113);
+
+  // Few distinct costs make for many equal-cost paths
+  for (int maxCost : {3, 100}) {
+    for (size_t nRouters : {2, 10, 60}) {
+      RandomTopology topology(rng, nRouters, ROUTER_A_NAME, maxCost);
+      AdjLsaContainer adjLsas = topology.getAdjLsas();
+
+      conf.getAdjacencyList().reset();
+      conf.getAdjacencyList().addAdjacents(topology.adjacencies[0]);
+      conf.setMaxFacesPerPrefix(0);
+
+      Map randomMap;
+      randomMap.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+      int32_t source = *randomMap.getMappingNoByRouterName(ROUTER_A_NAME);
+      ReferenceCalculator reference(adjLsas, randomMap);
+
+      routingTable.m_rTable.clear();
+      LinkStateRoutingTableCalculator calculator(randomMap.getMapSize());
+      calculator.calculatePath(randomMap, routingTable, conf, adjLsas);
+
+      // One tree per neighbor, in the order of the neighbors, as the per-neighbor runs of
+      // the original calculation found them
+      std::vector<int32_t> neighbors = reference.getNeighbors(source);
+      BOOST_REQUIRE_EQUAL(calculator.m_distances.size(), neighbors.size() * nRouters);
+      std::list<RoutingTableEntry> expectedTable;
+      for (size_t n = 0; n < neighbors.size(); ++n) {
+        std::vector<double> expected = reference.getDistances(source, neighbors[n]);
+        std::vector<double> actual(calculator.m_distances.begin() + n * nRouters,
+                                   calculator.m_distances.begin() + (n + 1) * nRouters);
+        BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(),
+                                      expected.begin(), expected.end());
+
+        std::string face =
+          topology.adjacencies[0].getAdjacent(*randomMap.getRouterNameByMappingNo(neighbors[n]))
+            .getFaceUri().toString();
+        for (size_t i = 0; i < nRouters; ++i) {
+          if (static_cast<int32_t>(i) != source && expected[i] != ReferenceCalculator::INF) {
+            expectedTable.emplace_back(*randomMap.getRouterNameByMappingNo(i));
+            NextHop nh(face, expected[i]);
+            expectedTable.back().getNexthopList().addNextHop(nh);
+          }
+        }
+      }
+      BOOST_CHECK(getRoutes(routingTable.m_rTable, false) == getRoutes(expectedTable, false));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RecalculateInSameSpace)
+{
+  const size_t N_ROUTERS = 40;
+  std::mt19937 rng(1613);
+  RandomTopology topology(rng, N_ROUTERS, ROUTER_A_NAME);
+  AdjLsaContainer adjLsas = topology.getAdjLsas();
+
+  conf.getAdjacencyList().reset();
+  conf.getAdjacencyList().addAdjacents(topology.adjacencies[0]);
+  conf.setMaxFacesPerPrefix(0);
+
+  Map randomMap;
+  randomMap.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+
+  routingTable.m_rTable.clear();
+  LinkStateRoutingTableCalculator calculator(randomMap.getMapSize());
+  calculator.calculatePath(randomMap, routingTable, conf, adjLsas);
+  auto routes = getRoutes(routingTable.m_rTable, false);
+
+  const int* parents = calculator.m_parents.data();
+  const double* distances = calculator.m_distances.data();
+  const auto* queue = calculator.m_workspaces[0].queue.data();
+
+  // The same network is calculated again in the space of the first calculation
+  routingTable.m_rTable.clear();
+  calculator.calculatePath(randomMap, routingTable, conf, adjLsas);
+  BOOST_CHECK(getRoutes(routingTable.m_rTable, false) == routes);
+
+  BOOST_CHECK(calculator.m_parents.data() == parents);
+  BOOST_CHECK(calculator.m_distances.data() == distances);
+  BOOST_CHECK(calculator.m_workspaces[0].queue.data() == queue);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdate)
+{
+  conf.setMaxFacesPerPrefix(0);
+  LinkStateRoutingTableCalculator calculator(map.getMapSize());
+  calculator.calculatePath(map, routingTable, conf, lsdb.getAdjLsdb());
+
+  AdjLsaContainer adjLsas = lsdb.getAdjLsdb();
+  auto setLinkCost = [&adjLsas] (const ndn::Name& from, const ndn::Name& to, double cost) {
+    auto& index = adjLsas.get<detail::byOriginRouter>();
+    index.modify(index.find(from), [&] (AdjLsa& adjLsa) {
+        adjLsa.getAdl().findAdjacent(to)->setLinkCost(cost);
+      });
+  };
+
+  // Only the route to C through B gets cheaper
+  setLinkCost(ROUTER_B_NAME, ROUTER_C_NAME, 7);
+  setLinkCost(ROUTER_C_NAME, ROUTER_B_NAME, 7);
+
+  std::list<RoutingTableEntry> changedEntries;
+  BOOST_REQUIRE(calculator.updatePath(map, conf, adjLsas, changedEntries));
+  BOOST_REQUIRE_EQUAL(changedEntries.size(), 2);
+
+  for (const auto& entry : changedEntries) {
+    BOOST_REQUIRE_EQUAL(entry.getNexthopList().size(), 2);
+    auto nextHops = entry.getNexthopList().getNextHops();
+    if (entry.getDestination() == ROUTER_B_NAME) {
+      // B through C
+      BOOST_CHECK(std::any_of(nextHops.begin(), nextHops.end(), [] (const NextHop& hop) {
+            return hop.getConnectingFaceUri() == ROUTER_C_FACE &&
+                   hop.getRouteCostAsAdjustedInteger() == LINK_AC_COST + 7;
+          }));
+    }
+    else {
+      BOOST_CHECK_EQUAL(entry.getDestination(), ROUTER_C_NAME);
+      BOOST_CHECK(std::any_of(nextHops.begin(), nextHops.end(), [] (const NextHop& hop) {
+            return hop.getConnectingFaceUri() == ROUTER_B_FACE &&
+                   hop.getRouteCostAsAdjustedInteger() == LINK_AB_COST + 7;
+          }));
+    }
+  }
+
+  // Nothing changed since the last update
+  changedEntries.clear();
+  BOOST_REQUIRE(calculator.updatePath(map, conf, adjLsas, changedEntries));
+  BOOST_CHECK(changedEntries.empty());
+
+  // The paths cannot be repaired while a link costs zero
+  setLinkCost(ROUTER_B_NAME, ROUTER_C_NAME, 0);
+  setLinkCost(ROUTER_C_NAME, ROUTER_B_NAME, 0);
+  BOOST_CHECK(!calculator.updatePath(map, conf, adjLsas, changedEntries));
+  setLinkCost(ROUTER_B_NAME, ROUTER_C_NAME, 7);
+  setLinkCost(ROUTER_C_NAME, ROUTER_B_NAME, 7);
+  BOOST_CHECK(calculator.updatePath(map, conf, adjLsas, changedEntries));
+
+  // The paths cannot be repaired once a link of this router changes
+  setLinkCost(ROUTER_A_NAME, ROUTER_B_NAME, 6);
+  setLinkCost(ROUTER_B_NAME, ROUTER_A_NAME, 6);
+  BOOST_CHECK(!calculator.updatePath(map, conf, adjLsas, changedEntries));
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateEquivalence)
+{
+  const size_t N_ROUTERS = 40;
+  std::mt19937 rng(2046);
+
+  // Few distinct costs make for many equal-cost paths, whose next hops must be the same
+  for (uint32_t maxFaces : {1, 0}) {
+    for (int maxCost : {100, 3}) {
+      conf.setMaxFacesPerPrefix(maxFaces);
+
+      for (int iteration = 0; iteration < 5; ++iteration) {
+        RandomTopology topology(rng, N_ROUTERS, ROUTER_A_NAME, maxCost);
+        AdjLsaContainer adjLsas = topology.getAdjLsas();
+
+        conf.getAdjacencyList().reset();
+        conf.getAdjacencyList().addAdjacents(topology.adjacencies[0]);
+
+        Map randomMap;
+        randomMap.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+
+        routingTable.m_rTable.clear();
+        LinkStateRoutingTableCalculator incremental(randomMap.getMapSize());
+        incremental.calculatePath(randomMap, routingTable, conf, adjLsas);
+        auto routes = getRoutes(routingTable.m_rTable, false);
+
+        // Change, add and break links between other routers, one at a time
+        for (int change = 0; change < 20; ++change) {
+          std::uniform_int_distribution<size_t> routerDist(1, N_ROUTERS - 1);
+          size_t i = routerDist(rng);
+          size_t j = routerDist(rng);
+          if (i == j) {
+            continue;
+          }
+          topology.addLink(i, j);
+          adjLsas = topology.getAdjLsas();
+
+          Map map;
+          map.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+          std::list<RoutingTableEntry> changedEntries;
+          BOOST_REQUIRE(incremental.updatePath(map, conf, adjLsas, changedEntries));
+
+          for (const auto& entry : changedEntries) {
+            std::set<std::pair<std::string, double>> nextHops;
+            for (const NextHop& hop : entry.getNexthopList().getNextHops()) {
+              nextHops.emplace(hop.getConnectingFaceUri(), hop.getRouteCost());
+            }
+            BOOST_CHECK(nextHops != routes[entry.getDestination()]);
+            routes[entry.getDestination()] = nextHops;
+          }
+
+          routingTable.m_rTable.clear();
+          LinkStateRoutingTableCalculator full(map.getMapSize());
+          full.calculatePath(map, routingTable, conf, adjLsas);
+
+          std::list<RoutingTableEntry> updatedTable;
+          for (const auto& route : routes) {
+            updatedTable.emplace_back(route.first);
+            for (const auto& hop : route.second) {
+              NextHop nh(hop.first, hop.second);
+              updatedTable.back().getNexthopList().addNextHop(nh);
+            }
+          }
+          BOOST_CHECK(getRoutes(updatedTable, false) == getRoutes(routingTable.m_rTable, false));
+        }
+
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelTrees)
+{
+  const size_t N_ROUTERS = 60;
+  std::mt19937 rng(3181);
+  RandomTopology topology(rng, N_ROUTERS, ROUTER_A_NAME, 3);
+  AdjLsaContainer adjLsas = topology.getAdjLsas();
+
+  conf.getAdjacencyList().reset();
+  conf.getAdjacencyList().addAdjacents(topology.adjacencies[0]);
+  conf.setMaxFacesPerPrefix(0);
+
+  Map randomMap;
+  randomMap.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+
+  routingTable.m_rTable.clear();
+  LinkStateRoutingTableCalculator sequential(randomMap.getMapSize());
+  sequential.calculatePath(randomMap, routingTable, conf, adjLsas);
+  auto routes = getRoutes(routingTable.m_rTable, false);
+
+  ThreadTaskRunner runner;
+  routingTable.m_rTable.clear();
+  LinkStateRoutingTableCalculator parallel(randomMap.getMapSize());
+  parallel.setTaskRunner(runner);
+  parallel.calculatePath(randomMap, routingTable, conf, adjLsas);
+  BOOST_CHECK_EQUAL(runner.nRuns, 1);
+  BOOST_CHECK_EQUAL(parallel.m_workspaces.size(), runner.getConcurrency());
+  BOOST_CHECK(getRoutes(routingTable.m_rTable, false) == routes);
+  BOOST_CHECK(parallel.m_parents == sequential.m_parents);
+  BOOST_CHECK(parallel.m_distances == sequential.m_distances);
+
+  // The trees are repaired on the threads too, and the changes of all the slots are found
+  for (int change = 0; change < 20; ++change) {
+    std::uniform_int_distribution<size_t> routerDist(1, N_ROUTERS - 1);
+    size_t i = routerDist(rng);
+    size_t j = routerDist(rng);
+    if (i == j) {
+      continue;
+    }
+    topology.addLink(i, j);
+    adjLsas = topology.getAdjLsas();
+
+    Map map;
+    map.createFromAdjLsdb(adjLsas.begin(), adjLsas.end());
+    std::list<RoutingTableEntry> sequentialChanges;
+    std::list<RoutingTableEntry> parallelChanges;
+    BOOST_REQUIRE(sequential.updatePath(map, conf, adjLsas, sequentialChanges));
+    BOOST_REQUIRE(parallel.updatePath(map, conf, adjLsas, parallelChanges));
+    BOOST_CHECK_EQUAL(parallelChanges.size(), sequentialChanges.size());
+    BOOST_CHECK(getRoutes(parallelChanges, false) == getRoutes(sequentialChanges, false));
+    BOOST_CHECK(parallel.m_parents == sequential.m_parents);
+    BOOST_CHECK(parallel.m_distances == sequential.m_distances);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
@@ -139,6 +139,29 @@ BOOST_AUTO_TEST_CASE(ValidateCorrectLSA)
                                     });
 }
 
+BOOST_AUTO_TEST_CASE(ValidateNameLsaDelta)
+{
+  ndn::Name lsaDataName = confParam.getLsaPrefix();
+  lsaDataName.append(confParam.getSiteName());
+  lsaDataName.append(confParam.getRouterName());
+  lsaDataName.append(std::to_string(Lsa::Type::NAME));
+
+  // Append delta, base sequence number, sequence number, version, segmentNo
+  uint64_t seqNo = nlsr.m_lsdb.m_sequencingManager.getNameLsaSeq();
+  lsaDataName.append(Lsdb::DELTA_COMPONENT).appendNumber(seqNo).appendNumber(seqNo + 1);
+  lsaDataName.appendNumber(1).appendNumber(1);
+
+  ndn::Data data(lsaDataName);
+  data.setFreshnessPeriod(ndn::time::seconds(10));
+  m_keyChain.sign(data, nlsr.m_signingInfo);
+
+  confParam.getValidator().validate(data,
+                                    [] (const Data&) { BOOST_CHECK(true); },
+                                    [] (const Data&, const ndn::security::v2::ValidationError&) {
+                                      BOOST_CHECK(false);
+                                    });
+}
+
 BOOST_AUTO_TEST_CASE(DoNotValidateIncorrectLSA)
 {
   // getSubName removes the /localhop compnonent from /localhop/ndn/NLSR/LSA
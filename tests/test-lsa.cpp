@@ -200,6 +200,55 @@ BOOST_AUTO_TEST_CASE(TestInitializeFromContent)
   BOOST_CHECK_EQUAL(clsa1.serialize(), clsa2.serialize());
 }
 
+BOOST_AUTO_TEST_CASE(TestWireEncoding)
+{
+  // Expiration time points are encoded with a millisecond precision
+  ndn::time::system_clock::TimePoint testTimePoint =
+    ndn::time::fromUnixTimestamp(ndn::time::toUnixTimestamp(ndn::time::system_clock::now()));
+
+  //Adj LSA
+  Adjacent adj1("adjacent1", ndn::FaceUri("udp://10.0.0.1"), 10, Adjacent::STATUS_ACTIVE, 0, 0);
+  Adjacent adj2("adjacent2", ndn::FaceUri("udp://10.0.0.2"), 2.5, Adjacent::STATUS_ACTIVE, 0, 0);
+
+  AdjacencyList adjList;
+  adjList.insert(adj1);
+  adjList.insert(adj2);
+
+  AdjLsa adjlsa1("router1", 1, testTimePoint, adjList.size(), adjList);
+  AdjLsa adjlsa2;
+
+  adjlsa2.wireDecode(adjlsa1.wireEncode());
+
+  BOOST_CHECK(adjlsa1.isEqualContent(adjlsa2));
+  BOOST_CHECK_EQUAL(adjlsa2.getNoLink(), 2);
+  BOOST_CHECK_EQUAL(adjlsa1.serialize(), adjlsa2.serialize());
+
+  //Name LSA
+  NamePrefixList npl1{ndn::Name("name1"), ndn::Name("name2")};
+
+  NameLsa nlsa1("router1", 7, testTimePoint, npl1);
+  NameLsa nlsa2;
+
+  nlsa2.wireDecode(nlsa1.wireEncode());
+
+  BOOST_CHECK_EQUAL(nlsa2.getOrigRouter(), ndn::Name("router1"));
+  BOOST_CHECK_EQUAL(nlsa2.getLsSeqNo(), 7);
+  BOOST_CHECK(nlsa2.getExpirationTimePoint() == testTimePoint);
+  BOOST_CHECK_EQUAL(nlsa1.serialize(), nlsa2.serialize());
+
+  //Coordinate LSA
+  std::vector<double> angles = {30, 40.0};
+  CoordinateLsa clsa1("router1", 12, testTimePoint, 2.5, angles);
+  CoordinateLsa clsa2;
+
+  clsa2.wireDecode(clsa1.wireEncode());
+
+  BOOST_CHECK_EQUAL(clsa1.serialize(), clsa2.serialize());
+
+  // The block of another LSA type is rejected
+  BOOST_CHECK_THROW(nlsa2.wireDecode(clsa1.wireEncode()), ndn::tlv::Error);
+}
+
 BOOST_AUTO_TEST_SUITE(TestNameLsa)
 
 BOOST_AUTO_TEST_CASE(OperatorEquals)
@@ -221,6 +270,102 @@ BOOST_AUTO_TEST_CASE(OperatorEquals)
   BOOST_CHECK(lsa1.isEqualContent(lsa2));
 }
 
+BOOST_AUTO_TEST_CASE(Delta)
+{
+  ndn::time::system_clock::TimePoint testTimePoint =
+    ndn::time::fromUnixTimestamp(ndn::time::toUnixTimestamp(ndn::time::system_clock::now()));
+
+  NameLsaDelta delta("router1", 8, testTimePoint, 7);
+  delta.addName("/ndn/name1");
+  delta.addName("/ndn/name2");
+  delta.removeName("/ndn/name3");
+
+  // Changes that undo each other cancel out
+  delta.removeName("/ndn/name2");
+  delta.addName("/ndn/name3");
+  delta.addName("/ndn/name4");
+  BOOST_CHECK(delta.getAddedNames() == (std::set<ndn::Name>{"/ndn/name1", "/ndn/name4"}));
+  BOOST_CHECK(delta.getRemovedNames().empty());
+
+  NameLsaDelta next("router1", 9, testTimePoint + ndn::time::seconds(10), 8);
+  next.removeName("/ndn/name1");
+  next.removeName("/ndn/name5");
+  delta.append(next);
+
+  BOOST_CHECK_EQUAL(delta.getBaseSeqNo(), 7);
+  BOOST_CHECK_EQUAL(delta.getLsSeqNo(), 9);
+  BOOST_CHECK(delta.getExpirationTimePoint() == next.getExpirationTimePoint());
+  BOOST_CHECK(delta.getAddedNames() == (std::set<ndn::Name>{"/ndn/name4"}));
+  BOOST_CHECK(delta.getRemovedNames() == (std::set<ndn::Name>{"/ndn/name5"}));
+
+  NameLsaDelta decoded;
+  decoded.wireDecode(delta.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getOrigRouter(), ndn::Name("router1"));
+  BOOST_CHECK_EQUAL(decoded.getLsSeqNo(), 9);
+  BOOST_CHECK_EQUAL(decoded.getBaseSeqNo(), 7);
+  BOOST_CHECK(decoded.getExpirationTimePoint() == delta.getExpirationTimePoint());
+  BOOST_CHECK(decoded.getAddedNames() == delta.getAddedNames());
+  BOOST_CHECK(decoded.getRemovedNames() == delta.getRemovedNames());
+
+  // A delta is not a name LSA, and has no text encoding
+  NameLsa nameLsa;
+  BOOST_CHECK_THROW(nameLsa.wireDecode(delta.wireEncode()), ndn::tlv::Error);
+  BOOST_CHECK(!decoded.deserialize(delta.serialize()));
+}
+
+BOOST_AUTO_TEST_CASE(Shard)
+{
+  ndn::time::system_clock::TimePoint testTimePoint =
+    ndn::time::fromUnixTimestamp(ndn::time::toUnixTimestamp(ndn::time::system_clock::now()));
+
+  NamePrefixList npl{ndn::Name("/ndn/name1"), ndn::Name("/ndn/name2")};
+  NameLsa lsa("router1", 12, testTimePoint, npl);
+  BOOST_CHECK_EQUAL(lsa.getKey(), ndn::Name("router1/NAME"));
+
+  // Shard 0 is encoded like a name LSA that is not sharded
+  NameLsa decoded;
+  decoded.setShard(5);
+  decoded.wireDecode(lsa.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getShard(), 0);
+
+  lsa.setShard(3);
+  BOOST_CHECK_EQUAL(lsa.getKey(), ndn::Name("router1/NAME-3"));
+  decoded.wireDecode(lsa.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getShard(), 3);
+  BOOST_CHECK_EQUAL(decoded.getKey(), lsa.getKey());
+  BOOST_CHECK_EQUAL(decoded.getNpl(), npl);
+
+  NameLsaDelta delta("router1", 13, testTimePoint, 12);
+  delta.setShard(3);
+  delta.addName("/ndn/name3");
+  NameLsaDelta decodedDelta;
+  decodedDelta.wireDecode(delta.wireEncode());
+  BOOST_CHECK_EQUAL(decodedDelta.getShard(), 3);
+  BOOST_CHECK_EQUAL(decodedDelta.getKey(), lsa.getKey());
+
+  // The type component names the shard of a name LSA
+  BOOST_CHECK_EQUAL(makeLsaTypeComponent(Lsa::Type::NAME), "NAME");
+  BOOST_CHECK_EQUAL(makeLsaTypeComponent(Lsa::Type::NAME, 3), "NAME-3");
+  BOOST_CHECK_EQUAL(makeLsaTypeComponent(Lsa::Type::ADJACENCY, 3), "ADJACENCY");
+  BOOST_CHECK_EQUAL(getLsaShard(ndn::Name::Component("NAME-3")), 3);
+  BOOST_CHECK_EQUAL(getLsaShard(ndn::Name::Component("NAME")), 0);
+  BOOST_CHECK_EQUAL(getLsaShard(ndn::Name::Component("NAME-")), 0);
+  BOOST_CHECK_EQUAL(getLsaShard(ndn::Name::Component("NAME-3x")), 0);
+
+  Lsa::Type type;
+  std::istringstream("NAME-3") >> type;
+  BOOST_CHECK_EQUAL(type, Lsa::Type::NAME);
+  std::istringstream("NAME-x") >> type;
+  BOOST_CHECK_EQUAL(type, Lsa::Type::BASE);
+
+  // Every name has a shard, and always the same
+  for (uint32_t nShards : {1, 4, 64}) {
+    uint32_t shard = NameLsa::getShardOf("/ndn/name1", nShards);
+    BOOST_CHECK_LT(shard, nShards);
+    BOOST_CHECK_EQUAL(NameLsa::getShardOf("/ndn/name1", nShards), shard);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestNameLsa
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,275 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#include "lsdb-snapshot.hpp"
+
+#include "test-common.hpp"
+#include "lsdb.hpp"
+#include "nlsr.hpp"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace nlsr {
+namespace test {
+
+using namespace ndn::time_literals;
+
+class LsdbSnapshotFixture : public BaseFixture
+{
+public:
+  LsdbSnapshotFixture()
+    : snapshot("/tmp")
+    , expiration(ndn::time::system_clock::now() + 1_h)
+  {
+    NamePrefixList npl;
+    npl.insert("/ndn/prefix1");
+    npl.insert("/ndn/prefix2");
+    nameLsas.emplace(ndn::Name("/ndn/site/%C1.Router/router1"), 10, expiration, npl);
+    nameLsas.emplace(ndn::Name("/ndn/site/%C1.Router/this-router"), 20, expiration, npl);
+
+    AdjacencyList adjacencies;
+    Adjacent adjacent("/ndn/site/%C1.Router/router2");
+    adjacent.setStatus(Adjacent::STATUS_ACTIVE);
+    adjacencies.insert(adjacent);
+    adjLsas.emplace(ndn::Name("/ndn/site/%C1.Router/router1"), 11, expiration,
+                    adjacencies.size(), adjacencies);
+
+    corLsas.emplace(ndn::Name("/ndn/site/%C1.Router/router1"), 12, expiration,
+                    2.5, std::vector<double>{30.0, 45.0});
+  }
+
+  ~LsdbSnapshotFixture()
+  {
+    boost::filesystem::remove(snapshot.getFileName());
+  }
+
+public:
+  LsdbSnapshot snapshot;
+  ndn::time::system_clock::TimePoint expiration;
+  NameLsaContainer nameLsas;
+  AdjLsaContainer adjLsas;
+  CoordinateLsaContainer corLsas;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestLsdbSnapshot, LsdbSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(WriteRead)
+{
+  BOOST_CHECK_EQUAL(snapshot.getFileName(), "/tmp/nlsrLsdb.snapshot");
+
+  // The LSAs of this router are not written
+  BOOST_CHECK_EQUAL(snapshot.write(nameLsas, adjLsas, corLsas,
+                                   "/ndn/site/%C1.Router/this-router"), 3);
+
+  LsdbSnapshot::Contents contents = snapshot.read();
+
+  const NameLsa& nameLsa = *nameLsas.begin();
+  BOOST_REQUIRE_EQUAL(contents.nameLsas.size(), 1);
+  BOOST_CHECK_EQUAL(contents.nameLsas[0].getOrigRouter(), nameLsa.getOrigRouter());
+  BOOST_CHECK_EQUAL(contents.nameLsas[0].getLsSeqNo(), 10);
+  BOOST_CHECK(contents.nameLsas[0].isEqualContent(nameLsa));
+
+  BOOST_REQUIRE_EQUAL(contents.adjLsas.size(), 1);
+  BOOST_CHECK_EQUAL(contents.adjLsas[0].getLsSeqNo(), 11);
+  BOOST_CHECK(contents.adjLsas[0].isEqualContent(*adjLsas.begin()));
+
+  BOOST_REQUIRE_EQUAL(contents.coordinateLsas.size(), 1);
+  BOOST_CHECK_EQUAL(contents.coordinateLsas[0].getLsSeqNo(), 12);
+  BOOST_CHECK(contents.coordinateLsas[0].isEqualContent(*corLsas.begin()));
+
+  // The expiration time is kept to the millisecond
+  BOOST_CHECK(ndn::time::abs(contents.nameLsas[0].getExpirationTimePoint() - expiration) < 1_ms);
+}
+
+BOOST_AUTO_TEST_CASE(Missing)
+{
+  BOOST_CHECK_THROW(snapshot.read(), LsdbSnapshot::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Damaged)
+{
+  snapshot.write(nameLsas, adjLsas, corLsas, "/ndn/site/%C1.Router/this-router");
+
+  // Flip one octet of the last record
+  std::fstream file(snapshot.getFileName(), std::ios::in | std::ios::out | std::ios::binary);
+  file.seekg(-10, std::ios::end);
+  char octet = static_cast<char>(file.get());
+  file.seekp(-10, std::ios::end);
+  file.put(static_cast<char>(octet ^ 0x01));
+  file.close();
+
+  BOOST_CHECK_THROW(snapshot.read(), LsdbSnapshot::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+  snapshot.write(nameLsas, adjLsas, corLsas, "/ndn/site/%C1.Router/this-router");
+  boost::filesystem::resize_file(snapshot.getFileName(), 20);
+
+  BOOST_CHECK_THROW(snapshot.read(), LsdbSnapshot::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+class LsdbPreloadFixture : public UnitTestTimeFixture
+{
+public:
+  LsdbPreloadFixture()
+    : face(m_ioService, m_keyChain, {true, true})
+    , conf(face)
+    , confProcessor(conf)
+    , nlsr(face, m_keyChain, conf)
+    , lsdb(nlsr.m_lsdb)
+  {
+    addIdentity("/ndn/site/%C1.Router/this-router");
+
+    nlsr.initialize();
+
+    advanceClocks(10_ms);
+    conf.setLsdbSnapshotInterval(60);
+  }
+
+  ~LsdbPreloadFixture()
+  {
+    boost::filesystem::remove(lsdb.m_snapshot.getFileName());
+  }
+
+public:
+  ndn::util::DummyClientFace face;
+  ConfParameter conf;
+  DummyConfFileProcessor confProcessor;
+  Nlsr nlsr;
+  Lsdb& lsdb;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestLsdbPreload, LsdbPreloadFixture)
+
+BOOST_AUTO_TEST_CASE(Preload)
+{
+  auto now = ndn::time::system_clock::now();
+  NamePrefixList npl;
+  npl.insert("/ndn/prefix");
+
+  NameLsaContainer nameLsas;
+  nameLsas.emplace(ndn::Name("/ndn/site/%C1.Router/router1"), 5, now + 1_h, npl);
+  nameLsas.emplace(ndn::Name("/ndn/site/%C1.Router/router2"), 6, now - 1_s, npl);
+  lsdb.m_snapshot.write(nameLsas, AdjLsaContainer(), CoordinateLsaContainer(),
+                        conf.getRouterPrefix());
+
+  // The LSA that has expired since is left out
+  BOOST_CHECK_EQUAL(lsdb.loadSnapshot(), 1);
+  BOOST_CHECK(lsdb.findNameLsa("/ndn/site/%C1.Router/router2/NAME") == nullptr);
+
+  const NameLsa* lsa = lsdb.findNameLsa("/ndn/site/%C1.Router/router1/NAME");
+  BOOST_REQUIRE(lsa != nullptr);
+  BOOST_CHECK(lsa->isProvisional());
+
+  // Sync announcing the same sequence number confirms the LSA without fetching it again
+  BOOST_CHECK_EQUAL(lsdb.isLsaNew("/ndn/site/%C1.Router/router1", Lsa::Type::NAME, 5), false);
+  BOOST_CHECK(!lsa->isProvisional());
+
+  // The snapshot is written again periodically
+  boost::filesystem::remove(lsdb.m_snapshot.getFileName());
+  advanceClocks(1_s, 60);
+  BOOST_CHECK_EQUAL(lsdb.m_snapshot.read().nameLsas.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(RoutesFromOwnAdjLsa)
+{
+  auto now = ndn::time::system_clock::now();
+  ndn::Name router1("/ndn/site/%C1.Router/router1");
+  ndn::Name adjLsaKey = ndn::Name(conf.getRouterPrefix()).append("ADJACENCY");
+
+  // The neighbor is configured, but has not answered a hello since the restart
+  Adjacent neighbor(router1, ndn::FaceUri("udp4://10.0.0.1:6363"), 10,
+                    Adjacent::STATUS_INACTIVE, 0, 256);
+  conf.getAdjacencyList().insert(neighbor);
+
+  AdjacencyList ownAdjacencies;
+  neighbor.setStatus(Adjacent::STATUS_ACTIVE);
+  ownAdjacencies.insert(neighbor);
+  AdjacencyList router1Adjacencies;
+  router1Adjacencies.insert(Adjacent(conf.getRouterPrefix(), ndn::FaceUri("udp4://10.0.0.2:6363"),
+                                     10, Adjacent::STATUS_ACTIVE, 0, 257));
+
+  AdjLsaContainer adjLsas;
+  adjLsas.emplace(conf.getRouterPrefix(), 3, now + 1_h, 1, ownAdjacencies);
+  adjLsas.emplace(router1, 4, now + 1_h, 1, router1Adjacencies);
+
+  // This router's Adj LSA is written with the others
+  BOOST_CHECK_EQUAL(lsdb.m_snapshot.write(NameLsaContainer(), adjLsas, CoordinateLsaContainer(),
+                                          conf.getRouterPrefix()), 2);
+
+  // After a restart, the routes are calculated before any neighbor answers a hello
+  BOOST_CHECK_EQUAL(lsdb.loadSnapshot(), 2);
+  const AdjLsa* ownLsa = lsdb.findAdjLsa(adjLsaKey);
+  BOOST_REQUIRE(ownLsa != nullptr);
+  BOOST_CHECK(ownLsa->isProvisional());
+
+  advanceClocks(1_s, 20);
+  RoutingTableEntry* entry = nlsr.m_routingTable.findRoutingTableEntry(router1);
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK_EQUAL(entry->getNexthopList().size(), 1);
+
+  // The Adj LSA built from hellos takes its place
+  lsdb.buildAndInstallOwnAdjLsa();
+  ownLsa = lsdb.findAdjLsa(adjLsaKey);
+  BOOST_REQUIRE(ownLsa != nullptr);
+  BOOST_CHECK(!ownLsa->isProvisional());
+  BOOST_CHECK_GT(ownLsa->getLsSeqNo(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(OwnAdjLsaExpires)
+{
+  AdjacencyList adjacencies;
+  adjacencies.insert(Adjacent("/ndn/site/%C1.Router/router1", ndn::FaceUri("udp4://10.0.0.1:6363"),
+                              10, Adjacent::STATUS_ACTIVE, 0, 256));
+  AdjLsaContainer adjLsas;
+  adjLsas.emplace(conf.getRouterPrefix(), 3, ndn::time::system_clock::now() + 10_s, 1,
+                  adjacencies);
+  lsdb.m_snapshot.write(NameLsaContainer(), adjLsas, CoordinateLsaContainer(),
+                        conf.getRouterPrefix());
+  BOOST_CHECK_EQUAL(lsdb.loadSnapshot(), 1);
+
+  // Unless hellos bring a newer one, it is removed when it expires, not refreshed
+  uint64_t seqNo = lsdb.m_sequencingManager.getAdjLsaSeq();
+  advanceClocks(1_s, 11);
+  BOOST_CHECK(lsdb.findAdjLsa(ndn::Name(conf.getRouterPrefix()).append("ADJACENCY")) == nullptr);
+  BOOST_CHECK_EQUAL(lsdb.m_sequencingManager.getAdjLsaSeq(), seqNo);
+}
+
+BOOST_AUTO_TEST_CASE(Disabled)
+{
+  conf.setLsdbSnapshotInterval(0);
+  lsdb.writeSnapshot();
+
+  BOOST_CHECK_EQUAL(lsdb.loadSnapshot(), 0);
+  BOOST_CHECK(lsdb.findNameLsa("/ndn/site/%C1.Router/router1/NAME") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
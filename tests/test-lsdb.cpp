@@ -30,6 +30,7 @@
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <ndn-cxx/util/segment-fetcher.hpp>
 
+#include <algorithm>
 #include <unistd.h>
 
 namespace nlsr {
@@ -170,21 +171,378 @@ BOOST_AUTO_TEST_CASE(LsdbSync)
   BOOST_CHECK_EQUAL(interests.size(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(FetchOneLsaPerRouterAndType)
+{
+  ndn::Name lsaName("/localhop/ndn/nlsr/LSA/site/%C1.Router/router2/NAME");
+  auto countInterests = [&] {
+    return std::count_if(face.sentInterests.begin(), face.sentInterests.end(),
+                         [&] (const ndn::Interest& interest) {
+                           return lsaName.isPrefixOf(interest.getName());
+                         });
+  };
+
+  lsdb.expressInterest(ndn::Name(lsaName).appendNumber(10), 0);
+  advanceClocks(10_ms);
+  BOOST_CHECK_EQUAL(countInterests(), 1);
+
+  // Another update with the same sequence number does not start another fetch
+  lsdb.expressInterest(ndn::Name(lsaName).appendNumber(10), 0);
+  advanceClocks(10_ms);
+  BOOST_CHECK_EQUAL(countInterests(), 1);
+
+  // A higher sequence number takes the place of the fetch in flight
+  lsdb.expressInterest(ndn::Name(lsaName).appendNumber(11), 0);
+  advanceClocks(10_ms);
+  BOOST_CHECK_EQUAL(countInterests(), 2);
+  BOOST_REQUIRE_EQUAL(lsdb.m_fetches.size(), 1);
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.at(lsaName).seqNo, 11);
+
+  // The LSAs of another type are fetched alongside
+  ndn::Name adjLsaName("/localhop/ndn/nlsr/LSA/site/%C1.Router/router2/ADJACENCY");
+  lsdb.expressInterest(ndn::Name(adjLsaName).appendNumber(3), 0);
+  advanceClocks(10_ms);
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ServeNameLsaDelta)
+{
+  conf.setNameLsaDelta(true);
+  conf.setLsaEncoding(LSA_ENCODING_TLV);
+
+  uint64_t seqNo = lsdb.m_sequencingManager.getNameLsaSeq();
+  conf.getNamePrefixList().insert("/ndn/added1");
+  lsdb.buildAndInstallOwnNameLsa();
+  conf.getNamePrefixList().insert("/ndn/added2");
+  lsdb.buildAndInstallOwnNameLsa();
+  conf.getNamePrefixList().remove("/ndn/added1");
+  lsdb.buildAndInstallOwnNameLsa();
+
+  NameLsaDelta delta;
+  BOOST_REQUIRE(lsdb.getOwnNameLsaDelta(0, seqNo, seqNo + 3, delta));
+  BOOST_CHECK(delta.getAddedNames() == (std::set<ndn::Name>{"/ndn/added2"}));
+  BOOST_CHECK(delta.getRemovedNames().empty());
+
+  BOOST_REQUIRE(lsdb.getOwnNameLsaDelta(0, seqNo + 2, seqNo + 3, delta));
+  BOOST_CHECK(delta.getAddedNames().empty());
+  BOOST_CHECK(delta.getRemovedNames() == (std::set<ndn::Name>{"/ndn/added1"}));
+
+  // The changes before delta mode was enabled are not known
+  BOOST_CHECK(!lsdb.getOwnNameLsaDelta(0, seqNo - 1, seqNo + 3, delta));
+
+  ndn::Name lsaName("/localhop/ndn/nlsr/LSA/site/%C1.Router/this-router/NAME");
+  ndn::Name interestName = ndn::Name(lsaName).append(Lsdb::DELTA_COMPONENT)
+                                             .appendNumber(seqNo + 1)
+                                             .appendNumber(seqNo + 3);
+  lsdb.processInterest(ndn::Name(), ndn::Interest(interestName));
+  advanceClocks(10_ms);
+
+  BOOST_REQUIRE(!face.sentData.empty());
+  BOOST_CHECK(interestName.isPrefixOf(face.sentData.back().getName()));
+  NameLsaDelta served;
+  served.wireDecode(face.sentData.back().getContent().blockFromValue());
+  BOOST_CHECK_EQUAL(served.getBaseSeqNo(), seqNo + 1);
+  BOOST_CHECK_EQUAL(served.getLsSeqNo(), seqNo + 3);
+  BOOST_CHECK(served.getAddedNames() == (std::set<ndn::Name>{"/ndn/added2"}));
+  BOOST_CHECK(served.getRemovedNames() == (std::set<ndn::Name>{"/ndn/added1"}));
+
+  // The whole name LSA is served when the changes are not known
+  face.sentData.clear();
+  interestName = ndn::Name(lsaName).append(Lsdb::DELTA_COMPONENT)
+                                   .appendNumber(seqNo - 1)
+                                   .appendNumber(seqNo + 3);
+  lsdb.processInterest(ndn::Name(), ndn::Interest(interestName));
+  advanceClocks(10_ms);
+
+  BOOST_REQUIRE(!face.sentData.empty());
+  NameLsa nameLsa;
+  nameLsa.wireDecode(face.sentData.back().getContent().blockFromValue());
+  BOOST_CHECK_EQUAL(nameLsa.getLsSeqNo(), seqNo + 3);
+}
+
+BOOST_AUTO_TEST_CASE(DeltaNotInPathOfFullFetch)
+{
+  conf.setNameLsaDelta(true);
+  conf.setLsaEncoding(LSA_ENCODING_TLV);
+  std::string config = R"CONF(
+              trust-anchor
+                {
+                  type any
+                }
+            )CONF";
+  conf.getValidator().load(config, "config-file-from-string");
+
+  uint64_t seqNo = lsdb.m_sequencingManager.getNameLsaSeq();
+  conf.getNamePrefixList().insert("/ndn/added");
+  lsdb.buildAndInstallOwnNameLsa();
+
+  ndn::Name lsaName("/localhop/ndn/nlsr/LSA/site/%C1.Router/this-router/NAME");
+  ndn::Name deltaName = ndn::Name(lsaName).append(Lsdb::DELTA_COMPONENT)
+                                          .appendNumber(seqNo)
+                                          .appendNumber(seqNo + 1);
+  lsdb.processInterest(ndn::Name(), ndn::Interest(deltaName));
+  advanceClocks(10_ms);
+
+  BOOST_REQUIRE(!face.sentData.empty());
+  const ndn::Data& deltaData = face.sentData.back();
+  BOOST_CHECK(deltaName.isPrefixOf(deltaData.getName()));
+
+  // A Content Store cannot answer the first Interest of a whole LSA fetch with the delta
+  ndn::Interest fullInterest(ndn::Name(lsaName).appendNumber(seqNo + 1));
+  fullInterest.setCanBePrefix(true);
+  fullInterest.setMustBeFresh(true);
+  BOOST_CHECK(!fullInterest.matchesData(deltaData));
+
+  // A delta that answers the fetch of a whole name LSA anyway is not installed, and the
+  // whole LSA is fetched again
+  ndn::Name otherLsaName("/localhop/ndn/nlsr/LSA/site/%C1.Router/other-router/NAME");
+  ndn::Name otherInterestName = ndn::Name(otherLsaName).appendNumber(6);
+  auto countFetches = [&] {
+    return std::count_if(face.sentInterests.begin(), face.sentInterests.end(),
+                         [&] (const ndn::Interest& interest) {
+                           return otherInterestName.isPrefixOf(interest.getName());
+                         });
+  };
+
+  lsdb.expressInterest(otherInterestName, 0);
+  advanceClocks(10_ms);
+  BOOST_REQUIRE_EQUAL(countFetches(), 1);
+
+  NameLsaDelta delta("/ndn/site/%C1.Router/other-router", 6,
+                     ndn::time::system_clock::now() + 1_h, 5);
+  delta.addName("/ndn/name");
+  ndn::Block content = ndn::encoding::makeNestedBlock(ndn::tlv::Content, delta);
+
+  ndn::Data data(ndn::Name(otherInterestName).appendVersion().appendSegment(0));
+  data.setContent(content.wire(), content.size());
+  data.setFinalBlock(ndn::Name::Component::fromSegment(0));
+  m_keyChain.sign(data);
+  face.receive(data);
+  advanceClocks(10_ms);
+
+  BOOST_CHECK(lsdb.findNameLsa("/ndn/site/%C1.Router/other-router/NAME") == nullptr);
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.count(otherLsaName), 0);
+
+  advanceClocks(1_s, 5);
+  BOOST_CHECK_EQUAL(countFetches(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(InstallNameLsaDelta)
+{
+  ndn::Name otherRouter("/ndn/site/%C1.Router/other-router");
+  auto expiration = ndn::time::system_clock::now() + 1_h;
+
+  NamePrefixList prefixes{ndn::Name("/ndn/name1"), ndn::Name("/ndn/name2")};
+  NameLsa lsa(otherRouter, 5, expiration, prefixes);
+  lsdb.installNameLsa(lsa);
+
+  NameLsaDelta delta(otherRouter, 6, expiration + 1_h, 5);
+  delta.addName("/ndn/name3");
+  delta.removeName("/ndn/name1");
+  BOOST_CHECK(lsdb.installNameLsaDelta(delta));
+
+  const NameLsa* installed = lsdb.findNameLsa(ndn::Name(otherRouter).append("NAME"));
+  BOOST_REQUIRE(installed != nullptr);
+  BOOST_CHECK_EQUAL(installed->getLsSeqNo(), 6);
+  BOOST_CHECK(installed->getExpirationTimePoint() == expiration + 1_h);
+  BOOST_CHECK_EQUAL(installed->getNpl(),
+                    (NamePrefixList{ndn::Name("/ndn/name2"), ndn::Name("/ndn/name3")}));
+
+  const auto& npt = nlsr.m_namePrefixTable;
+  auto hasEntry = [&] (const ndn::Name& name) {
+    return std::any_of(npt.begin(), npt.end(),
+                       [&] (const std::shared_ptr<NamePrefixTableEntry>& entry) {
+                         return entry->getNamePrefix() == name;
+                       });
+  };
+  BOOST_CHECK(!hasEntry("/ndn/name1"));
+  BOOST_CHECK(hasEntry("/ndn/name3"));
+
+  // A delta from a sequence number the LSDB does not hold is not installed
+  NameLsaDelta missedBase(otherRouter, 8, expiration, 7);
+  missedBase.addName("/ndn/name4");
+  BOOST_CHECK(!lsdb.installNameLsaDelta(missedBase));
+  BOOST_CHECK_EQUAL(installed->getLsSeqNo(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(BuildNameLsaShards)
+{
+  const uint32_t nShards = 4;
+  conf.setNameLsaShards(nShards);
+  lsdb.m_sync.buildUpdatePrefix();
+
+  for (int i = 0; i < 20; ++i) {
+    conf.getNamePrefixList().insert(ndn::Name("/ndn/name").appendNumber(i));
+  }
+  lsdb.buildAndInstallOwnNameLsa();
+
+  auto findShard = [&] (uint32_t shard) {
+    return lsdb.findNameLsa(ndn::Name(conf.getRouterPrefix())
+                              .append(makeLsaTypeComponent(Lsa::Type::NAME, shard)));
+  };
+
+  // Each name is advertised in the shard it hashes to
+  std::vector<uint64_t> seqNos;
+  size_t nNames = 0;
+  for (uint32_t shard = 0; shard < nShards; ++shard) {
+    const NameLsa* nameLsa = findShard(shard);
+    BOOST_REQUIRE(nameLsa != nullptr);
+    BOOST_CHECK_EQUAL(nameLsa->getShard(), shard);
+    for (const auto& name : nameLsa->getNpl().getNames()) {
+      BOOST_CHECK_EQUAL(NameLsa::getShardOf(name, nShards), shard);
+    }
+    nNames += nameLsa->getNpl().size();
+    seqNos.push_back(nameLsa->getLsSeqNo());
+  }
+  BOOST_CHECK_EQUAL(nNames, conf.getNamePrefixList().size());
+
+  // A new name only leads to a new LSA of the shard that holds it
+  ndn::Name newName("/ndn/new-name");
+  uint32_t newShard = NameLsa::getShardOf(newName, nShards);
+  conf.getNamePrefixList().insert(newName);
+  lsdb.buildAndInstallOwnNameLsa();
+
+  for (uint32_t shard = 0; shard < nShards; ++shard) {
+    if (shard == newShard) {
+      BOOST_CHECK_GT(findShard(shard)->getLsSeqNo(), seqNos[shard]);
+      BOOST_CHECK_EQUAL(findShard(shard)->getNpl().countSources(newName), 1);
+    }
+    else {
+      BOOST_CHECK_EQUAL(findShard(shard)->getLsSeqNo(), seqNos[shard]);
+    }
+  }
+
+  // Shards other than the first are served in TLV, which tells their shard
+  uint32_t servedShard = newShard == 0 ? 1 : newShard;
+  ndn::Name interestName("/localhop/ndn/nlsr/LSA/site/%C1.Router/this-router");
+  interestName.append(makeLsaTypeComponent(Lsa::Type::NAME, servedShard))
+              .appendNumber(findShard(servedShard)->getLsSeqNo());
+  lsdb.processInterest(ndn::Name(), ndn::Interest(interestName));
+  advanceClocks(10_ms);
+
+  BOOST_REQUIRE(!face.sentData.empty());
+  NameLsa served;
+  served.wireDecode(face.sentData.back().getContent().blockFromValue());
+  BOOST_CHECK_EQUAL(served.getShard(), servedShard);
+  BOOST_CHECK_EQUAL(served.getNpl(), findShard(servedShard)->getNpl());
+}
+
+BOOST_AUTO_TEST_CASE(InstallNameLsaShards)
+{
+  ndn::Name otherRouter("/ndn/site/%C1.Router/other-router");
+  auto expiration = ndn::time::system_clock::now() + 1_h;
+
+  NamePrefixList names1{ndn::Name("/ndn/name1")};
+  NameLsa shard0(otherRouter, 5, expiration, names1);
+  lsdb.installNameLsa(shard0);
+
+  NamePrefixList names2{ndn::Name("/ndn/name2")};
+  NameLsa shard2(otherRouter, 6, expiration, names2);
+  shard2.setShard(2);
+  lsdb.installNameLsa(shard2);
+
+  ndn::Name key0 = ndn::Name(otherRouter).append("NAME");
+  ndn::Name key2 = ndn::Name(otherRouter).append("NAME-2");
+  BOOST_REQUIRE(lsdb.findNameLsa(key0) != nullptr);
+  BOOST_REQUIRE(lsdb.findNameLsa(key2) != nullptr);
+  BOOST_CHECK_EQUAL(lsdb.findNameLsa(key2)->getShard(), 2);
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name(otherRouter).append("NAME-1")) == nullptr);
+
+  // The sequence numbers of the shards are independent
+  BOOST_CHECK(lsdb.isLsaNew(otherRouter, Lsa::Type::NAME, 6));
+  BOOST_CHECK(!lsdb.isLsaNew(otherRouter, Lsa::Type::NAME, 6, 2));
+  BOOST_CHECK(lsdb.isLsaNew(otherRouter, Lsa::Type::NAME, 7, 2));
+
+  const auto& npt = nlsr.m_namePrefixTable;
+  auto hasEntry = [&] (const ndn::Name& name) {
+    return std::any_of(npt.begin(), npt.end(),
+                       [&] (const std::shared_ptr<NamePrefixTableEntry>& entry) {
+                         return entry->getNamePrefix() == name;
+                       });
+  };
+  BOOST_CHECK(hasEntry("/ndn/name1"));
+  BOOST_CHECK(hasEntry("/ndn/name2"));
+
+  // A name that moves to another shard stays in the NPT, whichever shard is updated first
+  NamePrefixList movedNames{ndn::Name("/ndn/name1"), ndn::Name("/ndn/name2")};
+  NameLsa newShard0(otherRouter, 7, expiration, movedNames);
+  lsdb.installNameLsa(newShard0);
+  NamePrefixList noNames;
+  NameLsa newShard2(otherRouter, 8, expiration, noNames);
+  newShard2.setShard(2);
+  lsdb.installNameLsa(newShard2);
+  BOOST_CHECK(hasEntry("/ndn/name2"));
+
+  // The router prefix stays while one of its shards is in the LSDB
+  BOOST_CHECK(lsdb.removeNameLsa(key0));
+  BOOST_CHECK(!hasEntry("/ndn/name1"));
+  BOOST_CHECK(!hasEntry("/ndn/name2"));
+  BOOST_CHECK(hasEntry(otherRouter));
+
+  BOOST_CHECK(lsdb.removeNameLsa(key2));
+  BOOST_CHECK(!hasEntry(otherRouter));
+}
+
+BOOST_AUTO_TEST_CASE(FetchQueue)
+{
+  conf.setMaxLsaFetches(2);
+
+  ndn::Name prefix("/localhop/ndn/nlsr/LSA/site/%C1.Router");
+  ndn::Name router1 = ndn::Name(prefix).append("router1").append("NAME");
+  ndn::Name router2 = ndn::Name(prefix).append("router2").append("NAME");
+  ndn::Name router3 = ndn::Name(prefix).append("router3").append("NAME");
+
+  lsdb.expressInterest(ndn::Name(router1).appendNumber(10), 0);
+  lsdb.expressInterest(ndn::Name(router2).appendNumber(10), 0);
+  lsdb.expressInterest(ndn::Name(router3).appendNumber(10), 0);
+  advanceClocks(10_ms);
+
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.size(), 2);
+  BOOST_CHECK_EQUAL(lsdb.m_fetchQueue.size(), 1);
+
+  // A later sequence number takes the place of the queued one
+  lsdb.expressInterest(ndn::Name(router3).appendNumber(11), 0);
+  BOOST_CHECK_EQUAL(lsdb.m_fetchQueue.size(), 1);
+  BOOST_CHECK_EQUAL(lsdb.m_queuedFetches.at(router3).interestName,
+                    ndn::Name(router3).appendNumber(11));
+
+  // The queued fetch starts once a fetch in flight fails
+  auto interest = std::find_if(face.sentInterests.begin(), face.sentInterests.end(),
+                               [&] (const ndn::Interest& interest) {
+                                 return router1.isPrefixOf(interest.getName());
+                               });
+  BOOST_REQUIRE(interest != face.sentInterests.end());
+  ndn::lp::Nack nack(*interest);
+  nack.setReason(ndn::lp::NackReason::NO_ROUTE);
+  face.receive(nack);
+  advanceClocks(10_ms);
+
+  BOOST_CHECK(lsdb.m_fetchQueue.empty());
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.size(), 2);
+  BOOST_REQUIRE_EQUAL(lsdb.m_fetches.count(router3), 1);
+  BOOST_CHECK_EQUAL(lsdb.m_fetches.at(router3).seqNo, 11);
+
+  // The fetch that failed is tried again, and waits for its turn
+  advanceClocks(1_s, 5);
+  BOOST_CHECK_EQUAL(lsdb.m_fetchQueue.size(), 1);
+  BOOST_CHECK_EQUAL(lsdb.m_fetchQueue.front(), router1);
+}
+
 BOOST_AUTO_TEST_CASE(LsdbSegmentedData)
 {
   // Add a lot of NameLSAs to exceed max packet size
   ndn::Name lsaKey("/ndn/site/%C1.Router/this-router/NAME");
 
-  NameLsa* nameLsa = lsdb.findNameLsa(lsaKey);
+  const NameLsa* nameLsa = lsdb.findNameLsa(lsaKey);
   uint64_t seqNo = nameLsa->getLsSeqNo();
 
   ndn::Name prefix("/ndn/edu/memphis/netlab/research/nlsr/test/prefix/");
 
-  int nPrefixes = 0;
-  while (nameLsa->serialize().size() < ndn::MAX_NDN_PACKET_SIZE) {
-    nameLsa->addName(ndn::Name(prefix).appendNumber(++nPrefixes));
-  }
-  lsdb.installNameLsa(*nameLsa);
+  BOOST_REQUIRE(lsdb.modifyNameLsa(lsaKey, [&] (NameLsa& lsa) {
+    int nPrefixes = 0;
+    while (lsa.serialize().size() < ndn::MAX_NDN_PACKET_SIZE) {
+      lsa.addName(ndn::Name(prefix).appendNumber(++nPrefixes));
+    }
+  }));
 
   // Create another Lsdb and expressInterest
   ndn::util::DummyClientFace face2(m_ioService, m_keyChain, {true, true});
@@ -210,23 +568,26 @@ BOOST_AUTO_TEST_CASE(LsdbSegmentedData)
 
   advanceClocks(ndn::time::milliseconds(1), 10);
 
-  BOOST_CHECK_EQUAL(lsdb.getNameLsdb().front().getNpl(), lsdb2.getNameLsdb().front().getNpl());
+  const NameLsa* fetchedLsa = lsdb2.findNameLsa(lsaKey);
+  BOOST_REQUIRE(fetchedLsa != nullptr);
+  BOOST_CHECK_EQUAL(nameLsa->getNpl(), fetchedLsa->getNpl());
 }
 
 BOOST_AUTO_TEST_CASE(SegmentLsaData)
 {
   ndn::Name lsaKey("/ndn/site/%C1.Router/this-router/NAME");
 
-  NameLsa* lsa = lsdb.findNameLsa(lsaKey);
+  const NameLsa* lsa = lsdb.findNameLsa(lsaKey);
   uint64_t seqNo = lsa->getLsSeqNo();
 
   ndn::Name prefix("/ndn/edu/memphis/netlab/research/nlsr/test/prefix/");
 
-  int nPrefixes = 0;
-  while (lsa->serialize().size() < ndn::MAX_NDN_PACKET_SIZE) {
-    lsa->addName(ndn::Name(prefix).appendNumber(++nPrefixes));
-  }
-  lsdb.installNameLsa(*lsa);
+  BOOST_REQUIRE(lsdb.modifyNameLsa(lsaKey, [&] (NameLsa& modified) {
+    int nPrefixes = 0;
+    while (modified.serialize().size() < ndn::MAX_NDN_PACKET_SIZE) {
+      modified.addName(ndn::Name(prefix).appendNumber(++nPrefixes));
+    }
+  }));
 
   std::string expectedDataContent = lsa->serialize();
 
@@ -267,12 +628,62 @@ BOOST_AUTO_TEST_CASE(ReceiveSegmentedLsaData)
   ndn::Block block = ndn::encoding::makeStringBlock(ndn::tlv::Content, lsa.serialize());
   lsdb.afterFetchLsa(block.getBuffer(), interestName);
 
-  NameLsa* foundLsa = lsdb.findNameLsa(lsa.getKey());
+  const NameLsa* foundLsa = lsdb.findNameLsa(lsa.getKey());
   BOOST_REQUIRE(foundLsa != nullptr);
 
   BOOST_CHECK_EQUAL(foundLsa->serialize(), lsa.serialize());
 }
 
+BOOST_AUTO_TEST_CASE(SegmentTlvLsaData)
+{
+  conf.setLsaEncoding(LSA_ENCODING_TLV);
+
+  ndn::Name lsaKey("/ndn/site/%C1.Router/this-router/NAME");
+  const NameLsa* lsa = lsdb.findNameLsa(lsaKey);
+  BOOST_REQUIRE(lsa != nullptr);
+  ndn::Block expectedLsa = lsa->wireEncode();
+
+  ndn::Name interestName("/localhop/ndn/nlsr/LSA/site/%C1.Router/this-router/NAME/");
+  interestName.appendNumber(lsa->getLsSeqNo());
+
+  ndn::util::DummyClientFace face2(m_ioService, m_keyChain, {true, true});
+  face.linkTo(face2);
+
+  bool isFetched = false;
+  auto fetcher = ndn::util::SegmentFetcher::start(face2, ndn::Interest(interestName),
+                                                  ndn::security::v2::getAcceptAllValidator());
+  fetcher->onComplete.connect([&] (ndn::ConstBufferPtr bufferPtr) {
+                                ndn::Block block(bufferPtr);
+                                BOOST_CHECK(block.blockFromValue() == expectedLsa);
+                                isFetched = true;
+                              });
+
+  advanceClocks(ndn::time::milliseconds(1), 100);
+  fetcher->stop();
+
+  BOOST_CHECK(isFetched);
+}
+
+BOOST_AUTO_TEST_CASE(ReceiveTlvLsaData)
+{
+  ndn::Name router("/ndn/cs/%C1.Router/router1");
+  uint64_t seqNo = 12;
+  NamePrefixList prefixList{ndn::Name("/prefix/1"), ndn::Name("/prefix/2")};
+
+  NameLsa lsa(router, seqNo, ndn::time::system_clock::now(), prefixList);
+
+  ndn::Name interestName("/localhop/ndn/nlsr/LSA/cs/%C1.Router/router1/NAME/");
+  interestName.appendNumber(seqNo);
+
+  ndn::Block block = ndn::encoding::makeNestedBlock(ndn::tlv::Content, lsa);
+  lsdb.afterFetchLsa(block.getBuffer(), interestName);
+
+  const NameLsa* foundLsa = lsdb.findNameLsa(lsa.getKey());
+  BOOST_REQUIRE(foundLsa != nullptr);
+
+  BOOST_CHECK_EQUAL(foundLsa->getNpl(), lsa.getNpl());
+}
+
 BOOST_AUTO_TEST_CASE(LsdbRemoveAndExists)
 {
   ndn::time::system_clock::TimePoint testTimePoint =  ndn::time::system_clock::now();
@@ -302,6 +713,67 @@ BOOST_AUTO_TEST_CASE(LsdbRemoveAndExists)
   BOOST_CHECK_EQUAL(lsdb1.doesLsaExist(ndn::Name("/router1/1"), Lsa::Type::NAME), false);
 }
 
+BOOST_AUTO_TEST_CASE(LsdbLookupByKey)
+{
+  ndn::time::system_clock::TimePoint testTimePoint = ndn::time::system_clock::now();
+  NamePrefixList npl;
+  npl.insert("name1");
+
+  for (const std::string& router : {"/router3", "/router1", "/router2"}) {
+    NameLsa nlsa(ndn::Name(router), 12, testTimePoint, npl);
+    lsdb.installNameLsa(nlsa);
+  }
+
+  // LSAs are kept in the order of their originating routers
+  const NameLsaContainer& nameLsdb = lsdb.getNameLsdb();
+  BOOST_CHECK(std::is_sorted(nameLsdb.begin(), nameLsdb.end(),
+                             [] (const NameLsa& lhs, const NameLsa& rhs) {
+                               return lhs.getOrigRouter() < rhs.getOrigRouter();
+                             }));
+
+  const NameLsa* nlsa = lsdb.findNameLsa(ndn::Name("/router2/NAME"));
+  BOOST_REQUIRE(nlsa != nullptr);
+  BOOST_CHECK_EQUAL(nlsa->getOrigRouter(), ndn::Name("/router2"));
+
+  // The key names the type of the LSA too
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name("/router2/ADJACENCY")) == nullptr);
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name("/router2")) == nullptr);
+
+  BOOST_CHECK(lsdb.removeNameLsa(ndn::Name("/router2/NAME")));
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name("/router2/NAME")) == nullptr);
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name("/router1/NAME")) != nullptr);
+  BOOST_CHECK(lsdb.findNameLsa(ndn::Name("/router3/NAME")) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ModifyLsaInPlace)
+{
+  NamePrefixList npl;
+  npl.insert("name1");
+  for (uint32_t shard : {0, 1}) {
+    NameLsa nlsa(ndn::Name("/router1"), 12, ndn::time::system_clock::now(), npl);
+    nlsa.setShard(shard);
+    lsdb.installNameLsa(nlsa);
+  }
+  ndn::Name key = ndn::Name("/router1").append(makeLsaTypeComponent(Lsa::Type::NAME, 1));
+  const NameLsa* nlsa = lsdb.findNameLsa(key);
+  BOOST_REQUIRE(nlsa != nullptr);
+
+  BOOST_CHECK(lsdb.modifyNameLsa(key, [] (NameLsa& lsa) {
+    lsa.addName("name2");
+    lsa.setLsSeqNo(13);
+  }));
+
+  // The LSA is changed where it is, and is still found by its key
+  BOOST_CHECK(lsdb.findNameLsa(key) == nlsa);
+  BOOST_CHECK_EQUAL(nlsa->getLsSeqNo(), 13);
+  BOOST_CHECK_EQUAL(nlsa->getNpl().size(), 2);
+  BOOST_CHECK_EQUAL(lsdb.findNameLsa("/router1/NAME")->getLsSeqNo(), 12);
+  BOOST_CHECK_EQUAL(lsdb.getNameLsdb().size(), 2);
+
+  BOOST_CHECK(!lsdb.modifyNameLsa("/router2/NAME", [] (NameLsa&) {}));
+  BOOST_CHECK(!lsdb.modifyAdjLsa("/router1/ADJACENCY", [] (AdjLsa&) {}));
+}
+
 BOOST_AUTO_TEST_CASE(InstallNameLsa)
 {
   // Install lsa with name1 and name2
@@ -319,7 +791,7 @@ BOOST_AUTO_TEST_CASE(InstallNameLsa)
   lsdb.installNameLsa(lsa);
 
   BOOST_REQUIRE_EQUAL(lsdb.doesLsaExist(otherRouter + "/NAME", Lsa::Type::NAME), true);
-  NamePrefixList& nameList = lsdb.findNameLsa(otherRouter + "/NAME")->getNpl();
+  const NamePrefixList& nameList = lsdb.findNameLsa(otherRouter + "/NAME")->getNpl();
 
   BOOST_CHECK_EQUAL(nameList, prefixes);
   //areNamePrefixListsEqual(nameList, prefixes);
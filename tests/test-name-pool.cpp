@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+
+#include "name-pool.hpp"
+#include "name-prefix-list.hpp"
+#include "route/fib-entry.hpp"
+#include "route/map.hpp"
+
+#include "test-common.hpp"
+
+#include <map>
+#include <unordered_map>
+
+namespace nlsr {
+namespace test {
+
+BOOST_AUTO_TEST_SUITE(TestNamePool)
+
+BOOST_AUTO_TEST_CASE(SameNameSharesEntry)
+{
+  NamePool& pool = NamePool::getInstance();
+  size_t nNames = pool.size();
+
+  InternedName name1(ndn::Name("/ndn/test/pool/router1"));
+  InternedName name2("/ndn/test/pool/router1");
+  InternedName name3("/ndn/test/pool/router2");
+  BOOST_CHECK_EQUAL(pool.size(), nNames + 2);
+
+  BOOST_CHECK(name1 == name2);
+  BOOST_CHECK_EQUAL(name1.getId(), name2.getId());
+  BOOST_CHECK_EQUAL(&name1.get(), &name2.get());
+  BOOST_CHECK_EQUAL(name1.getHash(), std::hash<ndn::Name>()(name1.get()));
+  BOOST_CHECK(name1 != name3);
+  BOOST_CHECK_NE(name1.getId(), name3.getId());
+  BOOST_CHECK_EQUAL(name1.get(), ndn::Name("/ndn/test/pool/router1"));
+}
+
+BOOST_AUTO_TEST_CASE(LeavesPoolWithLastHandle)
+{
+  NamePool& pool = NamePool::getInstance();
+  size_t nNames = pool.size();
+
+  {
+    InternedName name("/ndn/test/pool/router3");
+    InternedName copy = name;
+    BOOST_CHECK_EQUAL(pool.size(), nNames + 1);
+
+    InternedName moved = std::move(copy);
+    BOOST_CHECK(moved == name);
+    BOOST_CHECK(copy == InternedName());
+
+    name = InternedName("/ndn/test/pool/router4");
+    BOOST_CHECK_EQUAL(pool.size(), nNames + 2);
+    moved = name;
+    BOOST_CHECK_EQUAL(pool.size(), nNames + 1);
+  }
+  BOOST_CHECK_EQUAL(pool.size(), nNames);
+}
+
+BOOST_AUTO_TEST_CASE(IdNotReused)
+{
+  uint64_t id = 0;
+  {
+    InternedName name("/ndn/test/pool/router5");
+    id = name.getId();
+  }
+  InternedName again("/ndn/test/pool/router5");
+  BOOST_CHECK_NE(again.getId(), id);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyName)
+{
+  NamePool& pool = NamePool::getInstance();
+  size_t nNames = pool.size();
+
+  InternedName empty(ndn::Name{});
+  BOOST_CHECK(empty == InternedName());
+  BOOST_CHECK_EQUAL(empty.getId(), 0);
+  BOOST_CHECK_EQUAL(empty.get(), ndn::Name());
+  BOOST_CHECK_EQUAL(pool.size(), nNames);
+}
+
+BOOST_AUTO_TEST_CASE(Comparisons)
+{
+  InternedName a("/ndn/test/pool/a");
+  InternedName b("/ndn/test/pool/b");
+
+  BOOST_CHECK(a < b);
+  BOOST_CHECK(!(b < a));
+  BOOST_CHECK(!(a < a));
+  BOOST_CHECK(a == ndn::Name("/ndn/test/pool/a"));
+  BOOST_CHECK(ndn::Name("/ndn/test/pool/b") == b);
+  BOOST_CHECK(a < ndn::Name("/ndn/test/pool/b"));
+  BOOST_CHECK(a != ndn::Name("/ndn/test/pool/b"));
+
+  // Ordered containers keep the order of the names
+  std::map<InternedName, int> ordered{{b, 2}, {a, 1}};
+  BOOST_CHECK_EQUAL(ordered.begin()->first, a);
+
+  std::unordered_map<InternedName, int> hashed{{a, 1}, {b, 2}};
+  BOOST_CHECK_EQUAL(hashed.at(ndn::Name("/ndn/test/pool/b")), 2);
+}
+
+BOOST_AUTO_TEST_CASE(SharedByTables)
+{
+  NamePool& pool = NamePool::getInstance();
+  size_t nNames = pool.size();
+
+  ndn::Name prefix("/ndn/test/pool/prefix");
+  NamePrefixList npl1{prefix};
+  NamePrefixList npl2{prefix};
+  FibEntry fibEntry(prefix);
+  BOOST_CHECK_EQUAL(pool.size(), nNames + 1);
+  BOOST_CHECK_EQUAL(&fibEntry.getName(), &InternedName(prefix).get());
+}
+
+BOOST_AUTO_TEST_CASE(HashedIndexLookup)
+{
+  NamePool& pool = NamePool::getInstance();
+
+  Map map;
+  map.addEntry("/ndn/test/pool/router6");
+  size_t nNames = pool.size();
+
+  // A plain name is hashed like its interned handle, and looking it up does not intern it
+  BOOST_CHECK_EQUAL(InternedNameHash()(InternedName("/ndn/test/pool/router6")),
+                    InternedNameHash()(ndn::Name("/ndn/test/pool/router6")));
+  BOOST_CHECK_EQUAL(InternedNameHash()(InternedName()), InternedNameHash()(ndn::Name()));
+  BOOST_CHECK(map.getMappingNoByRouterName("/ndn/test/pool/router6"));
+  BOOST_CHECK(!map.getMappingNoByRouterName("/ndn/test/pool/router7"));
+  BOOST_CHECK_EQUAL(pool.size(), nNames);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
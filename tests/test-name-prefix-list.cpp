@@ -189,6 +189,77 @@ BOOST_AUTO_TEST_CASE(BraceInitializerCtors)
   BOOST_CHECK(list1 == list4);
 }
 
+/*
+  Iterating over the NamePrefixList gives its names in the order they
+  were inserted, and removing a name keeps the order of the others.
+ */
+BOOST_AUTO_TEST_CASE(IterationOrder)
+{
+  const ndn::Name name1{"/ndn/test/prefix1"};
+  const ndn::Name name2{"/ndn/test/prefix2"};
+  const ndn::Name name3{"/ndn/test/prefix3"};
+  NamePrefixList list{name3, name1, name2};
+
+  BOOST_CHECK(std::vector<ndn::Name>(list.begin(), list.end()) ==
+              (std::vector<ndn::Name>{name3, name1, name2}));
+  BOOST_CHECK(std::vector<ndn::Name>(list.rbegin(), list.rend()) ==
+              (std::vector<ndn::Name>{name2, name1, name3}));
+
+  list.remove(name1);
+  BOOST_CHECK(std::vector<ndn::Name>(list.begin(), list.end()) ==
+              (std::vector<ndn::Name>{name3, name2}));
+
+  list.insert(name1);
+  list.sort();
+  BOOST_CHECK(std::vector<ndn::Name>(list.begin(), list.end()) ==
+              (std::vector<ndn::Name>{name1, name2, name3}));
+}
+
+/*
+  A name is only removed by a source that advertises it, and inserting
+  a source twice does not count it twice.
+ */
+BOOST_AUTO_TEST_CASE(InsertAndRemoveSources)
+{
+  const ndn::Name name1{"/ndn/test/prefix1"};
+  NamePrefixList list;
+
+  BOOST_CHECK(list.insert(name1, "nlsr.conf"));
+  BOOST_CHECK(!list.insert(name1, "nlsr.conf"));
+  BOOST_CHECK(list.insert(name1, "readvertise"));
+  BOOST_CHECK_EQUAL(list.countSources(name1), 2);
+
+  BOOST_CHECK(!list.remove(name1, "prefix-update"));
+  BOOST_CHECK(!list.remove("/not/a/prefix", "nlsr.conf"));
+  BOOST_CHECK(list.remove(name1, "nlsr.conf"));
+  BOOST_CHECK(list.getSources(name1) == std::vector<std::string>{"readvertise"});
+  BOOST_CHECK(list.remove(name1, "readvertise"));
+  BOOST_CHECK_EQUAL(list.size(), 0);
+  BOOST_CHECK_EQUAL(list.countSources(name1), 0);
+}
+
+/*
+  Many names can be inserted, looked up and removed one at a time, as
+  when prefixes are advertised in bulk.
+ */
+BOOST_AUTO_TEST_CASE(ManyNames)
+{
+  const size_t nNames = 20000;
+  NamePrefixList list;
+  for (size_t i = 0; i < nNames; ++i) {
+    BOOST_REQUIRE(list.insert(ndn::Name("/ndn/test").appendNumber(i)));
+  }
+  BOOST_CHECK_EQUAL(list.size(), nNames);
+
+  for (size_t i = 0; i < nNames; i += 2) {
+    BOOST_REQUIRE(list.remove(ndn::Name("/ndn/test").appendNumber(i)));
+  }
+  BOOST_CHECK_EQUAL(list.size(), nNames / 2);
+  BOOST_CHECK_EQUAL(list.countSources(ndn::Name("/ndn/test").appendNumber(0)), 0);
+  BOOST_CHECK_EQUAL(list.countSources(ndn::Name("/ndn/test").appendNumber(1)), 1);
+  BOOST_CHECK_EQUAL(*list.begin(), ndn::Name("/ndn/test").appendNumber(1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
@@ -134,6 +134,29 @@ BOOST_AUTO_TEST_CASE(SetEventIntervals)
   BOOST_CHECK_EQUAL(rt.getRoutingCalcInterval(), ndn::time::seconds(9));
 }
 
+BOOST_AUTO_TEST_CASE(SetEventThrottles)
+{
+  conf.setAdjLsaBuildInterval(3);
+  conf.setAdjLsaBuildInitialDelay(50);
+  conf.setAdjLsaBuildHoldDelay(200);
+  conf.setRoutingCalcInterval(9);
+  conf.setRoutingCalcInitialDelay(100);
+  conf.setRoutingCalcHoldDelay(10000);
+
+  Nlsr nlsr2(m_face, m_keyChain, conf);
+
+  const Throttle& adjLsaBuild = nlsr2.m_lsdb.getAdjLsaBuildThrottle();
+  BOOST_CHECK_EQUAL(adjLsaBuild.getInitialDelay(), ndn::time::milliseconds(50));
+  BOOST_CHECK_EQUAL(adjLsaBuild.getHoldDelay(), ndn::time::milliseconds(200));
+  BOOST_CHECK_EQUAL(adjLsaBuild.getMaxDelay(), ndn::time::seconds(3));
+
+  // The hold delay is capped by the routing calculation interval
+  const Throttle& routingCalc = nlsr2.m_routingTable.getCalculationThrottle();
+  BOOST_CHECK_EQUAL(routingCalc.getInitialDelay(), ndn::time::milliseconds(100));
+  BOOST_CHECK_EQUAL(routingCalc.getHoldDelay(), ndn::time::seconds(9));
+  BOOST_CHECK_EQUAL(routingCalc.getMaxDelay(), ndn::time::seconds(9));
+}
+
 BOOST_AUTO_TEST_CASE(FaceCreateEvent)
 {
   // Setting constants for the unit test
@@ -305,7 +328,7 @@ BOOST_AUTO_TEST_CASE(FaceDestroyEvent)
   // Make sure an adjacency LSA was built
   ndn::Name key = ndn::Name(conf.getRouterPrefix())
     .append(std::to_string(Lsa::Type::ADJACENCY));
-  AdjLsa* lsa = lsdb.findAdjLsa(key);
+  const AdjLsa* lsa = lsdb.findAdjLsa(key);
   BOOST_REQUIRE(lsa != nullptr);
 
   uint32_t lastAdjLsaSeqNo = lsa->getLsSeqNo();
@@ -405,7 +428,7 @@ BOOST_AUTO_TEST_CASE(BuildAdjLsaAfterHelloResponse)
   ndn::Name lsaKey = ndn::Name(conf.getRouterPrefix()).append(std::to_string(Lsa::Type::ADJACENCY));
 
   // Adjacency LSA should be built even though other router is INACTIVE
-  AdjLsa* lsa = lsdb.findAdjLsa(lsaKey);
+  const AdjLsa* lsa = lsdb.findAdjLsa(lsaKey);
   BOOST_REQUIRE(lsa != nullptr);
   BOOST_CHECK_EQUAL(lsa->getAdl().size(), 1);
 
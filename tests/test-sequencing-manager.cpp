@@ -39,11 +39,14 @@ public:
   SequencingManagerFixture()
   : m_seqManager("/tmp", HYPERBOLIC_STATE_OFF)
   {
+    boost::filesystem::remove(binarySeqFile);
   }
 
   ~SequencingManagerFixture()
   {
+    m_seqManager.waitForWrites();
     boost::filesystem::remove(seqFile);
+    boost::filesystem::remove(binarySeqFile);
   }
 
   void
@@ -69,6 +72,7 @@ public:
 
 public:
   std::string seqFile = "/tmp/nlsrSeqNo.txt";
+  std::string binarySeqFile = "/tmp/nlsrSeqNo.bin";
   SequencingManager m_seqManager;
 };
 
@@ -106,6 +110,77 @@ BOOST_AUTO_TEST_CASE(SeparateSeqNumber)
   checkSeqNumbers(100+10, 0, 100+10);
 }
 
+BOOST_AUTO_TEST_CASE(ReserveBlocks)
+{
+  const uint64_t blockSize = SequencingManager::SEQ_NO_BLOCK_SIZE;
+
+  // The first sequence number is reserved on disk before it is published
+  m_seqManager.increaseNameLsaSeq();
+  m_seqManager.increaseAdjLsaSeq();
+  m_seqManager.writeSeqNoToFile();
+  BOOST_CHECK(boost::filesystem::exists(binarySeqFile));
+  {
+    SequencingManager restarted("/tmp", HYPERBOLIC_STATE_OFF);
+    BOOST_CHECK_EQUAL(restarted.getNameLsaSeq(), m_seqManager.getNameLsaSeq() + blockSize);
+    BOOST_CHECK_EQUAL(restarted.getAdjLsaSeq(), m_seqManager.getAdjLsaSeq() + blockSize);
+  }
+
+  // A restarted router never reuses a sequence number in use, however often it is written
+  for (uint64_t i = 0; i < 5 * blockSize; ++i) {
+    m_seqManager.increaseNameLsaSeq();
+    m_seqManager.writeSeqNoToFile();
+
+    SequencingManager restarted("/tmp", HYPERBOLIC_STATE_OFF);
+    BOOST_REQUIRE_GE(restarted.getNameLsaSeq(), m_seqManager.getNameLsaSeq());
+    BOOST_REQUIRE_GE(restarted.getAdjLsaSeq(), m_seqManager.getAdjLsaSeq());
+  }
+
+  // The file keeps a whole block ahead once the writes are done
+  m_seqManager.waitForWrites();
+  SequencingManager restarted("/tmp", HYPERBOLIC_STATE_OFF);
+  BOOST_CHECK_GE(restarted.getNameLsaSeq(), m_seqManager.getNameLsaSeq() + blockSize / 2);
+  BOOST_CHECK_LE(restarted.getNameLsaSeq(), m_seqManager.getNameLsaSeq() + blockSize);
+}
+
+BOOST_AUTO_TEST_CASE(ReplaceTextFile)
+{
+  writeToFile("NameLsaSeq 100\nAdjLsaSeq 100\nCorLsaSeq 0");
+  initiateFromFile();
+  checkSeqNumbers(100+10, 100+10, 0);
+
+  // The binary file takes the place of the text file
+  m_seqManager.increaseNameLsaSeq();
+  m_seqManager.writeSeqNoToFile();
+  m_seqManager.waitForWrites();
+  BOOST_CHECK(boost::filesystem::exists(binarySeqFile));
+  BOOST_CHECK(!boost::filesystem::exists(seqFile));
+
+  initiateFromFile();
+  checkSeqNumbers(111 + SequencingManager::SEQ_NO_BLOCK_SIZE,
+                  110 + SequencingManager::SEQ_NO_BLOCK_SIZE, 0);
+}
+
+BOOST_AUTO_TEST_CASE(DamagedFile)
+{
+  m_seqManager.increaseNameLsaSeq();
+  m_seqManager.writeSeqNoToFile();
+  m_seqManager.waitForWrites();
+
+  // A file whose checksum is wrong is not used
+  {
+    std::fstream file(binarySeqFile, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+  SequencingManager restarted("/tmp", HYPERBOLIC_STATE_OFF);
+  BOOST_CHECK_EQUAL(restarted.getNameLsaSeq(), 0);
+
+  // The text file is read instead if there is one
+  writeToFile("NameLsaSeq 100\nAdjLsaSeq 100\nCorLsaSeq 0");
+  initiateFromFile();
+  checkSeqNumbers(100+10, 100+10, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace test
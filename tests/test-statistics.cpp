@@ -230,15 +230,13 @@ BOOST_AUTO_TEST_CASE(LsdbReceiveInterestSendData)
   ndn::Name adjLsaKey = conf.getRouterPrefix();
   adjLsaKey.append(std::to_string(Lsa::Type::ADJACENCY));
 
-  AdjLsa* adjLsa = lsdb.findAdjLsa(adjLsaKey);
+  const AdjLsa* adjLsa = lsdb.findAdjLsa(adjLsaKey);
   uint32_t seqNo = adjLsa->getLsSeqNo();
 
   Adjacent adjacency("adjacency");
   adjacency.setStatus(Adjacent::STATUS_ACTIVE);
 
-  adjLsa->addAdjacent(adjacency);
-
-  lsdb.installAdjLsa(*adjLsa);
+  BOOST_REQUIRE(lsdb.modifyAdjLsa(adjLsaKey, [&] (AdjLsa& lsa) { lsa.addAdjacent(adjacency); }));
 
   const std::string interestPrefix("/localhop/ndn/nlsr/LSA/site/%C1.Router/this-router/");
 
@@ -253,12 +251,12 @@ BOOST_AUTO_TEST_CASE(LsdbReceiveInterestSendData)
   ndn::Name nameLsaKey = conf.getRouterPrefix();
   nameLsaKey.append(std::to_string(Lsa::Type::NAME));
 
-  NameLsa* nameLsa = lsdb.findNameLsa(nameLsaKey);
+  const NameLsa* nameLsa = lsdb.findNameLsa(nameLsaKey);
 
   seqNo = nameLsa->getLsSeqNo();
 
-  nameLsa->addName(ndn::Name("/ndn/name"));
-  lsdb.installNameLsa(*nameLsa);
+  BOOST_REQUIRE(lsdb.modifyNameLsa(nameLsaKey,
+                                   [] (NameLsa& lsa) { lsa.addName(ndn::Name("/ndn/name")); }));
 
   // Receive Name LSA Interest
   receiveInterestAndCheckSentStats(interestPrefix,
@@ -272,10 +270,11 @@ BOOST_AUTO_TEST_CASE(LsdbReceiveInterestSendData)
   ndn::Name coorLsaKey = conf.getRouterPrefix();
   coorLsaKey.append(std::to_string(Lsa::Type::COORDINATE));
 
-  CoordinateLsa* coorLsa = lsdb.findCoordinateLsa(coorLsaKey);
+  const CoordinateLsa* coorLsa = lsdb.findCoordinateLsa(coorLsaKey);
   seqNo = coorLsa->getLsSeqNo();
-  coorLsa->setCorTheta({20.0, 30.0});
-  lsdb.installCoordinateLsa(*coorLsa);
+  BOOST_REQUIRE(lsdb.modifyCoordinateLsa(coorLsaKey, [] (CoordinateLsa& lsa) {
+    lsa.setCorTheta({20.0, 30.0});
+  }));
 
   // Receive Adjacency LSA Interest
   receiveInterestAndCheckSentStats(interestPrefix,
@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "throttle.hpp"
+
+#include "test-common.hpp"
+
+namespace nlsr {
+namespace test {
+
+using namespace ndn::time_literals;
+
+BOOST_FIXTURE_TEST_SUITE(TestThrottle, UnitTestTimeFixture)
+
+BOOST_AUTO_TEST_CASE(FixedDelay)
+{
+  Throttle throttle(5_s, 5_s, 5_s);
+
+  for (int i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL(throttle.scheduleRun(), 5_s);
+    advanceClocks(5_s);
+    throttle.recordRun();
+  }
+
+  advanceClocks(1_s);
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 5_s);
+}
+
+BOOST_AUTO_TEST_CASE(DelaysCappedByMax)
+{
+  Throttle throttle(15_s, 15_s, 9_s);
+
+  BOOST_CHECK_EQUAL(throttle.getInitialDelay(), 9_s);
+  BOOST_CHECK_EQUAL(throttle.getHoldDelay(), 9_s);
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 9_s);
+
+  throttle.setDelays(0_ms, 0_ms, 0_ms);
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 0_ms);
+  throttle.recordRun();
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 0_ms);
+}
+
+BOOST_AUTO_TEST_CASE(ExponentialBackoff)
+{
+  Throttle throttle(50_ms, 200_ms, 2_s);
+
+  // A single event is acted upon after the initial delay
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 50_ms);
+  advanceClocks(50_ms);
+  throttle.recordRun();
+
+  // Events that keep arriving are held down until the hold time has passed since the previous
+  // run, and the hold time doubles every time
+  const ndn::time::milliseconds holds[] = {200_ms, 400_ms, 800_ms, 1600_ms, 2_s, 2_s};
+  for (const auto& hold : holds) {
+    BOOST_CHECK_EQUAL(throttle.getCurrentHold(), hold);
+    advanceClocks(10_ms);
+    throttle.recordEvent();
+    BOOST_CHECK_EQUAL(throttle.scheduleRun(), hold - 10_ms);
+    advanceClocks(hold - 10_ms);
+    throttle.recordRun();
+  }
+  BOOST_CHECK_EQUAL(throttle.getCurrentHold(), 2_s);
+
+  // An event after the hold time, but before the throttle is quiet, waits for the initial
+  // delay and keeps the hold time
+  advanceClocks(3_s);
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 50_ms);
+  BOOST_CHECK_EQUAL(throttle.getCurrentHold(), 2_s);
+  advanceClocks(50_ms);
+  throttle.recordRun();
+
+  // Once quiet for twice the hold time, the throttle is back to the fast path
+  advanceClocks(4_s);
+  BOOST_CHECK_EQUAL(throttle.scheduleRun(), 50_ms);
+  BOOST_CHECK_EQUAL(throttle.getCurrentHold(), 200_ms);
+  advanceClocks(50_ms);
+  throttle.recordRun();
+
+  const Throttle::Statistics& stats = throttle.getStatistics();
+  BOOST_CHECK_EQUAL(stats.nEvents, 15U);
+  BOOST_CHECK_EQUAL(stats.nRuns, 9U);
+  BOOST_CHECK_EQUAL(stats.nFastRuns, 2U);
+  BOOST_CHECK_EQUAL(stats.nHeldRuns, 7U);
+  BOOST_CHECK_EQUAL(stats.longestDelay, 1990_ms);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2019,  The University of Memphis,
+ *                           Regents of the University of California,
+ *                           Arizona Board of Regents.
+ *
+ * This file is part of NLSR (Named-data Link State Routing).
+ * See AUTHORS.md for complete list of NLSR authors and contributors.
+ *
+ * NLSR is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NLSR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NLSR, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "timer-wheel.hpp"
+
+#include "test-common.hpp"
+
+#include <vector>
+
+namespace nlsr {
+namespace test {
+
+using namespace ndn::time_literals;
+
+class TimerWheelFixture : public UnitTestTimeFixture
+{
+public:
+  TimerWheelFixture()
+    : wheel(m_scheduler)
+  {
+  }
+
+public:
+  TimerWheel wheel;
+  std::vector<int> runs;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestTimerWheel, TimerWheelFixture)
+
+BOOST_AUTO_TEST_CASE(ExactTime)
+{
+  advanceClocks(10_ms);
+  wheel.schedule(1800_s, [this] { runs.push_back(1); });
+  wheel.schedule(1500_us, [this] { runs.push_back(2); });
+  BOOST_CHECK_EQUAL(wheel.size(), 2U);
+
+  // Delays are rounded up to the millisecond
+  advanceClocks(1_ms);
+  BOOST_CHECK(runs.empty());
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(runs.size(), 1U);
+  BOOST_CHECK_EQUAL(runs[0], 2);
+
+  advanceClocks(1_s, 1799);
+  advanceClocks(997_ms);
+  BOOST_CHECK_EQUAL(runs.size(), 1U);
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(runs.size(), 2U);
+  BOOST_CHECK_EQUAL(runs[1], 1);
+  BOOST_CHECK_EQUAL(wheel.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  TimerWheel::EventId first = wheel.schedule(100_ms, [this] { runs.push_back(1); });
+  TimerWheel::EventId second = wheel.schedule(100_ms, [this] { runs.push_back(2); });
+  TimerWheel::EventId later = wheel.schedule(1_h, [this] { runs.push_back(3); });
+  BOOST_CHECK(first);
+  BOOST_CHECK(!TimerWheel::EventId());
+
+  first.cancel();
+  later.cancel();
+  BOOST_CHECK(!first);
+  BOOST_CHECK_EQUAL(wheel.size(), 1U);
+
+  advanceClocks(100_ms);
+  BOOST_CHECK(runs == std::vector<int>({2}));
+  BOOST_CHECK(!second);
+
+  // Cancelling a timer that has run, or twice, has no effect
+  second.cancel();
+  first.cancel();
+  BOOST_CHECK_EQUAL(wheel.size(), 0U);
+
+  advanceClocks(1_h);
+  BOOST_CHECK(runs == std::vector<int>({2}));
+}
+
+BOOST_AUTO_TEST_CASE(BatchFiring)
+{
+  // Timers due at the same time run together, in the order they were scheduled, even when
+  // they were filed at different levels
+  wheel.schedule(5_s, [this] { runs.push_back(1); });
+  advanceClocks(4_s);
+  wheel.schedule(1_s, [this] { runs.push_back(2); });
+  wheel.schedule(1_s, [this] { runs.push_back(3); });
+  wheel.schedule(2_s, [this] { runs.push_back(4); });
+
+  advanceClocks(999_ms);
+  BOOST_CHECK(runs.empty());
+  advanceClocks(1_ms);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3}));
+  advanceClocks(1_s);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(LateClock)
+{
+  // Timers overtaken by the clock all run at the next tick, in the order they are due
+  wheel.schedule(3_s, [this] { runs.push_back(3); });
+  wheel.schedule(1_s, [this] { runs.push_back(1); });
+  wheel.schedule(2_s, [this] { runs.push_back(2); });
+  wheel.schedule(70_min, [this] { runs.push_back(4); });
+
+  advanceClocks(10_s);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3}));
+  advanceClocks(1_h);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3}));
+  advanceClocks(1_h);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3, 4}));
+
+  // An idle wheel catches up with the clock before filing new timers
+  advanceClocks(1_h);
+  wheel.schedule(20_ms, [this] { runs.push_back(5); });
+  advanceClocks(20_ms);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3, 4, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleFromCallback)
+{
+  TimerWheel::EventId cancelled;
+  wheel.schedule(1_s, [&] {
+    runs.push_back(1);
+    cancelled.cancel();
+    wheel.schedule(0_ms, [this] { runs.push_back(2); });
+    wheel.schedule(1_s, [this] { runs.push_back(3); });
+  });
+  cancelled = wheel.schedule(1_s, [this] { runs.push_back(4); });
+
+  advanceClocks(1_s);
+  BOOST_CHECK(runs == std::vector<int>({1}));
+  advanceClocks(1_ms);
+  BOOST_CHECK(runs == std::vector<int>({1, 2}));
+  advanceClocks(999_ms);
+  BOOST_CHECK(runs == std::vector<int>({1, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(ManyTimers)
+{
+  const int nTimers = 50000;
+  std::vector<TimerWheel::EventId> events;
+  std::vector<int> nRuns(nTimers);
+  for (int i = 0; i < nTimers; ++i) {
+    events.push_back(wheel.schedule(ndn::time::milliseconds((i * 7919) % 3600000),
+                                    [&nRuns, i] { ++nRuns[i]; }));
+  }
+  for (int i = 0; i < nTimers; i += 2) {
+    events[i].cancel();
+  }
+  BOOST_CHECK_EQUAL(wheel.size(), static_cast<size_t>(nTimers / 2));
+
+  advanceClocks(1_s, 3600);
+  BOOST_CHECK_EQUAL(wheel.size(), 0U);
+  int nWrong = 0;
+  for (int i = 0; i < nTimers; ++i) {
+    nWrong += nRuns[i] != i % 2;
+  }
+  BOOST_CHECK_EQUAL(nWrong, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace nlsr